@@ -0,0 +1,310 @@
+#include "debug.hpp"
+#include "aot_runtime.hpp"
+#if defined(_WIN32) || defined(_WIN64) || defined(WIN32)
+	#define PLATFORM_WINDOWS
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+	#undef near
+	#undef far
+#else
+	#include <pthread.h>
+#endif
+
+namespace logo {
+	//Stack space left for the builtin functions and the C++ runtime below the limit checked by the calls.
+	static constexpr std::size_t AOT_STACK_RESERVE = 1024 * 1024;
+
+	bool aot_parent_scope_variable(const Interpreter_Context* context,Symbol name,std::size_t slot,std::size_t line_index,Interpreter_Value* result) {
+		auto [var_index,success] = logo::find_parent_scope_variable(context,name,slot,line_index);
+		if(!success) return false;
+		*result = logo::aot_lvalue(var_index);
+		return true;
+	}
+
+	bool aot_unary_operation(const Interpreter_Context* context,Ast_Unary_Prefix_Operator_Type type,const Interpreter_Value& value,std::size_t line_index,Interpreter_Value* result) {
+		Option<Interpreter_Value> computed_value{};
+		if(type == Ast_Unary_Prefix_Operator_Type::Reference) computed_value = logo::make_reference(context,value,line_index);
+		else if(type == Ast_Unary_Prefix_Operator_Type::Dereference) computed_value = logo::dereference(context,value,line_index);
+		else computed_value = logo::compute_unary_operation(type,value,line_index);
+		if(!computed_value.has_value) return false;
+		*result = computed_value.value;
+		return true;
+	}
+
+	bool aot_binary_operation(Ast_Operation_Cache* cache,Ast_Binary_Operator_Type type,const Interpreter_Value& left,const Interpreter_Value& right,std::size_t line_index,Interpreter_Value* result) {
+		if(cache->specialization != Ast_Operation_Specialization::None) {
+			if(logo::compute_specialized_operation(cache->specialization,left,right,result)) return true;
+		}
+		auto specialization = logo::specialize_binary_operation(type,left.type,right.type);
+		if(specialization != cache->specialization) logo::update_operation_cache(cache,specialization);
+		auto [value,success] = logo::compute_binary_operation(type,left,right,line_index);
+		if(!success) return false;
+		*result = value;
+		return true;
+	}
+
+	bool aot_assignment(Interpreter_Context* context,Ast_Operation_Cache* cache,Ast_Assignment_Type type,const Interpreter_Value& lvalue,const Interpreter_Value& rvalue,std::size_t line_index) {
+		if(rvalue.type == Interpreter_Value_Type::Void) {
+			logo::report_interpreter_error(line_index,"Cannot assign value of type 'Void'.");
+			return false;
+		}
+		auto& target = context->variables[lvalue.var_index].value;
+		if(cache->specialization != Ast_Operation_Specialization::None) {
+			if(logo::compute_specialized_operation(cache->specialization,target,rvalue,&target)) return true;
+		}
+		if(type != Ast_Assignment_Type::Assignment) {
+			auto specialization = logo::specialize_compound_assignment(type,target.type,rvalue.type);
+			if(specialization != cache->specialization) logo::update_operation_cache(cache,specialization);
+		}
+		return logo::compute_assignment(type,&target,rvalue,line_index);
+	}
+
+	bool aot_check_lvalue(const Interpreter_Context* context,const Interpreter_Value& value,std::size_t line_index) {
+		if(value.type != Interpreter_Value_Type::Lvalue) {
+			logo::report_interpreter_error(line_index,"Cannot assign a value to a non-lvalue.");
+			return false;
+		}
+		return logo::check_parallel_loop_assignment(context,value.var_index,line_index);
+	}
+
+	bool aot_check_condition(const Interpreter_Value& condition,bool is_while_statement,std::size_t line_index) {
+		if(condition.type != Interpreter_Value_Type::Bool) {
+			if(is_while_statement) logo::report_interpreter_error(line_index,"Condition in a 'while' statement must be of type 'Bool'.");
+			else logo::report_interpreter_error(line_index,"Condition in a 'if' statement must be of type 'Bool'.");
+			return false;
+		}
+		return true;
+	}
+
+	bool aot_check_loop_bound(const Interpreter_Value& bound,bool is_starting_index,std::size_t line_index) {
+		if(bound.type != Interpreter_Value_Type::Int) {
+			if(is_starting_index) logo::report_interpreter_error(line_index,"Starting index in a 'for' loop must be an integer.");
+			else logo::report_interpreter_error(line_index,"Ending index in a 'for' loop must be an integer.");
+			return false;
+		}
+		return true;
+	}
+
+	bool aot_declare_variable(Interpreter_Context* context,Symbol name,const Interpreter_Value& value,std::size_t line_index) {
+		if(value.type == Interpreter_Value_Type::Void) {
+			logo::report_interpreter_error(line_index,"Cannot assign value of type 'Void' to '%'.",logo::get_symbol_name(name));
+			return false;
+		}
+		return logo::push_variable(context,name,value);
+	}
+
+	bool aot_define_function(Interpreter_Context* context,Symbol name,Array_View<Symbol> arguments,std::size_t function_index,bool is_memoized,
+							 std::size_t parent_function_index,bool defines_dynamic_functions) {
+		Interpreter_Function function{};
+		function.name = name;
+		function.arguments = arguments;
+		function.code_offset = function_index;
+		function.is_memoized = is_memoized;
+		function.parent_function_index = parent_function_index;
+		function.defines_dynamic_functions = defines_dynamic_functions;
+		return logo::define_function(context,function_index,function);
+	}
+
+	bool aot_function_call_argument(const Interpreter_Context* context,const Ast_Function_Call_Cache& cache,Symbol name,std::size_t arg_index,
+									const Interpreter_Value& value,std::size_t line_index,Interpreter_Value* arg) {
+		if(!cache.are_argument_types_proven && value.type == Interpreter_Value_Type::Void) {
+			logo::report_interpreter_error(line_index,"Cannot assign value of type 'Void' to a function parameter.");
+			return false;
+		}
+		if(arg_index >= 16) {
+			logo::report_interpreter_error(line_index,"Function '%' cannot take more than 16 arguments.",logo::get_symbol_name(name));
+			return false;
+		}
+		*arg = logo::aot_rvalue(context,value);
+		return true;
+	}
+
+	//Calls builtin functions and 'print'. Returns the called user defined function in 'function' without calling it.
+	[[nodiscard]] static bool call_builtin_function(Aot_State* state,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,
+													std::size_t line_index,Interpreter_Value* result,const Interpreter_Function** function) {
+		auto* context = &state->context;
+		*function = nullptr;
+		//This function is hardcoded because the interpreter doesn't support variadic functions.
+		if(name == context->print_symbol) {
+			if(!logo::check_parallel_loop_call(context,"print",line_index)) return false;
+			if(!logo::call_print_function(args,line_index)) return false;
+			result->type = Interpreter_Value_Type::Void;
+			return true;
+		}
+		auto [target,target_found] = logo::find_call_target(context,cache,name,function_index,args,line_index);
+		if(!target_found) return false;
+		if(target.builtin_function) {
+			auto [value,success] = target.builtin_function->func_ptr(context,line_index,args);
+			if(!success) return false;
+			*result = value;
+			return true;
+		}
+		*function = target.function;
+		return true;
+	}
+
+	[[nodiscard]] static bool push_arguments(Interpreter_Context* context,Array_View<Symbol> argument_names,Array_View<Interpreter_Value> args) {
+		for(std::size_t i = 0;i < args.length;i += 1) {
+			if(!logo::push_variable(context,argument_names[i],args[i])) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool call_user_function(Aot_State* state,const Interpreter_Function* function,Array_View<Interpreter_Value> args,std::size_t line_index,Interpreter_Value* result) {
+		auto* context = &state->context;
+		auto* memoized_function = &context->functions[static_cast<std::size_t>(function - context->functions.data)];
+		bool is_memoized_call = logo::can_memoize_call(memoized_function,args);
+		if(is_memoized_call) {
+			auto [value,found] = logo::find_memoized_result(context,memoized_function,args);
+			if(found) {
+				*result = value;
+				return true;
+			}
+		}
+
+		char stack_marker = 0;
+		if(reinterpret_cast<std::uintptr_t>(&stack_marker) < state->stack_limit) {
+			logo::report_interpreter_error(line_index,"Call stack exceeded the limit of % bytes.",state->program->max_stack_size);
+			return false;
+		}
+		std::size_t caller_first_var_index = context->current_function_scope_first_var_index;
+		std::size_t caller_frame_var_count = state->frame_var_count;
+		std::size_t caller_dynamic_scope_length = context->dynamic_scope.length;
+		state->frame_var_count = context->variables.length;
+		context->current_function_scope_first_var_index = context->variables.length;
+		if(function->defines_dynamic_functions && !logo::enter_dynamic_scope(context,function)) return false;
+		if(!logo::push_arguments(context,function->arguments,args)) return false;
+
+		//Calls in tail position leave the called function in 'tail_call_function' and return, so a chain of them runs in a loop.
+		std::size_t code_offset = function->code_offset;
+		while(true) {
+			state->tail_call_function = 0;
+			if(!state->program->functions[code_offset](state,result)) return false;
+			if(state->tail_call_function == 0) break;
+			code_offset = state->tail_call_function - 1;
+		}
+
+		logo::aot_leave_scope(context,state->frame_var_count);
+		context->current_function_scope_first_var_index = caller_first_var_index;
+		context->dynamic_scope.length = caller_dynamic_scope_length;
+		state->frame_var_count = caller_frame_var_count;
+		//The arguments live in the native frame of the caller, so they are still there after tail calls.
+		if(is_memoized_call) return logo::memoize_result(memoized_function,args,*result);
+		return true;
+	}
+
+	bool aot_call_function(Aot_State* state,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,std::size_t line_index,Interpreter_Value* result) {
+		const Interpreter_Function* function = nullptr;
+		if(!logo::call_builtin_function(state,cache,name,function_index,args,line_index,result,&function)) return false;
+		if(!function) return true;
+		return logo::call_user_function(state,function,args,line_index,result);
+	}
+
+	bool aot_tail_call_function(Aot_State* state,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,std::size_t line_index,Interpreter_Value* result) {
+		auto* context = &state->context;
+		const Interpreter_Function* function = nullptr;
+		if(!logo::call_builtin_function(state,cache,name,function_index,args,line_index,result,&function)) return false;
+		if(!function) return true;
+		//The result of a memoized call in tail position is only stored for the call whose native frame runs it.
+		if(logo::can_memoize_call(function,args)) {
+			auto [value,found] = logo::find_memoized_result(context,function,args);
+			if(found) {
+				*result = value;
+				return true;
+			}
+		}
+
+		//The arguments live in the native frame of the running function, which stays alive until the called function is run.
+		auto argument_names = function->arguments;
+		std::size_t code_offset = function->code_offset;
+		logo::aot_leave_scope(context,state->frame_var_count);
+		//Functions put on the dynamic scope never reuse their frame, so only the called function can be put there. 'call_user_function' removes it.
+		if(function->defines_dynamic_functions && !logo::enter_dynamic_scope(context,function)) return false;
+		if(!logo::push_arguments(context,argument_names,args)) return false;
+		state->tail_call_function = code_offset + 1;
+		return true;
+	}
+
+	[[nodiscard]] static bool run_top_level_code(Aot_State* state) {
+		char stack_marker = 0;
+		state->stack_limit = reinterpret_cast<std::uintptr_t>(&stack_marker) - state->program->max_stack_size;
+		return state->program->top_level_code(state);
+	}
+
+	//The generated code calls user defined functions recursively, so it runs on a thread whose stack is as big as the limit of the interpreter's call stack.
+	[[nodiscard]] static Option<bool> run_on_thread_with_stack(Aot_State* state) {
+		struct Thread_Data {
+			Aot_State* state;
+			bool success;
+		} data{state,false};
+		std::size_t stack_size = state->program->max_stack_size + AOT_STACK_RESERVE;
+#ifdef PLATFORM_WINDOWS
+		auto thread_proc = [](LPVOID arg) -> DWORD {
+			auto* thread_data = static_cast<Thread_Data*>(arg);
+			thread_data->success = logo::run_top_level_code(thread_data->state);
+			return 0;
+		};
+		HANDLE thread = CreateThread(nullptr,stack_size,thread_proc,&data,STACK_SIZE_PARAM_IS_A_RESERVATION,nullptr);
+		if(!thread) {
+			Report_Error("Couldn't create a thread with a stack of % bytes.",stack_size);
+			return {};
+		}
+		WaitForSingleObject(thread,INFINITE);
+		CloseHandle(thread);
+#else
+		pthread_attr_t attributes{};
+		if(pthread_attr_init(&attributes) != 0) {
+			Report_Error("Couldn't initialize thread attributes.");
+			return {};
+		}
+		defer[&]{pthread_attr_destroy(&attributes);};
+		pthread_t thread{};
+		auto thread_proc = [](void* arg) -> void* {
+			auto* thread_data = static_cast<Thread_Data*>(arg);
+			thread_data->success = logo::run_top_level_code(thread_data->state);
+			return nullptr;
+		};
+		if(pthread_attr_setstacksize(&attributes,stack_size) != 0 || pthread_create(&thread,&attributes,thread_proc,&data) != 0) {
+			Report_Error("Couldn't create a thread with a stack of % bytes.",stack_size);
+			return {};
+		}
+		pthread_join(thread,nullptr);
+#endif
+		return data.success;
+	}
+
+	int run_aot_program(const Aot_Program& program) {
+		if(!logo::debug_init()) {
+			logo::eprint("%\n",logo::get_reported_error());
+			return 1;
+		}
+		defer[]{logo::debug_term();};
+		defer[]{logo::term_symbol_table();};
+
+		//Symbols are compared by their indices, so the names have to be interned in the same order as in the transpiler.
+		for(std::size_t i = 0;i < program.symbol_names.length;i += 1) {
+			auto [symbol,success] = logo::intern_symbol(program.symbol_names[i]);
+			if(!success) {
+				logo::eprint("%\n",logo::get_reported_error());
+				return 1;
+			}
+			logo::assert(static_cast<std::size_t>(symbol) == i);
+		}
+
+		Aot_State state{};
+		state.program = &program;
+		if(!logo::init_interpreter_context(&state.context)) {
+			logo::eprint("%\n",logo::get_reported_error());
+			return 1;
+		}
+		defer[&]{logo::destroy_interpreter_context(&state.context);};
+
+		auto [success,thread_created] = logo::run_on_thread_with_stack(&state);
+		if(!thread_created || !success) {
+			logo::eprint("%\n",logo::get_reported_error());
+			return 1;
+		}
+		return 0;
+	}
+}
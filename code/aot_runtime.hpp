@@ -0,0 +1,98 @@
+#ifndef LOGO_AOT_RUNTIME_HPP
+#define LOGO_AOT_RUNTIME_HPP
+
+#include <bit>
+#include <cstdint>
+#include "utils.hpp"
+#include "parser.hpp"
+#include "array_view.hpp"
+#include "interpreter.hpp"
+#include "symbol_table.hpp"
+
+//This is the runtime of programs generated by 'logo --emit-cpp'. The generated code keeps the variables and the functions
+//in an 'Interpreter_Context' exactly like the interpreter does, so references, operator ' and the canvas behave the same way.
+//Operations whose operand types were proven by the type inference pass are written out as plain C++ by the transpiler,
+//everything else goes through the functions below.
+namespace logo {
+	struct Aot_State;
+	//Every user defined function is compiled to one of these. The arguments are already declared as variables when it's called.
+	using Aot_Function = bool(*)(Aot_State*,Interpreter_Value*);
+	struct Aot_Program {
+		Array_View<String_View> symbol_names; //Names of the symbols of the script in the order they were interned by the transpiler.
+		Array_View<Aot_Function> functions; //'Interpreter_Function::code_offset' is the index of the function in this array.
+		bool(*top_level_code)(Aot_State*);
+		std::size_t max_stack_size;
+	};
+	struct Aot_State {
+		Interpreter_Context context;
+		const Aot_Program* program;
+		std::uintptr_t stack_limit; //Calls fail with an error once the native stack grows below this address.
+		//Variables of the caller of the running function. Calls in tail position remove everything above them before the called function runs.
+		std::size_t frame_var_count;
+		std::size_t tail_call_function; //Index of the function called in tail position plus 1 or 0 if there isn't one.
+	};
+
+	[[nodiscard]] inline Interpreter_Value aot_int(std::int64_t value) {
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Int;
+		result.int_v = value;
+		return result;
+	}
+	//Float literals are written out as their bits so they don't change when they're parsed by the C++ compiler.
+	[[nodiscard]] inline Interpreter_Value aot_float(std::uint64_t bits) {
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Float;
+		result.float_v = std::bit_cast<double>(bits);
+		return result;
+	}
+	[[nodiscard]] inline Interpreter_Value aot_bool(bool value) {
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Bool;
+		result.bool_v = value;
+		return result;
+	}
+	[[nodiscard]] inline Interpreter_Value aot_string(Symbol value) {
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::String;
+		result.string_v = value;
+		return result;
+	}
+	[[nodiscard]] inline Interpreter_Value aot_lvalue(std::size_t var_index) {
+		return logo::make_lvalue(var_index);
+	}
+	[[nodiscard]] inline Interpreter_Value aot_rvalue(const Interpreter_Context* context,const Interpreter_Value& value) {
+		if(value.type == Interpreter_Value_Type::Lvalue) return context->variables[value.var_index].value;
+		return value;
+	}
+	//Leaves a scope, removing the variables that were declared in it.
+	inline void aot_leave_scope(Interpreter_Context* context,std::size_t var_count) {
+		context->variables.length = var_count;
+	}
+
+	[[nodiscard]] bool aot_parent_scope_variable(const Interpreter_Context* context,Symbol name,std::size_t slot,std::size_t line_index,Interpreter_Value* result);
+	[[nodiscard]] bool aot_unary_operation(const Interpreter_Context* context,Ast_Unary_Prefix_Operator_Type type,const Interpreter_Value& value,std::size_t line_index,Interpreter_Value* result);
+	[[nodiscard]] bool aot_binary_operation(Ast_Operation_Cache* cache,Ast_Binary_Operator_Type type,const Interpreter_Value& left,const Interpreter_Value& right,std::size_t line_index,Interpreter_Value* result);
+	[[nodiscard]] bool aot_assignment(Interpreter_Context* context,Ast_Operation_Cache* cache,Ast_Assignment_Type type,const Interpreter_Value& lvalue,const Interpreter_Value& rvalue,std::size_t line_index);
+	[[nodiscard]] bool aot_check_lvalue(const Interpreter_Context* context,const Interpreter_Value& value,std::size_t line_index);
+	[[nodiscard]] bool aot_check_condition(const Interpreter_Value& condition,bool is_while_statement,std::size_t line_index);
+	[[nodiscard]] bool aot_check_loop_bound(const Interpreter_Value& bound,bool is_starting_index,std::size_t line_index);
+	[[nodiscard]] bool aot_declare_variable(Interpreter_Context* context,Symbol name,const Interpreter_Value& value,std::size_t line_index);
+	//Every function is defined before the top level code runs. 'function_index' is both the index assigned by the resolver and the index in 'Aot_Program::functions'.
+	//The flags and 'parent_function_index' are copied from 'Ast_Function_Definition'.
+	[[nodiscard]] bool aot_define_function(Interpreter_Context* context,Symbol name,Array_View<Symbol> arguments,std::size_t function_index,bool is_memoized,
+										   std::size_t parent_function_index,bool defines_dynamic_functions);
+	//Checks the computed argument of a call and stores its value in 'arg'.
+	[[nodiscard]] bool aot_function_call_argument(const Interpreter_Context* context,const Ast_Function_Call_Cache& cache,Symbol name,std::size_t arg_index,
+												  const Interpreter_Value& value,std::size_t line_index,Interpreter_Value* arg);
+	//'function_index' is 'Ast_Function_Call::function_index'.
+	[[nodiscard]] bool aot_call_function(Aot_State* state,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,std::size_t line_index,Interpreter_Value* result);
+	//Same as above but for a call whose result is returned by a function whose variables nothing can refer to.
+	//The running function is left first and the called one is run by 'aot_call_function' in the same native frame.
+	[[nodiscard]] bool aot_tail_call_function(Aot_State* state,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,std::size_t line_index,Interpreter_Value* result);
+
+	//Sets up the interpreter context, runs the program on a thread with a stack of 'program.max_stack_size' bytes and prints the error if there is one.
+	//Returns the exit code of the process.
+	[[nodiscard]] int run_aot_program(const Aot_Program& program);
+}
+
+#endif
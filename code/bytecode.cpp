@@ -0,0 +1,535 @@
+#include <limits>
+#include "debug.hpp"
+#include "bytecode.hpp"
+
+namespace logo {
+	void Bytecode_Program::destroy() {
+		functions.destroy();
+		parent_variables.destroy();
+		call_sites.destroy();
+		constants.destroy();
+		line_indices.destroy();
+		instructions.destroy();
+	}
+
+	struct Compiler_Loop {
+		std::size_t scope_depth;
+		std::size_t first_jump_index;
+		bool has_scope;
+	};
+	struct Compiler_Loop_Jump {
+		std::size_t instruction_index;
+		bool is_break;
+	};
+	struct Compiler_Pending_Function {
+		std::size_t function_index;
+		Array_View<Ast_Statement> body_statements;
+	};
+	struct Compiler_State {
+		Bytecode_Program* program;
+		std::size_t scope_depth;
+		bool inside_function;
+		Symbol print_symbol;
+		Heap_Array<Compiler_Loop> loops;
+		Heap_Array<Compiler_Loop_Jump> loop_jumps;
+		Heap_Array<Compiler_Pending_Function> pending_functions;
+		void destroy() {
+			pending_functions.destroy();
+			loop_jumps.destroy();
+			loops.destroy();
+		}
+	};
+
+	template<typename... Args>
+	static void report_compiler_error(std::size_t line_index,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
+		logo::format_into(logo::write_char32_t_to_error_message,"[Compile error] Line %: ",line_index);
+		logo::format_into(logo::write_char32_t_to_error_message,format,std::forward<Args>(args)...);
+		logo::write_char32_t_to_error_message('\n');
+	}
+
+	[[nodiscard]] static bool emit_instruction(Compiler_State* state,Bytecode_Opcode opcode,std::size_t operand,std::size_t line_index,std::uint8_t variant = 0) {
+		if(operand > std::numeric_limits<std::uint32_t>::max()) {
+			logo::report_compiler_error(line_index,"The program is too big.");
+			return false;
+		}
+		Bytecode_Instruction instruction{};
+		instruction.opcode = opcode;
+		instruction.variant = variant;
+		instruction.operand = static_cast<std::uint32_t>(operand);
+		if(!state->program->instructions.push_back(instruction)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(instruction));
+			return false;
+		}
+		if(!state->program->line_indices.push_back(line_index)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(line_index));
+			return false;
+		}
+		return true;
+	}
+
+	static void patch_jump(Compiler_State* state,std::size_t instruction_index,std::size_t target) {
+		state->program->instructions[instruction_index].operand = static_cast<std::uint32_t>(target);
+	}
+
+	[[nodiscard]] static Option<std::size_t> add_constant(Compiler_State* state,const Interpreter_Value& value) {
+		if(!state->program->constants.push_back(value)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(value));
+			return {};
+		}
+		return state->program->constants.length - 1;
+	}
+
+	[[nodiscard]] static Bytecode_Opcode binary_operator_opcode(Ast_Binary_Operator_Type type) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus: return Bytecode_Opcode::Add;
+			case Ast_Binary_Operator_Type::Minus: return Bytecode_Opcode::Subtract;
+			case Ast_Binary_Operator_Type::Multiply: return Bytecode_Opcode::Multiply;
+			case Ast_Binary_Operator_Type::Divide: return Bytecode_Opcode::Divide;
+			case Ast_Binary_Operator_Type::Remainder: return Bytecode_Opcode::Remainder;
+			case Ast_Binary_Operator_Type::Exponentiate: return Bytecode_Opcode::Exponentiate;
+			case Ast_Binary_Operator_Type::Logical_And: return Bytecode_Opcode::Logical_And;
+			case Ast_Binary_Operator_Type::Logical_Or: return Bytecode_Opcode::Logical_Or;
+			case Ast_Binary_Operator_Type::Compare_Equal: return Bytecode_Opcode::Compare_Equal;
+			case Ast_Binary_Operator_Type::Compare_Unequal: return Bytecode_Opcode::Compare_Unequal;
+			case Ast_Binary_Operator_Type::Compare_Less_Than: return Bytecode_Opcode::Compare_Less_Than;
+			case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: return Bytecode_Opcode::Compare_Less_Than_Or_Equal;
+			case Ast_Binary_Operator_Type::Compare_Greater_Than: return Bytecode_Opcode::Compare_Greater_Than;
+			case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: return Bytecode_Opcode::Compare_Greater_Than_Or_Equal;
+			default: logo::unreachable();
+		}
+	}
+
+	//When 'as_lvalue' is true, identifiers, dereferences and parent scope accesses leave an lvalue on the stack instead of the value it refers to.
+	[[nodiscard]] static bool compile_expression(Compiler_State* state,const Ast_Expression& expression,bool as_lvalue) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: {
+				const auto& value = expression.value;
+				Interpreter_Value constant{};
+				switch(value.type) {
+					case Ast_Value_Type::Identifier: {
+						return logo::emit_instruction(state,as_lvalue ? Bytecode_Opcode::Load_Variable_Lvalue : Bytecode_Opcode::Load_Variable,value.slot,value.line_index);
+					}
+					case Ast_Value_Type::Int_Literal: {
+						constant.type = Interpreter_Value_Type::Int;
+						constant.int_v = value.int_value;
+						break;
+					}
+					case Ast_Value_Type::Float_Literal: {
+						constant.type = Interpreter_Value_Type::Float;
+						constant.float_v = value.float_value;
+						break;
+					}
+					case Ast_Value_Type::Bool_Literal: {
+						constant.type = Interpreter_Value_Type::Bool;
+						constant.bool_v = value.bool_value;
+						break;
+					}
+					case Ast_Value_Type::String_Literal: {
+						constant.type = Interpreter_Value_Type::String;
+						constant.string_v = value.string_value;
+						break;
+					}
+					default: logo::unreachable();
+				}
+				auto [constant_index,success] = logo::add_constant(state,constant);
+				if(!success) return false;
+				return logo::emit_instruction(state,Bytecode_Opcode::Push_Constant,constant_index,value.line_index);
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				switch(unary_operator->type) {
+					case Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access: {
+						const auto& child_value = unary_operator->child->value;
+						if(child_value.depth == 0) {
+							return logo::emit_instruction(state,as_lvalue ? Bytecode_Opcode::Load_Variable_Lvalue : Bytecode_Opcode::Load_Variable,child_value.slot,unary_operator->line_index);
+						}
+						Bytecode_Parent_Variable parent_variable{};
+						parent_variable.name = child_value.identfier_name;
+						parent_variable.slot = child_value.slot;
+						if(!state->program->parent_variables.push_back(parent_variable)) {
+							Report_Error("Couldn't allocate % bytes of memory.",sizeof(parent_variable));
+							return false;
+						}
+						return logo::emit_instruction(state,as_lvalue ? Bytecode_Opcode::Load_Parent_Variable_Lvalue : Bytecode_Opcode::Load_Parent_Variable,state->program->parent_variables.length - 1,unary_operator->line_index);
+					}
+					case Ast_Unary_Prefix_Operator_Type::Reference: {
+						if(!logo::compile_expression(state,*unary_operator->child,true)) return false;
+						return logo::emit_instruction(state,Bytecode_Opcode::Make_Reference,0,unary_operator->line_index);
+					}
+					case Ast_Unary_Prefix_Operator_Type::Dereference: {
+						if(!logo::compile_expression(state,*unary_operator->child,false)) return false;
+						if(unary_operator->is_reference_proven) {
+							return logo::emit_instruction(state,as_lvalue ? Bytecode_Opcode::Dereference_Lvalue_Unchecked : Bytecode_Opcode::Dereference_Unchecked,0,unary_operator->line_index);
+						}
+						return logo::emit_instruction(state,as_lvalue ? Bytecode_Opcode::Dereference_Lvalue : Bytecode_Opcode::Dereference,0,unary_operator->line_index);
+					}
+					case Ast_Unary_Prefix_Operator_Type::Plus: {
+						if(!logo::compile_expression(state,*unary_operator->child,false)) return false;
+						return logo::emit_instruction(state,Bytecode_Opcode::Unary_Plus,0,unary_operator->line_index);
+					}
+					case Ast_Unary_Prefix_Operator_Type::Minus: {
+						if(!logo::compile_expression(state,*unary_operator->child,false)) return false;
+						return logo::emit_instruction(state,Bytecode_Opcode::Negate,0,unary_operator->line_index);
+					}
+					case Ast_Unary_Prefix_Operator_Type::Logical_Not: {
+						if(!logo::compile_expression(state,*unary_operator->child,false)) return false;
+						return logo::emit_instruction(state,Bytecode_Opcode::Logical_Not,0,unary_operator->line_index);
+					}
+					default: logo::unreachable();
+				}
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto* binary_operator = expression.binary_operator;
+				if(!logo::compile_expression(state,*binary_operator->left,false)) return false;
+				//'and' skips the right operand when the left one is false and 'or' when it's true. The left operand is then the result.
+				bool is_logical_operator = binary_operator->type == Ast_Binary_Operator_Type::Logical_And || binary_operator->type == Ast_Binary_Operator_Type::Logical_Or;
+				std::size_t short_circuit_index = state->program->instructions.length;
+				if(is_logical_operator) {
+					auto jump_value = static_cast<std::uint8_t>(binary_operator->type == Ast_Binary_Operator_Type::Logical_Or);
+					if(!logo::emit_instruction(state,Bytecode_Opcode::Short_Circuit,0,binary_operator->line_index,jump_value)) return false;
+				}
+				if(!logo::compile_expression(state,*binary_operator->right,false)) return false;
+				auto opcode = logo::binary_operator_opcode(binary_operator->type);
+				if(binary_operator->cache.is_proven) opcode = logo::get_unchecked_opcode(logo::get_specialized_binary_opcode(binary_operator->cache.specialization));
+				if(!logo::emit_instruction(state,opcode,0,binary_operator->line_index)) return false;
+				if(is_logical_operator) logo::patch_jump(state,short_circuit_index,state->program->instructions.length);
+				return true;
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				if(!logo::compile_expression(state,*conditional->condition,false)) return false;
+				std::size_t jump_to_else_index = state->program->instructions.length;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::Jump_If_False,0,conditional->line_index,static_cast<std::uint8_t>(Bytecode_Condition_Type::Conditional_Expression))) return false;
+				if(!logo::compile_expression(state,*conditional->if_true,as_lvalue)) return false;
+				std::size_t jump_to_end_index = state->program->instructions.length;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::Jump,0,conditional->line_index)) return false;
+				logo::patch_jump(state,jump_to_else_index,state->program->instructions.length);
+				if(!logo::compile_expression(state,*conditional->if_false,as_lvalue)) return false;
+				logo::patch_jump(state,jump_to_end_index,state->program->instructions.length);
+				return true;
+			}
+			case Ast_Expression_Type::Function_Call: {
+				const auto* function_call = expression.function_call;
+				if(function_call->arguments.length > 16) {
+					logo::report_compiler_error(function_call->line_index,"Function '%' cannot take more than 16 arguments.",logo::get_symbol_name(function_call->name));
+					return false;
+				}
+				for(const auto* arg_expr : function_call->arguments) {
+					if(!logo::compile_expression(state,*arg_expr,false)) return false;
+				}
+
+				Bytecode_Call_Site call_site{};
+				call_site.name = function_call->name;
+				call_site.arg_count = function_call->arguments.length;
+				call_site.are_argument_types_proven = function_call->cache.are_argument_types_proven;
+				call_site.is_name_in_scope = function_call->cache.is_name_in_scope;
+				call_site.function_index = function_call->function_index;
+				if(!state->program->call_sites.push_back(call_site)) {
+					Report_Error("Couldn't allocate % bytes of memory.",sizeof(call_site));
+					return false;
+				}
+				//This function is hardcoded because the interpreter doesn't support variadic functions.
+				bool is_print = function_call->name == state->print_symbol;
+				return logo::emit_instruction(state,is_print ? Bytecode_Opcode::Print : Bytecode_Opcode::Call,state->program->call_sites.length - 1,function_call->line_index);
+			}
+			case Ast_Expression_Type::Array_Access: {
+				logo::report_compiler_error(expression.array_access->line_index,"Arrays are not yet implemented.");
+				return false;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool compile_statements(Compiler_State* state,Array_View<Ast_Statement> statements);
+
+	[[nodiscard]] static bool compile_scope(Compiler_State* state,Array_View<Ast_Statement> statements,std::size_t line_index) {
+		if(!logo::emit_instruction(state,Bytecode_Opcode::Begin_Scope,0,line_index)) return false;
+		state->scope_depth += 1;
+		if(!logo::compile_statements(state,statements)) return false;
+		state->scope_depth -= 1;
+		return logo::emit_instruction(state,Bytecode_Opcode::End_Scope,1,line_index);
+	}
+
+	//The closing 'End_Scope' is emitted by the caller because 'continue' jumps to it.
+	[[nodiscard]] static bool compile_loop_body(Compiler_State* state,Array_View<Ast_Statement> statements,bool skip_scope,std::size_t line_index) {
+		if(skip_scope) return logo::compile_statements(state,statements);
+		if(!logo::emit_instruction(state,Bytecode_Opcode::Begin_Scope,0,line_index)) return false;
+		state->scope_depth += 1;
+		if(!logo::compile_statements(state,statements)) return false;
+		state->scope_depth -= 1;
+		return true;
+	}
+
+	[[nodiscard]] static bool begin_loop(Compiler_State* state,bool has_scope) {
+		Compiler_Loop loop{};
+		loop.scope_depth = state->scope_depth;
+		loop.first_jump_index = state->loop_jumps.length;
+		loop.has_scope = has_scope;
+		if(!state->loops.push_back(loop)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(loop));
+			return false;
+		}
+		return true;
+	}
+
+	static void end_loop(Compiler_State* state,std::size_t continue_target,std::size_t break_target) {
+		const auto& loop = state->loops[state->loops.length - 1];
+		for(std::size_t i = loop.first_jump_index;i < state->loop_jumps.length;i += 1) {
+			const auto& jump = state->loop_jumps[i];
+			logo::patch_jump(state,jump.instruction_index,jump.is_break ? break_target : continue_target);
+		}
+		state->loop_jumps.length = loop.first_jump_index;
+		state->loops.pop_back();
+	}
+
+	[[nodiscard]] static bool compile_loop_jump(Compiler_State* state,bool is_break,std::size_t line_index) {
+		if(state->loops.length == 0) {
+			logo::report_compiler_error(line_index,"'%' statement must be inside of a loop.",is_break ? "break" : "continue");
+			return false;
+		}
+		const auto& loop = state->loops[state->loops.length - 1];
+		//'break' leaves the scope of the loop body as well, 'continue' jumps to the instruction that leaves it.
+		std::size_t scope_count = state->scope_depth - loop.scope_depth - ((is_break || !loop.has_scope) ? 0 : 1);
+		if(scope_count > 0) {
+			if(!logo::emit_instruction(state,Bytecode_Opcode::End_Scope,scope_count,line_index)) return false;
+		}
+
+		Compiler_Loop_Jump jump{};
+		jump.instruction_index = state->program->instructions.length;
+		jump.is_break = is_break;
+		if(!state->loop_jumps.push_back(jump)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(jump));
+			return false;
+		}
+		return logo::emit_instruction(state,Bytecode_Opcode::Jump,0,line_index);
+	}
+
+	[[nodiscard]] static bool compile_statement(Compiler_State* state,const Ast_Statement& statement) {
+		switch(statement.type) {
+			case Ast_Statement_Type::Expression: {
+				if(!logo::compile_expression(state,statement.expression,false)) return false;
+				return logo::emit_instruction(state,Bytecode_Opcode::Pop,0,statement.line_index);
+			}
+			case Ast_Statement_Type::Declaration: {
+				if(!logo::compile_expression(state,statement.declaration.initial_value_expr,false)) return false;
+				return logo::emit_instruction(state,Bytecode_Opcode::Declare_Variable,static_cast<std::size_t>(statement.declaration.name),statement.line_index);
+			}
+			case Ast_Statement_Type::Assignment: {
+				if(!logo::compile_expression(state,statement.assignment.lvalue_expr,true)) return false;
+				if(!logo::compile_expression(state,statement.assignment.rvalue_expr,false)) return false;
+				auto opcode = Bytecode_Opcode::Assign;
+				if(statement.assignment.cache.is_proven) opcode = logo::get_unchecked_opcode(logo::get_specialized_assignment_opcode(statement.assignment.cache.specialization));
+				return logo::emit_instruction(state,opcode,0,statement.assignment.line_index,static_cast<std::uint8_t>(statement.assignment.type));
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				const auto& definition = statement.function_definition;
+				Bytecode_Function function{};
+				function.name = definition.name;
+				function.arguments = Array_View<Symbol>(definition.function_arguments.data,definition.function_arguments.length);
+				function.body_statements = Array_View<Ast_Statement>(definition.body_statements.data,definition.body_statements.length);
+				function.function_index = definition.function_index;
+				function.is_memoized = definition.is_memoized;
+				function.parent_function_index = definition.parent_function_index;
+				function.defines_dynamic_functions = definition.defines_dynamic_functions;
+				if(!state->program->functions.push_back(function)) {
+					Report_Error("Couldn't allocate % bytes of memory.",sizeof(function));
+					return false;
+				}
+
+				Compiler_Pending_Function pending_function{};
+				pending_function.function_index = state->program->functions.length - 1;
+				pending_function.body_statements = Array_View<Ast_Statement>(definition.body_statements.data,definition.body_statements.length);
+				if(!state->pending_functions.push_back(pending_function)) {
+					Report_Error("Couldn't allocate % bytes of memory.",sizeof(pending_function));
+					return false;
+				}
+				//Functions are defined by the VM before the program starts, nothing is done when the definition is reached.
+				return true;
+			}
+			case Ast_Statement_Type::If_Statement: {
+				const auto& if_statement = statement.if_statement;
+				if(!logo::compile_expression(state,if_statement.condition_expr,false)) return false;
+				std::size_t jump_to_else_index = state->program->instructions.length;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::Jump_If_False,0,statement.line_index,static_cast<std::uint8_t>(Bytecode_Condition_Type::If_Statement))) return false;
+
+				if(if_statement.if_true_statements.length > 0) {
+					if(!logo::compile_scope(state,{if_statement.if_true_statements.data,if_statement.if_true_statements.length},statement.line_index)) return false;
+				}
+				if(if_statement.if_false_statements.length > 0) {
+					std::size_t jump_to_end_index = state->program->instructions.length;
+					if(!logo::emit_instruction(state,Bytecode_Opcode::Jump,0,statement.line_index)) return false;
+					logo::patch_jump(state,jump_to_else_index,state->program->instructions.length);
+					if(!logo::compile_scope(state,{if_statement.if_false_statements.data,if_statement.if_false_statements.length},statement.line_index)) return false;
+					logo::patch_jump(state,jump_to_end_index,state->program->instructions.length);
+				}
+				else logo::patch_jump(state,jump_to_else_index,state->program->instructions.length);
+				return true;
+			}
+			case Ast_Statement_Type::While_Statement: {
+				const auto& while_statement = statement.while_statement;
+				std::size_t loop_start_index = state->program->instructions.length;
+				if(!logo::compile_expression(state,while_statement.condition_expr,false)) return false;
+				std::size_t jump_to_exit_index = state->program->instructions.length;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::Jump_If_False,0,statement.line_index,static_cast<std::uint8_t>(Bytecode_Condition_Type::While_Statement))) return false;
+
+				if(!logo::begin_loop(state,!while_statement.skip_scope)) return false;
+				if(!logo::compile_loop_body(state,{while_statement.body_statements.data,while_statement.body_statements.length},while_statement.skip_scope,statement.line_index)) return false;
+				std::size_t continue_target = state->program->instructions.length;
+				if(!while_statement.skip_scope) {
+					if(!logo::emit_instruction(state,Bytecode_Opcode::End_Scope,1,statement.line_index)) return false;
+				}
+				if(!logo::emit_instruction(state,Bytecode_Opcode::Jump,loop_start_index,statement.line_index)) return false;
+
+				std::size_t exit_target = state->program->instructions.length;
+				logo::patch_jump(state,jump_to_exit_index,exit_target);
+				logo::end_loop(state,continue_target,exit_target);
+				return true;
+			}
+			case Ast_Statement_Type::For_Statement: {
+				const auto& for_statement = statement.for_statement;
+				if(!logo::compile_expression(state,for_statement.start_expr,false)) return false;
+				if(!logo::compile_expression(state,for_statement.end_expr,false)) return false;
+				//'For_Prepare' skips the following jump if the loop executes at least once.
+				if(!logo::emit_instruction(state,Bytecode_Opcode::For_Prepare,static_cast<std::size_t>(for_statement.iterator_identifier),statement.line_index)) return false;
+				std::size_t jump_to_exit_index = state->program->instructions.length;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::Jump,0,statement.line_index)) return false;
+
+				//Steps of the induction variables stay on the stack above the bounds until 'For_End'.
+				auto induction_variable_count = static_cast<std::uint8_t>(for_statement.induction_variables.length);
+				for(std::size_t i = 0;i < for_statement.induction_variables.length;i += 1) {
+					const auto& induction_variable = for_statement.induction_variables[i];
+					if(!logo::compile_expression(state,induction_variable.step_expr,false)) return false;
+					if(!logo::emit_instruction(state,Bytecode_Opcode::Declare_Induction_Variable,static_cast<std::size_t>(induction_variable.name),statement.line_index,static_cast<std::uint8_t>(i))) return false;
+				}
+				//The VM runs the iterations of parallel loops one after another, it only resets the turtle between them.
+				if(for_statement.is_parallel && !logo::emit_instruction(state,Bytecode_Opcode::Enter_Parallel_Loop,0,statement.line_index)) return false;
+
+				if(!logo::begin_loop(state,!for_statement.skip_scope)) return false;
+				std::size_t body_start_index = state->program->instructions.length;
+				if(!logo::compile_loop_body(state,{for_statement.body_statements.data,for_statement.body_statements.length},for_statement.skip_scope,statement.line_index)) return false;
+				std::size_t continue_target = state->program->instructions.length;
+				if(!for_statement.skip_scope) {
+					if(!logo::emit_instruction(state,Bytecode_Opcode::End_Scope,1,statement.line_index)) return false;
+				}
+				if(for_statement.is_parallel && !logo::emit_instruction(state,Bytecode_Opcode::Next_Parallel_Iteration,0,statement.line_index)) return false;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::For_Step,body_start_index,statement.line_index,induction_variable_count)) return false;
+				std::size_t break_target = state->program->instructions.length;
+				if(!logo::emit_instruction(state,Bytecode_Opcode::For_End,0,statement.line_index,induction_variable_count)) return false;
+				if(for_statement.is_parallel && !logo::emit_instruction(state,Bytecode_Opcode::Leave_Parallel_Loop,0,statement.line_index)) return false;
+
+				logo::patch_jump(state,jump_to_exit_index,state->program->instructions.length);
+				logo::end_loop(state,continue_target,break_target);
+				return true;
+			}
+			case Ast_Statement_Type::Break_Statement: {
+				return logo::compile_loop_jump(state,true,statement.line_index);
+			}
+			case Ast_Statement_Type::Continue_Statement: {
+				return logo::compile_loop_jump(state,false,statement.line_index);
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				if(!state->inside_function) {
+					logo::report_compiler_error(statement.line_index,"'return' statement must be inside of a function.");
+					return false;
+				}
+				if(statement.return_statement.return_value) {
+					if(!logo::compile_expression(state,*statement.return_statement.return_value,false)) return false;
+					//A call in tail position is the last instruction of the return value. 'Tail_Call' falls back to a regular call when it can't jump to the function
+					//so the 'Return' is still needed.
+					auto& last_instruction = state->program->instructions[state->program->instructions.length - 1];
+					if(statement.return_statement.is_tail_call && last_instruction.opcode == Bytecode_Opcode::Call) {
+						last_instruction.opcode = Bytecode_Opcode::Tail_Call;
+						last_instruction.variant = statement.return_statement.can_reuse_frame ? 1 : 0;
+					}
+					return logo::emit_instruction(state,Bytecode_Opcode::Return,0,statement.line_index,1);
+				}
+				return logo::emit_instruction(state,Bytecode_Opcode::Return,0,statement.line_index,0);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool compile_statements(Compiler_State* state,Array_View<Ast_Statement> statements) {
+		for(const auto& statement : statements) {
+			if(!logo::compile_statement(state,statement)) return false;
+		}
+		return true;
+	}
+
+	static_assert(static_cast<std::size_t>(Bytecode_Opcode::Logical_Or_Bool) - static_cast<std::size_t>(Bytecode_Opcode::Add_Int) ==
+				  static_cast<std::size_t>(Ast_Operation_Specialization::Bool_Logical_Or) - static_cast<std::size_t>(Ast_Operation_Specialization::Int_Plus));
+	Bytecode_Opcode get_specialized_binary_opcode(Ast_Operation_Specialization specialization) {
+		logo::assert(specialization != Ast_Operation_Specialization::None);
+		auto offset = static_cast<std::size_t>(specialization) - static_cast<std::size_t>(Ast_Operation_Specialization::Int_Plus);
+		return static_cast<Bytecode_Opcode>(static_cast<std::size_t>(Bytecode_Opcode::Add_Int) + offset);
+	}
+
+	Bytecode_Opcode get_specialized_assignment_opcode(Ast_Operation_Specialization specialization) {
+		switch(specialization) {
+			case Ast_Operation_Specialization::Int_Plus: return Bytecode_Opcode::Assign_Add_Int;
+			case Ast_Operation_Specialization::Int_Minus: return Bytecode_Opcode::Assign_Subtract_Int;
+			case Ast_Operation_Specialization::Int_Multiply: return Bytecode_Opcode::Assign_Multiply_Int;
+			case Ast_Operation_Specialization::Int_Divide: return Bytecode_Opcode::Assign_Divide_Int;
+			case Ast_Operation_Specialization::Int_Remainder: return Bytecode_Opcode::Assign_Remainder_Int;
+			case Ast_Operation_Specialization::Float_Plus: return Bytecode_Opcode::Assign_Add_Float;
+			case Ast_Operation_Specialization::Float_Minus: return Bytecode_Opcode::Assign_Subtract_Float;
+			case Ast_Operation_Specialization::Float_Multiply: return Bytecode_Opcode::Assign_Multiply_Float;
+			case Ast_Operation_Specialization::Float_Divide: return Bytecode_Opcode::Assign_Divide_Float;
+			case Ast_Operation_Specialization::Float_Remainder: return Bytecode_Opcode::Assign_Remainder_Float;
+			default: logo::unreachable();
+		}
+	}
+
+	Bytecode_Opcode get_unchecked_opcode(Bytecode_Opcode specialized_opcode) {
+		constexpr auto offset = static_cast<std::size_t>(Bytecode_Opcode::Add_Int_Unchecked) - static_cast<std::size_t>(Bytecode_Opcode::Add_Int);
+		logo::assert(specialized_opcode >= Bytecode_Opcode::Add_Int && specialized_opcode < Bytecode_Opcode::Add_Int_Unchecked);
+		return static_cast<Bytecode_Opcode>(static_cast<std::size_t>(specialized_opcode) + offset);
+	}
+
+	bool can_quicken_instruction(const Bytecode_Instruction& instruction,Bytecode_Opcode opcode) {
+		if(opcode == instruction.opcode) return true;
+		static constexpr Interpreter_Value_Type Operand_Types[] = {Interpreter_Value_Type::Int,Interpreter_Value_Type::Float,Interpreter_Value_Type::Bool};
+		for(auto operand_type : Operand_Types) {
+			if(instruction.opcode == Bytecode_Opcode::Assign) {
+				auto specialization = logo::specialize_compound_assignment(static_cast<Ast_Assignment_Type>(instruction.variant),operand_type,operand_type);
+				if(specialization != Ast_Operation_Specialization::None && logo::get_specialized_assignment_opcode(specialization) == opcode) return true;
+				continue;
+			}
+			for(auto type = Ast_Binary_Operator_Type::Plus;type <= Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal;type = static_cast<Ast_Binary_Operator_Type>(static_cast<int>(type) + 1)) {
+				if(logo::binary_operator_opcode(type) != instruction.opcode) continue;
+				auto specialization = logo::specialize_binary_operation(type,operand_type,operand_type);
+				if(specialization != Ast_Operation_Specialization::None && logo::get_specialized_binary_opcode(specialization) == opcode) return true;
+			}
+		}
+		return false;
+	}
+
+	Option<Bytecode_Program> compile_ast(Array_View<Ast_Statement> statements) {
+		Bytecode_Program program{};
+		bool successful_return = false;
+		defer[&]{ if(!successful_return) program.destroy(); };
+
+		Compiler_State state{};
+		state.program = &program;
+		auto [print_symbol,print_symbol_interned] = logo::intern_symbol("print");
+		if(!print_symbol_interned) return {};
+		state.print_symbol = print_symbol;
+		defer[&]{state.destroy();};
+
+		if(!logo::compile_statements(&state,statements)) return {};
+		if(!logo::emit_instruction(&state,Bytecode_Opcode::Halt,0,0)) return {};
+
+		//Function bodies are placed after the top level code. Compiling a body can queue up more functions defined inside it.
+		for(std::size_t i = 0;i < state.pending_functions.length;i += 1) {
+			auto pending_function = state.pending_functions[i];
+			program.functions[pending_function.function_index].code_offset = program.instructions.length;
+			state.scope_depth = 0;
+			state.inside_function = true;
+			if(!logo::compile_statements(&state,pending_function.body_statements)) return {};
+			if(!logo::emit_instruction(&state,Bytecode_Opcode::Return,0,0,0)) return {};
+		}
+
+		successful_return = true;
+		return program;
+	}
+}
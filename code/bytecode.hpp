@@ -0,0 +1,165 @@
+#ifndef LOGO_BYTECODE_HPP
+#define LOGO_BYTECODE_HPP
+
+#include <cstdint>
+#include "utils.hpp"
+#include "string.hpp"
+#include "parser.hpp"
+#include "heap_array.hpp"
+#include "array_view.hpp"
+#include "interpreter.hpp"
+#include "symbol_table.hpp"
+
+namespace logo {
+	//The order of opcodes matters because the VM builds its dispatch table from this list.
+#define LOGO_BYTECODE_OPCODES(X)\
+	X(Halt)\
+	X(Push_Constant)\
+	X(Pop)\
+	X(Load_Variable)\
+	X(Load_Variable_Lvalue)\
+	X(Load_Parent_Variable)\
+	X(Load_Parent_Variable_Lvalue)\
+	X(Make_Reference)\
+	X(Dereference)\
+	X(Dereference_Lvalue)\
+	X(Dereference_Unchecked)\
+	X(Dereference_Lvalue_Unchecked)\
+	X(Unary_Plus)\
+	X(Negate)\
+	X(Logical_Not)\
+	X(Add)\
+	X(Subtract)\
+	X(Multiply)\
+	X(Divide)\
+	X(Remainder)\
+	X(Exponentiate)\
+	X(Logical_And)\
+	X(Logical_Or)\
+	X(Compare_Equal)\
+	X(Compare_Unequal)\
+	X(Compare_Less_Than)\
+	X(Compare_Less_Than_Or_Equal)\
+	X(Compare_Greater_Than)\
+	X(Compare_Greater_Than_Or_Equal)\
+	X(Declare_Variable)\
+	X(Assign)\
+	X(Tail_Call)\
+	X(Call)\
+	X(Print)\
+	X(Jump)\
+	X(Jump_If_False)\
+	X(Short_Circuit)\
+	X(Begin_Scope)\
+	X(End_Scope)\
+	X(Return)\
+	X(For_Prepare)\
+	X(Declare_Induction_Variable)\
+	X(For_Step)\
+	X(For_End)\
+	X(Enter_Parallel_Loop)\
+	X(Next_Parallel_Iteration)\
+	X(Leave_Parallel_Loop)\
+	LOGO_BYTECODE_SPECIALIZED_OPCODES(X,)\
+	LOGO_BYTECODE_SPECIALIZED_OPCODES(X,_Unchecked)
+
+	//Specialized opcodes without a suffix are never emitted by the compiler. The VM replaces generic arithmetic, comparison, logical and compound assignment
+	//instructions with them after they have been executed with two ints, two floats or two bools and puts the generic ones back if the operand types change.
+	//Opcodes with the '_Unchecked' suffix are emitted for operations whose operand types were proven by the type inference pass and never check them.
+	//The binary operations are in the same order as the values of 'Ast_Operation_Specialization'.
+#define LOGO_BYTECODE_SPECIALIZED_OPCODES(X,SUFFIX)\
+	X(Add_Int##SUFFIX)\
+	X(Subtract_Int##SUFFIX)\
+	X(Multiply_Int##SUFFIX)\
+	X(Divide_Int##SUFFIX)\
+	X(Remainder_Int##SUFFIX)\
+	X(Compare_Equal_Int##SUFFIX)\
+	X(Compare_Unequal_Int##SUFFIX)\
+	X(Compare_Less_Than_Int##SUFFIX)\
+	X(Compare_Less_Than_Or_Equal_Int##SUFFIX)\
+	X(Compare_Greater_Than_Int##SUFFIX)\
+	X(Compare_Greater_Than_Or_Equal_Int##SUFFIX)\
+	X(Add_Float##SUFFIX)\
+	X(Subtract_Float##SUFFIX)\
+	X(Multiply_Float##SUFFIX)\
+	X(Divide_Float##SUFFIX)\
+	X(Remainder_Float##SUFFIX)\
+	X(Compare_Equal_Float##SUFFIX)\
+	X(Compare_Unequal_Float##SUFFIX)\
+	X(Compare_Less_Than_Float##SUFFIX)\
+	X(Compare_Less_Than_Or_Equal_Float##SUFFIX)\
+	X(Compare_Greater_Than_Float##SUFFIX)\
+	X(Compare_Greater_Than_Or_Equal_Float##SUFFIX)\
+	X(Logical_And_Bool##SUFFIX)\
+	X(Logical_Or_Bool##SUFFIX)\
+	X(Assign_Add_Int##SUFFIX)\
+	X(Assign_Subtract_Int##SUFFIX)\
+	X(Assign_Multiply_Int##SUFFIX)\
+	X(Assign_Divide_Int##SUFFIX)\
+	X(Assign_Remainder_Int##SUFFIX)\
+	X(Assign_Add_Float##SUFFIX)\
+	X(Assign_Subtract_Float##SUFFIX)\
+	X(Assign_Multiply_Float##SUFFIX)\
+	X(Assign_Divide_Float##SUFFIX)\
+	X(Assign_Remainder_Float##SUFFIX)
+
+	enum struct Bytecode_Opcode : std::uint8_t {
+#define LOGO_BYTECODE_OPCODE_ENUM(NAME) NAME,
+		LOGO_BYTECODE_OPCODES(LOGO_BYTECODE_OPCODE_ENUM)
+#undef LOGO_BYTECODE_OPCODE_ENUM
+	};
+
+	enum struct Bytecode_Condition_Type : std::uint8_t {
+		If_Statement,
+		While_Statement,
+		Conditional_Expression
+	};
+
+	//'operand' is an index into one of the tables of 'Bytecode_Program', a variable slot, a symbol or an instruction index, depending on the opcode.
+	//'variant' holds the assignment type of 'Assign', the condition type of 'Jump_If_False', the bool that makes 'Short_Circuit' jump, whether 'Return' has a value,
+	//whether 'Tail_Call' can reuse the frame of the current function, the index of the variable declared by 'Declare_Induction_Variable' and the number of induction variables of 'For_Step' and 'For_End'.
+	struct Bytecode_Instruction {
+		Bytecode_Opcode opcode;
+		std::uint8_t variant;
+		std::uint32_t operand;
+	};
+	struct Bytecode_Call_Site {
+		Symbol name;
+		std::size_t arg_count;
+		bool are_argument_types_proven; //Copied from 'Ast_Function_Call_Cache'.
+		bool is_name_in_scope; //Copied from 'Ast_Function_Call_Cache'.
+		std::size_t function_index; //Copied from 'Ast_Function_Call'.
+	};
+	struct Bytecode_Parent_Variable {
+		Symbol name;
+		std::size_t slot; //Copied from 'Ast_Value::slot'.
+	};
+	struct Bytecode_Function {
+		Symbol name;
+		Array_View<Symbol> arguments;
+		Array_View<Ast_Statement> body_statements; //Used by the JIT which compiles functions from the AST.
+		std::size_t code_offset;
+		std::size_t function_index; //Index in 'Interpreter_Context::functions' assigned by the resolver.
+		std::size_t parent_function_index;
+		bool defines_dynamic_functions;
+		bool is_memoized;
+	};
+	struct Bytecode_Program {
+		Heap_Array<Bytecode_Instruction> instructions;
+		Heap_Array<std::size_t> line_indices;
+		Heap_Array<Interpreter_Value> constants;
+		Heap_Array<Bytecode_Call_Site> call_sites;
+		Heap_Array<Bytecode_Parent_Variable> parent_variables;
+		Heap_Array<Bytecode_Function> functions;
+		void destroy();
+	};
+	[[nodiscard]] Option<Bytecode_Program> compile_ast(Array_View<Ast_Statement> statements);
+	//These return the specialized opcodes without a suffix, 'get_unchecked_opcode' maps them to the ones with the '_Unchecked' suffix.
+	[[nodiscard]] Bytecode_Opcode get_specialized_binary_opcode(Ast_Operation_Specialization specialization);
+	[[nodiscard]] Bytecode_Opcode get_specialized_assignment_opcode(Ast_Operation_Specialization specialization);
+	[[nodiscard]] Bytecode_Opcode get_unchecked_opcode(Bytecode_Opcode specialized_opcode);
+	//Returns true if the VM could replace the instruction with 'opcode' while running the program, which is either the opcode of the instruction or one of its specialized opcodes without a suffix.
+	[[nodiscard]] bool can_quicken_instruction(const Bytecode_Instruction& instruction,Bytecode_Opcode opcode);
+}
+
+#endif
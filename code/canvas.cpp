@@ -1,9 +1,26 @@
 #include <cmath>
+#include <new>
 #include <cstdio>
 #include "debug.hpp"
 #include "canvas.hpp"
 
 namespace logo {
+	static constexpr std::uint32_t Parallel_Pixel_Color_Bits = 24;
+
+	static void draw_pixel(Canvas* canvas,std::size_t index) {
+		if(!canvas->is_drawing_in_parallel) {
+			canvas->pixels[index] = canvas->pen_color;
+			return;
+		}
+		const auto& color = canvas->pen_color;
+		std::uint64_t value = (canvas->draw_order << Parallel_Pixel_Color_Bits) | (static_cast<std::uint64_t>(color.r) << 16) | (static_cast<std::uint64_t>(color.g) << 8) | color.b;
+		auto& pixel = canvas->parallel_pixels[index];
+		std::uint64_t current = pixel.load(std::memory_order_relaxed);
+		while((current >> Parallel_Pixel_Color_Bits) <= canvas->draw_order) {
+			if(pixel.compare_exchange_weak(current,value,std::memory_order_relaxed)) break;
+		}
+	}
+
 	bool Canvas::init(std::int32_t w,std::int32_t h,Color background_color) {
 		width = w;
 		height = h;
@@ -12,17 +29,73 @@ namespace logo {
 		rot = 0.0;
 		is_pen_down = true;
 		pen_color = Color{0,0,0};
-		if(!pixels.resize(static_cast<std::size_t>(width) * height,background_color)) {
-			Report_Error("Couldn't allocate % bytes of memory.",width * height * sizeof(pixels[0]));
+		//The pixels of a previous canvas are reused if they fit.
+		std::size_t pixel_count = static_cast<std::size_t>(width) * height;
+		if(!pixels.reserve(pixel_count)) {
+			Report_Error("Couldn't allocate % bytes of memory.",pixel_count * sizeof(pixels[0]));
 			return false;
 		}
+		for(std::size_t i = 0;i < pixel_count;i += 1) pixels.data[i] = background_color;
+		pixels.length = pixel_count;
 		return true;
 	}
 
 	void Canvas::destroy() {
+		delete[] parallel_pixels;
 		pixels.destroy();
 	}
 
+	void Canvas::reset() {
+		Heap_Array<Color> pixel_memory = pixels;
+		pixel_memory.length = 0;
+		auto parallel_pixel_memory = parallel_pixels;
+		auto parallel_pixel_memory_count = parallel_pixel_count;
+		*this = {};
+		pixels = pixel_memory;
+		parallel_pixels = parallel_pixel_memory;
+		parallel_pixel_count = parallel_pixel_memory_count;
+	}
+
+	Turtle Canvas::get_turtle() const {
+		return Turtle{pos_x,pos_y,rot,is_pen_down,pen_color};
+	}
+
+	void Canvas::set_turtle(const Turtle& turtle) {
+		pos_x = turtle.pos_x;
+		pos_y = turtle.pos_y;
+		rot = turtle.rot;
+		is_pen_down = turtle.is_pen_down;
+		pen_color = turtle.pen_color;
+	}
+
+	bool Canvas::begin_parallel_drawing() {
+		draw_order = 0;
+		if(pixels.length == 0) return true;
+		if(parallel_pixel_count < pixels.length) {
+			auto new_parallel_pixels = new(std::nothrow) std::atomic<std::uint64_t>[pixels.length]();
+			if(!new_parallel_pixels) {
+				Report_Error("Couldn't allocate % bytes of memory.",pixels.length * sizeof(parallel_pixels[0]));
+				return false;
+			}
+			delete[] parallel_pixels;
+			parallel_pixels = new_parallel_pixels;
+			parallel_pixel_count = pixels.length;
+		}
+		is_drawing_in_parallel = true;
+		return true;
+	}
+
+	void Canvas::end_parallel_drawing() {
+		if(!is_drawing_in_parallel) return;
+		for(std::size_t i = 0;i < pixels.length;i += 1) {
+			std::uint64_t value = parallel_pixels[i].load(std::memory_order_relaxed);
+			if(value == 0) continue;
+			pixels[i] = Color{static_cast<std::uint8_t>(value >> 16),static_cast<std::uint8_t>(value >> 8),static_cast<std::uint8_t>(value)};
+			parallel_pixels[i].store(0,std::memory_order_relaxed);
+		}
+		is_drawing_in_parallel = false;
+	}
+
 	bool Canvas::save_as_bitmap(String_View file_path) {
 		logo::print("Saving canvas as \"%\".\n",file_path);
 
@@ -108,7 +181,7 @@ namespace logo {
 
 			for(std::int32_t x = x0;x <= x1;x += 1) {
 				if(x >= 0 && x < width && y >= 0 && y < height) {
-					if(is_pen_down) pixels[y * width + x] = pen_color;
+					if(is_pen_down) logo::draw_pixel(this,static_cast<std::size_t>(y * width + x));
 				}
 				if(d > 0) {
 					y += yi;
@@ -130,7 +203,7 @@ namespace logo {
 
 			for(std::int32_t y = y0;y <= y1;y += 1) {
 				if(x >= 0 && x < width && y >= 0 && y < height) {
-					if(is_pen_down) pixels[y * width + x] = pen_color;
+					if(is_pen_down) logo::draw_pixel(this,static_cast<std::size_t>(y * width + x));
 				}
 				if(d > 0) {
 					x += xi;
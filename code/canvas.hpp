@@ -1,6 +1,7 @@
 #ifndef LOGO_CANVAS_HPP
 #define LOGO_CANVAS_HPP
 
+#include <atomic>
 #include <cstdint>
 #include "string.hpp"
 #include "heap_array.hpp"
@@ -9,17 +10,36 @@ namespace logo {
 	struct Color {
 		std::uint8_t r,g,b;
 	};
+	struct Turtle {
+		double pos_x,pos_y,rot;
+		bool is_pen_down;
+		Color pen_color;
+	};
+	//'Canvas::draw_order' is kept in the bits of a parallel pixel above the color.
+	static constexpr std::uint64_t MAX_DRAW_ORDER = (std::uint64_t(1) << 40) - 1;
 	struct Canvas {
 		std::int32_t width,height;
 		double pos_x,pos_y,rot;
 		bool is_pen_down;
 		Color pen_color;
 		Heap_Array<Color> pixels;
+		//While the iterations of a parallel loop are drawing, every pixel is written here together with 'draw_order' of the iteration that drew it,
+		//so that the pixel drawn by the iteration that comes last in the loop wins no matter which thread got there first.
+		std::atomic<std::uint64_t>* parallel_pixels;
+		std::size_t parallel_pixel_count;
+		bool is_drawing_in_parallel;
+		std::uint64_t draw_order;
 
 		bool init(std::int32_t w,std::int32_t h,Color background_color = {255,255,255});
 		void destroy();
+		void reset(); //Forgets the drawing but keeps the memory of the pixels for the next 'init'.
 		bool save_as_bitmap(String_View file_path);
 		void move_forward(double steps);
+		[[nodiscard]] Turtle get_turtle() const;
+		void set_turtle(const Turtle& turtle);
+		//Canvases that share the pixels can draw at the same time between these two calls.
+		[[nodiscard]] bool begin_parallel_drawing();
+		void end_parallel_drawing();
 	};
 }
 
@@ -21,6 +21,8 @@
 
 namespace logo {
 	static Array_String<2048> reported_error_message;
+	//Each thread of a parallel loop reports its errors into its own buffer.
+	static thread_local Array_String<2048>* current_error_message = &reported_error_message;
 
 	bool debug_init() {
 #ifdef PLATFORM_WINDOWS
@@ -84,12 +86,35 @@ namespace logo {
 		return true;
 	}
 
+	bool write_to_stdout(String_View bytes) {
+		const char* ptr = bytes.begin_ptr;
+		while(ptr != bytes.end_ptr) {
+#ifdef PLATFORM_WINDOWS
+			DWORD written_byte_count = 0;
+			if(!WriteFile(GetStdHandle(STD_OUTPUT_HANDLE),ptr,static_cast<DWORD>(bytes.end_ptr - ptr),&written_byte_count,nullptr)) return false;
+#else
+			auto written_byte_count = write(STDOUT_FILENO,ptr,static_cast<std::size_t>(bytes.end_ptr - ptr));
+			if(written_byte_count <= 0) return false;
+#endif
+			ptr += written_byte_count;
+		}
+		return true;
+	}
+
 	bool write_char32_t_to_error_message(char32_t code_point) {
-		return reported_error_message.append(code_point);
+		return current_error_message->append(code_point);
+	}
+
+	void redirect_reported_errors(Array_String<2048>* buffer) {
+		current_error_message = buffer ? buffer : &reported_error_message;
 	}
 
 	String_View get_reported_error() {
-		return {reported_error_message.buffer,reported_error_message.byte_length};
+		return {current_error_message->buffer,current_error_message->byte_length};
+	}
+
+	void truncate_reported_error(std::size_t byte_length) {
+		if(byte_length < current_error_message->byte_length) current_error_message->byte_length = byte_length;
 	}
 
 	void assert(bool condition,std::source_location loc) {
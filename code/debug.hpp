@@ -9,6 +9,8 @@ namespace logo {
 	void debug_term();
 	bool print_stdout_char32_t(char32_t c);
 	bool print_stderr_char32_t(char32_t c);
+	//Writes the bytes as they are, without the color codes of 'print'. Used for output that's meant to be redirected to a file.
+	[[nodiscard]] bool write_to_stdout(String_View bytes);
 
 	template<typename... Args>
 	void print(Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
@@ -32,6 +34,10 @@ namespace logo {
 	Report_Error(Format_String<std::type_identity_t<Args>...>,Args&&...) -> Report_Error<Args...>;
 
 	[[nodiscard]] String_View get_reported_error();
+	//Drops everything that was reported after the error message was 'byte_length' bytes long. Used for errors that are expected and handled.
+	void truncate_reported_error(std::size_t byte_length);
+	//Makes the errors reported by the calling thread go to 'buffer' instead of the shared error message, 'nullptr' goes back to the shared one.
+	void redirect_reported_errors(Array_String<2048>* buffer);
 	void assert(bool condition,std::source_location loc = std::source_location::current());
 	[[noreturn]] void unreachable(std::source_location loc = std::source_location::current());
 }
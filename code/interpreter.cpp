@@ -1,76 +1,56 @@
+#include <bit>
 #include <cmath>
 #include <random>
 #include <chrono>
+#include <limits>
+#include <cstring>
+#include <initializer_list>
 #include "debug.hpp"
 #include "parser.hpp"
 #include "canvas.hpp"
+#include "jit.hpp"
+#include "profile.hpp"
 #include "interpreter.hpp"
+#include "thread_pool.hpp"
 #include "static_array.hpp"
 
 namespace logo {
-	struct Interpreter_Variable;
-	struct Interpreter_Context;
-	enum struct Interpreter_Value_Type {
-		Void,
-		Int,
-		Float,
-		Bool,
-		String,
-		Reference,
-		Lvalue,
-		Int_Or_Float, //This is only used in 'Interpreter_Builtin_Function' to denote argumnets that can be both ints or floats.
-		Any //This is only used in 'Interpreter_Builtin_Function' to denote arguments of unspecified type.
-	};
-	struct Interpreter_Value_Reference {
-		std::size_t var_index;
-		std::size_t generation;
-	};
-	struct Interpreter_Value_Lvalue {
-		std::size_t var_index;
-	};
-	struct Interpreter_Value {
-		Interpreter_Value_Type type;
-		union {
-			std::int64_t int_v;
-			double float_v;
-			bool bool_v;
-			String_View string_v;
-			Interpreter_Value_Reference reference_v;
-			Interpreter_Value_Lvalue lvalue_v;
-		};
-		Interpreter_Value() : type(),int_v() {}
-	};
-	struct Interpreter_Variable {
-		String_View name;
-		Interpreter_Value value;
-		std::size_t generation;
-	};
-	struct Interpreter_Function {
-		String_View name;
-		Array_View<String_View> arguments;
-		Array_View<Ast_Statement> body_statements;
-	};
-	struct Interpreter_Builtin_Function {
-		String_View name;
-		Static_Array<Interpreter_Value_Type,16> argument_types;
-		Option<Interpreter_Value>(*func_ptr)(Interpreter_Context*,std::size_t,Array_View<Interpreter_Value>);
-	};
-	struct Interpreter_Context {
-		std::mt19937_64 random_engine;
-		std::uniform_real_distribution<double> random_dist_0_1;
-		Heap_Array<Interpreter_Variable> variables;
-		std::size_t current_function_scope_first_var_index;
-		std::size_t generation_counter;
-		Heap_Array<Interpreter_Function> functions;
-		Canvas canvas;
-		Heap_Array<Interpreter_Builtin_Function> builtin_functions;
-	};
+	std::size_t lookup_parent_scope_variable(const Interpreter_Context* context,Symbol name,std::size_t slot) {
+		//The top level variable the access is bound to is the only one it can refer to, so it's found if it exists at the moment.
+		if(slot != 0) {
+			if(slot <= context->variables.length && context->variables[slot - 1].name == name) return slot - 1;
+			return context->variables.length;
+		}
+		for(std::size_t i = context->variables.length;i > 0;i -= 1) {
+			if(context->variables[i - 1].name == name) return i - 1;
+		}
+		return context->variables.length;
+	}
 
-	template<typename... Args>
-	static void report_interpreter_error(std::size_t line_index,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
-		logo::format_into(logo::write_char32_t_to_error_message,"[Runtime error] Line %: ",line_index);
-		logo::format_into(logo::write_char32_t_to_error_message,format,std::forward<Args>(args)...);
-		logo::write_char32_t_to_error_message('\n');
+	Option<std::size_t> find_parent_scope_variable(const Interpreter_Context* context,Symbol name,std::size_t slot,std::size_t line_index) {
+		auto var_index = logo::lookup_parent_scope_variable(context,name,slot);
+		if(var_index == context->variables.length) {
+			logo::report_interpreter_error(line_index,"Variable '%' does not exist.",logo::get_symbol_name(name));
+			return {};
+		}
+		return var_index;
+	}
+
+	bool push_variable(Interpreter_Context* context,Symbol name,const Interpreter_Value& value) {
+		Interpreter_Variable variable{};
+		variable.name = name;
+		context->generation_counter += 1;
+		variable.generation = context->generation_counter;
+		variable.value = value;
+		if(context->variables.length >= MAX_VARIABLE_COUNT) {
+			Report_Error("There can't be more than % variables.",MAX_VARIABLE_COUNT);
+			return false;
+		}
+		if(!context->variables.push_back(variable)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(variable));
+			return false;
+		}
+		return true;
 	}
 
 	[[nodiscard]] static Option<Interpreter_Value> make_interpreter_value_from_ast_value(Interpreter_Context* context,const Ast_Value& value) {
@@ -97,17 +77,9 @@ namespace logo {
 				return result;
 			}
 			case Ast_Value_Type::Identifier: {
-				result.type = Interpreter_Value_Type::Lvalue;
-				result.lvalue_v = {};
-				for(std::size_t i = context->current_function_scope_first_var_index;i < context->variables.length;i += 1) {
-					const auto& var = context->variables[i];
-					if(std::strcmp(var.name.begin_ptr,value.identfier_name.begin_ptr) == 0) {
-						result.lvalue_v.var_index = i;
-						return result;
-					}
-				}
-				logo::report_interpreter_error(value.line_index,"Identifier '%' does not exist.",value.identfier_name);
-				return {};
+				std::size_t var_index = context->current_function_scope_first_var_index + value.slot;
+				logo::assert(var_index < context->variables.length);
+				return logo::make_lvalue(var_index);
 			}
 			default: logo::unreachable();
 		}
@@ -131,9 +103,12 @@ namespace logo {
 			case Ast_Binary_Operator_Type::Plus: return left + right;
 			case Ast_Binary_Operator_Type::Minus: return left - right;
 			case Ast_Binary_Operator_Type::Multiply: return left * right;
-			case Ast_Binary_Operator_Type::Divide: return left / right;
+			case Ast_Binary_Operator_Type::Divide: {
+				if constexpr(std::is_integral_v<T>) return logo::divide_integers(left,right);
+				else return left / right;
+			}
 			case Ast_Binary_Operator_Type::Remainder: {
-				if constexpr(std::is_integral_v<T>) return left % right;
+				if constexpr(std::is_integral_v<T>) return logo::compute_integer_remainder(left,right);
 				else return std::fmod(left,right);
 			}
 			case Ast_Binary_Operator_Type::Exponentiate: return std::pow(left,right);
@@ -146,10 +121,13 @@ namespace logo {
 			case Ast_Assignment_Type::Compound_Plus: return left + right;
 			case Ast_Assignment_Type::Compound_Minus: return left - right;
 			case Ast_Assignment_Type::Compound_Multiply: return left * right;
-			case Ast_Assignment_Type::Compound_Divide: return left / right;
+			case Ast_Assignment_Type::Compound_Divide: {
+				if constexpr(std::is_integral_v<T>) return logo::divide_integers(left,right);
+				else return left / right;
+			}
 			case Ast_Assignment_Type::Compound_Remainder:
 			{
-				if constexpr(std::is_integral_v<T>) return left % right;
+				if constexpr(std::is_integral_v<T>) return logo::compute_integer_remainder(left,right);
 				else return std::fmod(left,right);
 			}
 			case Ast_Assignment_Type::Compound_Exponentiate: return std::pow(left,right);
@@ -157,631 +135,1796 @@ namespace logo {
 		}
 	}
 
-	enum struct Interpreter_Status {
-		Success,
-		Error,
-		Function_Return,
-		Break,
-		Continue
+	Option<Interpreter_Value> compute_unary_operation(Ast_Unary_Prefix_Operator_Type type,const Interpreter_Value& value,std::size_t line_index) {
+		Interpreter_Value result = value;
+		switch(type) {
+			case Ast_Unary_Prefix_Operator_Type::Plus:
+			case Ast_Unary_Prefix_Operator_Type::Minus: {
+				if(result.type == Interpreter_Value_Type::Bool) {
+					logo::report_interpreter_error(line_index,"Cannot negate '%'.",result.bool_v);
+					return {};
+				}
+				if(result.type == Interpreter_Value_Type::String) {
+					logo::report_interpreter_error(line_index,"Cannot negate \"%\".",logo::get_symbol_name(result.string_v));
+					return {};
+				}
+				if(type == Ast_Unary_Prefix_Operator_Type::Plus) break;
+				if(result.type == Interpreter_Value_Type::Int) result.int_v *= -1;
+				else if(result.type == Interpreter_Value_Type::Float) result.float_v *= -1.0;
+				break;
+			}
+			case Ast_Unary_Prefix_Operator_Type::Logical_Not: {
+				if(result.type == Interpreter_Value_Type::Bool) result.bool_v = !result.bool_v;
+				else {
+					//@TODO: Print value that couldn't be negated.
+					logo::report_interpreter_error(line_index,"Cannot logically negate a nonboolean value.");
+					return {};
+				}
+				break;
+			}
+			default: logo::unreachable();
+		}
+		return result;
+	}
+
+	Option<Interpreter_Value> compute_binary_operation(Ast_Binary_Operator_Type type,const Interpreter_Value& left,const Interpreter_Value& right,std::size_t line_index) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus:
+			case Ast_Binary_Operator_Type::Minus:
+			case Ast_Binary_Operator_Type::Multiply:
+			case Ast_Binary_Operator_Type::Divide:
+			case Ast_Binary_Operator_Type::Remainder:
+			case Ast_Binary_Operator_Type::Exponentiate: {
+				Interpreter_Value result{};
+				if(logo::is_integer_division_by_zero(type,left,right)) {
+					logo::report_interpreter_error(line_index,"Integer division by zero.");
+					return {};
+				}
+				if(left.type == Interpreter_Value_Type::Int && right.type == Interpreter_Value_Type::Int) {
+					result.type = Interpreter_Value_Type::Int;
+					result.int_v = logo::compute_arithmetic_operation(type,left.int_v,right.int_v);
+				}
+				else if(left.type == Interpreter_Value_Type::Float && right.type == Interpreter_Value_Type::Float) {
+					result.type = Interpreter_Value_Type::Float;
+					result.float_v = logo::compute_arithmetic_operation(type,left.float_v,right.float_v);
+				}
+				else if(left.type == Interpreter_Value_Type::Int && right.type == Interpreter_Value_Type::Float) {
+					result.type = Interpreter_Value_Type::Float;
+					result.float_v = logo::compute_arithmetic_operation(type,static_cast<double>(left.int_v),right.float_v);
+				}
+				else if(left.type == Interpreter_Value_Type::Float && right.type == Interpreter_Value_Type::Int) {
+					result.type = Interpreter_Value_Type::Float;
+					result.float_v = logo::compute_arithmetic_operation(type,left.float_v,static_cast<double>(right.int_v));
+				}
+				else {
+					//@TODO: Print more info.
+					logo::report_interpreter_error(line_index,"Invalid arithmetic operation (error message in progress).");
+					return {};
+				}
+				return result;
+			}
+			case Ast_Binary_Operator_Type::Logical_And:
+			case Ast_Binary_Operator_Type::Logical_Or: {
+				if(left.type != Interpreter_Value_Type::Bool || right.type != Interpreter_Value_Type::Bool) {
+					String_View operator_string = (type == Ast_Binary_Operator_Type::Logical_And) ? "and" : "or";
+					logo::report_interpreter_error(line_index,"Operator '%' needs both operands of type 'Bool'.",operator_string);
+					return {};
+				}
+				Interpreter_Value result{};
+				result.type = Interpreter_Value_Type::Bool;
+				if(type == Ast_Binary_Operator_Type::Logical_And) result.bool_v = (left.bool_v && right.bool_v);
+				else result.bool_v = (left.bool_v || right.bool_v);
+				return result;
+			}
+			case Ast_Binary_Operator_Type::Compare_Equal:
+			case Ast_Binary_Operator_Type::Compare_Unequal:
+			case Ast_Binary_Operator_Type::Compare_Less_Than:
+			case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal:
+			case Ast_Binary_Operator_Type::Compare_Greater_Than:
+			case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: {
+				Interpreter_Value result{};
+				result.type = Interpreter_Value_Type::Bool;
+				if(left.type == Interpreter_Value_Type::Int && right.type == Interpreter_Value_Type::Int) {
+					result.bool_v = logo::compute_compare_operation(type,left.int_v,right.int_v);
+				}
+				else if(left.type == Interpreter_Value_Type::Float && right.type == Interpreter_Value_Type::Float) {
+					result.bool_v = logo::compute_compare_operation(type,left.float_v,right.float_v);
+				}
+				else if(left.type == Interpreter_Value_Type::Int && right.type == Interpreter_Value_Type::Float) {
+					result.bool_v = logo::compute_compare_operation(type,static_cast<double>(left.int_v),right.float_v);
+				}
+				else if(left.type == Interpreter_Value_Type::Float && right.type == Interpreter_Value_Type::Int) {
+					result.bool_v = logo::compute_compare_operation(type,left.float_v,static_cast<double>(right.int_v));
+				}
+				else if(left.type == Interpreter_Value_Type::Bool && right.type == Interpreter_Value_Type::Bool) {
+					if(type != Ast_Binary_Operator_Type::Compare_Equal && type != Ast_Binary_Operator_Type::Compare_Unequal) {
+						//@TODO: Print the wrong operator.
+						logo::report_interpreter_error(line_index,"Cannot apply that comparison operator on bools.");
+						return {};
+					}
+					if(type == Ast_Binary_Operator_Type::Compare_Equal) result.bool_v = (left.bool_v == right.bool_v);
+					else result.bool_v = (left.bool_v != right.bool_v);
+				}
+				else if(left.type == Interpreter_Value_Type::String && right.type == Interpreter_Value_Type::String) {
+					if(type != Ast_Binary_Operator_Type::Compare_Equal && type != Ast_Binary_Operator_Type::Compare_Unequal) {
+						//@TODO: Print the wrong operator.
+						logo::report_interpreter_error(line_index,"Cannot apply that comparison operator on strings.");
+						return {};
+					}
+					//Strings are interned, so equal strings are the same symbol.
+					if(type == Ast_Binary_Operator_Type::Compare_Equal) result.bool_v = (left.string_v == right.string_v);
+					else result.bool_v = (left.string_v != right.string_v);
+				}
+				else {
+					//@TODO: Print more info.
+					logo::report_interpreter_error(line_index,"Invalid comparison operation (error message in progress).");
+					return {};
+				}
+				return result;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	bool is_short_circuited(Ast_Binary_Operator_Type type,const Interpreter_Value& left) {
+		if(left.type != Interpreter_Value_Type::Bool) return false;
+		if(type == Ast_Binary_Operator_Type::Logical_And) return !left.bool_v;
+		if(type == Ast_Binary_Operator_Type::Logical_Or) return left.bool_v;
+		return false;
+	}
+
+	bool check_conditional_expression_condition(const Interpreter_Value& condition,std::size_t line_index) {
+		if(condition.type != Interpreter_Value_Type::Bool) {
+			logo::report_interpreter_error(line_index,"Condition in a conditional expression must be of type 'Bool'.");
+			return false;
+		}
+		return true;
+	}
+
+	bool compute_assignment(Ast_Assignment_Type type,Interpreter_Value* target,const Interpreter_Value& value,std::size_t line_index) {
+		if(type == Ast_Assignment_Type::Assignment) {
+			*target = value;
+		}
+		else if(target->type == Interpreter_Value_Type::Int && value.type == Interpreter_Value_Type::Int) {
+			if(value.int_v == 0 && (type == Ast_Assignment_Type::Compound_Divide || type == Ast_Assignment_Type::Compound_Remainder)) {
+				logo::report_interpreter_error(line_index,"Integer division by zero.");
+				return false;
+			}
+			target->type = Interpreter_Value_Type::Int;
+			target->int_v = logo::compute_compound_assignment_operation(type,target->int_v,value.int_v);
+		}
+		else if(target->type == Interpreter_Value_Type::Float && value.type == Interpreter_Value_Type::Float) {
+			target->type = Interpreter_Value_Type::Float;
+			target->float_v = logo::compute_compound_assignment_operation(type,target->float_v,value.float_v);
+		}
+		else if(target->type == Interpreter_Value_Type::Int && value.type == Interpreter_Value_Type::Float) {
+			target->type = Interpreter_Value_Type::Float;
+			target->float_v = logo::compute_compound_assignment_operation(type,static_cast<double>(target->int_v),value.float_v);
+		}
+		else if(target->type == Interpreter_Value_Type::Float && value.type == Interpreter_Value_Type::Int) {
+			target->type = Interpreter_Value_Type::Float;
+			target->float_v = logo::compute_compound_assignment_operation(type,target->float_v,static_cast<double>(value.int_v));
+		}
+		else {
+			logo::report_interpreter_error(line_index,"Cannot perform compound assignment if the type of the variable being assigned to and the type of the expression on the right are not 'Int' or 'Float'.");
+			return false;
+		}
+		return true;
+	}
+
+	Ast_Operation_Specialization specialize_binary_operation(Ast_Binary_Operator_Type type,Interpreter_Value_Type left_type,Interpreter_Value_Type right_type) {
+		if(left_type == Interpreter_Value_Type::Int && right_type == Interpreter_Value_Type::Int) {
+			switch(type) {
+				case Ast_Binary_Operator_Type::Plus: return Ast_Operation_Specialization::Int_Plus;
+				case Ast_Binary_Operator_Type::Minus: return Ast_Operation_Specialization::Int_Minus;
+				case Ast_Binary_Operator_Type::Multiply: return Ast_Operation_Specialization::Int_Multiply;
+				case Ast_Binary_Operator_Type::Divide: return Ast_Operation_Specialization::Int_Divide;
+				case Ast_Binary_Operator_Type::Remainder: return Ast_Operation_Specialization::Int_Remainder;
+				case Ast_Binary_Operator_Type::Compare_Equal: return Ast_Operation_Specialization::Int_Compare_Equal;
+				case Ast_Binary_Operator_Type::Compare_Unequal: return Ast_Operation_Specialization::Int_Compare_Unequal;
+				case Ast_Binary_Operator_Type::Compare_Less_Than: return Ast_Operation_Specialization::Int_Compare_Less_Than;
+				case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: return Ast_Operation_Specialization::Int_Compare_Less_Than_Or_Equal;
+				case Ast_Binary_Operator_Type::Compare_Greater_Than: return Ast_Operation_Specialization::Int_Compare_Greater_Than;
+				case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: return Ast_Operation_Specialization::Int_Compare_Greater_Than_Or_Equal;
+				default: return Ast_Operation_Specialization::None;
+			}
+		}
+		if(left_type == Interpreter_Value_Type::Float && right_type == Interpreter_Value_Type::Float) {
+			switch(type) {
+				case Ast_Binary_Operator_Type::Plus: return Ast_Operation_Specialization::Float_Plus;
+				case Ast_Binary_Operator_Type::Minus: return Ast_Operation_Specialization::Float_Minus;
+				case Ast_Binary_Operator_Type::Multiply: return Ast_Operation_Specialization::Float_Multiply;
+				case Ast_Binary_Operator_Type::Divide: return Ast_Operation_Specialization::Float_Divide;
+				case Ast_Binary_Operator_Type::Remainder: return Ast_Operation_Specialization::Float_Remainder;
+				case Ast_Binary_Operator_Type::Compare_Equal: return Ast_Operation_Specialization::Float_Compare_Equal;
+				case Ast_Binary_Operator_Type::Compare_Unequal: return Ast_Operation_Specialization::Float_Compare_Unequal;
+				case Ast_Binary_Operator_Type::Compare_Less_Than: return Ast_Operation_Specialization::Float_Compare_Less_Than;
+				case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: return Ast_Operation_Specialization::Float_Compare_Less_Than_Or_Equal;
+				case Ast_Binary_Operator_Type::Compare_Greater_Than: return Ast_Operation_Specialization::Float_Compare_Greater_Than;
+				case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: return Ast_Operation_Specialization::Float_Compare_Greater_Than_Or_Equal;
+				default: return Ast_Operation_Specialization::None;
+			}
+		}
+		if(left_type == Interpreter_Value_Type::Bool && right_type == Interpreter_Value_Type::Bool) {
+			switch(type) {
+				case Ast_Binary_Operator_Type::Logical_And: return Ast_Operation_Specialization::Bool_Logical_And;
+				case Ast_Binary_Operator_Type::Logical_Or: return Ast_Operation_Specialization::Bool_Logical_Or;
+				default: return Ast_Operation_Specialization::None;
+			}
+		}
+		return Ast_Operation_Specialization::None;
+	}
+
+	Ast_Operation_Specialization specialize_compound_assignment(Ast_Assignment_Type type,Interpreter_Value_Type target_type,Interpreter_Value_Type value_type) {
+		switch(type) {
+			case Ast_Assignment_Type::Compound_Plus: return logo::specialize_binary_operation(Ast_Binary_Operator_Type::Plus,target_type,value_type);
+			case Ast_Assignment_Type::Compound_Minus: return logo::specialize_binary_operation(Ast_Binary_Operator_Type::Minus,target_type,value_type);
+			case Ast_Assignment_Type::Compound_Multiply: return logo::specialize_binary_operation(Ast_Binary_Operator_Type::Multiply,target_type,value_type);
+			case Ast_Assignment_Type::Compound_Divide: return logo::specialize_binary_operation(Ast_Binary_Operator_Type::Divide,target_type,value_type);
+			case Ast_Assignment_Type::Compound_Remainder: return logo::specialize_binary_operation(Ast_Binary_Operator_Type::Remainder,target_type,value_type);
+			default: return Ast_Operation_Specialization::None;
+		}
+	}
+
+	//Integer divisions by zero are left to the generic operations, which report the error. Proven divisions have a nonzero literal divisor.
+	[[nodiscard]] static bool is_specialized_division_by_zero(Ast_Operation_Specialization specialization,const Interpreter_Value& right) {
+		if(specialization != Ast_Operation_Specialization::Int_Divide && specialization != Ast_Operation_Specialization::Int_Remainder) return false;
+		return right.int_v == 0;
+	}
+
+	template<bool CHECK_OPERAND_TYPES>
+	[[nodiscard]] static bool compute_operation_with_specialization(Ast_Operation_Specialization specialization,const Interpreter_Value& left,const Interpreter_Value& right,Interpreter_Value* result) {
+#define LOGO_SPECIALIZED_OPERATION(NAME,OPERAND_TYPE,RESULT_TYPE,RESULT_FIELD,EXPRESSION)\
+		case Ast_Operation_Specialization::NAME: {\
+			if constexpr(CHECK_OPERAND_TYPES) {\
+				if(left.type != Interpreter_Value_Type::OPERAND_TYPE || right.type != Interpreter_Value_Type::OPERAND_TYPE) return false;\
+				if(logo::is_specialized_division_by_zero(Ast_Operation_Specialization::NAME,right)) return false;\
+			}\
+			result->type = Interpreter_Value_Type::RESULT_TYPE;\
+			result->RESULT_FIELD = (EXPRESSION);\
+			return true;\
+		}
+		switch(specialization) {
+			LOGO_SPECIALIZED_OPERATION(Int_Plus,Int,Int,int_v,left.int_v + right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Minus,Int,Int,int_v,left.int_v - right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Multiply,Int,Int,int_v,left.int_v * right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Divide,Int,Int,int_v,logo::divide_integers(left.int_v,right.int_v))
+			LOGO_SPECIALIZED_OPERATION(Int_Remainder,Int,Int,int_v,logo::compute_integer_remainder(left.int_v,right.int_v))
+			LOGO_SPECIALIZED_OPERATION(Int_Compare_Equal,Int,Bool,bool_v,left.int_v == right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Compare_Unequal,Int,Bool,bool_v,left.int_v != right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Compare_Less_Than,Int,Bool,bool_v,left.int_v < right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Compare_Less_Than_Or_Equal,Int,Bool,bool_v,left.int_v <= right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Compare_Greater_Than,Int,Bool,bool_v,left.int_v > right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Int_Compare_Greater_Than_Or_Equal,Int,Bool,bool_v,left.int_v >= right.int_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Plus,Float,Float,float_v,left.float_v + right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Minus,Float,Float,float_v,left.float_v - right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Multiply,Float,Float,float_v,left.float_v * right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Divide,Float,Float,float_v,left.float_v / right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Remainder,Float,Float,float_v,std::fmod(left.float_v,right.float_v))
+			LOGO_SPECIALIZED_OPERATION(Float_Compare_Equal,Float,Bool,bool_v,left.float_v == right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Compare_Unequal,Float,Bool,bool_v,left.float_v != right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Compare_Less_Than,Float,Bool,bool_v,left.float_v < right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Compare_Less_Than_Or_Equal,Float,Bool,bool_v,left.float_v <= right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Compare_Greater_Than,Float,Bool,bool_v,left.float_v > right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Float_Compare_Greater_Than_Or_Equal,Float,Bool,bool_v,left.float_v >= right.float_v)
+			LOGO_SPECIALIZED_OPERATION(Bool_Logical_And,Bool,Bool,bool_v,left.bool_v && right.bool_v)
+			LOGO_SPECIALIZED_OPERATION(Bool_Logical_Or,Bool,Bool,bool_v,left.bool_v || right.bool_v)
+			default: logo::unreachable();
+		}
+#undef LOGO_SPECIALIZED_OPERATION
+	}
+
+	bool compute_specialized_operation(Ast_Operation_Specialization specialization,const Interpreter_Value& left,const Interpreter_Value& right,Interpreter_Value* result) {
+		return logo::compute_operation_with_specialization<true>(specialization,left,right,result);
+	}
+
+	Interpreter_Value compute_unchecked_operation(Ast_Operation_Specialization specialization,const Interpreter_Value& left,const Interpreter_Value& right) {
+		Interpreter_Value result{};
+		if(!logo::compute_operation_with_specialization<false>(specialization,left,right,&result)) logo::unreachable();
+		return result;
+	}
+
+	void update_operation_cache(Ast_Operation_Cache* cache,Ast_Operation_Specialization specialization) {
+		if(cache->specialization != Ast_Operation_Specialization::None) {
+			cache->specialization = Ast_Operation_Specialization::None;
+			if(cache->deoptimization_count < MAX_DEOPTIMIZATION_COUNT) cache->deoptimization_count += 1;
+		}
+		if(cache->deoptimization_count < MAX_DEOPTIMIZATION_COUNT) cache->specialization = specialization;
+	}
+
+	Option<Interpreter_Value> make_reference(const Interpreter_Context* context,const Interpreter_Value& value,std::size_t line_index) {
+		if(value.type != Interpreter_Value_Type::Lvalue) {
+			logo::report_interpreter_error(line_index,"Cannot take a reference to an object that is not an lvalue.");
+			return {};
+		}
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Reference;
+		result.var_index = value.var_index;
+		logo::assert(result.var_index < context->variables.length);
+		result.generation = context->variables[result.var_index].generation;
+		return result;
+	}
+
+	Option<Interpreter_Value> dereference(const Interpreter_Context* context,const Interpreter_Value& value,std::size_t line_index) {
+		if(value.type != Interpreter_Value_Type::Reference) {
+			logo::report_interpreter_error(line_index,"Cannot dereference an object that is not a reference.");
+			return {};
+		}
+		if(value.var_index >= context->variables.length) {
+			logo::report_interpreter_error(line_index,"Dangling reference.");
+			return {};
+		}
+		const auto& referenced_var = context->variables[value.var_index];
+		if(value.generation != referenced_var.generation) {
+			logo::report_interpreter_error(line_index,"Dangling reference.");
+			return {};
+		}
+		return logo::make_lvalue(value.var_index);
+	}
+
+	bool call_print_function(Array_View<Interpreter_Value> args,std::size_t line_index) {
+		if(args.length == 0) {
+			logo::report_interpreter_error(line_index,"Function 'print' takes at least 1 argument.");
+			return false;
+		}
+		const auto& format_arg = args[0];
+		if(format_arg.type != Interpreter_Value_Type::String) {
+			logo::report_interpreter_error(line_index,"Argument 0 to function 'print' must be a string.");
+			return false;
+		}
+
+		Static_Array<String_Format_Arg,15> format_args{};
+		for(std::size_t i = 1;i < args.length;i += 1) {
+			const auto& arg_value = args[i];
+
+			String_Format_Arg format_value{};
+			switch(arg_value.type) {
+				case Interpreter_Value_Type::Int: format_value = logo::make_string_format_arg(arg_value.int_v); break;
+				case Interpreter_Value_Type::Float: format_value = logo::make_string_format_arg(arg_value.float_v); break;
+				case Interpreter_Value_Type::Bool: format_value = logo::make_string_format_arg(arg_value.bool_v); break;
+				case Interpreter_Value_Type::String: format_value = logo::make_string_format_arg(logo::get_symbol_name(arg_value.string_v)); break;
+				case Interpreter_Value_Type::Reference: format_value = logo::make_string_format_arg("(Reference)"); break; //@TODO: Print what that reference points to.
+				default: logo::unreachable();
+			}
+
+			if(!format_args.push_back(format_value)) {
+				Report_Error("Couldn't create a formatting argument.");
+				return false;
+			}
+		}
+		auto format_result = logo::format_args_into(logo::print_stdout_char32_t,logo::get_symbol_name(format_arg.string_v),{format_args.data,format_args.length});
+		if(format_result.external_failure) {
+			Report_Error("Couldn't execute a print statement.");
+			return false;
+		}
+		if(format_result.count_of_args != format_result.count_of_arguments_processed) {
+			logo::report_interpreter_error(line_index,"The number of argumnets given to 'print' does nor match the numnber of markers in the format string.");
+			return false;
+		}
+		return true;
+	}
+
+	bool define_function(Interpreter_Context* context,std::size_t function_index,const Interpreter_Function& function) {
+		while(context->functions.length <= function_index) {
+			if(!context->functions.push_back(Interpreter_Function{})) {
+				Report_Error("Couldn't allocate % bytes of memory.",sizeof(function));
+				return false;
+			}
+		}
+		context->functions[function_index] = function;
+		return true;
+	}
+
+	[[nodiscard]] static bool is_memoizable_value(const Interpreter_Value& value) {
+		switch(value.type) {
+			case Interpreter_Value_Type::Int:
+			case Interpreter_Value_Type::Float:
+			case Interpreter_Value_Type::Bool:
+			case Interpreter_Value_Type::String: return true;
+			default: return false;
+		}
+	}
+
+	//Floats are compared bit by bit, so 0.0 and -0.0 are different arguments.
+	[[nodiscard]] static std::uint64_t get_memo_key(const Interpreter_Value& value) {
+		switch(value.type) {
+			case Interpreter_Value_Type::Int: return static_cast<std::uint64_t>(value.int_v);
+			case Interpreter_Value_Type::Float: return std::bit_cast<std::uint64_t>(value.float_v);
+			case Interpreter_Value_Type::Bool: return value.bool_v ? 1 : 0;
+			case Interpreter_Value_Type::String: return static_cast<std::uint64_t>(value.string_v);
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static std::size_t hash_memo_arguments(Array_View<Interpreter_Value> args) {
+		std::uint64_t hash = 0;
+		for(const auto& arg : args) {
+			hash = (hash ^ logo::get_memo_key(arg) ^ (static_cast<std::uint64_t>(arg.type) << 59)) * 0x9E3779B97F4A7C15ull;
+		}
+		return static_cast<std::size_t>(hash >> 32);
+	}
+
+	[[nodiscard]] static bool are_memo_arguments_equal(const Interpreter_Value* entry_args,Array_View<Interpreter_Value> args) {
+		for(std::size_t i = 0;i < args.length;i += 1) {
+			if(entry_args[i].type != args[i].type || logo::get_memo_key(entry_args[i]) != logo::get_memo_key(args[i])) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static Interpreter_Value* get_memo_entry(const Interpreter_Memo_Table& table,Array_View<Interpreter_Value> args) {
+		std::size_t entry_index = logo::hash_memo_arguments(args) & (table.entry_count - 1);
+		return table.values.data + entry_index * (args.length + 1);
+	}
+
+	//Doubles the number of entries and moves the old entries over. Entries that land in the same place overwrite each other.
+	[[nodiscard]] static bool grow_memo_table(Interpreter_Memo_Table* table,std::size_t arg_count) {
+		std::size_t entry_count = (table->entry_count == 0) ? 64 : (table->entry_count * 2);
+		std::size_t entry_length = arg_count + 1;
+		Interpreter_Memo_Table new_table{};
+		if(!new_table.values.resize(entry_count * entry_length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",entry_count * entry_length * sizeof(Interpreter_Value));
+			return false;
+		}
+		new_table.entry_count = entry_count;
+		for(std::size_t i = 0;i < table->entry_count;i += 1) {
+			const auto* entry = table->values.data + i * entry_length;
+			if(entry[0].type == Interpreter_Value_Type::Void) continue;
+			auto* new_entry = logo::get_memo_entry(new_table,Array_View<Interpreter_Value>(entry + 1,arg_count));
+			if(new_entry[0].type == Interpreter_Value_Type::Void) new_table.used_entry_count += 1;
+			for(std::size_t j = 0;j < entry_length;j += 1) new_entry[j] = entry[j];
+		}
+		table->destroy();
+		*table = new_table;
+		return true;
+	}
+
+	bool can_memoize_call(const Interpreter_Function* function,Array_View<Interpreter_Value> args) {
+		if(!function->is_memoized) return false;
+		for(const auto& arg : args) {
+			if(!logo::is_memoizable_value(arg)) return false;
+		}
+		return true;
+	}
+
+	Option<Interpreter_Value> find_memoized_result(Interpreter_Context* context,const Interpreter_Function* function,Array_View<Interpreter_Value> args) {
+		const auto& table = function->memo_table;
+		if(table.entry_count > 0) {
+			const auto* entry = logo::get_memo_entry(table,args);
+			if(entry[0].type != Interpreter_Value_Type::Void && logo::are_memo_arguments_equal(entry + 1,args)) {
+				context->statistics.memo_hit_count += 1;
+				return entry[0];
+			}
+		}
+		context->statistics.memo_miss_count += 1;
+		return {};
+	}
+
+	bool memoize_result(Interpreter_Function* function,Array_View<Interpreter_Value> args,const Interpreter_Value& result) {
+		if(!logo::is_memoizable_value(result)) return true;
+		auto* table = &function->memo_table;
+		if(table->entry_count < MAX_MEMO_ENTRY_COUNT && (table->used_entry_count + 1) * 4 > table->entry_count * 3) {
+			if(!logo::grow_memo_table(table,args.length)) return false;
+		}
+		auto* entry = logo::get_memo_entry(*table,args);
+		if(entry[0].type == Interpreter_Value_Type::Void) table->used_entry_count += 1;
+		entry[0] = result;
+		for(std::size_t i = 0;i < args.length;i += 1) entry[i + 1] = args[i];
+		return true;
+	}
+
+	void print_interpreter_statistics(const Interpreter_Statistics& statistics) {
+		std::size_t memo_call_count = statistics.memo_hit_count + statistics.memo_miss_count;
+		if(memo_call_count > 0) logo::eprint("Memoized functions answered % of % calls from their caches.\n",statistics.memo_hit_count,memo_call_count);
+	}
+
+	[[nodiscard]] static bool check_builtin_function_arguments(const Interpreter_Builtin_Function& function,Array_View<Interpreter_Value> args,std::size_t line_index) {
+		for(std::size_t i = 0;i < function.argument_count;i += 1) {
+			Interpreter_Value_Type arg_type = args[i].type;
+			Interpreter_Value_Type required_type = logo::get_builtin_argument_type(function,i);
+			if(required_type != Interpreter_Value_Type::Any && required_type != arg_type) {
+				if(required_type != Interpreter_Value_Type::Int_Or_Float || (arg_type != Interpreter_Value_Type::Int && arg_type != Interpreter_Value_Type::Float)) {
+					Array_String<64> type_name{};
+					switch(required_type) {
+						case Interpreter_Value_Type::Int: type_name.append("'Int'"); break;
+						case Interpreter_Value_Type::Float: type_name.append("'Float'"); break;
+						case Interpreter_Value_Type::Bool: type_name.append("'Bool'"); break;
+						case Interpreter_Value_Type::String: type_name.append("'String'"); break;
+						case Interpreter_Value_Type::Reference: type_name.append("'Reference'"); break;
+						case Interpreter_Value_Type::Int_Or_Float: type_name.append("'Int' or 'Float'"); break;
+						default: logo::unreachable();
+					}
+					logo::report_interpreter_error(line_index,"Argument % to function '%' must be of type %.",i,String_View(function.name,function.name_length),String_View(type_name.buffer,type_name.byte_length));
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	//Packs the types of up to 16 arguments into one integer, 4 bits per argument.
+	[[nodiscard]] static std::uint64_t compute_argument_signature(Array_View<Interpreter_Value> args) {
+		static_assert(static_cast<std::uint64_t>(Interpreter_Value_Type::Any) < 16);
+		std::uint64_t signature = 0;
+		for(const auto& arg : args) {
+			signature = (signature << 4) | static_cast<std::uint64_t>(arg.type);
+		}
+		return signature;
+	}
+
+	//A call that the resolver couldn't bind to a function in its scope looks for the function among the ones defined by the running functions.
+	//The outermost running function takes precedence, like the first definition of a signature does. The functions defined in the blocks
+	//at the top level are checked last, whether their block is running or not. If 'any_arg_count' is true, only the name has to match.
+	[[nodiscard]] static Option<std::size_t> find_dynamic_function(const Interpreter_Context* context,Symbol name,std::size_t arg_count,bool any_arg_count) {
+		for(std::size_t i = 0;i <= context->dynamic_scope.length;i += 1) {
+			std::size_t parent_function_index = (i == context->dynamic_scope.length) ? 0 : (context->dynamic_scope[i] + 1);
+			for(std::size_t j = 0;j < context->functions.length;j += 1) {
+				const auto& function = context->functions[j];
+				if(function.parent_function_index != parent_function_index || function.name != name) continue;
+				if(any_arg_count || function.arguments.length == arg_count) return j;
+			}
+		}
+		return {};
+	}
+
+	bool enter_dynamic_scope(Interpreter_Context* context,const Interpreter_Function* function) {
+		if(!context->dynamic_scope.push_back(static_cast<std::size_t>(function - context->functions.data))) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(std::size_t));
+			return false;
+		}
+		return true;
+	}
+
+	//'context->functions' holds the functions of the whole program, so only the ones visible from the call are considered.
+	static void report_missing_function(const Interpreter_Context* context,const Ast_Function_Call_Cache& cache,Symbol name,std::size_t arg_count,std::size_t line_index) {
+		bool name_exists = cache.is_name_in_scope || logo::find_dynamic_function(context,name,arg_count,true).has_value;
+		for(std::size_t i = 0;i <= MAX_BUILTIN_FUNCTION_ARGUMENT_COUNT;i += 1) {
+			if(logo::find_builtin_function(name,i).has_value) name_exists = true;
+		}
+		if(name_exists) logo::report_interpreter_error(line_index,"Function '%' does not take % arguments.",logo::get_symbol_name(name),arg_count);
+		else logo::report_interpreter_error(line_index,"Function '%' does not exist.",logo::get_symbol_name(name));
+	}
+
+	Option<Interpreter_Call_Target> find_call_target(Interpreter_Context* context,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,std::size_t line_index) {
+		//The threads of a parallel loop share the AST, so they fill a copy of the cache.
+		Ast_Function_Call_Cache worker_cache{};
+		if(context->is_parallel_worker) {
+			worker_cache = *cache;
+			cache = &worker_cache;
+		}
+		Interpreter_Call_Target target{};
+		//Builtin functions can't be redefined so a cached builtin function is always the right one, only the argument types can change.
+		if(cache->target == Ast_Function_Call_Target::Builtin_Function) {
+			target.builtin_function = &logo::get_builtin_function(cache->target_index);
+			if(cache->are_argument_types_proven) return target;
+			auto signature = logo::compute_argument_signature(args);
+			if(signature != cache->argument_signature) {
+				if(!logo::check_builtin_function_arguments(*target.builtin_function,args,line_index)) return {};
+				cache->argument_signature = signature;
+			}
+			return target;
+		}
+		//Functions bound by the resolver never go out of scope at runtime.
+		if(cache->target == Ast_Function_Call_Target::Function) {
+			target.function = &context->functions[cache->target_index];
+			return target;
+		}
+
+		auto [builtin_function_index,builtin_function_found] = logo::find_builtin_function(name,args.length);
+		if(builtin_function_found) {
+			target.builtin_function = &logo::get_builtin_function(builtin_function_index);
+			if(!cache->are_argument_types_proven && !logo::check_builtin_function_arguments(*target.builtin_function,args,line_index)) return {};
+			cache->target = Ast_Function_Call_Target::Builtin_Function;
+			cache->target_index = builtin_function_index;
+			cache->argument_signature = logo::compute_argument_signature(args);
+			return target;
+		}
+
+		//The function found at runtime depends on the running functions, so it's not cached.
+		if(function_index == 0) {
+			auto [dynamic_function_index,dynamic_function_found] = logo::find_dynamic_function(context,name,args.length,false);
+			if(!dynamic_function_found) {
+				logo::report_missing_function(context,*cache,name,args.length,line_index);
+				return {};
+			}
+			target.function = &context->functions[dynamic_function_index];
+			return target;
+		}
+		target.function = &context->functions[function_index - 1];
+		cache->target = Ast_Function_Call_Target::Function;
+		cache->target_index = function_index - 1;
+		return target;
+	}
+
+	enum struct Interpreter_Frame_Type : std::uint8_t {
+		Statements, //Runs statements one by one.
+		Scope, //Same as 'Statements' but removes the variables declared by the statements at the end.
+		Function_Body, //Same as 'Statements' but returns 'Void' from the function at the end.
+		Call, //Restores the state of the caller when the function returns.
+		Expression, //Computes an expression and pushes the result onto the value stack.
+		Unary_Operator,
+		Binary_Operator,
+		Logical_Operator, //Decides if the right operand of 'and' or 'or' has to be computed.
+		Conditional, //Computes the branch selected by the condition on top of the value stack.
+		Function_Call_Argument, //Checks the argument on top of the value stack.
+		Function_Call,
+		Expression_Statement,
+		Declaration,
+		Assignment,
+		If_Statement,
+		While_Statement,
+		For_Statement,
+		Return_Statement,
+		Parallel_Iteration //Stands for the loop in an iteration of a parallel loop that runs on another thread, 'continue' ends the iteration.
+	};
+	enum struct Interpreter_Frame_Phase : std::uint8_t {
+		None,
+		Assignment_Target,
+		Assignment_Value,
+		Loop_Condition,
+		Loop_Body,
+		Loop_Break,
+		For_Start,
+		For_End,
+		For_Induction_Variable
 	};
-	struct Interpreter_Result {
-		Interpreter_Status status;
-		Interpreter_Value value;
-		Interpreter_Result(Interpreter_Status _status) : status(_status),value() {}
-		Interpreter_Result(const Interpreter_Value& _value) : status(Interpreter_Status::Success),value(_value) {}
+	//One entry of the explicit call stack of the tree walking interpreter. Every frame is a piece of work that's left to do,
+	//which lets user defined functions be called without recursing on the native stack.
+	struct Interpreter_Frame {
+		Interpreter_Frame_Type type;
+		Interpreter_Frame_Phase phase;
+		bool is_rvalue; //Only used by 'Expression', 'Unary_Operator' and 'Conditional'.
+		bool is_in_dynamic_scope; //Only used by 'Call' frames, true if the called function was put on 'Interpreter_Context::dynamic_scope'.
+		union {
+			const Ast_Statement* statements;
+			const Ast_Statement* statement;
+			const Ast_Expression* expression;
+			const Ast_Unary_Prefix_Operator* unary_operator;
+			Ast_Binary_Operator* binary_operator;
+			const Ast_Conditional* conditional;
+			Ast_Function_Call* function_call;
+			Interpreter_Function* memoized_function; //Only used by 'Call' frames of memoized calls, whose arguments stay on the value stack until the result is stored.
+		};
+		//'Statements' frames use these as the number of statements and the index of the next one, 'Call' frames as the length of the value stack
+		//and the first variable of the caller. 'For_Statement' frames keep the first value of the loop on the value stack and the index of the iterator variable.
+		std::size_t length;
+		std::size_t index;
+		std::size_t var_count;
+	};
+	struct Interpreter_State {
+		Interpreter_Context* context; //Owned by the caller of 'interpret_ast'.
+		Heap_Array<Interpreter_Frame> frames;
+		Heap_Array<Interpreter_Value> values;
+		std::size_t max_stack_size;
+		Jit_State jit;
+		bool use_threads; //Parallel loops run serially if this is false.
+		void destroy() {
+			jit.destroy();
+			values.destroy();
+			frames.destroy();
+		}
 	};
 
-	[[nodiscard]] static Interpreter_Result interpret_ast(Interpreter_Context* context,Array_View<Ast_Statement> statements,bool is_function_scope,bool inside_loop);
+	[[nodiscard]] static bool push_frame(Interpreter_State* state,const Interpreter_Frame& frame) {
+		if(!state->frames.push_back(frame)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(frame));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool push_statements_frame(Interpreter_State* state,Interpreter_Frame_Type type,Array_View<Ast_Statement> statements) {
+		Interpreter_Frame frame{};
+		frame.type = type;
+		frame.statements = statements.ptr;
+		frame.length = statements.length;
+		frame.var_count = state->context->variables.length;
+		return logo::push_frame(state,frame);
+	}
+
+	[[nodiscard]] static bool push_expression_frame(Interpreter_State* state,const Ast_Expression& expression,bool is_rvalue) {
+		Interpreter_Frame frame{};
+		frame.type = Interpreter_Frame_Type::Expression;
+		frame.is_rvalue = is_rvalue;
+		frame.expression = &expression;
+		return logo::push_frame(state,frame);
+	}
+
+	[[nodiscard]] static bool push_statement_frame(Interpreter_State* state,Interpreter_Frame_Type type,const Ast_Statement& statement,Interpreter_Frame_Phase phase = Interpreter_Frame_Phase::None) {
+		Interpreter_Frame frame{};
+		frame.type = type;
+		frame.phase = phase;
+		frame.statement = &statement;
+		return logo::push_frame(state,frame);
+	}
+
+	[[nodiscard]] static bool push_value(Interpreter_State* state,const Interpreter_Value& value) {
+		if(!state->values.push_back(value)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(value));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static Interpreter_Value pop_value(Interpreter_State* state) {
+		state->values.length -= 1;
+		return state->values.data[state->values.length];
+	}
+
+	[[nodiscard]] static Interpreter_Value make_rvalue(const Interpreter_Context* context,const Interpreter_Value& value) {
+		if(value.type == Interpreter_Value_Type::Lvalue) return context->variables[value.var_index].value;
+		return value;
+	}
+
+	[[nodiscard]] static Option<Interpreter_Value> compute_expression(Interpreter_Context* context,const Ast_Expression& expression);
+
+	//Computes an expression and turns the resulting lvalue (if there is one) into the value it refers to.
+	[[nodiscard]] static Option<Interpreter_Value> compute_rvalue_expression(Interpreter_Context* context,const Ast_Expression& expression) {
+		auto [value,success] = logo::compute_expression(context,expression);
+		if(!success) return {};
+		return logo::make_rvalue(context,value);
+	}
+
+	[[nodiscard]] static Option<Interpreter_Value> compute_unary_operator(const Interpreter_Context* context,const Ast_Unary_Prefix_Operator& unary_operator,const Interpreter_Value& value) {
+		if(unary_operator.type == Ast_Unary_Prefix_Operator_Type::Reference) return logo::make_reference(context,value,unary_operator.line_index);
+		if(unary_operator.type == Ast_Unary_Prefix_Operator_Type::Dereference) {
+			if(unary_operator.is_reference_proven) return logo::make_lvalue(value.var_index);
+			return logo::dereference(context,value,unary_operator.line_index);
+		}
+		return logo::compute_unary_operation(unary_operator.type,value,unary_operator.line_index);
+	}
+
+	[[nodiscard]] static Option<Interpreter_Value> compute_binary_operator(const Interpreter_Context* context,Ast_Binary_Operator* binary_operator,const Interpreter_Value& left,const Interpreter_Value& right) {
+		if(binary_operator->cache.is_proven) return logo::compute_unchecked_operation(binary_operator->cache.specialization,left,right);
+		if(binary_operator->cache.specialization != Ast_Operation_Specialization::None) {
+			Interpreter_Value result{};
+			if(logo::compute_specialized_operation(binary_operator->cache.specialization,left,right,&result)) return result;
+		}
+		auto specialization = logo::specialize_binary_operation(binary_operator->type,left.type,right.type);
+		if(specialization != binary_operator->cache.specialization && !context->is_parallel_worker) logo::update_operation_cache(&binary_operator->cache,specialization);
+		return logo::compute_binary_operation(binary_operator->type,left,right,binary_operator->line_index);
+	}
 
+	//Expressions without function calls can't enter a function so they are computed recursively. Their depth only depends on the source code.
 	[[nodiscard]] static Option<Interpreter_Value> compute_expression(Interpreter_Context* context,const Ast_Expression& expression) {
 		switch(expression.type) {
 			case Ast_Expression_Type::Value: {
 				return logo::make_interpreter_value_from_ast_value(context,expression.value);
 			}
 			case Ast_Expression_Type::Unary_Prefix_Operator: {
-				if(expression.unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
-					const auto* child = expression.unary_prefix_operator->child;
-					if(child->type != Ast_Expression_Type::Value) {
-						logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"'parent scope access' operator can only be applied on an identifier.");
-						return {};
-					}
-					if(child->value.type != Ast_Value_Type::Identifier) {
-						logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"'parent scope access' operator can only be applied on an identifier.");
-						return {};
-					}
-					
-					for(std::size_t i = context->variables.length;i > 0;i -= 1) {
-						const auto& var = context->variables[i - 1];
-						if(std::strcmp(child->value.identfier_name.begin_ptr,var.name.begin_ptr) == 0) {
-							Interpreter_Value result{};
-							result.type = Interpreter_Value_Type::Lvalue;
-							result.lvalue_v = {};
-							result.lvalue_v.var_index = i - 1;
-							return result;
-						}
-					}
-					logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Variable '%' does not exist.",child->value.identfier_name);
-					return {};
-				}
+				const auto* unary_operator = expression.unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					const auto& child_value = unary_operator->child->value;
+					if(child_value.depth == 0) return logo::make_interpreter_value_from_ast_value(context,child_value);
 
-				auto [value,success] = logo::compute_expression(context,*expression.unary_prefix_operator->child);
-				if(!success) return {};
-				switch(expression.unary_prefix_operator->type) {
-					case Ast_Unary_Prefix_Operator_Type::Plus:
-					case Ast_Unary_Prefix_Operator_Type::Minus: {
-						if(value.type == Interpreter_Value_Type::Lvalue) {
-							Interpreter_Value copy = value;
-							value = context->variables[copy.lvalue_v.var_index].value;
-						}
-
-						if(value.type == Interpreter_Value_Type::Bool) {
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Cannot negate '%'.",value.bool_v);
-							return {};
-						}
-						if(value.type == Interpreter_Value_Type::String) {
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Cannot negate \"%\".",value.string_v);
-							return {};
-						}
-						if(value.type == Interpreter_Value_Type::Int) value.int_v *= -1;
-						else if(value.type == Interpreter_Value_Type::Float) value.float_v *= -1.0;
-						break;
-					}
-					case Ast_Unary_Prefix_Operator_Type::Logical_Not: {
-						if(value.type == Interpreter_Value_Type::Lvalue) {
-							Interpreter_Value copy = value;
-							value = context->variables[copy.lvalue_v.var_index].value;
-						}
-
-						if(value.type == Interpreter_Value_Type::Bool) value.bool_v = !value.bool_v;
-						else {
-							//@TODO: Print value that couldn't be negated.
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Cannot logically negate a nonboolean value.");
-							return {};
-						}
-						break;
-					}
-					case Ast_Unary_Prefix_Operator_Type::Reference: {
-						if(value.type != Interpreter_Value_Type::Lvalue) {
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Cannot take a reference to an object that is not an lvalue.");
-							return {};
-						}
-
-						auto var_index = value.lvalue_v.var_index;
-						value.type = Interpreter_Value_Type::Reference;
-						value.reference_v = {};
-						value.reference_v.var_index = var_index;
-						logo::assert(value.reference_v.var_index < context->variables.length);
-						value.reference_v.generation = context->variables[value.reference_v.var_index].generation;
-						break;
-					}
-					case Ast_Unary_Prefix_Operator_Type::Dereference: {
-						if(value.type == Interpreter_Value_Type::Lvalue) {
-							Interpreter_Value copy = value;
-							value = context->variables[copy.lvalue_v.var_index].value;
-						}
-						if(value.type != Interpreter_Value_Type::Reference) {
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Cannot dereference an object that is not a reference.");
-							return {};
-						}
-
-						if(value.reference_v.var_index >= context->variables.length) {
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Dangling reference.");
-							return {};
-						}
-						const auto& referenced_var = context->variables[value.reference_v.var_index];
-						if(value.reference_v.generation != referenced_var.generation) {
-							logo::report_interpreter_error(expression.unary_prefix_operator->line_index,"Dangling reference.");
-							return {};
-						}
-
-						auto var_index = value.reference_v.var_index;
-						value.type = Interpreter_Value_Type::Lvalue;
-						value.lvalue_v = {};
-						value.lvalue_v.var_index = var_index;
-						break;
-					}
-					default: logo::unreachable();
+					auto [var_index,success] = logo::find_parent_scope_variable(context,child_value.identfier_name,child_value.slot,unary_operator->line_index);
+					if(!success) return {};
+					return logo::make_lvalue(var_index);
 				}
-				return value;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Reference) {
+					auto [value,success] = logo::compute_expression(context,*unary_operator->child);
+					if(!success) return {};
+					return logo::compute_unary_operator(context,*unary_operator,value);
+				}
+				auto [value,success] = logo::compute_rvalue_expression(context,*unary_operator->child);
+				if(!success) return {};
+				return logo::compute_unary_operator(context,*unary_operator,value);
 			}
 			case Ast_Expression_Type::Binary_Operator: {
-				auto [value0,success0] = logo::compute_expression(context,*expression.binary_operator->left);
+				auto* binary_operator = expression.binary_operator;
+				auto [value0,success0] = logo::compute_rvalue_expression(context,*binary_operator->left);
 				if(!success0) return {};
-				if(value0.type == Interpreter_Value_Type::Lvalue) {
-					Interpreter_Value copy = value0;
-					value0 = context->variables[copy.lvalue_v.var_index].value;
-				}
-
-				auto [value1,success1] = logo::compute_expression(context,*expression.binary_operator->right);
+				if(logo::is_short_circuited(binary_operator->type,value0)) return value0;
+				auto [value1,success1] = logo::compute_rvalue_expression(context,*binary_operator->right);
 				if(!success1) return {};
-				if(value1.type == Interpreter_Value_Type::Lvalue) {
-					Interpreter_Value copy = value1;
-					value1 = context->variables[copy.lvalue_v.var_index].value;
-				}
+				return logo::compute_binary_operator(context,binary_operator,value0,value1);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				auto [condition,success] = logo::compute_rvalue_expression(context,*conditional->condition);
+				if(!success) return {};
+				if(!logo::check_conditional_expression_condition(condition,conditional->line_index)) return {};
+				return logo::compute_expression(context,condition.bool_v ? *conditional->if_true : *conditional->if_false);
+			}
+			case Ast_Expression_Type::Array_Access: {
+				logo::report_interpreter_error(expression.array_access->line_index,"Arrays are not yet implemented.");
+				return {};
+			}
+			default: logo::unreachable();
+		}
+	}
 
-				switch(expression.binary_operator->type) {
-					case Ast_Binary_Operator_Type::Plus:
-					case Ast_Binary_Operator_Type::Minus:
-					case Ast_Binary_Operator_Type::Multiply:
-					case Ast_Binary_Operator_Type::Divide:
-					case Ast_Binary_Operator_Type::Remainder:
-					case Ast_Binary_Operator_Type::Exponentiate: {
-						Interpreter_Value result{};
-						if(value0.type == Interpreter_Value_Type::Int && value1.type == Interpreter_Value_Type::Int) {
-							result.type = Interpreter_Value_Type::Int;
-							result.int_v = logo::compute_arithmetic_operation(expression.binary_operator->type,value0.int_v,value1.int_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::Float && value1.type == Interpreter_Value_Type::Float) {
-							result.type = Interpreter_Value_Type::Float;
-							result.float_v = logo::compute_arithmetic_operation(expression.binary_operator->type,value0.float_v,value1.float_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::Int && value1.type == Interpreter_Value_Type::Float) {
-							result.type = Interpreter_Value_Type::Float;
-							result.float_v = logo::compute_arithmetic_operation(expression.binary_operator->type,static_cast<double>(value0.int_v),value1.float_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::Float && value1.type == Interpreter_Value_Type::Int) {
-							result.type = Interpreter_Value_Type::Float;
-							result.float_v = logo::compute_arithmetic_operation(expression.binary_operator->type,value0.float_v,static_cast<double>(value1.int_v));
-						}
-						else {
-							//@TODO: Print more info.
-							logo::report_interpreter_error(expression.binary_operator->line_index,"Invalid arithmetic operation (error message in progress).");
-							return {};
-						}
-						return result;
-					}
-					case Ast_Binary_Operator_Type::Logical_And:
-					case Ast_Binary_Operator_Type::Logical_Or: {
-						if(value0.type != Interpreter_Value_Type::Bool || value1.type != Interpreter_Value_Type::Bool) {
-							String_View operator_string = (expression.binary_operator->type == Ast_Binary_Operator_Type::Logical_And) ? "and" : "or";
-							logo::report_interpreter_error(expression.binary_operator->line_index,"Operator '%' needs both operands of type 'Bool'.",operator_string);
-							return {};
-						}
-						Interpreter_Value result{};
-						result.type = Interpreter_Value_Type::Bool;
-						if(expression.binary_operator->type == Ast_Binary_Operator_Type::Logical_And) result.bool_v = (value0.bool_v && value1.bool_v);
-						else result.bool_v = (value0.bool_v || value1.bool_v);
-						return result;
-					}
-					case Ast_Binary_Operator_Type::Compare_Equal:
-					case Ast_Binary_Operator_Type::Compare_Unequal:
-					case Ast_Binary_Operator_Type::Compare_Less_Than:
-					case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal:
-					case Ast_Binary_Operator_Type::Compare_Greater_Than:
-					case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: {
-						Interpreter_Value result{};
-						result.type = Interpreter_Value_Type::Bool;
-						if(value0.type == Interpreter_Value_Type::Int && value1.type == Interpreter_Value_Type::Int) {
-							result.bool_v = logo::compute_compare_operation(expression.binary_operator->type,value0.int_v,value1.int_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::Float && value1.type == Interpreter_Value_Type::Float) {
-							result.bool_v = logo::compute_compare_operation(expression.binary_operator->type,value0.float_v,value1.float_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::Int && value1.type == Interpreter_Value_Type::Float) {
-							result.bool_v = logo::compute_compare_operation(expression.binary_operator->type,static_cast<double>(value0.int_v),value1.float_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::Float && value1.type == Interpreter_Value_Type::Int) {
-							result.bool_v = logo::compute_compare_operation(expression.binary_operator->type,value0.float_v,static_cast<double>(value1.int_v));
-						}
-						else if(value0.type == Interpreter_Value_Type::Bool && value1.type == Interpreter_Value_Type::Bool) {
-							if(expression.binary_operator->type != Ast_Binary_Operator_Type::Compare_Equal && expression.binary_operator->type != Ast_Binary_Operator_Type::Compare_Unequal) {
-								//@TODO: Print the wrong operator.
-								logo::report_interpreter_error(expression.binary_operator->line_index,"Cannot apply that comparison operator on bools.");
-								return {};
-							}
-							if(expression.binary_operator->type == Ast_Binary_Operator_Type::Compare_Equal) result.bool_v = (value0.bool_v == value1.bool_v);
-							else result.bool_v = (value0.bool_v != value1.bool_v);
-						}
-						else if(value0.type == Interpreter_Value_Type::String && value1.type == Interpreter_Value_Type::String) {
-							if(expression.binary_operator->type != Ast_Binary_Operator_Type::Compare_Equal && expression.binary_operator->type != Ast_Binary_Operator_Type::Compare_Unequal) {
-								//@TODO: Print the wrong operator.
-								logo::report_interpreter_error(expression.binary_operator->line_index,"Cannot apply that comparison operator on strings.");
-								return {};
-							}
-							if(expression.binary_operator->type == Ast_Binary_Operator_Type::Compare_Equal) result.bool_v = (std::strcmp(value0.string_v.begin_ptr,value1.string_v.begin_ptr) == 0);
-							else result.bool_v = (std::strcmp(value0.string_v.begin_ptr,value1.string_v.begin_ptr) != 0);
-						}
-						else {
-							//@TODO: Print more info.
-							logo::report_interpreter_error(expression.binary_operator->line_index,"Invalid comparison operation (error message in progress).");
-							return {};
-						}
-						return result;
-					}
-					default: logo::unreachable();
-				}
+	//Marks every expression that contains a function call.
+	static bool mark_function_calls(Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value:
+			case Ast_Expression_Type::Array_Access: {
+				expression->contains_function_call = false;
+				break;
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				expression->contains_function_call = logo::mark_function_calls(expression->unary_prefix_operator->child);
+				break;
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				bool left_contains_function_call = logo::mark_function_calls(expression->binary_operator->left);
+				bool right_contains_function_call = logo::mark_function_calls(expression->binary_operator->right);
+				expression->contains_function_call = left_contains_function_call || right_contains_function_call;
+				break;
+			}
+			case Ast_Expression_Type::Conditional: {
+				bool condition_contains_function_call = logo::mark_function_calls(expression->conditional->condition);
+				bool if_true_contains_function_call = logo::mark_function_calls(expression->conditional->if_true);
+				bool if_false_contains_function_call = logo::mark_function_calls(expression->conditional->if_false);
+				expression->contains_function_call = condition_contains_function_call || if_true_contains_function_call || if_false_contains_function_call;
+				break;
 			}
 			case Ast_Expression_Type::Function_Call: {
-				Static_Array<Interpreter_Value,16> arg_values{};
-				for(const auto& arg_expr : expression.function_call->arguments) {
-					auto [arg_value,success] = logo::compute_expression(context,*arg_expr);
-					if(!success) return {};
+				for(auto* arg_expr : expression->function_call->arguments) static_cast<void>(logo::mark_function_calls(arg_expr));
+				expression->contains_function_call = true;
+				break;
+			}
+			default: logo::unreachable();
+		}
+		return expression->contains_function_call;
+	}
 
-					if(arg_value.type == Interpreter_Value_Type::Void) {
-						logo::report_interpreter_error(expression.function_call->line_index,"Cannot assign value of type 'Void' to a function parameter.");
-						return {};
-					}
-					if(arg_value.type == Interpreter_Value_Type::Lvalue) {
-						auto& referenced_value = context->variables[arg_value.lvalue_v.var_index].value;
-						arg_value = referenced_value;
-					}
-					if(!arg_values.push_back(arg_value)) {
-						logo::report_interpreter_error(expression.function_call->line_index,"Function '%' cannot take more than 16 arguments.",expression.function_call->name);
-						return {};
+	static void mark_function_calls(Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					static_cast<void>(logo::mark_function_calls(&statement.expression));
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					static_cast<void>(logo::mark_function_calls(&statement.declaration.initial_value_expr));
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					static_cast<void>(logo::mark_function_calls(&statement.assignment.lvalue_expr));
+					static_cast<void>(logo::mark_function_calls(&statement.assignment.rvalue_expr));
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					static_cast<void>(logo::mark_function_calls(&statement.if_statement.condition_expr));
+					logo::mark_function_calls(&statement.if_statement.if_true_statements);
+					logo::mark_function_calls(&statement.if_statement.if_false_statements);
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					static_cast<void>(logo::mark_function_calls(&statement.while_statement.condition_expr));
+					logo::mark_function_calls(&statement.while_statement.body_statements);
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					static_cast<void>(logo::mark_function_calls(&statement.for_statement.start_expr));
+					static_cast<void>(logo::mark_function_calls(&statement.for_statement.end_expr));
+					for(auto& induction_variable : statement.for_statement.induction_variables) {
+						static_cast<void>(logo::mark_function_calls(&induction_variable.step_expr));
 					}
+					logo::mark_function_calls(&statement.for_statement.body_statements);
+					break;
 				}
+				case Ast_Statement_Type::Function_Definition: {
+					logo::mark_function_calls(&statement.function_definition.body_statements);
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value) static_cast<void>(logo::mark_function_calls(statement.return_statement.return_value));
+					break;
+				}
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				default: logo::unreachable();
+			}
+		}
+	}
 
-				//This function is hardcoded because the interpreter doesn't support variadic functions.
-				if(std::strcmp(expression.function_call->name.begin_ptr,"print") == 0) {
-					if(expression.function_call->arguments.length == 0) {
-						logo::report_interpreter_error(expression.function_call->line_index,"Function 'print' takes at least 1 argument.");
-						return {};
-					}
-					const auto& format_arg = arg_values[0];
-					if(format_arg.type != Interpreter_Value_Type::String) {
-						logo::report_interpreter_error(expression.function_call->line_index,"Argument 0 to function 'print' must be a string.");
-						return {};
-					}
+	//Puts every function of the program at the index the resolver gave it, so that entering a scope doesn't have to define anything.
+	[[nodiscard]] static bool define_functions(Interpreter_Context* context,Array_View<Ast_Statement> statements) {
+		for(const auto& statement : statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::If_Statement: {
+					const auto& if_statement = statement.if_statement;
+					if(!logo::define_functions(context,{if_statement.if_true_statements.data,if_statement.if_true_statements.length})) return false;
+					if(!logo::define_functions(context,{if_statement.if_false_statements.data,if_statement.if_false_statements.length})) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					const auto& body_statements = statement.while_statement.body_statements;
+					if(!logo::define_functions(context,{body_statements.data,body_statements.length})) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					const auto& body_statements = statement.for_statement.body_statements;
+					if(!logo::define_functions(context,{body_statements.data,body_statements.length})) return false;
+					break;
+				}
+				case Ast_Statement_Type::Function_Definition: {
+					const auto& function_definition = statement.function_definition;
+					Interpreter_Function function{};
+					function.name = function_definition.name;
+					function.arguments = Array_View<Symbol>(function_definition.function_arguments.data,function_definition.function_arguments.length);
+					function.body_statements = Array_View<Ast_Statement>(function_definition.body_statements.data,function_definition.body_statements.length);
+					function.is_memoized = function_definition.is_memoized;
+					function.parent_function_index = function_definition.parent_function_index;
+					function.defines_dynamic_functions = function_definition.defines_dynamic_functions;
+					if(!logo::define_function(context,function_definition.function_index,function)) return false;
+					if(!logo::define_functions(context,function.body_statements)) return false;
+					break;
+				}
+				default: break;
+			}
+		}
+		return true;
+	}
 
-					Static_Array<String_Format_Arg,15> format_args{};
-					for(std::size_t i = 1;i < arg_values.length;i += 1) {
-						const auto& arg_value = arg_values[i];
-
-						String_Format_Arg format_arg{};
-						switch(arg_value.type) {
-							case Interpreter_Value_Type::Int: format_arg = logo::make_string_format_arg(arg_value.int_v); break;
-							case Interpreter_Value_Type::Float: format_arg = logo::make_string_format_arg(arg_value.float_v); break;
-							case Interpreter_Value_Type::Bool: format_arg = logo::make_string_format_arg(arg_value.bool_v); break;
-							case Interpreter_Value_Type::String: format_arg = logo::make_string_format_arg(arg_value.string_v); break;
-							case Interpreter_Value_Type::Reference: format_arg = logo::make_string_format_arg("(Reference)"); break; //@TODO: Print what that reference points to.
-							default: logo::unreachable();
-						}
-
-						if(!format_args.push_back(format_arg)) {
-							Report_Error("Couldn't create a formatting argument.");
-							return {};
-						}
-					}
-					auto format_result = logo::format_args_into(logo::print_stdout_char32_t,format_arg.string_v,{format_args.data,format_args.length});
-					if(format_result.external_failure) {
-						Report_Error("Couldn't execute a print statement.");
-						return {};
-					}
-					if(format_result.count_of_args != format_result.count_of_arguments_processed) {
-						logo::report_interpreter_error(expression.function_call->line_index,"The number of argumnets given to 'print' does nor match the numnber of markers in the format string.");
-						return {};
-					}
+	//Every function call checks how much memory the variables and the frames take up, so deep recursion ends with an error instead of running out of memory.
+	[[nodiscard]] static bool check_stack_size(const Interpreter_State* state,std::size_t line_index) {
+		std::size_t stack_size = state->frames.length * sizeof(Interpreter_Frame) + state->values.length * sizeof(Interpreter_Value) +
+								 state->context->variables.length * sizeof(Interpreter_Variable);
+		if(stack_size > state->max_stack_size) {
+			logo::report_interpreter_error(line_index,"Call stack exceeded the limit of % bytes.",state->max_stack_size);
+			return false;
+		}
+		return true;
+	}
 
-					Interpreter_Value result{};
-					result.type = Interpreter_Value_Type::Void;
-					return result;
-				}
+	//Leaves the function that's currently running and pushes 'value' as the result of its call.
+	[[nodiscard]] static bool return_from_function(Interpreter_State* state,const Interpreter_Value& value) {
+		auto* context = state->context;
+		while(state->frames[state->frames.length - 1].type != Interpreter_Frame_Type::Call) state->frames.length -= 1;
+		const auto& frame = state->frames[state->frames.length - 1];
+		context->current_function_scope_first_var_index = frame.index;
+		context->variables.length = frame.var_count;
+		state->values.length = frame.length;
+		if(frame.is_in_dynamic_scope) logo::leave_dynamic_scope(context);
+		if(frame.memoized_function) {
+			std::size_t arg_count = frame.memoized_function->arguments.length;
+			state->values.length -= arg_count;
+			if(!logo::memoize_result(frame.memoized_function,Array_View<Interpreter_Value>(state->values.data + state->values.length,arg_count),value)) return false;
+		}
+		state->frames.length -= 1;
+		return logo::push_value(state,value);
+	}
 
-				bool function_overload_exist = false;
-				for(const auto& builtin_function : context->builtin_functions) {
-					if(std::strcmp(expression.function_call->name.begin_ptr,builtin_function.name.begin_ptr) != 0) continue;
-					function_overload_exist = true;
-					if(expression.function_call->arguments.length != builtin_function.argument_types.length) continue;
-
-					for(std::size_t i = 0;i < builtin_function.argument_types.length;i += 1) {
-						Interpreter_Value_Type arg_type = arg_values[i].type;
-						Interpreter_Value_Type required_type = builtin_function.argument_types[i];
-						if(required_type != Interpreter_Value_Type::Any && required_type != arg_type) {
-							if(required_type != Interpreter_Value_Type::Int_Or_Float || (arg_type != Interpreter_Value_Type::Int && arg_type != Interpreter_Value_Type::Float)) {
-								Array_String<64> type_name{};
-								switch(required_type) {
-									case Interpreter_Value_Type::Int: type_name.append("'Int'"); break;
-									case Interpreter_Value_Type::Float: type_name.append("'Float'"); break;
-									case Interpreter_Value_Type::Bool: type_name.append("'Bool'"); break;
-									case Interpreter_Value_Type::String: type_name.append("'String'"); break;
-									case Interpreter_Value_Type::Reference: type_name.append("'Reference'"); break;
-									case Interpreter_Value_Type::Int_Or_Float: type_name.append("'Int' or 'Float'"); break;
-									default: logo::unreachable();
-								}
-								logo::report_interpreter_error(expression.function_call->line_index,"Argument % to function '%' must be of type %.",i,expression.function_call->name,String_View(type_name.buffer,type_name.byte_length));
-								return {};
-							}
-						}
-					}
-					return builtin_function.func_ptr(context,expression.function_call->line_index,{arg_values.data,arg_values.length});
+	//Removes the frames inside of the innermost loop, leaving the scopes they entered. The loop frame stays on top.
+	static void unwind_to_loop(Interpreter_State* state) {
+		while(true) {
+			const auto& frame = state->frames[state->frames.length - 1];
+			if(frame.type == Interpreter_Frame_Type::While_Statement || frame.type == Interpreter_Frame_Type::For_Statement || frame.type == Interpreter_Frame_Type::Parallel_Iteration) return;
+			logo::assert(frame.type != Interpreter_Frame_Type::Call);
+			if(frame.type == Interpreter_Frame_Type::Scope) state->context->variables.length = frame.var_count;
+			state->frames.length -= 1;
+		}
+	}
+
+	//Calls the function with the arguments on top of the value stack. A call that's the value of a 'return' statement is in tail position.
+	//If nothing can refer to the variables of the current function, its frame is replaced by the frame of the called function.
+	[[nodiscard]] static bool call_function(Interpreter_State* state,Ast_Function_Call* function_call) {
+		auto* context = state->context;
+		std::size_t first_arg_index = state->values.length - function_call->arguments.length;
+		Array_View<Interpreter_Value> args(state->values.data + first_arg_index,function_call->arguments.length);
+
+		//This function is hardcoded because the interpreter doesn't support variadic functions.
+		if(function_call->name == context->print_symbol) {
+			if(!logo::check_parallel_loop_call(context,"print",function_call->line_index)) return false;
+			if(!logo::call_print_function(args,function_call->line_index)) return false;
+			state->values.length = first_arg_index;
+			Interpreter_Value result{};
+			result.type = Interpreter_Value_Type::Void;
+			return logo::push_value(state,result);
+		}
+
+		auto [target,target_found] = logo::find_call_target(context,&function_call->cache,function_call->name,function_call->function_index,args,function_call->line_index);
+		if(!target_found) return false;
+		if(target.builtin_function) {
+			auto [result,success] = target.builtin_function->func_ptr(context,function_call->line_index,args);
+			if(!success) return false;
+			state->values.length = first_arg_index;
+			return logo::push_value(state,result);
+		}
+		auto* function = &context->functions[static_cast<std::size_t>(target.function - context->functions.data)];
+		if(!logo::count_watchdog_step(context,function_call->line_index)) return false;
+		bool is_memoized_call = logo::can_memoize_call(function,args);
+		if(is_memoized_call) {
+			auto [result,found] = logo::find_memoized_result(context,function,args);
+			if(found) {
+				state->values.length = first_arg_index;
+				return logo::push_value(state,result);
+			}
+		}
+		else {
+			Interpreter_Value jit_result{};
+			auto jit_call_result = logo::call_jit_function(&state->jit,context,function,args,&jit_result);
+			if(jit_call_result == Jit_Call_Result::Stopped) return false;
+			if(jit_call_result == Jit_Call_Result::Returned) {
+				state->values.length = first_arg_index;
+				return logo::push_value(state,jit_result);
+			}
+		}
+		auto argument_names = function->arguments;
+		auto body_statements = function->body_statements;
+
+		//A memoized call in tail position doesn't get a frame of its own, its result is only stored for the call whose frame it takes over.
+		const auto& top_frame = state->frames[state->frames.length - 1];
+		if(top_frame.type == Interpreter_Frame_Type::Return_Statement && top_frame.statement->return_statement.can_reuse_frame) {
+			std::size_t call_frame_index = state->frames.length;
+			while(state->frames[call_frame_index - 1].type != Interpreter_Frame_Type::Call) call_frame_index -= 1;
+			auto& call_frame = state->frames[call_frame_index - 1];
+			//Functions put on the dynamic scope never reuse their frame, see 'can_reuse_frame' in the resolver.
+			if(function->defines_dynamic_functions) {
+				if(!logo::enter_dynamic_scope(context,function)) return false;
+				call_frame.is_in_dynamic_scope = true;
+			}
+			//The arguments stay in the unused part of the value stack until they are copied.
+			context->variables.length = call_frame.var_count;
+			for(std::size_t i = 0;i < args.length;i += 1) {
+				if(!logo::push_variable(context,argument_names[i],args[i])) return false;
+			}
+			state->values.length = call_frame.length;
+			state->frames.length = call_frame_index;
+			return logo::push_statements_frame(state,Interpreter_Frame_Type::Function_Body,body_statements);
+		}
+
+		if(!logo::check_stack_size(state,function_call->line_index)) return false;
+		Interpreter_Frame frame{};
+		frame.type = Interpreter_Frame_Type::Call;
+		frame.length = first_arg_index;
+		frame.index = context->current_function_scope_first_var_index;
+		frame.var_count = context->variables.length;
+		if(is_memoized_call) {
+			frame.memoized_function = function;
+			frame.length += args.length;
+		}
+		frame.is_in_dynamic_scope = function->defines_dynamic_functions;
+		if(frame.is_in_dynamic_scope && !logo::enter_dynamic_scope(context,function)) return false;
+		if(!logo::push_frame(state,frame)) return false;
+
+		context->current_function_scope_first_var_index = context->variables.length;
+		for(std::size_t i = 0;i < args.length;i += 1) {
+			if(!logo::push_variable(context,argument_names[i],args[i])) return false;
+		}
+		state->values.length = frame.length;
+		return logo::push_statements_frame(state,Interpreter_Frame_Type::Function_Body,body_statements);
+	}
+
+	[[nodiscard]] static bool push_function_call_argument(Interpreter_State* state,const Ast_Function_Call& function_call,std::size_t arg_index,const Interpreter_Value& arg_value) {
+		if(!function_call.cache.are_argument_types_proven && arg_value.type == Interpreter_Value_Type::Void) {
+			logo::report_interpreter_error(function_call.line_index,"Cannot assign value of type 'Void' to a function parameter.");
+			return false;
+		}
+		if(arg_index >= 16) {
+			logo::report_interpreter_error(function_call.line_index,"Function '%' cannot take more than 16 arguments.",logo::get_symbol_name(function_call.name));
+			return false;
+		}
+		return logo::push_value(state,logo::make_rvalue(state->context,arg_value));
+	}
+
+	//Pushes the value of the expression onto the value stack. If computing it needs to enter a function, the value is pushed
+	//by the frames that are left on the call stack. Operands without function calls are computed right away.
+	[[nodiscard]] static bool compute_expression_on_stack(Interpreter_State* state,const Ast_Expression& expression,bool is_rvalue) {
+		auto* context = state->context;
+		if(!expression.contains_function_call) {
+			auto [value,success] = is_rvalue ? logo::compute_rvalue_expression(context,expression) : logo::compute_expression(context,expression);
+			if(!success) return false;
+			return logo::push_value(state,value);
+		}
+		switch(expression.type) {
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				Interpreter_Frame frame{};
+				frame.type = Interpreter_Frame_Type::Unary_Operator;
+				frame.is_rvalue = is_rvalue;
+				frame.unary_operator = expression.unary_prefix_operator;
+				if(!logo::push_frame(state,frame)) return false;
+				bool is_child_rvalue = expression.unary_prefix_operator->type != Ast_Unary_Prefix_Operator_Type::Reference;
+				return logo::compute_expression_on_stack(state,*expression.unary_prefix_operator->child,is_child_rvalue);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				auto type = expression.binary_operator->type;
+				Interpreter_Frame frame{};
+				frame.type = Interpreter_Frame_Type::Binary_Operator;
+				frame.binary_operator = expression.binary_operator;
+				if(type == Ast_Binary_Operator_Type::Logical_And || type == Ast_Binary_Operator_Type::Logical_Or) {
+					frame.type = Interpreter_Frame_Type::Logical_Operator;
+					if(!logo::push_frame(state,frame)) return false;
+					return logo::compute_expression_on_stack(state,*expression.binary_operator->left,true);
+				}
+				if(!logo::push_frame(state,frame)) return false;
+				if(expression.binary_operator->left->contains_function_call) {
+					if(!logo::push_expression_frame(state,*expression.binary_operator->right,true)) return false;
+					return logo::compute_expression_on_stack(state,*expression.binary_operator->left,true);
 				}
+				if(!logo::compute_expression_on_stack(state,*expression.binary_operator->left,true)) return false;
+				return logo::compute_expression_on_stack(state,*expression.binary_operator->right,true);
+			}
+			case Ast_Expression_Type::Conditional: {
+				Interpreter_Frame frame{};
+				frame.type = Interpreter_Frame_Type::Conditional;
+				frame.is_rvalue = is_rvalue;
+				frame.conditional = expression.conditional;
+				if(!logo::push_frame(state,frame)) return false;
+				return logo::compute_expression_on_stack(state,*expression.conditional->condition,true);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				auto* function_call = expression.function_call;
+				//Arguments are computed from left to right, the ones before the first argument with a function call are computed right away.
+				std::size_t arg_index = 0;
+				for(;arg_index < function_call->arguments.length;arg_index += 1) {
+					const auto& arg_expr = *function_call->arguments[arg_index];
+					if(arg_expr.contains_function_call) break;
+					auto [arg_value,success] = logo::compute_expression(context,arg_expr);
+					if(!success) return false;
+					if(!logo::push_function_call_argument(state,*function_call,arg_index,arg_value)) return false;
+				}
+				if(arg_index == function_call->arguments.length) return logo::call_function(state,function_call);
+
+				Interpreter_Frame frame{};
+				frame.type = Interpreter_Frame_Type::Function_Call;
+				frame.function_call = function_call;
+				if(!logo::push_frame(state,frame)) return false;
+				for(std::size_t i = function_call->arguments.length;i > arg_index;i -= 1) {
+					frame.type = Interpreter_Frame_Type::Function_Call_Argument;
+					frame.index = i - 1;
+					if(!logo::push_frame(state,frame)) return false;
+					if(i - 1 > arg_index && !logo::push_expression_frame(state,*function_call->arguments[i - 1],false)) return false;
+				}
+				return logo::compute_expression_on_stack(state,*function_call->arguments[arg_index],false);
+			}
+			default: logo::unreachable();
+		}
+	}
 
-				for(auto& function : context->functions) {
-					if(std::strcmp(function.name.begin_ptr,expression.function_call->name.begin_ptr) != 0) continue;
-					function_overload_exist = true;
-					if(expression.function_call->arguments.length != function.arguments.length) continue;
-
-					auto var_count = context->variables.length;
-					auto func_count = context->functions.length;
-					auto copy_var_index = context->current_function_scope_first_var_index;
-					context->current_function_scope_first_var_index = context->variables.length;
-
-					for(std::size_t i = 0;i < arg_values.length;i += 1) {
-						Interpreter_Variable variable{};
-						variable.name = function.arguments[i];
-						context->generation_counter += 1;
-						variable.generation = context->generation_counter;
-						variable.value = arg_values[i];
-						if(!context->variables.push_back(variable)) {
-							Report_Error("Couldn't allocate % bytes of memory.",sizeof(variable));
-							return {};
-						}
-					}
+	[[nodiscard]] static bool execute_assignment(Interpreter_Context* context,const Ast_Assignment& assignment,const Interpreter_Value& lvalue_value,const Interpreter_Value& rvalue_value) {
+		if(rvalue_value.type == Interpreter_Value_Type::Void) {
+			logo::report_interpreter_error(assignment.line_index,"Cannot assign value of type 'Void'.");
+			return false;
+		}
+		if(!logo::check_parallel_loop_assignment(context,lvalue_value.var_index,assignment.line_index)) return false;
+
+		auto& target_lvalue = context->variables[lvalue_value.var_index].value;
+		auto& cache = assignment.cache;
+		if(cache.is_proven) {
+			target_lvalue = logo::compute_unchecked_operation(cache.specialization,target_lvalue,rvalue_value);
+			return true;
+		}
+		if(cache.specialization != Ast_Operation_Specialization::None) {
+			if(logo::compute_specialized_operation(cache.specialization,target_lvalue,rvalue_value,&target_lvalue)) return true;
+		}
+		if(assignment.type != Ast_Assignment_Type::Assignment) {
+			auto specialization = logo::specialize_compound_assignment(assignment.type,target_lvalue.type,rvalue_value.type);
+			if(specialization != cache.specialization && !context->is_parallel_worker) logo::update_operation_cache(&cache,specialization);
+		}
+		return logo::compute_assignment(assignment.type,&target_lvalue,rvalue_value,assignment.line_index);
+	}
+
+	[[nodiscard]] static bool check_lvalue(const Ast_Assignment& assignment,const Interpreter_Value& lvalue_value) {
+		if(lvalue_value.type != Interpreter_Value_Type::Lvalue) {
+			logo::report_interpreter_error(assignment.line_index,"Cannot assign a value to a non-lvalue.");
+			return false;
+		}
+		return true;
+	}
 
-					auto func_result = logo::interpret_ast(context,function.body_statements,true,false);
+	[[nodiscard]] static bool check_condition(const Ast_Statement& statement,const Interpreter_Value& condition) {
+		if(condition.type != Interpreter_Value_Type::Bool) {
+			if(statement.type == Ast_Statement_Type::If_Statement) logo::report_interpreter_error(statement.line_index,"Condition in a 'if' statement must be of type 'Bool'.");
+			else logo::report_interpreter_error(statement.line_index,"Condition in a 'while' statement must be of type 'Bool'.");
+			return false;
+		}
+		return true;
+	}
 
-					context->current_function_scope_first_var_index = copy_var_index;
-					context->functions.length = func_count;
-					context->variables.length = var_count;
+	[[nodiscard]] static bool enter_if_statement_branch(Interpreter_State* state,const Ast_Statement& statement,bool condition) {
+		const auto& statements = condition ? statement.if_statement.if_true_statements : statement.if_statement.if_false_statements;
+		if(statements.length == 0) return true;
+		return logo::push_statements_frame(state,Interpreter_Frame_Type::Scope,{statements.data,statements.length});
+	}
 
-					if(func_result.status == Interpreter_Status::Error) {};
-					if(func_result.status == Interpreter_Status::Function_Return) {
-						return func_result.value;
+	[[nodiscard]] static bool execute_statement(Interpreter_State* state,const Ast_Statement& statement) {
+		auto* context = state->context;
+		switch(statement.type) {
+			case Ast_Statement_Type::Expression: {
+				if(statement.expression.contains_function_call) {
+					if(!logo::push_statement_frame(state,Interpreter_Frame_Type::Expression_Statement,statement)) return false;
+					std::size_t frame_count = state->frames.length;
+					if(!logo::compute_expression_on_stack(state,statement.expression,false)) return false;
+					//Calls to builtin functions don't enter any frames, so the statement is done already.
+					if(state->frames.length == frame_count) {
+						state->frames.length -= 1;
+						state->values.length -= 1;
 					}
-					logo::assert(func_result.status != Interpreter_Status::Success);
+					return true;
 				}
-				if(function_overload_exist) logo::report_interpreter_error(expression.function_call->line_index,"Function '%' does not take % arguments.",expression.function_call->name,arg_values.length);
-				else logo::report_interpreter_error(expression.function_call->line_index,"Function '%' does not exist.",expression.function_call->name);
-				return {};
+				auto [value,success] = logo::compute_expression(context,statement.expression);
+				return success;
 			}
-			case Ast_Expression_Type::Array_Access: {
-				logo::report_interpreter_error(expression.array_access->line_index,"Arrays are not yet implemented.");
-				return {};
+			case Ast_Statement_Type::Declaration: {
+				if(statement.declaration.initial_value_expr.contains_function_call) {
+					if(!logo::push_statement_frame(state,Interpreter_Frame_Type::Declaration,statement)) return false;
+					return logo::compute_expression_on_stack(state,statement.declaration.initial_value_expr,true);
+				}
+				auto [value,success] = logo::compute_rvalue_expression(context,statement.declaration.initial_value_expr);
+				if(!success) return false;
+
+				if(value.type == Interpreter_Value_Type::Void) {
+					logo::report_interpreter_error(statement.line_index,"Cannot assign value of type 'Void' to '%'.",logo::get_symbol_name(statement.declaration.name));
+					return false;
+				}
+				return logo::push_variable(context,statement.declaration.name,value);
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				//Every function is defined by 'define_functions' before the program starts.
+				return true;
+			}
+			case Ast_Statement_Type::Assignment: {
+				const auto& assignment = statement.assignment;
+				if(assignment.lvalue_expr.contains_function_call) {
+					if(!logo::push_statement_frame(state,Interpreter_Frame_Type::Assignment,statement,Interpreter_Frame_Phase::Assignment_Target)) return false;
+					return logo::compute_expression_on_stack(state,assignment.lvalue_expr,false);
+				}
+				auto [lvalue_value,success0] = logo::compute_expression(context,assignment.lvalue_expr);
+				if(!success0) return false;
+				if(!logo::check_lvalue(assignment,lvalue_value)) return false;
+
+				if(assignment.rvalue_expr.contains_function_call) {
+					if(!logo::push_value(state,lvalue_value)) return false;
+					if(!logo::push_statement_frame(state,Interpreter_Frame_Type::Assignment,statement,Interpreter_Frame_Phase::Assignment_Value)) return false;
+					return logo::compute_expression_on_stack(state,assignment.rvalue_expr,true);
+				}
+				auto [rvalue_value,success1] = logo::compute_rvalue_expression(context,assignment.rvalue_expr);
+				if(!success1) return false;
+				return logo::execute_assignment(context,assignment,lvalue_value,rvalue_value);
+			}
+			case Ast_Statement_Type::If_Statement: {
+				if(statement.if_statement.condition_expr.contains_function_call) {
+					if(!logo::push_statement_frame(state,Interpreter_Frame_Type::If_Statement,statement)) return false;
+					return logo::compute_expression_on_stack(state,statement.if_statement.condition_expr,true);
+				}
+				auto [condition,success] = logo::compute_rvalue_expression(context,statement.if_statement.condition_expr);
+				if(!success) return false;
+				if(!logo::check_condition(statement,condition)) return false;
+				return logo::enter_if_statement_branch(state,statement,condition.bool_v);
+			}
+			case Ast_Statement_Type::While_Statement: {
+				if(!logo::push_statement_frame(state,Interpreter_Frame_Type::While_Statement,statement,Interpreter_Frame_Phase::Loop_Condition)) return false;
+				return logo::push_expression_frame(state,statement.while_statement.condition_expr,true);
+			}
+			case Ast_Statement_Type::For_Statement: {
+				if(!logo::push_statement_frame(state,Interpreter_Frame_Type::For_Statement,statement,Interpreter_Frame_Phase::For_Start)) return false;
+				return logo::push_expression_frame(state,statement.for_statement.start_expr,true);
+			}
+			case Ast_Statement_Type::Break_Statement:
+			case Ast_Statement_Type::Continue_Statement: {
+				logo::unwind_to_loop(state);
+				auto& loop_frame = state->frames[state->frames.length - 1];
+				loop_frame.phase = (statement.type == Ast_Statement_Type::Break_Statement) ? Interpreter_Frame_Phase::Loop_Break : Interpreter_Frame_Phase::Loop_Body;
+				return true;
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				const auto& return_statement = statement.return_statement;
+				Interpreter_Value result{};
+				result.type = Interpreter_Value_Type::Void;
+				if(return_statement.return_value) {
+					if(return_statement.return_value->contains_function_call) {
+						if(!logo::push_statement_frame(state,Interpreter_Frame_Type::Return_Statement,statement)) return false;
+						return logo::compute_expression_on_stack(state,*return_statement.return_value,true);
+					}
+					auto [value,success] = logo::compute_rvalue_expression(context,*return_statement.return_value);
+					if(!success) return false;
+					result = value;
+				}
+				return logo::return_from_function(state,result);
 			}
 			default: logo::unreachable();
 		}
 	}
 
-	[[nodiscard]] static Interpreter_Result interpret_ast(Interpreter_Context* context,Array_View<Ast_Statement> statements,bool is_function_scope,bool inside_loop) {
-		for(const auto& statement : statements) {
-			switch(statement.type) {
-				case Ast_Statement_Type::Expression: {
-					auto [value,success] = logo::compute_expression(context,statement.expression);
-					if(!success) return Interpreter_Status::Error;
-					break;
-				}
-				case Ast_Statement_Type::Declaration: {
-					for(std::size_t i = context->current_function_scope_first_var_index;i < context->variables.length;i += 1) {
-						const auto& var = context->variables[i];
-						if(std::strcmp(var.name.begin_ptr,statement.declaration.name.begin_ptr) == 0) {
-							logo::report_interpreter_error(statement.line_index,"Variable '%' has already been defined.",statement.declaration.name);
-							return Interpreter_Status::Error;
-						}
-					}
-
-					Interpreter_Variable variable{};
-					variable.name = statement.declaration.name;
-					context->generation_counter += 1;
-					variable.generation = context->generation_counter;
-					auto [value,success] = logo::compute_expression(context,statement.declaration.initial_value_expr);
-					if(!success) return Interpreter_Status::Error;
+	//Leaves the scope of a loop body unless the optimizer marked it as unnecessary.
+	static void leave_loop_body(Interpreter_State* state,const Interpreter_Frame& frame) {
+		bool skip_scope = (frame.type == Interpreter_Frame_Type::While_Statement) ? frame.statement->while_statement.skip_scope : frame.statement->for_statement.skip_scope;
+		if(!skip_scope) state->context->variables.length = frame.var_count;
+	}
 
-					if(value.type == Interpreter_Value_Type::Void) {
-						logo::report_interpreter_error(statement.line_index,"Cannot assign value of type 'Void' to '%'.",statement.declaration.name);
-						return Interpreter_Status::Error;
-					}
-					if(value.type == Interpreter_Value_Type::Lvalue) {
-						Interpreter_Value copy = value;
-						value = context->variables[copy.lvalue_v.var_index].value;
-					}
-					variable.value = value;
+	[[nodiscard]] static bool enter_loop_body(Interpreter_State* state,std::size_t frame_index,const Heap_Array<Ast_Statement>& body_statements) {
+		auto& frame = state->frames[frame_index];
+		frame.phase = Interpreter_Frame_Phase::Loop_Body;
+		frame.var_count = state->context->variables.length;
+		return logo::push_statements_frame(state,Interpreter_Frame_Type::Statements,{body_statements.data,body_statements.length});
+	}
 
-					if(!context->variables.push_back(variable)) {
-						Report_Error("Couldn't allocate % bytes of memory.",sizeof(variable));
-						return Interpreter_Status::Error;
-					}
-					break;
+	[[nodiscard]] static bool execute_while_statement(Interpreter_State* state) {
+		std::size_t frame_index = state->frames.length - 1;
+		auto& frame = state->frames[frame_index];
+		const auto& statement = *frame.statement;
+		switch(frame.phase) {
+			case Interpreter_Frame_Phase::Loop_Condition: {
+				auto condition = logo::pop_value(state);
+				if(!logo::check_condition(statement,condition)) return false;
+				if(!condition.bool_v) {
+					state->frames.length -= 1;
+					return true;
 				}
-				case Ast_Statement_Type::Function_Definition: {
-					Interpreter_Function function{};
-					function.name = statement.function_definition.name;
-					function.arguments = Array_View<String_View>(statement.function_definition.function_arguments.data,statement.function_definition.function_arguments.length);
-					function.body_statements = Array_View<Ast_Statement>(statement.function_definition.body_statements.data,statement.function_definition.body_statements.length);
-
-					if(!context->functions.push_back(function)) {
-						Report_Error("Couldn't allocate % bytes of memory.",sizeof(function));
-						return Interpreter_Status::Error;
-					}
-					break;
+				return logo::enter_loop_body(state,frame_index,statement.while_statement.body_statements);
+			}
+			case Interpreter_Frame_Phase::Loop_Body: {
+				logo::leave_loop_body(state,frame);
+				if(!logo::count_watchdog_step(state->context,statement.line_index)) return false;
+				const auto& condition_expr = statement.while_statement.condition_expr;
+				if(condition_expr.contains_function_call) {
+					frame.phase = Interpreter_Frame_Phase::Loop_Condition;
+					return logo::compute_expression_on_stack(state,condition_expr,true);
 				}
-				case Ast_Statement_Type::Assignment: {
-					auto [lvalue_value,success0] = logo::compute_expression(context,statement.assignment.lvalue_expr);
-					if(!success0) return Interpreter_Status::Error;
-
-					if(lvalue_value.type != Interpreter_Value_Type::Lvalue) {
-						logo::report_interpreter_error(statement.assignment.line_index,"Cannot assign a value to a non-lvalue.");
-						return Interpreter_Status::Error;
-					}
-
-					auto [rvalue_value,success1] = logo::compute_expression(context,statement.assignment.rvalue_expr);
-					if(!success1) return Interpreter_Status::Error;
-
-					if(rvalue_value.type == Interpreter_Value_Type::Void) {
-						logo::report_interpreter_error(statement.assignment.line_index,"Cannot assign value of type 'Void'.");
-						return Interpreter_Status::Error;
-					}
-					if(rvalue_value.type == Interpreter_Value_Type::Lvalue) {
-						Interpreter_Value copy = rvalue_value;
-						rvalue_value = context->variables[copy.lvalue_v.var_index].value;
-					}
-
-					auto& target_lvalue = context->variables[lvalue_value.lvalue_v.var_index].value;
-					if(statement.assignment.type == Ast_Assignment_Type::Assignment) {
-						target_lvalue = rvalue_value;
-					}
-					else if(target_lvalue.type == Interpreter_Value_Type::Int && rvalue_value.type == Interpreter_Value_Type::Int) {
-						target_lvalue.type = Interpreter_Value_Type::Int;
-						target_lvalue.int_v = logo::compute_compound_assignment_operation(statement.assignment.type,target_lvalue.int_v,rvalue_value.int_v);
-					}
-					else if(target_lvalue.type == Interpreter_Value_Type::Float && rvalue_value.type == Interpreter_Value_Type::Float) {
-						target_lvalue.type = Interpreter_Value_Type::Float;
-						target_lvalue.float_v = logo::compute_compound_assignment_operation(statement.assignment.type,target_lvalue.float_v,rvalue_value.float_v);
-					}
-					else if(target_lvalue.type == Interpreter_Value_Type::Int && rvalue_value.type == Interpreter_Value_Type::Float) {
-						target_lvalue.type = Interpreter_Value_Type::Float;
-						target_lvalue.float_v = logo::compute_compound_assignment_operation(statement.assignment.type,static_cast<double>(target_lvalue.int_v),rvalue_value.float_v);
-					}
-					else if(target_lvalue.type == Interpreter_Value_Type::Float && rvalue_value.type == Interpreter_Value_Type::Int) {
-						target_lvalue.type = Interpreter_Value_Type::Float;
-						target_lvalue.float_v = logo::compute_compound_assignment_operation(statement.assignment.type,target_lvalue.float_v,static_cast<double>(rvalue_value.int_v));
-					}
-					else {
-						logo::report_interpreter_error(statement.assignment.line_index,"Cannot perform compound assignment if the type of the variable being assigned to and the type of the expression on the right are not 'Int' or 'Float'.");
-						return Interpreter_Status::Error;
-					}
-					break;
+				auto [condition,success] = logo::compute_rvalue_expression(state->context,condition_expr);
+				if(!success) return false;
+				if(!logo::check_condition(statement,condition)) return false;
+				if(!condition.bool_v) {
+					state->frames.length -= 1;
+					return true;
 				}
-				case Ast_Statement_Type::If_Statement: {
-					auto [condition_expr,success] = logo::compute_expression(context,statement.if_statement.condition_expr);
-					if(!success) return Interpreter_Status::Error;
-
-					if(condition_expr.type != Interpreter_Value_Type::Bool) {
-						logo::report_interpreter_error(statement.line_index,"Condition in a 'if' statement must be of type 'Bool'.");
-						return Interpreter_Status::Error;
-					}
-
-					std::size_t var_count = context->variables.length;
-					std::size_t func_count = context->functions.length;
-
-					Interpreter_Result result{Interpreter_Status::Error};
-					if(condition_expr.bool_v && statement.if_statement.if_true_statements.length > 0) {
-						result = logo::interpret_ast(context,{statement.if_statement.if_true_statements.data,statement.if_statement.if_true_statements.length},false,inside_loop);
-						if(result.status == Interpreter_Status::Error) return Interpreter_Status::Error;
-					}
-					else if(!condition_expr.bool_v && statement.if_statement.if_false_statements.length > 0) {
-						result = logo::interpret_ast(context,{statement.if_statement.if_false_statements.data,statement.if_statement.if_false_statements.length},false,inside_loop);
-						if(result.status == Interpreter_Status::Error) return Interpreter_Status::Error;
-					}
-
-					context->functions.length = func_count;
-					context->variables.length = var_count;
+				return logo::push_statements_frame(state,Interpreter_Frame_Type::Statements,{statement.while_statement.body_statements.data,statement.while_statement.body_statements.length});
+			}
+			case Interpreter_Frame_Phase::Loop_Break: {
+				logo::leave_loop_body(state,frame);
+				state->frames.length -= 1;
+				return true;
+			}
+			default: logo::unreachable();
+		}
+	}
 
-					if(result.status == Interpreter_Status::Function_Return) return result;
-					if(result.status == Interpreter_Status::Break) return Interpreter_Status::Break;
-					if(result.status == Interpreter_Status::Continue) return Interpreter_Status::Continue;
-					break;
-				}
-				case Ast_Statement_Type::While_Statement: {
-					auto condition_expr_option = logo::compute_expression(context,statement.while_statement.condition_expr);
-					if(!condition_expr_option.has_value) return Interpreter_Status::Error;
+	[[nodiscard]] static bool execute_frame(Interpreter_State* state);
+
+	static constexpr std::size_t MAX_PARALLEL_LOOP_THREAD_COUNT = 64;
+	//A thread that runs iterations of a parallel loop. It has its own variables, functions and call stack, only the pixels of the canvas are shared.
+	struct Interpreter_Parallel_Worker {
+		Interpreter_State state;
+		Interpreter_Context context;
+		Array_String<2048> error_message;
+		std::uint64_t random_seed;
+		std::int64_t failed_iteration; //The first iteration that failed on this thread or the maximum of 'std::int64_t'.
+		bool has_stopped; //The iteration that failed went over one of the limits of the watchdog.
+		bool is_initialized; //Every thread copies the context when it gets its first iterations, the threads that don't get any skip that.
+		void destroy() {
+			state.destroy();
+			for(auto& function : context.functions) function.memo_table.destroy();
+			context.parallel_loop_turtles.destroy();
+			context.dynamic_scope.destroy();
+			context.functions.destroy();
+			context.variables.destroy();
+		}
+	};
+	struct Interpreter_Parallel_Loop {
+		const Interpreter_State* state; //State of the thread that runs the script, it isn't touched until the loop ends.
+		const Ast_Statement* statement;
+		Interpreter_Parallel_Worker* workers;
+		std::size_t iterator_var_index;
+		std::size_t var_count; //Variables at the start of every iteration, the iterator and the induction variables are the last ones.
+		const Interpreter_Value* induction_variable_steps;
+		std::int64_t first_iteration;
+		std::atomic<std::int64_t> failed_iteration; //The first iteration that failed on any thread, the iterations after it are skipped.
+		std::atomic<std::size_t> step_count;
+	};
 
-					if(condition_expr_option.value.type != Interpreter_Value_Type::Bool) {
-						logo::report_interpreter_error(statement.line_index,"Condition in a 'while' statement must be of type 'Bool'.");
-						return Interpreter_Status::Error;
-					}
+	[[nodiscard]] static bool init_parallel_worker(Interpreter_Parallel_Loop* loop,Interpreter_Parallel_Worker* worker) {
+		const auto* main_context = loop->state->context;
+		auto* context = &worker->context;
+		context->random_engine = std::mt19937_64(worker->random_seed);
+		context->random_dist_0_1 = main_context->random_dist_0_1;
+		if(!context->variables.reserve(main_context->variables.capacity)) {
+			Report_Error("Couldn't allocate % bytes of memory.",main_context->variables.capacity * sizeof(Interpreter_Variable));
+			return false;
+		}
+		for(std::size_t i = 0;i < loop->var_count;i += 1) context->variables.data[i] = main_context->variables[i];
+		context->variables.length = loop->var_count;
+		if(!context->functions.reserve(main_context->functions.length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",main_context->functions.length * sizeof(Interpreter_Function));
+			return false;
+		}
+		for(std::size_t i = 0;i < main_context->functions.length;i += 1) {
+			auto& function = context->functions.data[i];
+			function = main_context->functions[i];
+			function.jit_function_index = 0; //The machine code belongs to the JIT of the thread that runs the script.
+			function.memo_table = {};
+		}
+		context->functions.length = main_context->functions.length;
+		if(!context->dynamic_scope.reserve(main_context->dynamic_scope.capacity)) {
+			Report_Error("Couldn't allocate % bytes of memory.",main_context->dynamic_scope.capacity * sizeof(std::size_t));
+			return false;
+		}
+		for(std::size_t i = 0;i < main_context->dynamic_scope.length;i += 1) context->dynamic_scope.data[i] = main_context->dynamic_scope[i];
+		context->dynamic_scope.length = main_context->dynamic_scope.length;
+		if(!context->parallel_loop_turtles.push_back(main_context->parallel_loop_turtles[0])) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Turtle));
+			return false;
+		}
+		context->generation_counter = main_context->generation_counter;
+		context->canvas = main_context->canvas;
+		context->print_symbol = main_context->print_symbol;
+		context->parallel_loop_var_count = main_context->parallel_loop_var_count;
+		context->is_parallel_worker = true;
+		context->watchdog = main_context->watchdog;
+		context->watchdog.limits.canvas_path = nullptr; //The canvas is saved by the thread that runs the script once every thread has finished drawing.
+		context->watchdog.shared_step_count = &loop->step_count;
+		//The first step checks the limits, which starts the countdown of the thread.
+		context->watchdog.countdown_length = 1;
+		context->watchdog.countdown = 1;
+
+		worker->state.context = context;
+		worker->state.max_stack_size = loop->state->max_stack_size;
+		worker->state.jit.is_enabled = loop->state->jit.is_enabled;
+		worker->is_initialized = true;
+		return true;
+	}
 
-					while(condition_expr_option.value.bool_v) {
-						std::size_t var_count = context->variables.length;
-						std::size_t func_count = context->functions.length;
+	[[nodiscard]] static bool run_parallel_iteration(const Interpreter_Parallel_Loop* loop,Interpreter_Parallel_Worker* worker,std::int64_t iteration) {
+		auto* state = &worker->state;
+		auto* context = &worker->context;
+		const auto& statement = *loop->statement;
+		const auto& for_statement = statement.for_statement;
+		state->frames.length = 0;
+		state->values.length = 0;
+		//An iteration that failed could have left the thread inside of a function.
+		context->current_function_scope_first_var_index = loop->state->context->current_function_scope_first_var_index;
+		context->variables.length = loop->var_count;
+		context->dynamic_scope.length = loop->state->context->dynamic_scope.length;
+		context->variables[loop->iterator_var_index].value.int_v = iteration;
+		for(std::size_t j = 0;j < for_statement.induction_variables.length;j += 1) {
+			context->variables[loop->iterator_var_index + 1 + j].value.int_v = iteration * loop->induction_variable_steps[j].int_v;
+		}
+		context->canvas.set_turtle(context->parallel_loop_turtles[0]);
+		context->canvas.draw_order = static_cast<std::uint64_t>(iteration - loop->first_iteration) + 1;
+		if(!logo::count_watchdog_step(context,statement.line_index)) return false;
+
+		Interpreter_Frame frame{};
+		frame.type = Interpreter_Frame_Type::Parallel_Iteration;
+		frame.var_count = loop->var_count;
+		if(!logo::push_frame(state,frame)) return false;
+		if(!logo::push_statements_frame(state,Interpreter_Frame_Type::Statements,{for_statement.body_statements.data,for_statement.body_statements.length})) return false;
+		while(state->frames.length > 0) {
+			if(!logo::execute_frame(state)) return false;
+		}
+		return true;
+	}
 
-						auto result = logo::interpret_ast(context,{statement.while_statement.body_statements.data,statement.while_statement.body_statements.length},false,true);
-						if(result.status == Interpreter_Status::Error) return Interpreter_Status::Error;
+	static void run_parallel_iterations(void* data,std::size_t thread_index,std::int64_t begin,std::int64_t end) {
+		auto* loop = static_cast<Interpreter_Parallel_Loop*>(data);
+		auto* worker = &loop->workers[thread_index];
+		logo::redirect_reported_errors(&worker->error_message);
+		defer[&]{logo::redirect_reported_errors(nullptr);};
+		for(std::int64_t iteration = begin;iteration < end;iteration += 1) {
+			if(iteration > loop->failed_iteration.load(std::memory_order_relaxed)) return;
+			std::size_t error_byte_length = worker->error_message.byte_length;
+			if((worker->is_initialized || logo::init_parallel_worker(loop,worker)) && logo::run_parallel_iteration(loop,worker,iteration)) continue;
+
+			//Only the error of the first iteration that failed is reported, the same one as when the loop runs on one thread.
+			if(iteration < worker->failed_iteration) {
+				Array_String<2048> error_message{};
+				error_message.append(String_View(worker->error_message.buffer + error_byte_length,worker->error_message.byte_length - error_byte_length));
+				worker->error_message = error_message;
+				worker->failed_iteration = iteration;
+				worker->has_stopped = worker->context.watchdog.has_stopped;
+			}
+			else worker->error_message.byte_length = error_byte_length;
+			worker->context.watchdog.has_stopped = false;
+			auto failed_iteration = loop->failed_iteration.load(std::memory_order_relaxed);
+			while(iteration < failed_iteration && !loop->failed_iteration.compare_exchange_weak(failed_iteration,iteration,std::memory_order_relaxed)) {}
+			return;
+		}
+	}
 
-						context->functions.length = func_count;
-						context->variables.length = var_count;
+	//Parallel loops nested in the iterations of another parallel loop run on the thread of the outer iteration.
+	[[nodiscard]] static bool can_run_in_parallel(const Interpreter_State* state,std::int64_t begin,std::int64_t end) {
+		if(!state->use_threads || state->context->parallel_loop_turtles.length != 1 || begin >= end) return false;
+		if(static_cast<std::uint64_t>(end) - static_cast<std::uint64_t>(begin) > MAX_DRAW_ORDER) return false;
+		return logo::get_hardware_thread_count() > 1;
+	}
 
-						if(result.status == Interpreter_Status::Function_Return) return result;
-						if(result.status == Interpreter_Status::Break) break;
+	//Runs the iterations of the parallel loop in 'frame' from 'begin' to 'end' on the threads of the pool. The pixels are drawn in the order of the iterations,
+	//whichever thread gets to them first, so the canvas ends up the same as when the loop runs on one thread.
+	[[nodiscard]] static bool run_parallel_for_statement(Interpreter_State* state,const Interpreter_Frame& frame,std::int64_t begin,std::int64_t end) {
+		auto* context = state->context;
+		if(!context->thread_pool) {
+			context->thread_pool = logo::create_thread_pool(std::min(logo::get_hardware_thread_count(),MAX_PARALLEL_LOOP_THREAD_COUNT));
+			if(!context->thread_pool) return false;
+		}
+		std::size_t thread_count = logo::get_thread_count(context->thread_pool);
+		auto* workers = new(std::nothrow) Interpreter_Parallel_Worker[thread_count]();
+		if(!workers) {
+			Report_Error("Couldn't allocate % bytes of memory.",thread_count * sizeof(Interpreter_Parallel_Worker));
+			return false;
+		}
+		defer[&]{
+			for(std::size_t i = 0;i < thread_count;i += 1) workers[i].destroy();
+			delete[] workers;
+		};
+		for(std::size_t i = 0;i < thread_count;i += 1) {
+			workers[i].random_seed = context->random_engine();
+			workers[i].failed_iteration = std::numeric_limits<std::int64_t>::max();
+		}
+		if(!context->canvas.begin_parallel_drawing()) return false;
+
+		auto& watchdog = context->watchdog;
+		Interpreter_Parallel_Loop loop{};
+		loop.state = state;
+		loop.statement = frame.statement;
+		loop.workers = workers;
+		loop.iterator_var_index = frame.index;
+		loop.var_count = frame.var_count;
+		loop.induction_variable_steps = state->values.data + frame.length + 2;
+		loop.first_iteration = begin;
+		loop.failed_iteration = std::numeric_limits<std::int64_t>::max();
+		loop.step_count = watchdog.step_count + (watchdog.countdown_length - watchdog.countdown);
+		logo::run_thread_pool(context->thread_pool,begin,end,&loop,logo::run_parallel_iterations);
+		context->canvas.end_parallel_drawing();
+
+		std::size_t step_count = loop.step_count.load(std::memory_order_relaxed);
+		const Interpreter_Parallel_Worker* failed_worker = nullptr;
+		for(std::size_t i = 0;i < thread_count;i += 1) {
+			const auto& worker = workers[i];
+			if(worker.failed_iteration != std::numeric_limits<std::int64_t>::max() && (!failed_worker || worker.failed_iteration < failed_worker->failed_iteration)) failed_worker = &worker;
+			if(!worker.is_initialized) continue;
+			step_count += worker.context.watchdog.countdown_length - worker.context.watchdog.countdown;
+			context->statistics.memo_hit_count += worker.context.statistics.memo_hit_count;
+			context->statistics.memo_miss_count += worker.context.statistics.memo_miss_count;
+		}
+		//The calls made by the threads count towards compiling the functions for the rest of the script.
+		for(std::size_t i = 0;i < context->functions.length;i += 1) {
+			auto& function = context->functions[i];
+			std::size_t call_count = function.call_count;
+			for(std::size_t j = 0;j < thread_count;j += 1) {
+				if(workers[j].is_initialized) call_count += workers[j].context.functions[i].call_count - function.call_count;
+			}
+			function.call_count = call_count;
+		}
+		//The next step checks the limits with the steps made by every thread.
+		watchdog.step_count = step_count;
+		watchdog.countdown_length = 1;
+		watchdog.countdown = 1;
+
+		if(failed_worker) {
+			if(failed_worker->has_stopped) {
+				watchdog.has_stopped = true;
+				if(watchdog.limits.canvas_path && !context->canvas.save_as_bitmap(String_View(watchdog.limits.canvas_path))) return false;
+			}
+			logo::format_into(logo::write_char32_t_to_error_message,"%",String_View(failed_worker->error_message.buffer,failed_worker->error_message.byte_length));
+			return false;
+		}
+		return true;
+	}
 
-						condition_expr_option = logo::compute_expression(context,statement.while_statement.condition_expr);
-						if(!condition_expr_option.has_value) return Interpreter_Status::Error;
-					}
-					break;
+	//The iteration counter, the upper bound and the steps of the induction variables stay on the value stack until the loop ends.
+	//The first iteration of a parallel loop runs on the thread of the script, so that the caches in the AST are filled before the other threads only read them.
+	[[nodiscard]] static bool execute_for_statement(Interpreter_State* state) {
+		auto* context = state->context;
+		std::size_t frame_index = state->frames.length - 1;
+		auto& frame = state->frames[frame_index];
+		const auto& statement = *frame.statement;
+		const auto& for_statement = statement.for_statement;
+		switch(frame.phase) {
+			case Interpreter_Frame_Phase::For_Start: {
+				const auto& lower_bound_value = state->values[state->values.length - 1];
+				if(lower_bound_value.type != Interpreter_Value_Type::Int) {
+					logo::report_interpreter_error(statement.line_index,"Starting index in a 'for' loop must be an integer.");
+					return false;
 				}
-				case Ast_Statement_Type::For_Statement: {
-					auto [lower_bound_value,success0] = logo::compute_expression(context,statement.for_statement.start_expr);
-					if(!success0) return Interpreter_Status::Error;
-					if(lower_bound_value.type == Interpreter_Value_Type::Lvalue) {
-						Interpreter_Value copy = lower_bound_value;
-						lower_bound_value = context->variables[copy.lvalue_v.var_index].value;
-					}
-					if(lower_bound_value.type != Interpreter_Value_Type::Int) {
-						logo::report_interpreter_error(statement.line_index,"Starting index in a 'for' loop must be an integer.");
-						return Interpreter_Status::Error;
-					}
-
-					auto [upper_bound_value,success1] = logo::compute_expression(context,statement.for_statement.end_expr);
-					if(!success1) return Interpreter_Status::Error;
-					if(upper_bound_value.type == Interpreter_Value_Type::Lvalue) {
-						Interpreter_Value copy = upper_bound_value;
-						upper_bound_value = context->variables[copy.lvalue_v.var_index].value;
+				frame.phase = Interpreter_Frame_Phase::For_End;
+				return logo::push_expression_frame(state,for_statement.end_expr,true);
+			}
+			case Interpreter_Frame_Phase::For_End: {
+				const auto& upper_bound_value = state->values[state->values.length - 1];
+				if(upper_bound_value.type != Interpreter_Value_Type::Int) {
+					logo::report_interpreter_error(statement.line_index,"Ending index in a 'for' loop must be an integer.");
+					return false;
+				}
+				const auto& lower_bound_value = state->values[state->values.length - 2];
+				if(lower_bound_value.int_v >= upper_bound_value.int_v) {
+					state->values.length -= 2;
+					state->frames.length -= 1;
+					return true;
+				}
+				frame.length = state->values.length - 2;
+				frame.index = context->variables.length;
+				frame.phase = Interpreter_Frame_Phase::For_Induction_Variable;
+				if(!logo::push_variable(context,for_statement.iterator_identifier,lower_bound_value)) return false;
+				break;
+			}
+			case Interpreter_Frame_Phase::For_Induction_Variable: {
+				//The optimizer only creates induction variables with integer steps.
+				const auto& step_value = state->values[state->values.length - 1];
+				logo::assert(step_value.type == Interpreter_Value_Type::Int);
+
+				std::size_t induction_variable_index = state->values.length - frame.length - 3;
+				Interpreter_Value value{};
+				value.type = Interpreter_Value_Type::Int;
+				value.int_v = state->values[frame.length].int_v * step_value.int_v;
+				if(!logo::push_variable(context,for_statement.induction_variables[induction_variable_index].name,value)) return false;
+				break;
+			}
+			case Interpreter_Frame_Phase::Loop_Body: {
+				logo::leave_loop_body(state,frame);
+				if(!logo::count_watchdog_step(context,statement.line_index)) return false;
+				auto& counter = state->values[frame.length].int_v;
+				if(for_statement.is_parallel) {
+					logo::next_parallel_loop_iteration(context);
+					auto upper_bound = state->values[frame.length + 1].int_v;
+					if(logo::can_run_in_parallel(state,counter + 1,upper_bound)) {
+						if(!logo::run_parallel_for_statement(state,frame,counter + 1,upper_bound)) return false;
+						counter = upper_bound - 1;
 					}
-					if(upper_bound_value.type != Interpreter_Value_Type::Int) {
-						logo::report_interpreter_error(statement.line_index,"Ending index in a 'for' loop must be an integer.");
-						return Interpreter_Status::Error;
+				}
+				counter += 1;
+				if(counter < state->values[frame.length + 1].int_v) {
+					context->variables[frame.index].value.int_v += 1;
+					for(std::size_t j = 0;j < for_statement.induction_variables.length;j += 1) {
+						context->variables[frame.index + 1 + j].value.int_v += state->values[frame.length + 2 + j].int_v;
 					}
+					return logo::push_statements_frame(state,Interpreter_Frame_Type::Statements,{for_statement.body_statements.data,for_statement.body_statements.length});
+				}
+				context->variables.pop_back(1 + for_statement.induction_variables.length);
+				if(for_statement.is_parallel) logo::leave_parallel_loop(context);
+				state->values.length = frame.length;
+				state->frames.length -= 1;
+				return true;
+			}
+			case Interpreter_Frame_Phase::Loop_Break: {
+				logo::leave_loop_body(state,frame);
+				context->variables.pop_back(1 + for_statement.induction_variables.length);
+				state->values.length = frame.length;
+				state->frames.length -= 1;
+				return true;
+			}
+			default: logo::unreachable();
+		}
 
-					if(lower_bound_value.int_v < upper_bound_value.int_v) {
-						Interpreter_Variable iterator_variable{};
-						iterator_variable.name = statement.for_statement.iterator_identifier;
-						context->generation_counter += 1;
-						iterator_variable.generation = context->generation_counter;
-						iterator_variable.value = lower_bound_value;
-
-						if(!context->variables.push_back(iterator_variable)) {
-							Report_Error("Couldn't allocate % bytes of memory.",sizeof(iterator_variable));
-							return Interpreter_Status::Error;
-						}
-						std::size_t iterator_var_index = context->variables.length - 1;
-
-						for(std::int64_t i = lower_bound_value.int_v;i < upper_bound_value.int_v;i += 1) {
-							std::size_t var_count = context->variables.length;
-							std::size_t func_count = context->functions.length;
-
-							auto result = logo::interpret_ast(context,{statement.for_statement.body_statements.data,statement.for_statement.body_statements.length},false,true);
-							if(result.status == Interpreter_Status::Error) return Interpreter_Status::Error;
-
-							context->functions.length = func_count;
-							context->variables.length = var_count;
-
-							if(result.status == Interpreter_Status::Function_Return) return result;
-							if(result.status == Interpreter_Status::Break) break;
+		//The step of the next induction variable is computed after the previous one is declared.
+		std::size_t induction_variable_count = state->values.length - frame.length - 2;
+		if(induction_variable_count < for_statement.induction_variables.length) {
+			return logo::push_expression_frame(state,for_statement.induction_variables[induction_variable_count].step_expr,true);
+		}
+		if(for_statement.is_parallel && !logo::enter_parallel_loop(context)) return false;
+		return logo::enter_loop_body(state,frame_index,for_statement.body_statements);
+	}
 
-							context->variables[iterator_var_index].value.int_v += 1;
-						}
-						context->variables.pop_back();
-					}
-					break;
+	[[nodiscard]] static bool execute_frame(Interpreter_State* state) {
+		auto* context = state->context;
+		auto& frame = state->frames[state->frames.length - 1];
+		switch(frame.type) {
+			case Interpreter_Frame_Type::Statements:
+			case Interpreter_Frame_Type::Scope:
+			case Interpreter_Frame_Type::Function_Body: {
+				if(frame.index < frame.length) {
+					const auto& statement = frame.statements[frame.index];
+					frame.index += 1;
+					return logo::execute_statement(state,statement);
 				}
-				case Ast_Statement_Type::Break_Statement: {
-					return Interpreter_Status::Break;
+				if(frame.type == Interpreter_Frame_Type::Function_Body) {
+					Interpreter_Value result{};
+					result.type = Interpreter_Value_Type::Void;
+					return logo::return_from_function(state,result);
 				}
-				case Ast_Statement_Type::Continue_Statement: {
-					return Interpreter_Status::Continue;
+				if(frame.type == Interpreter_Frame_Type::Scope) context->variables.length = frame.var_count;
+				state->frames.length -= 1;
+				return true;
+			}
+			case Interpreter_Frame_Type::Expression: {
+				const auto& expression = *frame.expression;
+				bool is_rvalue = frame.is_rvalue;
+				state->frames.length -= 1;
+				return logo::compute_expression_on_stack(state,expression,is_rvalue);
+			}
+			case Interpreter_Frame_Type::Unary_Operator: {
+				const auto* unary_operator = frame.unary_operator;
+				bool is_rvalue = frame.is_rvalue;
+				state->frames.length -= 1;
+				auto [value,success] = logo::compute_unary_operator(context,*unary_operator,logo::pop_value(state));
+				if(!success) return false;
+				return logo::push_value(state,is_rvalue ? logo::make_rvalue(context,value) : value);
+			}
+			case Interpreter_Frame_Type::Binary_Operator: {
+				auto* binary_operator = frame.binary_operator;
+				state->frames.length -= 1;
+				auto right = logo::pop_value(state);
+				auto left = logo::pop_value(state);
+				auto [value,success] = logo::compute_binary_operator(context,binary_operator,left,right);
+				if(!success) return false;
+				return logo::push_value(state,value);
+			}
+			case Interpreter_Frame_Type::Logical_Operator: {
+				//The left operand stays on the value stack, either as the result or as the left operand of the 'Binary_Operator' frame.
+				const auto* binary_operator = frame.binary_operator;
+				if(logo::is_short_circuited(binary_operator->type,state->values[state->values.length - 1])) {
+					state->frames.length -= 1;
+					return true;
 				}
-				case Ast_Statement_Type::Return_Statement: {
-					Interpreter_Result return_value = Interpreter_Status::Function_Return;
-					if(statement.return_statement.return_value) {
-						auto [value,success] = logo::compute_expression(context,*statement.return_statement.return_value);
-						if(!success) return Interpreter_Status::Error;
-						return_value.value = value;
-					}
-					else return_value.value.type = Interpreter_Value_Type::Void;
-					return return_value;
+				frame.type = Interpreter_Frame_Type::Binary_Operator;
+				return logo::compute_expression_on_stack(state,*binary_operator->right,true);
+			}
+			case Interpreter_Frame_Type::Conditional: {
+				const auto* conditional = frame.conditional;
+				bool is_rvalue = frame.is_rvalue;
+				state->frames.length -= 1;
+				auto condition = logo::pop_value(state);
+				if(!logo::check_conditional_expression_condition(condition,conditional->line_index)) return false;
+				return logo::compute_expression_on_stack(state,condition.bool_v ? *conditional->if_true : *conditional->if_false,is_rvalue);
+			}
+			case Interpreter_Frame_Type::Function_Call_Argument: {
+				const auto* function_call = frame.function_call;
+				std::size_t arg_index = frame.index;
+				state->frames.length -= 1;
+				return logo::push_function_call_argument(state,*function_call,arg_index,logo::pop_value(state));
+			}
+			case Interpreter_Frame_Type::Function_Call: {
+				auto* function_call = frame.function_call;
+				state->frames.length -= 1;
+				return logo::call_function(state,function_call);
+			}
+			case Interpreter_Frame_Type::Expression_Statement: {
+				state->frames.length -= 1;
+				state->values.length -= 1;
+				return true;
+			}
+			case Interpreter_Frame_Type::Declaration: {
+				const auto& statement = *frame.statement;
+				state->frames.length -= 1;
+				auto value = logo::pop_value(state);
+				if(value.type == Interpreter_Value_Type::Void) {
+					logo::report_interpreter_error(statement.line_index,"Cannot assign value of type 'Void' to '%'.",logo::get_symbol_name(statement.declaration.name));
+					return false;
 				}
-				default: logo::unreachable();
+				return logo::push_variable(context,statement.declaration.name,value);
 			}
+			case Interpreter_Frame_Type::Assignment: {
+				const auto& assignment = frame.statement->assignment;
+				if(frame.phase == Interpreter_Frame_Phase::Assignment_Target) {
+					if(!logo::check_lvalue(assignment,state->values[state->values.length - 1])) return false;
+					frame.phase = Interpreter_Frame_Phase::Assignment_Value;
+					return logo::push_expression_frame(state,assignment.rvalue_expr,true);
+				}
+				state->frames.length -= 1;
+				auto rvalue_value = logo::pop_value(state);
+				auto lvalue_value = logo::pop_value(state);
+				return logo::execute_assignment(context,assignment,lvalue_value,rvalue_value);
+			}
+			case Interpreter_Frame_Type::If_Statement: {
+				const auto& statement = *frame.statement;
+				state->frames.length -= 1;
+				auto condition = logo::pop_value(state);
+				if(!logo::check_condition(statement,condition)) return false;
+				return logo::enter_if_statement_branch(state,statement,condition.bool_v);
+			}
+			case Interpreter_Frame_Type::While_Statement: {
+				return logo::execute_while_statement(state);
+			}
+			case Interpreter_Frame_Type::For_Statement: {
+				return logo::execute_for_statement(state);
+			}
+			case Interpreter_Frame_Type::Return_Statement: {
+				return logo::return_from_function(state,logo::pop_value(state));
+			}
+			case Interpreter_Frame_Type::Parallel_Iteration: {
+				context->variables.length = frame.var_count;
+				state->frames.length -= 1;
+				return true;
+			}
+			default: logo::unreachable();
 		}
-		if(is_function_scope) {
-			Interpreter_Result return_value = Interpreter_Status::Function_Return;
-			return_value.value.type = Interpreter_Value_Type::Void;
-			return return_value;
-		}
-		return Interpreter_Status::Success;
 	}
 
 	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_typename(Interpreter_Context* context,std::size_t,Array_View<Interpreter_Value> values) {
-		Interpreter_Value result{};
-		result.type = Interpreter_Value_Type::String;
-		const auto& arg = values[0];
-		switch(arg.type) {
-			case Interpreter_Value_Type::Int: result.string_v = "Int"; return result;
-			case Interpreter_Value_Type::Float: result.string_v = "Float"; return result;
-			case Interpreter_Value_Type::Bool: result.string_v = "Bool"; return result;
-			case Interpreter_Value_Type::String: result.string_v = "String"; return result;
-			case Interpreter_Value_Type::Reference: result.string_v = "Reference"; return result;
+		String_View type_name{};
+		switch(values[0].type) {
+			case Interpreter_Value_Type::Int: type_name = "Int"; break;
+			case Interpreter_Value_Type::Float: type_name = "Float"; break;
+			case Interpreter_Value_Type::Bool: type_name = "Bool"; break;
+			case Interpreter_Value_Type::String: type_name = "String"; break;
+			case Interpreter_Value_Type::Reference: type_name = "Reference"; break;
 			default: logo::unreachable();
 		}
+		auto [symbol,success] = logo::intern_symbol(type_name);
+		if(!success) return {};
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::String;
+		result.string_v = symbol;
 		return result;
 	}
 
@@ -842,6 +1985,7 @@ namespace logo {
 	}
 
 	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_init(Interpreter_Context* context,std::size_t line_index,Array_View<Interpreter_Value> values) {
+		if(!logo::check_parallel_loop_call(context,"init",line_index)) return {};
 		const auto& arg0 = values[0];
 		if(arg0.int_v > std::numeric_limits<std::int32_t>::max()) {
 			logo::report_interpreter_error(line_index,"Argument 0 to function 'init' must be an intger from interval (0,%].",std::numeric_limits<std::int32_t>::max());
@@ -860,6 +2004,7 @@ namespace logo {
 	}
 
 	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_init_with_colors(Interpreter_Context* context,std::size_t line_index,Array_View<Interpreter_Value> values) {
+		if(!logo::check_parallel_loop_call(context,"init",line_index)) return {};
 		const auto& arg0 = values[0];
 		if(arg0.int_v > std::numeric_limits<std::int32_t>::max()) {
 			logo::report_interpreter_error(line_index,"Argument 0 to function 'init' must be an intger from interval (0,%].",std::numeric_limits<std::int32_t>::max());
@@ -1005,165 +2150,336 @@ namespace logo {
 		return result;
 	}
 
-	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_save(Interpreter_Context* context,std::size_t,Array_View<Interpreter_Value> values) {
+	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_save(Interpreter_Context* context,std::size_t line_index,Array_View<Interpreter_Value> values) {
+		if(!logo::check_parallel_loop_call(context,"save",line_index)) return {};
 		const auto& arg = values[0];
-		if(!context->canvas.save_as_bitmap(arg.string_v)) return {};
+		if(!context->canvas.save_as_bitmap(logo::get_symbol_name(arg.string_v))) return {};
 		Interpreter_Value result{};
 		result.type = Interpreter_Value_Type::Void;
 		return result;
 	}
 
-	bool interpret_ast(Array_View<Ast_Statement> statements) {
-		Interpreter_Context context{};
-		context.random_engine = std::mt19937_64(std::chrono::steady_clock::now().time_since_epoch().count());
-		context.random_dist_0_1 = std::uniform_real_distribution(0.0,1.0);
-		context.current_function_scope_first_var_index = 0;
-		defer[&]{
-			context.builtin_functions.destroy();
-			context.canvas.destroy();
-			context.functions.destroy();
-			context.variables.destroy();
-		};
+	void destroy_interpreter_context(Interpreter_Context* context) {
+		logo::destroy_thread_pool(context->thread_pool);
+		context->parallel_loop_turtles.destroy();
+		for(auto& function : context->functions) function.memo_table.destroy();
+		context->canvas.destroy();
+		context->dynamic_scope.destroy();
+		context->functions.destroy();
+		context->variables.destroy();
+	}
 
-#define LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(CONTEXT,NAME,FUNC)\
-	if(!(CONTEXT).builtin_functions.push_back(Interpreter_Builtin_Function{(NAME),{Interpreter_Value_Type::Int_Or_Float},\
-	[](Interpreter_Context*,std::size_t,Array_View<Interpreter_Value> values) -> Option<Interpreter_Value> {\
-		Interpreter_Value result{};\
-		result.type = Interpreter_Value_Type::Float;\
-		const auto& arg = values[0];\
-		if(arg.type == Interpreter_Value_Type::Int) result.float_v = static_cast<double>((FUNC)(arg.int_v));\
-		else result.float_v = (FUNC)(arg.float_v);\
-		return result;\
-	}})) {\
-		Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));\
-		return false;\
-	}
-
-#define LOGO_DEFINE_DOUBLE_ARG_MATH_BUILTIN_FUNCTION(CONTEXT,NAME,FUNC)\
-	if(!(CONTEXT).builtin_functions.push_back(Interpreter_Builtin_Function{(NAME),{Interpreter_Value_Type::Int_Or_Float,Interpreter_Value_Type::Int_Or_Float},\
-	[](Interpreter_Context*,std::size_t,Array_View<Interpreter_Value> values) -> Option<Interpreter_Value> {\
-		Interpreter_Value result{};\
-		result.type = Interpreter_Value_Type::Float;\
-		double arg0_v = 0.0,arg1_v = 0.0;\
-		const auto& arg0 = values[0];\
-		if(arg0.type == Interpreter_Value_Type::Int) arg0_v = static_cast<double>(arg0.int_v);\
-		else arg0_v = arg0.float_v;\
-		const auto& arg1 = values[1];\
-		if(arg1.type == Interpreter_Value_Type::Int) arg1_v = static_cast<double>(arg1.int_v);\
-		else arg1_v = arg1.float_v;\
-		result.float_v = (FUNC)(arg0_v,arg1_v);\
-		return result;\
-	}})) {\
-		Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));\
-		return false;\
-	}
-
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"sin",std::sin);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"cos",std::cos);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"tan",std::tan);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"asin",std::asin);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"acos",std::acos);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"atan",std::atan);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"sinh",std::sinh);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"cosh",std::cosh);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"tanh",std::tanh);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"asinh",std::asinh);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"acosh",std::acosh);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"atanh",std::atanh);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"abs",std::abs);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"sqrt",std::sqrt);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"cbrt",std::cbrt);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"gamma",std::tgamma);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"radians",logo::radians);
-		LOGO_DEFINE_SINGLE_ARG_MATH_BUILTIN_FUNCTION(context,"degrees",logo::degrees);
-		LOGO_DEFINE_DOUBLE_ARG_MATH_BUILTIN_FUNCTION(context,"min",logo::float_min);
-		LOGO_DEFINE_DOUBLE_ARG_MATH_BUILTIN_FUNCTION(context,"max",logo::float_max);
-
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"typename",{Interpreter_Value_Type::Any},logo::interpreter_builtin_function_typename})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"int",{Interpreter_Value_Type::Any},logo::interpreter_builtin_function_int})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"float",{Interpreter_Value_Type::Any},logo::interpreter_builtin_function_float})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"pi",{},logo::interpreter_builtin_function_pi})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"random",{},logo::interpreter_builtin_function_random})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"init",{Interpreter_Value_Type::Int,Interpreter_Value_Type::Int},logo::interpreter_builtin_function_init})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"init",{Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,
-												Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,Interpreter_Value_Type::Int},logo::interpreter_builtin_function_init_with_colors})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"forward",{Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_forward})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"backwards",{Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_backwards})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"backward",{Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_backwards})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"right",{Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_right})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
-		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"left",{Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_left})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
+	void reset_interpreter_context(Interpreter_Context* context) {
+		for(auto& function : context->functions) function.memo_table.destroy();
+		context->functions.length = 0;
+		context->dynamic_scope.length = 0;
+		context->variables.length = 0;
+		context->current_function_scope_first_var_index = 0;
+		context->generation_counter = 0;
+		context->canvas.reset();
+		context->statistics = {};
+		context->watchdog = {};
+		context->parallel_loop_turtles.length = 0;
+		context->parallel_loop_var_count = 0;
+	}
+
+	[[nodiscard]] static std::size_t get_watchdog_countdown_length(const Interpreter_Watchdog& watchdog) {
+		if(watchdog.limits.max_step_count == 0) return WATCHDOG_CHECK_INTERVAL;
+		//The threads of a parallel loop can go over the limit together before any of them notices.
+		if(watchdog.step_count >= watchdog.limits.max_step_count) return 1;
+		std::size_t remaining_step_count = watchdog.limits.max_step_count - watchdog.step_count;
+		return (remaining_step_count < WATCHDOG_CHECK_INTERVAL) ? remaining_step_count : WATCHDOG_CHECK_INTERVAL;
+	}
+
+	void start_watchdog(Interpreter_Context* context,const Interpreter_Limits& limits) {
+		auto& watchdog = context->watchdog;
+		watchdog = {};
+		watchdog.limits = limits;
+		watchdog.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(limits.timeout_seconds);
+		watchdog.countdown_length = logo::get_watchdog_countdown_length(watchdog);
+		watchdog.countdown = watchdog.countdown_length;
+	}
+
+	bool check_watchdog_limits(Interpreter_Context* context,std::size_t line_index) {
+		auto& watchdog = context->watchdog;
+		const auto& limits = watchdog.limits;
+		if(watchdog.shared_step_count) watchdog.step_count = watchdog.shared_step_count->fetch_add(watchdog.countdown_length,std::memory_order_relaxed) + watchdog.countdown_length;
+		else watchdog.step_count += watchdog.countdown_length;
+		bool is_over_step_limit = limits.max_step_count != 0 && watchdog.step_count >= limits.max_step_count;
+		bool is_over_time_limit = limits.timeout_seconds != 0 && std::chrono::steady_clock::now() >= watchdog.deadline;
+		if(is_over_step_limit || is_over_time_limit) {
+			watchdog.has_stopped = true;
+			if(limits.canvas_path && !context->canvas.save_as_bitmap(String_View(limits.canvas_path))) return false;
+			if(is_over_step_limit) logo::report_interpreter_error(line_index,"Script exceeded the limit of % steps.",limits.max_step_count);
+			else logo::report_interpreter_error(line_index,"Script exceeded the time limit of % seconds.",limits.timeout_seconds);
 			return false;
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"setpos",{Interpreter_Value_Type::Int_Or_Float,Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_setpos})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
+		watchdog.countdown_length = logo::get_watchdog_countdown_length(watchdog);
+		watchdog.countdown = watchdog.countdown_length;
+		return true;
+	}
+
+	bool enter_parallel_loop(Interpreter_Context* context) {
+		if(!context->parallel_loop_turtles.push_back(context->canvas.get_turtle())) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Turtle));
 			return false;
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"setrot",{Interpreter_Value_Type::Int_Or_Float},logo::interpreter_builtin_function_setrot})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+		if(context->parallel_loop_turtles.length == 1) context->parallel_loop_var_count = context->variables.length;
+		return true;
+	}
+
+	void next_parallel_loop_iteration(Interpreter_Context* context) {
+		context->canvas.set_turtle(context->parallel_loop_turtles[context->parallel_loop_turtles.length - 1]);
+	}
+
+	void leave_parallel_loop(Interpreter_Context* context) {
+		logo::next_parallel_loop_iteration(context);
+		context->parallel_loop_turtles.length -= 1;
+		if(context->parallel_loop_turtles.length == 0) context->parallel_loop_var_count = 0;
+	}
+
+	bool check_parallel_loop_call(const Interpreter_Context* context,String_View name,std::size_t line_index) {
+		if(context->parallel_loop_turtles.length == 0) return true;
+		logo::report_interpreter_error(line_index,"Function '%' can't be called inside a parallel loop.",name);
+		return false;
+	}
+
+	template<double(*Func)(double)>
+	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_math(Interpreter_Context*,std::size_t,Array_View<Interpreter_Value> values) {
+		const auto& arg = values[0];
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Float;
+		result.float_v = Func((arg.type == Interpreter_Value_Type::Int) ? static_cast<double>(arg.int_v) : arg.float_v);
+		return result;
+	}
+
+	template<double(*Func)(double,double)>
+	[[nodiscard]] static Option<Interpreter_Value> interpreter_builtin_function_math(Interpreter_Context*,std::size_t,Array_View<Interpreter_Value> values) {
+		const auto& arg0 = values[0];
+		const auto& arg1 = values[1];
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Float;
+		result.float_v = Func((arg0.type == Interpreter_Value_Type::Int) ? static_cast<double>(arg0.int_v) : arg0.float_v,
+							  (arg1.type == Interpreter_Value_Type::Int) ? static_cast<double>(arg1.int_v) : arg1.float_v);
+		return result;
+	}
+
+	[[nodiscard]] static consteval Interpreter_Builtin_Function make_builtin_function(const char* name,std::initializer_list<Interpreter_Value_Type> argument_types,Interpreter_Value_Type return_type,
+																					 Option<Interpreter_Value>(*func_ptr)(Interpreter_Context*,std::size_t,Array_View<Interpreter_Value>),bool is_pure = false) {
+		Interpreter_Builtin_Function function{};
+		function.name = name;
+		while(name[function.name_length] != '\0') function.name_length += 1;
+		for(auto type : argument_types) function.argument_types = (function.argument_types << 4) | static_cast<std::uint64_t>(type);
+		function.argument_count = argument_types.size();
+		function.return_type = return_type;
+		function.func_ptr = func_ptr;
+		function.is_pure = is_pure;
+		return function;
+	}
+
+	//The indices of the functions are stored in the caches of the call sites, so the order doesn't matter.
+	static constexpr Interpreter_Builtin_Function BUILTIN_FUNCTIONS[] = {
+		logo::make_builtin_function("sin",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::sin>,true),
+		logo::make_builtin_function("cos",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::cos>,true),
+		logo::make_builtin_function("tan",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::tan>,true),
+		logo::make_builtin_function("asin",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::asin>,true),
+		logo::make_builtin_function("acos",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::acos>,true),
+		logo::make_builtin_function("atan",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::atan>,true),
+		logo::make_builtin_function("sinh",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::sinh>,true),
+		logo::make_builtin_function("cosh",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::cosh>,true),
+		logo::make_builtin_function("tanh",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::tanh>,true),
+		logo::make_builtin_function("asinh",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::asinh>,true),
+		logo::make_builtin_function("acosh",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::acosh>,true),
+		logo::make_builtin_function("atanh",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::atanh>,true),
+		logo::make_builtin_function("abs",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::abs>,true),
+		logo::make_builtin_function("sqrt",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::sqrt>,true),
+		logo::make_builtin_function("cbrt",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::cbrt>,true),
+		logo::make_builtin_function("gamma",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<std::tgamma>,true),
+		logo::make_builtin_function("radians",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<logo::radians>,true),
+		logo::make_builtin_function("degrees",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<logo::degrees>,true),
+		logo::make_builtin_function("min",{Interpreter_Value_Type::Int_Or_Float,Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<logo::float_min>,true),
+		logo::make_builtin_function("max",{Interpreter_Value_Type::Int_Or_Float,Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_math<logo::float_max>,true),
+		logo::make_builtin_function("typename",{Interpreter_Value_Type::Any},Interpreter_Value_Type::String,logo::interpreter_builtin_function_typename),
+		logo::make_builtin_function("int",{Interpreter_Value_Type::Any},Interpreter_Value_Type::Int,logo::interpreter_builtin_function_int),
+		logo::make_builtin_function("float",{Interpreter_Value_Type::Any},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_float),
+		logo::make_builtin_function("pi",{},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_pi,true),
+		logo::make_builtin_function("random",{},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_random),
+		logo::make_builtin_function("init",{Interpreter_Value_Type::Int,Interpreter_Value_Type::Int},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_init),
+		logo::make_builtin_function("init",{Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,Interpreter_Value_Type::Int},
+									Interpreter_Value_Type::Void,logo::interpreter_builtin_function_init_with_colors),
+		logo::make_builtin_function("forward",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_forward),
+		logo::make_builtin_function("backwards",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_backwards),
+		logo::make_builtin_function("backward",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_backwards),
+		logo::make_builtin_function("right",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_right),
+		logo::make_builtin_function("left",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_left),
+		logo::make_builtin_function("setpos",{Interpreter_Value_Type::Int_Or_Float,Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_setpos),
+		logo::make_builtin_function("setrot",{Interpreter_Value_Type::Int_Or_Float},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_setrot),
+		logo::make_builtin_function("getposx",{},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_getposx),
+		logo::make_builtin_function("getposy",{},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_getposy),
+		logo::make_builtin_function("getrot",{},Interpreter_Value_Type::Float,logo::interpreter_builtin_function_getrot),
+		logo::make_builtin_function("penup",{},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_penup),
+		logo::make_builtin_function("pendown",{},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_pendown),
+		logo::make_builtin_function("pencolor",{Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,Interpreter_Value_Type::Int},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_pencolor),
+		logo::make_builtin_function("save",{Interpreter_Value_Type::String},Interpreter_Value_Type::Void,logo::interpreter_builtin_function_save)
+	};
+	static constexpr std::size_t BUILTIN_FUNCTION_COUNT = sizeof(BUILTIN_FUNCTIONS) / sizeof(BUILTIN_FUNCTIONS[0]);
+	//A quarter of the buckets is used, so a seed that doesn't make any two functions collide is found after a few tries.
+	static constexpr std::size_t BUILTIN_FUNCTION_BUCKET_COUNT = std::bit_ceil(BUILTIN_FUNCTION_COUNT * 4);
+	static_assert(BUILTIN_FUNCTION_COUNT < 256);
+
+	[[nodiscard]] static constexpr std::size_t hash_builtin_function_signature(const char* name,std::size_t name_length,std::size_t arg_count,std::uint32_t seed) {
+		std::uint32_t hash = 2166136261u ^ seed;
+		for(std::size_t i = 0;i < name_length;i += 1) hash = (hash ^ static_cast<std::uint8_t>(name[i])) * 16777619u;
+		hash = (hash ^ static_cast<std::uint32_t>(arg_count)) * 16777619u;
+		return static_cast<std::size_t>((hash * 0x9E3779B9u) >> 16) & (BUILTIN_FUNCTION_BUCKET_COUNT - 1);
+	}
+
+	//Perfect hash table of the builtin functions: every signature is hashed into a different bucket, so a lookup takes one hash and one comparison.
+	struct Builtin_Function_Table {
+		std::uint32_t seed;
+		std::uint8_t buckets[BUILTIN_FUNCTION_BUCKET_COUNT]; //Every bucket holds a function index plus 1 or 0 if it's empty.
+	};
+
+	[[nodiscard]] static consteval bool are_builtin_function_signatures_unique() {
+		for(std::size_t i = 0;i < BUILTIN_FUNCTION_COUNT;i += 1) {
+			const auto& function = BUILTIN_FUNCTIONS[i];
+			if(function.argument_count > MAX_BUILTIN_FUNCTION_ARGUMENT_COUNT) return false;
+			for(std::size_t j = 0;j < i;j += 1) {
+				const auto& other_function = BUILTIN_FUNCTIONS[j];
+				if(function.argument_count != other_function.argument_count || function.name_length != other_function.name_length) continue;
+				bool are_names_equal = true;
+				for(std::size_t k = 0;k < function.name_length;k += 1) {
+					if(function.name[k] != other_function.name[k]) are_names_equal = false;
+				}
+				if(are_names_equal) return false;
+			}
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"getposx",{},logo::interpreter_builtin_function_getposx})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+		return true;
+	}
+	//Otherwise no seed would separate the functions.
+	static_assert(logo::are_builtin_function_signatures_unique(),"Builtin functions must have distinct signatures and take at most 16 arguments.");
+
+	[[nodiscard]] static consteval Builtin_Function_Table make_builtin_function_table() {
+		Builtin_Function_Table table{};
+		for(std::uint32_t seed = 0;;seed += 1) {
+			for(auto& bucket : table.buckets) bucket = 0;
+			bool has_collision = false;
+			for(std::size_t i = 0;i < BUILTIN_FUNCTION_COUNT && !has_collision;i += 1) {
+				const auto& function = BUILTIN_FUNCTIONS[i];
+				auto& bucket = table.buckets[logo::hash_builtin_function_signature(function.name,function.name_length,function.argument_count,seed)];
+				if(bucket != 0) has_collision = true;
+				bucket = static_cast<std::uint8_t>(i + 1);
+			}
+			if(!has_collision) {
+				table.seed = seed;
+				return table;
+			}
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"getposy",{},logo::interpreter_builtin_function_getposy})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+	}
+	static constexpr Builtin_Function_Table BUILTIN_FUNCTION_TABLE = logo::make_builtin_function_table();
+
+	Option<std::size_t> find_builtin_function(Symbol name,std::size_t arg_count) {
+		String_View name_string = logo::get_symbol_name(name);
+		std::size_t name_length = name_string.byte_length();
+		std::size_t bucket = BUILTIN_FUNCTION_TABLE.buckets[logo::hash_builtin_function_signature(name_string.begin_ptr,name_length,arg_count,BUILTIN_FUNCTION_TABLE.seed)];
+		if(bucket == 0) return {};
+		const auto& function = BUILTIN_FUNCTIONS[bucket - 1];
+		if(function.argument_count != arg_count || function.name_length != name_length || std::memcmp(function.name,name_string.begin_ptr,name_length) != 0) return {};
+		return bucket - 1;
+	}
+
+	const Interpreter_Builtin_Function& get_builtin_function(std::size_t index) {
+		return BUILTIN_FUNCTIONS[index];
+	}
+
+	bool init_interpreter_context(Interpreter_Context* context) {
+		*context = {};
+		context->random_engine = std::mt19937_64(std::chrono::steady_clock::now().time_since_epoch().count());
+		context->random_dist_0_1 = std::uniform_real_distribution(0.0,1.0);
+		context->current_function_scope_first_var_index = 0;
+		auto [print_symbol,print_symbol_interned] = logo::intern_symbol("print");
+		if(!print_symbol_interned) return false;
+		context->print_symbol = print_symbol;
+		//Names that 'typename' and the JIT look up while the script runs are interned here, so that the threads of a parallel loop never add to the symbol table.
+		String_View names[] = {"Int","Float","Bool","String","Reference","forward","backward","backwards","right","left"};
+		for(const auto& name : names) {
+			if(!logo::intern_symbol(name).has_value) return false;
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"getrot",{},logo::interpreter_builtin_function_getrot})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+		return true;
+	}
+
+	void apply_call_count_profile(Interpreter_Context* context,const Type_Profile& profile) {
+		if(profile.call_counts.length != context->functions.length) return;
+		for(std::size_t i = 0;i < context->functions.length;i += 1) {
+			context->functions[i].call_count = profile.call_counts[i];
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"penup",{},logo::interpreter_builtin_function_penup})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
+	}
+
+	bool record_call_count_profile(const Interpreter_Context* context,Type_Profile* profile) {
+		profile->call_counts.destroy();
+		if(!profile->call_counts.resize(context->functions.length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",context->functions.length * sizeof(std::size_t));
 			return false;
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"pendown",{},logo::interpreter_builtin_function_pendown})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+		for(std::size_t i = 0;i < context->functions.length;i += 1) {
+			profile->call_counts[i] = context->functions[i].call_count;
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"pencolor",{Interpreter_Value_Type::Int,Interpreter_Value_Type::Int,Interpreter_Value_Type::Int},logo::interpreter_builtin_function_pencolor})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+		return true;
+	}
+
+	Option<Interpreter_Statistics> interpret_ast(Interpreter_Context* context,Heap_Array<Ast_Statement>* statements,std::size_t max_stack_size,bool use_jit,const Interpreter_Limits& limits,Type_Profile* profile) {
+		logo::reset_interpreter_context(context);
+		Interpreter_State state{};
+		state.context = context;
+		defer[&]{state.destroy();};
+		state.max_stack_size = max_stack_size;
+		state.jit.is_enabled = use_jit;
+		state.use_threads = true;
+
+		logo::mark_function_calls(statements);
+		if(!logo::define_functions(state.context,{statements->data,statements->length})) return {};
+		if(profile) logo::apply_call_count_profile(state.context,*profile);
+		logo::start_watchdog(state.context,limits);
+		if(!logo::push_statements_frame(&state,Interpreter_Frame_Type::Statements,{statements->data,statements->length})) return {};
+		while(state.frames.length > 0) {
+			if(!logo::execute_frame(&state)) return {};
 		}
-		if(!context.builtin_functions.push_back(Interpreter_Builtin_Function{"save",{Interpreter_Value_Type::String},logo::interpreter_builtin_function_save})) {
-			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Interpreter_Builtin_Function));
-			return false;
+		if(profile && !logo::record_call_count_profile(state.context,profile)) return {};
+		return state.context->statistics;
+	}
+
+	bool evaluate_expressions(Heap_Array<Ast_Statement>* statements,Array_View<Ast_Expression*> expressions,std::size_t max_step_count,Interpreter_Value* results) {
+		Interpreter_Context context{};
+		if(!logo::init_interpreter_context(&context)) return false;
+		defer[&]{logo::destroy_interpreter_context(&context);};
+		Interpreter_State state{};
+		state.context = &context;
+		defer[&]{state.destroy();};
+		state.max_stack_size = DEFAULT_MAX_STACK_SIZE;
+
+		logo::mark_function_calls(statements);
+		if(!logo::define_functions(state.context,{statements->data,statements->length})) return false;
+		for(std::size_t i = 0;i < expressions.length;i += 1) {
+			results[i] = {};
+			state.frames.length = 0;
+			state.values.length = 0;
+			state.context->variables.length = 0;
+			state.context->current_function_scope_first_var_index = 0;
+			state.context->parallel_loop_turtles.length = 0;
+			state.context->parallel_loop_var_count = 0;
+			//The empty frame stands for the code around the expression, calls look at the frame below them.
+			if(!logo::push_statements_frame(&state,Interpreter_Frame_Type::Statements,{})) return false;
+			if(!logo::push_expression_frame(&state,*expressions[i],true)) return false;
+
+			std::size_t error_byte_length = logo::get_reported_error().byte_length();
+			std::size_t step_count = 0;
+			while(state.frames.length > 0 && step_count < max_step_count) {
+				if(!logo::execute_frame(&state)) break;
+				step_count += 1;
+			}
+			logo::truncate_reported_error(error_byte_length);
+			if(state.frames.length == 0 && state.values.length == 1) results[i] = state.values[0];
 		}
-		return logo::interpret_ast(&context,statements,false,false).status == Interpreter_Status::Success;
+		return true;
 	}
 }
@@ -1,11 +1,259 @@
 #ifndef LOGO_INTERPRETER_HPP
 #define LOGO_INTERPRETER_HPP
 
+#include <atomic>
+#include <limits>
+#include <random>
+#include <chrono>
+#include "debug.hpp"
+#include "utils.hpp"
+#include "canvas.hpp"
+#include "string.hpp"
+#include "parser.hpp"
+#include "heap_array.hpp"
 #include "array_view.hpp"
+#include "static_array.hpp"
+#include "symbol_table.hpp"
 
 namespace logo {
-	struct Ast_Statement;
-	bool interpret_ast(Array_View<Ast_Statement> statements);
+	struct Type_Profile;
+	struct Thread_Pool;
+	struct Interpreter_Context;
+	enum struct Interpreter_Value_Type {
+		Void,
+		Int,
+		Float,
+		Bool,
+		String,
+		Reference,
+		Lvalue,
+		Int_Or_Float, //This is only used in 'Interpreter_Builtin_Function' to denote argumnets that can be both ints or floats.
+		Any //This is only used in 'Interpreter_Builtin_Function' to denote arguments of unspecified type and by the type inference pass to denote values of unknown type.
+	};
+	//Every value takes up 16 bytes: strings are symbols and references hold the index of the variable next to the type,
+	//so that the 64-bit payload is left for the generation of the variable.
+	struct Interpreter_Value {
+		Interpreter_Value_Type type;
+		std::uint32_t var_index; //Index of the variable that a reference or an lvalue points to.
+		union {
+			std::int64_t int_v;
+			double float_v;
+			bool bool_v;
+			Symbol string_v;
+			std::size_t generation; //Generation of the variable that a reference points to.
+		};
+		Interpreter_Value() : type(),var_index(),int_v() {}
+	};
+	static_assert(sizeof(Interpreter_Value) == 16);
+	//There can't be more variables than 'MAX_VARIABLE_COUNT', so their indices always fit in 'Interpreter_Value::var_index'.
+	static constexpr std::size_t MAX_VARIABLE_COUNT = std::numeric_limits<std::uint32_t>::max();
+	[[nodiscard]] inline Interpreter_Value make_lvalue(std::size_t var_index) {
+		Interpreter_Value result{};
+		result.type = Interpreter_Value_Type::Lvalue;
+		result.var_index = static_cast<std::uint32_t>(var_index);
+		return result;
+	}
+	struct Interpreter_Variable {
+		Symbol name;
+		Interpreter_Value value;
+		std::size_t generation;
+	};
+	//Caches the results of a memoized function. Every entry takes up 'arguments.length + 1' values: the result followed by the arguments.
+	//An entry with a 'Void' result is empty. Colliding entries overwrite each other, so the table never grows past 'MAX_MEMO_ENTRY_COUNT' entries.
+	struct Interpreter_Memo_Table {
+		Heap_Array<Interpreter_Value> values;
+		std::size_t entry_count; //Always a power of 2 or 0 if the table hasn't been allocated yet.
+		std::size_t used_entry_count;
+		void destroy() {
+			values.destroy();
+			entry_count = 0;
+			used_entry_count = 0;
+		}
+	};
+	static constexpr std::size_t MAX_MEMO_ENTRY_COUNT = 16384;
+	struct Interpreter_Function {
+		Symbol name;
+		Array_View<Symbol> arguments;
+		Array_View<Ast_Statement> body_statements;
+		std::size_t code_offset; //This is only used by the bytecode VM to denote the first instruction of the function body.
+		std::size_t call_count; //Counted by the JIT until the function is compiled.
+		std::size_t jit_function_index; //Index of the compiled function in 'Jit_State::functions' plus 1, 0 if the function hasn't been compiled.
+		bool is_memoized; //'Ast_Function_Definition::is_memoized'.
+		std::size_t parent_function_index; //'Ast_Function_Definition::parent_function_index'.
+		bool defines_dynamic_functions; //'Ast_Function_Definition::defines_dynamic_functions'.
+		Interpreter_Memo_Table memo_table;
+	};
+	static constexpr std::size_t MAX_BUILTIN_FUNCTION_ARGUMENT_COUNT = 16;
+	//Builtin functions are defined at compile time, so they don't depend on the symbol table or the context.
+	struct Interpreter_Builtin_Function {
+		const char* name;
+		std::size_t name_length;
+		std::uint64_t argument_types; //Types of up to 16 arguments, 4 bits per argument with the last one in the lowest bits.
+		std::size_t argument_count;
+		Interpreter_Value_Type return_type;
+		Option<Interpreter_Value>(*func_ptr)(Interpreter_Context*,std::size_t,Array_View<Interpreter_Value>);
+		bool is_pure; //Pure functions don't touch the context and their result depends only on the arguments.
+	};
+	[[nodiscard]] constexpr Interpreter_Value_Type get_builtin_argument_type(const Interpreter_Builtin_Function& function,std::size_t index) {
+		return static_cast<Interpreter_Value_Type>((function.argument_types >> ((function.argument_count - index - 1) * 4)) & 0xF);
+	}
+	struct Interpreter_Call_Target {
+		const Interpreter_Builtin_Function* builtin_function;
+		const Interpreter_Function* function;
+	};
+	struct Interpreter_Statistics {
+		std::size_t memo_hit_count;
+		std::size_t memo_miss_count;
+	};
+	struct Interpreter_Limits {
+		std::size_t max_step_count; //Loop iterations and calls of user defined functions the script can make, 0 if it's not limited.
+		std::size_t timeout_seconds; //0 if the time isn't limited.
+		const char* canvas_path; //If this isn't nullptr, the canvas drawn so far is saved there when the script goes over a limit.
+	};
+	//Every loop iteration and call of a user defined function counts 'countdown' down, the limits are only checked when it reaches 0.
+	//The clock is read every 'WATCHDOG_CHECK_INTERVAL' steps, so the script can go over the time limit by as long as that many steps take.
+	struct Interpreter_Watchdog {
+		std::size_t countdown;
+		std::size_t countdown_length; //Value 'countdown' started at.
+		std::size_t step_count; //Steps made before the current countdown started.
+		Interpreter_Limits limits;
+		std::chrono::steady_clock::time_point deadline;
+		std::atomic<std::size_t>* shared_step_count; //The threads of a parallel loop count their steps here instead of 'step_count'.
+		bool has_stopped; //Set when the script went over one of the limits.
+	};
+	static constexpr std::size_t WATCHDOG_CHECK_INTERVAL = 4096;
+	struct Interpreter_Context {
+		std::mt19937_64 random_engine;
+		std::uniform_real_distribution<double> random_dist_0_1;
+		Heap_Array<Interpreter_Variable> variables;
+		std::size_t current_function_scope_first_var_index;
+		std::size_t generation_counter;
+		Heap_Array<Interpreter_Function> functions; //Every user defined function of the program at the index assigned by the resolver.
+		Heap_Array<std::size_t> dynamic_scope; //Indices of the running functions whose 'defines_dynamic_functions' is true, the innermost one is the last.
+		Canvas canvas;
+		Symbol print_symbol;
+		Interpreter_Statistics statistics;
+		Interpreter_Watchdog watchdog;
+		Heap_Array<Turtle> parallel_loop_turtles; //The turtle at the start of every running parallel loop, the innermost one is the last.
+		std::size_t parallel_loop_var_count; //Variables declared before the outermost parallel loop started, together with its iterator and induction variables.
+		bool is_parallel_worker; //The context of a thread running iterations of a parallel loop, it doesn't write the caches in the AST.
+		Thread_Pool* thread_pool; //Created by the first parallel loop.
+	};
+
+	template<typename... Args>
+	void report_interpreter_error(std::size_t line_index,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
+		logo::format_into(logo::write_char32_t_to_error_message,"[Runtime error] Line %: ",line_index);
+		logo::format_into(logo::write_char32_t_to_error_message,format,std::forward<Args>(args)...);
+		logo::write_char32_t_to_error_message('\n');
+	}
+
+	[[nodiscard]] bool init_interpreter_context(Interpreter_Context* context);
+	void destroy_interpreter_context(Interpreter_Context* context);
+	//Clears the variables, the functions and the canvas of the previous script but keeps their memory, the interned symbols and the thread pool,
+	//so that one context can run many scripts without setting everything up again. The random number generator isn't reseeded.
+	void reset_interpreter_context(Interpreter_Context* context);
+
+	//Starts counting the steps and the time of the script. Without a call to this function the limits are never checked.
+	void start_watchdog(Interpreter_Context* context,const Interpreter_Limits& limits);
+	//Called when the countdown reaches 0. Returns false with the error reported if the script went over one of the limits.
+	[[nodiscard]] bool check_watchdog_limits(Interpreter_Context* context,std::size_t line_index);
+	//Counts a loop iteration or a call of a user defined function.
+	[[nodiscard]] inline bool count_watchdog_step(Interpreter_Context* context,std::size_t line_index) {
+		context->watchdog.countdown -= 1;
+		return context->watchdog.countdown != 0 || logo::check_watchdog_limits(context,line_index);
+	}
+
+	//Every iteration of a parallel loop starts with the turtle where it was when the loop started and the turtle is put back there when the loop ends.
+	//Call 'enter_parallel_loop' after the iterator and the induction variables are declared.
+	[[nodiscard]] bool enter_parallel_loop(Interpreter_Context* context);
+	void next_parallel_loop_iteration(Interpreter_Context* context);
+	void leave_parallel_loop(Interpreter_Context* context);
+	//The iterations of a parallel loop can run in any order, so they can't assign the variables declared outside of the loop.
+	[[nodiscard]] inline bool check_parallel_loop_assignment(const Interpreter_Context* context,std::size_t var_index,std::size_t line_index) {
+		if(var_index >= context->parallel_loop_var_count) return true;
+		logo::report_interpreter_error(line_index,"Variable '%' was declared outside of the parallel loop and can't be assigned inside of it.",logo::get_symbol_name(context->variables[var_index].name));
+		return false;
+	}
+	//Checks calls of the functions whose effects depend on the order of the iterations.
+	[[nodiscard]] bool check_parallel_loop_call(const Interpreter_Context* context,String_View name,std::size_t line_index);
+
+	//'slot' is 'Ast_Value::slot' of the identifier of a parent scope access to a variable outside of the current function.
+	//Returns the index of the most recently declared variable with the given name or the number of variables if there is none.
+	[[nodiscard]] std::size_t lookup_parent_scope_variable(const Interpreter_Context* context,Symbol name,std::size_t slot);
+	//Same as above but reports an error if the variable doesn't exist.
+	[[nodiscard]] Option<std::size_t> find_parent_scope_variable(const Interpreter_Context* context,Symbol name,std::size_t slot,std::size_t line_index);
+	[[nodiscard]] bool push_variable(Interpreter_Context* context,Symbol name,const Interpreter_Value& value);
+
+	//The divisor must not be 0, integer division by zero is reported as an error before these are called. 'INT64_MIN / -1' wraps around instead of trapping.
+	[[nodiscard]] inline std::int64_t divide_integers(std::int64_t left,std::int64_t right) {
+		if(right == -1) return static_cast<std::int64_t>(0 - static_cast<std::uint64_t>(left));
+		return left / right;
+	}
+	[[nodiscard]] inline std::int64_t compute_integer_remainder(std::int64_t left,std::int64_t right) {
+		if(right == -1) return 0;
+		return left % right;
+	}
+	//Returns true if computing the operation would divide an integer by zero, which is reported as an error.
+	[[nodiscard]] inline bool is_integer_division_by_zero(Ast_Binary_Operator_Type type,const Interpreter_Value& left,const Interpreter_Value& right) {
+		if(type != Ast_Binary_Operator_Type::Divide && type != Ast_Binary_Operator_Type::Remainder) return false;
+		return left.type == Interpreter_Value_Type::Int && right.type == Interpreter_Value_Type::Int && right.int_v == 0;
+	}
+
+	[[nodiscard]] Option<Interpreter_Value> compute_unary_operation(Ast_Unary_Prefix_Operator_Type type,const Interpreter_Value& value,std::size_t line_index);
+	[[nodiscard]] Option<Interpreter_Value> compute_binary_operation(Ast_Binary_Operator_Type type,const Interpreter_Value& left,const Interpreter_Value& right,std::size_t line_index);
+	//Returns true if the left operand of 'and' or 'or' decides the result. The result is then the left operand and the right one isn't computed.
+	[[nodiscard]] bool is_short_circuited(Ast_Binary_Operator_Type type,const Interpreter_Value& left);
+	[[nodiscard]] bool check_conditional_expression_condition(const Interpreter_Value& condition,std::size_t line_index);
+	[[nodiscard]] bool compute_assignment(Ast_Assignment_Type type,Interpreter_Value* target,const Interpreter_Value& value,std::size_t line_index);
+	[[nodiscard]] Ast_Operation_Specialization specialize_binary_operation(Ast_Binary_Operator_Type type,Interpreter_Value_Type left_type,Interpreter_Value_Type right_type);
+	[[nodiscard]] Ast_Operation_Specialization specialize_compound_assignment(Ast_Assignment_Type type,Interpreter_Value_Type target_type,Interpreter_Value_Type value_type);
+	//Returns false without touching 'result' if the operands don't have the types the operation was specialized for.
+	[[nodiscard]] bool compute_specialized_operation(Ast_Operation_Specialization specialization,const Interpreter_Value& left,const Interpreter_Value& right,Interpreter_Value* result);
+	//Same as above but the operands must have the right types.
+	[[nodiscard]] Interpreter_Value compute_unchecked_operation(Ast_Operation_Specialization specialization,const Interpreter_Value& left,const Interpreter_Value& right);
+	//Replaces the specialization of an operation. Replacing an existing one counts as a deoptimization.
+	void update_operation_cache(Ast_Operation_Cache* cache,Ast_Operation_Specialization specialization);
+	[[nodiscard]] Option<Interpreter_Value> make_reference(const Interpreter_Context* context,const Interpreter_Value& value,std::size_t line_index);
+	[[nodiscard]] Option<Interpreter_Value> dereference(const Interpreter_Context* context,const Interpreter_Value& value,std::size_t line_index);
+
+	//Returns the index of the builtin function with the given name and argument count. Builtin functions can't be overloaded on the argument types.
+	[[nodiscard]] Option<std::size_t> find_builtin_function(Symbol name,std::size_t arg_count);
+	[[nodiscard]] const Interpreter_Builtin_Function& get_builtin_function(std::size_t index);
+	[[nodiscard]] bool call_print_function(Array_View<Interpreter_Value> args,std::size_t line_index);
+	//Functions are defined once before the program starts, 'function_index' is 'Ast_Function_Definition::function_index'.
+	[[nodiscard]] bool define_function(Interpreter_Context* context,std::size_t function_index,const Interpreter_Function& function);
+	//'function_index' is 'Ast_Function_Call::function_index'. Builtin functions take precedence over the user defined function the call is bound to.
+	//Calls that aren't bound to a function look for one defined by the functions on 'Interpreter_Context::dynamic_scope'.
+	//A called function whose 'defines_dynamic_functions' is true has to be put on 'Interpreter_Context::dynamic_scope' while it runs.
+	[[nodiscard]] bool enter_dynamic_scope(Interpreter_Context* context,const Interpreter_Function* function);
+	inline void leave_dynamic_scope(Interpreter_Context* context) {
+		context->dynamic_scope.length -= 1;
+	}
+	[[nodiscard]] Option<Interpreter_Call_Target> find_call_target(Interpreter_Context* context,Ast_Function_Call_Cache* cache,Symbol name,std::size_t function_index,Array_View<Interpreter_Value> args,std::size_t line_index);
+
+	//Returns true if the result of calling 'function' with 'args' can be looked up in and stored into its memo table. Calls that take references can't be memoized.
+	[[nodiscard]] bool can_memoize_call(const Interpreter_Function* function,Array_View<Interpreter_Value> args);
+	//Looks up the result of a call for which 'can_memoize_call' returned true and counts it as a hit or a miss.
+	[[nodiscard]] Option<Interpreter_Value> find_memoized_result(Interpreter_Context* context,const Interpreter_Function* function,Array_View<Interpreter_Value> args);
+	//Returns false only if the memo table couldn't be allocated. Results that are references or 'Void' aren't stored.
+	[[nodiscard]] bool memoize_result(Interpreter_Function* function,Array_View<Interpreter_Value> args,const Interpreter_Value& result);
+	//Prints to stderr, so that the statistics don't mix with the output of the script.
+	void print_interpreter_statistics(const Interpreter_Statistics& statistics);
+	//Starts the call counters of the JIT at the counts saved in the profile, so that the functions that were hot in the profiled run are compiled on their first call.
+	void apply_call_count_profile(Interpreter_Context* context,const Type_Profile& profile);
+	[[nodiscard]] bool record_call_count_profile(const Interpreter_Context* context,Type_Profile* profile);
+
+	//Memory that the variables and the call stack of a script can take up before it's stopped with an error.
+	static constexpr std::size_t DEFAULT_MAX_STACK_SIZE = 256 * 1024 * 1024;
+
+	//Marks the expressions that contain function calls in the AST before running it. If 'use_jit' is true, hot functions are compiled to machine code.
+	//If 'profile' isn't nullptr, the call counts of the functions start at the ones it holds and are saved into it after the script finishes.
+	//The script is stopped with an error once it goes over 'limits'. 'context' must have been initialized with 'init_interpreter_context',
+	//it's reset before the script starts and can run the next script after this one finishes.
+	[[nodiscard]] Option<Interpreter_Statistics> interpret_ast(Interpreter_Context* context,Heap_Array<Ast_Statement>* statements,std::size_t max_stack_size,bool use_jit,const Interpreter_Limits& limits,Type_Profile* profile);
+	//Computes expressions that don't read any variables with the user defined functions of the program defined. The optimizer uses this to call pure functions at compile time.
+	//'results[i]' is left as 'Void' if computing 'expressions[i]' fails or takes more than 'max_step_count' steps, such errors aren't reported.
+	[[nodiscard]] bool evaluate_expressions(Heap_Array<Ast_Statement>* statements,Array_View<Ast_Expression*> expressions,std::size_t max_step_count,Interpreter_Value* results);
 }
 
 #endif
@@ -0,0 +1,1049 @@
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include "jit.hpp"
+#include "debug.hpp"
+#include "canvas.hpp"
+
+//Machine code is generated for the System V calling convention used on x86-64 Linux.
+#if defined(__linux__) && defined(__x86_64__)
+#define LOGO_JIT_SUPPORTED
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace logo {
+	void Jit_State::destroy() {
+#ifdef LOGO_JIT_SUPPORTED
+		for(const auto& region : code_regions) munmap(region.address,region.size);
+#endif
+		slots.destroy();
+		code_regions.destroy();
+		parent_variables.destroy();
+		functions.destroy();
+	}
+
+	bool is_jit_supported() {
+#ifdef LOGO_JIT_SUPPORTED
+		return true;
+#else
+		return false;
+#endif
+	}
+
+#ifdef LOGO_JIT_SUPPORTED
+	//Register numbers as they are encoded in the ModRM and REX bytes.
+	static constexpr std::uint8_t RAX = 0;
+	static constexpr std::uint8_t RCX = 1;
+	static constexpr std::uint8_t RDX = 2;
+	static constexpr std::uint8_t RBX = 3;
+	static constexpr std::uint8_t RSP = 4;
+	static constexpr std::uint8_t RBP = 5;
+	static constexpr std::uint8_t RSI = 6;
+	static constexpr std::uint8_t RDI = 7;
+	static constexpr std::uint8_t R12 = 12;
+	static constexpr std::uint8_t XMM0 = 0;
+	static constexpr std::uint8_t XMM1 = 1;
+
+	enum struct Jit_Condition : std::uint8_t {
+		Below = 0x2,
+		Above_Or_Equal = 0x3,
+		Equal = 0x4,
+		Not_Equal = 0x5,
+		Above = 0x7,
+		Parity = 0xA,
+		No_Parity = 0xB,
+		Less = 0xC,
+		Greater_Or_Equal = 0xD,
+		Less_Or_Equal = 0xE,
+		Greater = 0xF
+	};
+
+	//The compiled function gets the address of the slots in rdi and the address of the canvas in rsi and keeps them in rbx and r12.
+	//Slot 0 receives the returned value, slot 1 its type, then come the variables accessed with operator ' and the variables of the function.
+	//Slot 1 gets 'JIT_STOPPED_TYPE' instead of a type if the watchdog stopped the function in a loop.
+	//Loop counters, loop bounds and induction variable steps live in the stack frame below rbx and r12.
+	using Jit_Code = void(*)(std::uint64_t* slots,Canvas* canvas);
+	static constexpr std::size_t JIT_FIRST_PARENT_VARIABLE_SLOT = 2;
+	static constexpr std::int32_t JIT_FIRST_HIDDEN_SLOT_DISPLACEMENT = -24;
+	static constexpr Interpreter_Value_Type JIT_STOPPED_TYPE = Interpreter_Value_Type::Any;
+
+	struct Jit_Loop {
+		std::size_t first_jump_index;
+	};
+	struct Jit_Loop_Jump {
+		std::size_t patch_offset;
+		bool is_break;
+	};
+	struct Jit_Compiler {
+		Interpreter_Context* context; //The code counts the steps of the watchdog of this context.
+		Heap_Array<std::uint8_t> code;
+		Heap_Array<Interpreter_Value_Type> variable_types; //Types of the variables that are in scope, indexed by their slots.
+		Array_View<Jit_Parent_Variable> parent_variables;
+		Heap_Array<Jit_Loop> loops;
+		Heap_Array<Jit_Loop_Jump> loop_jumps;
+		Heap_Array<std::size_t> return_jumps;
+		std::size_t max_variable_count;
+		std::size_t hidden_slot_count;
+		std::size_t max_hidden_slot_count;
+		std::size_t pushed_value_count; //Temporary values pushed onto the machine stack, the stack has to be aligned to 16 bytes at every call.
+		Symbol forward_symbol;
+		Symbol backward_symbol;
+		Symbol backwards_symbol;
+		Symbol right_symbol;
+		Symbol left_symbol;
+		//Running out of memory only means that the function stays interpreted, so emitting code doesn't stop at every failed allocation.
+		bool is_out_of_memory;
+		void destroy() {
+			return_jumps.destroy();
+			loop_jumps.destroy();
+			loops.destroy();
+			variable_types.destroy();
+			code.destroy();
+		}
+	};
+
+	static void jit_move_forward(Canvas* canvas,double steps) {
+		canvas->move_forward(steps);
+	}
+
+	static double jit_pow(double left,double right) {
+		return std::pow(left,right);
+	}
+
+	static double jit_fmod(double left,double right) {
+		return std::fmod(left,right);
+	}
+
+	static void emit_byte(Jit_Compiler* compiler,std::uint8_t byte) {
+		if(!compiler->code.push_back(byte)) compiler->is_out_of_memory = true;
+	}
+
+	static void emit_bytes(Jit_Compiler* compiler,std::initializer_list<std::uint8_t> bytes) {
+		for(auto byte : bytes) logo::emit_byte(compiler,byte);
+	}
+
+	static void emit_u32(Jit_Compiler* compiler,std::uint32_t value) {
+		for(std::size_t i = 0;i < 4;i += 1) logo::emit_byte(compiler,static_cast<std::uint8_t>(value >> (i * 8)));
+	}
+
+	static void emit_u64(Jit_Compiler* compiler,std::uint64_t value) {
+		for(std::size_t i = 0;i < 8;i += 1) logo::emit_byte(compiler,static_cast<std::uint8_t>(value >> (i * 8)));
+	}
+
+	static void emit_prefix_and_rex(Jit_Compiler* compiler,std::uint8_t prefix,bool rex_w,std::uint8_t reg,std::uint8_t rm) {
+		if(prefix != 0) logo::emit_byte(compiler,prefix);
+		auto rex = static_cast<std::uint8_t>(0x40 | (rex_w ? 0x08 : 0) | ((reg >> 3) << 2) | (rm >> 3));
+		if(rex != 0x40) logo::emit_byte(compiler,rex);
+	}
+
+	//Emits an instruction with both operands in registers. 'reg' can also be an opcode extension.
+	static void emit_instruction(Jit_Compiler* compiler,std::uint8_t prefix,bool rex_w,std::initializer_list<std::uint8_t> opcode,std::uint8_t reg,std::uint8_t rm) {
+		logo::emit_prefix_and_rex(compiler,prefix,rex_w,reg,rm);
+		logo::emit_bytes(compiler,opcode);
+		logo::emit_byte(compiler,static_cast<std::uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+	}
+
+	//Same as above but the second operand is in memory at 'base + displacement'.
+	static void emit_memory_instruction(Jit_Compiler* compiler,std::uint8_t prefix,bool rex_w,std::initializer_list<std::uint8_t> opcode,std::uint8_t reg,std::uint8_t base,std::int32_t displacement) {
+		logo::emit_prefix_and_rex(compiler,prefix,rex_w,reg,base);
+		logo::emit_bytes(compiler,opcode);
+		logo::emit_byte(compiler,static_cast<std::uint8_t>(0x80 | ((reg & 7) << 3) | (base & 7)));
+		//rsp and r12 can only be used as a base through the SIB byte.
+		if((base & 7) == RSP) logo::emit_byte(compiler,0x24);
+		logo::emit_u32(compiler,static_cast<std::uint32_t>(displacement));
+	}
+
+	static void emit_move_immediate(Jit_Compiler* compiler,std::uint8_t reg,std::uint64_t value) {
+		logo::emit_byte(compiler,static_cast<std::uint8_t>(0x48 | (reg >> 3)));
+		logo::emit_byte(compiler,static_cast<std::uint8_t>(0xB8 + (reg & 7)));
+		logo::emit_u64(compiler,value);
+	}
+
+	static void emit_move_float_immediate(Jit_Compiler* compiler,std::uint8_t xmm,double value) {
+		logo::emit_move_immediate(compiler,RDX,std::bit_cast<std::uint64_t>(value));
+		logo::emit_instruction(compiler,0x66,true,{0x0F,0x6E},xmm,RDX);
+	}
+
+	static void emit_load(Jit_Compiler* compiler,Interpreter_Value_Type type,std::uint8_t reg,std::uint8_t xmm,std::uint8_t base,std::int32_t displacement) {
+		if(type == Interpreter_Value_Type::Float) logo::emit_memory_instruction(compiler,0xF2,false,{0x0F,0x10},xmm,base,displacement);
+		else logo::emit_memory_instruction(compiler,0,true,{0x8B},reg,base,displacement);
+	}
+
+	//Stores rax or xmm0.
+	static void emit_store(Jit_Compiler* compiler,Interpreter_Value_Type type,std::uint8_t base,std::int32_t displacement) {
+		if(type == Interpreter_Value_Type::Float) logo::emit_memory_instruction(compiler,0xF2,false,{0x0F,0x11},XMM0,base,displacement);
+		else logo::emit_memory_instruction(compiler,0,true,{0x89},RAX,base,displacement);
+	}
+
+	//Moves rax to rcx or xmm0 to xmm1.
+	static void emit_move_to_second_operand(Jit_Compiler* compiler,Interpreter_Value_Type type) {
+		if(type == Interpreter_Value_Type::Float) logo::emit_instruction(compiler,0xF2,false,{0x0F,0x10},XMM1,XMM0);
+		else logo::emit_instruction(compiler,0,true,{0x89},RAX,RCX);
+	}
+
+	static void emit_push(Jit_Compiler* compiler,Interpreter_Value_Type type) {
+		if(type == Interpreter_Value_Type::Float) {
+			logo::emit_bytes(compiler,{0x48,0x83,0xEC,0x08});
+			logo::emit_memory_instruction(compiler,0xF2,false,{0x0F,0x11},XMM0,RSP,0);
+		}
+		else logo::emit_byte(compiler,0x50);
+		compiler->pushed_value_count += 1;
+	}
+
+	static void emit_pop(Jit_Compiler* compiler,Interpreter_Value_Type type) {
+		if(type == Interpreter_Value_Type::Float) {
+			logo::emit_memory_instruction(compiler,0xF2,false,{0x0F,0x10},XMM0,RSP,0);
+			logo::emit_bytes(compiler,{0x48,0x83,0xC4,0x08});
+		}
+		else logo::emit_byte(compiler,0x58);
+		compiler->pushed_value_count -= 1;
+	}
+
+	//Calls a function that takes and returns doubles in xmm registers.
+	static void emit_call(Jit_Compiler* compiler,std::uint64_t address) {
+		bool is_misaligned = (compiler->pushed_value_count % 2) != 0;
+		if(is_misaligned) logo::emit_bytes(compiler,{0x48,0x83,0xEC,0x08});
+		logo::emit_move_immediate(compiler,RAX,address);
+		logo::emit_bytes(compiler,{0xFF,0xD0});
+		if(is_misaligned) logo::emit_bytes(compiler,{0x48,0x83,0xC4,0x08});
+	}
+
+	//Sets rax to 0 or 1.
+	static void emit_set_condition(Jit_Compiler* compiler,Jit_Condition condition) {
+		logo::emit_bytes(compiler,{0x0F,static_cast<std::uint8_t>(0x90 | static_cast<std::uint8_t>(condition)),0xC0});
+		logo::emit_bytes(compiler,{0x0F,0xB6,0xC0});
+	}
+
+	//Returns the offset of the 32-bit displacement so it can be patched.
+	[[nodiscard]] static std::size_t emit_jump(Jit_Compiler* compiler) {
+		logo::emit_byte(compiler,0xE9);
+		logo::emit_u32(compiler,0);
+		return compiler->code.length - 4;
+	}
+
+	//Jumps if rax is 0.
+	[[nodiscard]] static std::size_t emit_jump_if_false(Jit_Compiler* compiler) {
+		logo::emit_instruction(compiler,0,true,{0x85},RAX,RAX);
+		logo::emit_bytes(compiler,{0x0F,0x84});
+		logo::emit_u32(compiler,0);
+		return compiler->code.length - 4;
+	}
+
+	//Jumps if rax isn't 0.
+	[[nodiscard]] static std::size_t emit_jump_if_true(Jit_Compiler* compiler) {
+		logo::emit_instruction(compiler,0,true,{0x85},RAX,RAX);
+		logo::emit_bytes(compiler,{0x0F,0x85});
+		logo::emit_u32(compiler,0);
+		return compiler->code.length - 4;
+	}
+
+	static void patch_jump(Jit_Compiler* compiler,std::size_t patch_offset,std::size_t target_offset) {
+		if(compiler->is_out_of_memory) return;
+		auto displacement = static_cast<std::uint32_t>(static_cast<std::int64_t>(target_offset) - static_cast<std::int64_t>(patch_offset + 4));
+		std::memcpy(compiler->code.data + patch_offset,&displacement,sizeof(displacement));
+	}
+
+	[[nodiscard]] static std::int32_t get_variable_displacement(const Jit_Compiler* compiler,std::size_t slot) {
+		return static_cast<std::int32_t>((JIT_FIRST_PARENT_VARIABLE_SLOT + compiler->parent_variables.length + slot) * sizeof(std::uint64_t));
+	}
+
+	[[nodiscard]] static std::int32_t get_parent_variable_displacement(std::size_t index) {
+		return static_cast<std::int32_t>((JIT_FIRST_PARENT_VARIABLE_SLOT + index) * sizeof(std::uint64_t));
+	}
+
+	[[nodiscard]] static std::int32_t push_hidden_slot(Jit_Compiler* compiler) {
+		auto displacement = static_cast<std::int32_t>(JIT_FIRST_HIDDEN_SLOT_DISPLACEMENT - static_cast<std::int32_t>(compiler->hidden_slot_count * sizeof(std::uint64_t)));
+		compiler->hidden_slot_count += 1;
+		if(compiler->hidden_slot_count > compiler->max_hidden_slot_count) compiler->max_hidden_slot_count = compiler->hidden_slot_count;
+		return displacement;
+	}
+
+	[[nodiscard]] static bool is_numeric_type(Interpreter_Value_Type type) {
+		return type == Interpreter_Value_Type::Int || type == Interpreter_Value_Type::Float;
+	}
+
+	[[nodiscard]] static bool is_compilable_type(Interpreter_Value_Type type) {
+		return logo::is_one_of(type,Interpreter_Value_Type::Int,Interpreter_Value_Type::Float,Interpreter_Value_Type::Bool);
+	}
+
+	//Finds the memory operand of a variable of the function or of a variable accessed with operator '.
+	[[nodiscard]] static bool find_variable(const Jit_Compiler* compiler,const Ast_Expression& expression,std::uint8_t* base,std::int32_t* displacement,Interpreter_Value_Type* type) {
+		const Ast_Expression* identifier = &expression;
+		if(identifier->type == Ast_Expression_Type::Unary_Prefix_Operator && identifier->unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+			identifier = identifier->unary_prefix_operator->child;
+		}
+		if(identifier->type != Ast_Expression_Type::Value || identifier->value.type != Ast_Value_Type::Identifier) return false;
+		const auto& value = identifier->value;
+		*base = RBX;
+		if(value.depth == 0) {
+			if(value.slot >= compiler->variable_types.length) return false;
+			*displacement = logo::get_variable_displacement(compiler,value.slot);
+			*type = compiler->variable_types[value.slot];
+			return true;
+		}
+		if(identifier == &expression) return false;
+		for(std::size_t i = 0;i < compiler->parent_variables.length;i += 1) {
+			if(compiler->parent_variables[i].name == value.identfier_name) {
+				*displacement = logo::get_parent_variable_displacement(i);
+				*type = compiler->parent_variables[i].type;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	[[nodiscard]] static bool is_simple_operand(const Ast_Expression& expression) {
+		if(expression.type == Ast_Expression_Type::Value) return true;
+		return expression.type == Ast_Expression_Type::Unary_Prefix_Operator && expression.unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access;
+	}
+
+	//Loads a literal or a variable into 'reg' or 'xmm' without touching other registers except rdx.
+	[[nodiscard]] static Option<Interpreter_Value_Type> compile_simple_operand(Jit_Compiler* compiler,const Ast_Expression& expression,std::uint8_t reg,std::uint8_t xmm) {
+		if(expression.type == Ast_Expression_Type::Value) {
+			switch(expression.value.type) {
+				case Ast_Value_Type::Int_Literal: {
+					logo::emit_move_immediate(compiler,reg,static_cast<std::uint64_t>(expression.value.int_value));
+					return Interpreter_Value_Type::Int;
+				}
+				case Ast_Value_Type::Float_Literal: {
+					logo::emit_move_float_immediate(compiler,xmm,expression.value.float_value);
+					return Interpreter_Value_Type::Float;
+				}
+				case Ast_Value_Type::Bool_Literal: {
+					logo::emit_move_immediate(compiler,reg,expression.value.bool_value ? 1 : 0);
+					return Interpreter_Value_Type::Bool;
+				}
+				case Ast_Value_Type::Identifier: break;
+				default: return {};
+			}
+		}
+		std::uint8_t base = 0;
+		std::int32_t displacement = 0;
+		Interpreter_Value_Type type{};
+		if(!logo::find_variable(compiler,expression,&base,&displacement,&type)) return {};
+		logo::emit_load(compiler,type,reg,xmm,base,displacement);
+		return type;
+	}
+
+	//'idiv' traps instead of reporting an error for a zero divisor and overflows for -1, so integer division is compiled only for the other literal divisors.
+	[[nodiscard]] static bool is_safe_integer_divisor(const Ast_Expression& divisor) {
+		if(divisor.type != Ast_Expression_Type::Value || divisor.value.type != Ast_Value_Type::Int_Literal) return false;
+		return divisor.value.int_value != 0 && divisor.value.int_value != -1;
+	}
+
+	//Computes an arithmetic operation, a comparison or a logical operation the same way 'compute_binary_operation' does.
+	//The left operand is in rax or xmm0, the right one in rcx or xmm1 and the result ends up in rax or xmm0. 'divisor' is the expression of the right operand.
+	[[nodiscard]] static Option<Interpreter_Value_Type> emit_binary_operation(Jit_Compiler* compiler,Ast_Binary_Operator_Type type,Interpreter_Value_Type left,Interpreter_Value_Type right,const Ast_Expression& divisor) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus:
+			case Ast_Binary_Operator_Type::Minus:
+			case Ast_Binary_Operator_Type::Multiply:
+			case Ast_Binary_Operator_Type::Divide:
+			case Ast_Binary_Operator_Type::Remainder:
+			case Ast_Binary_Operator_Type::Exponentiate: {
+				if(!logo::is_numeric_type(left) || !logo::is_numeric_type(right)) return {};
+				if(left == Interpreter_Value_Type::Int && right == Interpreter_Value_Type::Int) {
+					switch(type) {
+						case Ast_Binary_Operator_Type::Plus: logo::emit_instruction(compiler,0,true,{0x01},RCX,RAX); break;
+						case Ast_Binary_Operator_Type::Minus: logo::emit_instruction(compiler,0,true,{0x29},RCX,RAX); break;
+						case Ast_Binary_Operator_Type::Multiply: logo::emit_instruction(compiler,0,true,{0x0F,0xAF},RAX,RCX); break;
+						case Ast_Binary_Operator_Type::Divide:
+						case Ast_Binary_Operator_Type::Remainder: {
+							if(!logo::is_safe_integer_divisor(divisor)) return {};
+							logo::emit_bytes(compiler,{0x48,0x99});
+							logo::emit_instruction(compiler,0,true,{0xF7},7,RCX);
+							if(type == Ast_Binary_Operator_Type::Remainder) logo::emit_instruction(compiler,0,true,{0x89},RDX,RAX);
+							break;
+						}
+						case Ast_Binary_Operator_Type::Exponentiate: {
+							logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM0,RAX);
+							logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM1,RCX);
+							logo::emit_call(compiler,reinterpret_cast<std::uint64_t>(&logo::jit_pow));
+							logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2C},RAX,XMM0);
+							break;
+						}
+						default: logo::unreachable();
+					}
+					return Interpreter_Value_Type::Int;
+				}
+				if(left == Interpreter_Value_Type::Int) logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM0,RAX);
+				if(right == Interpreter_Value_Type::Int) logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM1,RCX);
+				switch(type) {
+					case Ast_Binary_Operator_Type::Plus: logo::emit_instruction(compiler,0xF2,false,{0x0F,0x58},XMM0,XMM1); break;
+					case Ast_Binary_Operator_Type::Minus: logo::emit_instruction(compiler,0xF2,false,{0x0F,0x5C},XMM0,XMM1); break;
+					case Ast_Binary_Operator_Type::Multiply: logo::emit_instruction(compiler,0xF2,false,{0x0F,0x59},XMM0,XMM1); break;
+					case Ast_Binary_Operator_Type::Divide: logo::emit_instruction(compiler,0xF2,false,{0x0F,0x5E},XMM0,XMM1); break;
+					case Ast_Binary_Operator_Type::Remainder: logo::emit_call(compiler,reinterpret_cast<std::uint64_t>(&logo::jit_fmod)); break;
+					case Ast_Binary_Operator_Type::Exponentiate: logo::emit_call(compiler,reinterpret_cast<std::uint64_t>(&logo::jit_pow)); break;
+					default: logo::unreachable();
+				}
+				return Interpreter_Value_Type::Float;
+			}
+			case Ast_Binary_Operator_Type::Logical_And:
+			case Ast_Binary_Operator_Type::Logical_Or: {
+				if(left != Interpreter_Value_Type::Bool || right != Interpreter_Value_Type::Bool) return {};
+				logo::emit_instruction(compiler,0,true,{static_cast<std::uint8_t>((type == Ast_Binary_Operator_Type::Logical_And) ? 0x21 : 0x09)},RCX,RAX);
+				return Interpreter_Value_Type::Bool;
+			}
+			case Ast_Binary_Operator_Type::Compare_Equal:
+			case Ast_Binary_Operator_Type::Compare_Unequal:
+			case Ast_Binary_Operator_Type::Compare_Less_Than:
+			case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal:
+			case Ast_Binary_Operator_Type::Compare_Greater_Than:
+			case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: {
+				bool is_equality = (type == Ast_Binary_Operator_Type::Compare_Equal || type == Ast_Binary_Operator_Type::Compare_Unequal);
+				if((left == Interpreter_Value_Type::Int && right == Interpreter_Value_Type::Int) || (left == Interpreter_Value_Type::Bool && right == Interpreter_Value_Type::Bool && is_equality)) {
+					logo::emit_instruction(compiler,0,true,{0x39},RCX,RAX);
+					switch(type) {
+						case Ast_Binary_Operator_Type::Compare_Equal: logo::emit_set_condition(compiler,Jit_Condition::Equal); break;
+						case Ast_Binary_Operator_Type::Compare_Unequal: logo::emit_set_condition(compiler,Jit_Condition::Not_Equal); break;
+						case Ast_Binary_Operator_Type::Compare_Less_Than: logo::emit_set_condition(compiler,Jit_Condition::Less); break;
+						case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: logo::emit_set_condition(compiler,Jit_Condition::Less_Or_Equal); break;
+						case Ast_Binary_Operator_Type::Compare_Greater_Than: logo::emit_set_condition(compiler,Jit_Condition::Greater); break;
+						case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: logo::emit_set_condition(compiler,Jit_Condition::Greater_Or_Equal); break;
+						default: logo::unreachable();
+					}
+					return Interpreter_Value_Type::Bool;
+				}
+				if(!logo::is_numeric_type(left) || !logo::is_numeric_type(right)) return {};
+				if(left == Interpreter_Value_Type::Int) logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM0,RAX);
+				if(right == Interpreter_Value_Type::Int) logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM1,RCX);
+				//'ucomisd' sets the parity flag if any operand is NaN, the conditions are chosen so that every comparison with NaN except '!=' is false.
+				switch(type) {
+					case Ast_Binary_Operator_Type::Compare_Equal:
+					case Ast_Binary_Operator_Type::Compare_Unequal: {
+						bool is_equal = (type == Ast_Binary_Operator_Type::Compare_Equal);
+						logo::emit_instruction(compiler,0x66,false,{0x0F,0x2E},XMM0,XMM1);
+						logo::emit_bytes(compiler,{0x0F,static_cast<std::uint8_t>(0x90 | static_cast<std::uint8_t>(is_equal ? Jit_Condition::Equal : Jit_Condition::Not_Equal)),0xC0});
+						logo::emit_bytes(compiler,{0x0F,static_cast<std::uint8_t>(0x90 | static_cast<std::uint8_t>(is_equal ? Jit_Condition::No_Parity : Jit_Condition::Parity)),0xC1});
+						logo::emit_bytes(compiler,{static_cast<std::uint8_t>(is_equal ? 0x20 : 0x08),0xC8});
+						logo::emit_bytes(compiler,{0x0F,0xB6,0xC0});
+						break;
+					}
+					case Ast_Binary_Operator_Type::Compare_Less_Than:
+					case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: {
+						logo::emit_instruction(compiler,0x66,false,{0x0F,0x2E},XMM1,XMM0);
+						logo::emit_set_condition(compiler,(type == Ast_Binary_Operator_Type::Compare_Less_Than) ? Jit_Condition::Above : Jit_Condition::Above_Or_Equal);
+						break;
+					}
+					case Ast_Binary_Operator_Type::Compare_Greater_Than:
+					case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: {
+						logo::emit_instruction(compiler,0x66,false,{0x0F,0x2E},XMM0,XMM1);
+						logo::emit_set_condition(compiler,(type == Ast_Binary_Operator_Type::Compare_Greater_Than) ? Jit_Condition::Above : Jit_Condition::Above_Or_Equal);
+						break;
+					}
+					default: logo::unreachable();
+				}
+				return Interpreter_Value_Type::Bool;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	//Leaves the value of the expression in rax or xmm0. Expressions that the interpreter would report an error for are not compiled.
+	[[nodiscard]] static Option<Interpreter_Value_Type> compile_expression(Jit_Compiler* compiler,const Ast_Expression& expression) {
+		if(logo::is_simple_operand(expression)) return logo::compile_simple_operand(compiler,expression,RAX,XMM0);
+		switch(expression.type) {
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto& unary_operator = *expression.unary_prefix_operator;
+				if(!logo::is_one_of(unary_operator.type,Ast_Unary_Prefix_Operator_Type::Plus,Ast_Unary_Prefix_Operator_Type::Minus,Ast_Unary_Prefix_Operator_Type::Logical_Not)) return {};
+				auto [type,success] = logo::compile_expression(compiler,*unary_operator.child);
+				if(!success) return {};
+				if(unary_operator.type == Ast_Unary_Prefix_Operator_Type::Logical_Not) {
+					if(type != Interpreter_Value_Type::Bool) return {};
+					logo::emit_bytes(compiler,{0x83,0xF0,0x01});
+					return type;
+				}
+				if(!logo::is_numeric_type(type)) return {};
+				if(unary_operator.type == Ast_Unary_Prefix_Operator_Type::Minus) {
+					if(type == Interpreter_Value_Type::Int) logo::emit_instruction(compiler,0,true,{0xF7},3,RAX);
+					else {
+						logo::emit_move_float_immediate(compiler,XMM1,-1.0);
+						logo::emit_instruction(compiler,0xF2,false,{0x0F,0x59},XMM0,XMM1);
+					}
+				}
+				return type;
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto& binary_operator = *expression.binary_operator;
+				auto [left_type,success0] = logo::compile_expression(compiler,*binary_operator.left);
+				if(!success0) return {};
+				if(binary_operator.type == Ast_Binary_Operator_Type::Logical_And || binary_operator.type == Ast_Binary_Operator_Type::Logical_Or) {
+					//The left operand stays in rax when it decides the result.
+					if(left_type != Interpreter_Value_Type::Bool) return {};
+					std::size_t end_jump = (binary_operator.type == Ast_Binary_Operator_Type::Logical_And) ? logo::emit_jump_if_false(compiler) : logo::emit_jump_if_true(compiler);
+					auto [right_type,success1] = logo::compile_expression(compiler,*binary_operator.right);
+					if(!success1 || right_type != Interpreter_Value_Type::Bool) return {};
+					logo::patch_jump(compiler,end_jump,compiler->code.length);
+					return Interpreter_Value_Type::Bool;
+				}
+				Interpreter_Value_Type right_type{};
+				if(logo::is_simple_operand(*binary_operator.right)) {
+					auto [type,success1] = logo::compile_simple_operand(compiler,*binary_operator.right,RCX,XMM1);
+					if(!success1) return {};
+					right_type = type;
+				}
+				else {
+					logo::emit_push(compiler,left_type);
+					auto [type,success1] = logo::compile_expression(compiler,*binary_operator.right);
+					if(!success1) return {};
+					right_type = type;
+					logo::emit_move_to_second_operand(compiler,right_type);
+					logo::emit_pop(compiler,left_type);
+				}
+				return logo::emit_binary_operation(compiler,binary_operator.type,left_type,right_type,*binary_operator.right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				//Both branches must leave a value of the same type in the same register.
+				const auto& conditional = *expression.conditional;
+				auto [condition_type,success0] = logo::compile_expression(compiler,*conditional.condition);
+				if(!success0 || condition_type != Interpreter_Value_Type::Bool) return {};
+				std::size_t else_jump = logo::emit_jump_if_false(compiler);
+				auto [if_true_type,success1] = logo::compile_expression(compiler,*conditional.if_true);
+				if(!success1) return {};
+				std::size_t end_jump = logo::emit_jump(compiler);
+				logo::patch_jump(compiler,else_jump,compiler->code.length);
+				auto [if_false_type,success2] = logo::compile_expression(compiler,*conditional.if_false);
+				if(!success2 || if_false_type != if_true_type) return {};
+				logo::patch_jump(compiler,end_jump,compiler->code.length);
+				return if_true_type;
+			}
+			default: return {};
+		}
+	}
+
+	[[nodiscard]] static bool compile_statements(Jit_Compiler* compiler,Array_View<Ast_Statement> statements);
+
+	//Variables declared inside of the statements go out of scope after them.
+	[[nodiscard]] static bool compile_scope(Jit_Compiler* compiler,Array_View<Ast_Statement> statements) {
+		std::size_t variable_count = compiler->variable_types.length;
+		if(!logo::compile_statements(compiler,statements)) return false;
+		compiler->variable_types.length = variable_count;
+		return true;
+	}
+
+	[[nodiscard]] static bool declare_variable(Jit_Compiler* compiler,Interpreter_Value_Type type) {
+		if(!compiler->variable_types.push_back(type)) {
+			compiler->is_out_of_memory = true;
+			return false;
+		}
+		if(compiler->variable_types.length > compiler->max_variable_count) compiler->max_variable_count = compiler->variable_types.length;
+		return true;
+	}
+
+	[[nodiscard]] static bool begin_loop(Jit_Compiler* compiler) {
+		Jit_Loop loop{};
+		loop.first_jump_index = compiler->loop_jumps.length;
+		if(!compiler->loops.push_back(loop)) {
+			compiler->is_out_of_memory = true;
+			return false;
+		}
+		return true;
+	}
+
+	static void end_loop(Jit_Compiler* compiler,std::size_t continue_offset,std::size_t break_offset) {
+		const auto& loop = compiler->loops[compiler->loops.length - 1];
+		for(std::size_t i = loop.first_jump_index;i < compiler->loop_jumps.length;i += 1) {
+			const auto& jump = compiler->loop_jumps[i];
+			logo::patch_jump(compiler,jump.patch_offset,jump.is_break ? break_offset : continue_offset);
+		}
+		compiler->loop_jumps.length = loop.first_jump_index;
+		compiler->loops.length -= 1;
+	}
+
+	//Counts a loop iteration like 'count_watchdog_step' and leaves the function if the watchdog stops it.
+	static void emit_watchdog_step(Jit_Compiler* compiler,std::size_t line_index) {
+		//mov rax,&countdown; sub qword [rax],1; jnz continue
+		logo::emit_move_immediate(compiler,RAX,reinterpret_cast<std::uint64_t>(&compiler->context->watchdog.countdown));
+		logo::emit_bytes(compiler,{0x48,0x83,0x28,0x01,0x0F,0x85});
+		logo::emit_u32(compiler,0);
+		std::size_t countdown_jump = compiler->code.length - 4;
+
+		logo::emit_move_immediate(compiler,RDI,reinterpret_cast<std::uint64_t>(compiler->context));
+		logo::emit_move_immediate(compiler,RSI,static_cast<std::uint64_t>(line_index));
+		logo::emit_call(compiler,reinterpret_cast<std::uint64_t>(&logo::check_watchdog_limits));
+		//test al,al; jnz continue
+		logo::emit_bytes(compiler,{0x84,0xC0,0x0F,0x85});
+		logo::emit_u32(compiler,0);
+		std::size_t limits_jump = compiler->code.length - 4;
+
+		logo::emit_memory_instruction(compiler,0,true,{0xC7},0,RBX,sizeof(std::uint64_t));
+		logo::emit_u32(compiler,static_cast<std::uint32_t>(JIT_STOPPED_TYPE));
+		if(!compiler->return_jumps.push_back(logo::emit_jump(compiler))) compiler->is_out_of_memory = true;
+		logo::patch_jump(compiler,countdown_jump,compiler->code.length);
+		logo::patch_jump(compiler,limits_jump,compiler->code.length);
+	}
+
+	//Only calls to the turtle movement functions are compiled, they are made directly on the canvas.
+	[[nodiscard]] static bool compile_turtle_call(Jit_Compiler* compiler,const Ast_Function_Call& function_call) {
+		auto name = function_call.name;
+		if(function_call.arguments.length != 1) return false;
+		if(!logo::is_one_of(name,compiler->forward_symbol,compiler->backward_symbol,compiler->backwards_symbol,compiler->right_symbol,compiler->left_symbol)) return false;
+		auto [type,success] = logo::compile_expression(compiler,*function_call.arguments[0]);
+		if(!success || !logo::is_numeric_type(type)) return false;
+		if(type == Interpreter_Value_Type::Int) logo::emit_instruction(compiler,0xF2,true,{0x0F,0x2A},XMM0,RAX);
+
+		if(name == compiler->right_symbol || name == compiler->left_symbol) {
+			auto rotation_displacement = static_cast<std::int32_t>(offsetof(Canvas,rot));
+			logo::emit_memory_instruction(compiler,0xF2,false,{0x0F,0x10},XMM1,R12,rotation_displacement);
+			logo::emit_instruction(compiler,0xF2,false,{0x0F,static_cast<std::uint8_t>((name == compiler->right_symbol) ? 0x5C : 0x58)},XMM1,XMM0);
+			logo::emit_memory_instruction(compiler,0xF2,false,{0x0F,0x11},XMM1,R12,rotation_displacement);
+			return true;
+		}
+		if(name != compiler->forward_symbol) {
+			//Flips the sign bit like the unary minus in the interpreter.
+			logo::emit_move_float_immediate(compiler,XMM1,-0.0);
+			logo::emit_instruction(compiler,0x66,false,{0x0F,0x57},XMM0,XMM1);
+		}
+		logo::emit_instruction(compiler,0,true,{0x89},R12,RDI);
+		logo::emit_call(compiler,reinterpret_cast<std::uint64_t>(&logo::jit_move_forward));
+		return true;
+	}
+
+	[[nodiscard]] static Option<Ast_Binary_Operator_Type> get_compound_assignment_operator(Ast_Assignment_Type type) {
+		switch(type) {
+			case Ast_Assignment_Type::Compound_Plus: return Ast_Binary_Operator_Type::Plus;
+			case Ast_Assignment_Type::Compound_Minus: return Ast_Binary_Operator_Type::Minus;
+			case Ast_Assignment_Type::Compound_Multiply: return Ast_Binary_Operator_Type::Multiply;
+			case Ast_Assignment_Type::Compound_Divide: return Ast_Binary_Operator_Type::Divide;
+			case Ast_Assignment_Type::Compound_Remainder: return Ast_Binary_Operator_Type::Remainder;
+			case Ast_Assignment_Type::Compound_Exponentiate: return Ast_Binary_Operator_Type::Exponentiate;
+			default: return {};
+		}
+	}
+
+	//Variables keep the type they were declared with, assignments that would change it are not compiled.
+	[[nodiscard]] static bool compile_assignment(Jit_Compiler* compiler,const Ast_Assignment& assignment) {
+		std::uint8_t base = 0;
+		std::int32_t displacement = 0;
+		Interpreter_Value_Type target_type{};
+		if(!logo::find_variable(compiler,assignment.lvalue_expr,&base,&displacement,&target_type)) return false;
+		//Variables outside of the function are loaded when it's called, so they can't be modified.
+		if(displacement < logo::get_variable_displacement(compiler,0)) return false;
+
+		auto [value_type,success0] = logo::compile_expression(compiler,assignment.rvalue_expr);
+		if(!success0) return false;
+		if(assignment.type != Ast_Assignment_Type::Assignment) {
+			auto [operator_type,success1] = logo::get_compound_assignment_operator(assignment.type);
+			if(!success1 || !logo::is_numeric_type(target_type)) return false;
+			logo::emit_move_to_second_operand(compiler,value_type);
+			logo::emit_load(compiler,target_type,RAX,XMM0,base,displacement);
+			auto [result_type,success2] = logo::emit_binary_operation(compiler,operator_type,target_type,value_type,assignment.rvalue_expr);
+			if(!success2) return false;
+			value_type = result_type;
+		}
+		if(value_type != target_type) return false;
+		logo::emit_store(compiler,value_type,base,displacement);
+		return true;
+	}
+
+	//Follows 'execute_for_statement': the counter and the upper bound are computed once and the iterator is increased together with the counter.
+	[[nodiscard]] static bool compile_for_statement(Jit_Compiler* compiler,const Ast_For_Statement& for_statement,std::size_t line_index) {
+		//Parallel loops reset the turtle between the iterations and are split between threads by the interpreter.
+		if(for_statement.is_parallel) return false;
+		std::size_t hidden_slot_count = compiler->hidden_slot_count;
+		std::size_t variable_count = compiler->variable_types.length;
+		auto counter_displacement = logo::push_hidden_slot(compiler);
+		auto upper_bound_displacement = logo::push_hidden_slot(compiler);
+
+		auto [lower_bound_type,success0] = logo::compile_expression(compiler,for_statement.start_expr);
+		if(!success0 || lower_bound_type != Interpreter_Value_Type::Int) return false;
+		logo::emit_store(compiler,Interpreter_Value_Type::Int,RBP,counter_displacement);
+		auto [upper_bound_type,success1] = logo::compile_expression(compiler,for_statement.end_expr);
+		if(!success1 || upper_bound_type != Interpreter_Value_Type::Int) return false;
+		logo::emit_store(compiler,Interpreter_Value_Type::Int,RBP,upper_bound_displacement);
+
+		logo::emit_load(compiler,Interpreter_Value_Type::Int,RAX,XMM0,RBP,counter_displacement);
+		logo::emit_memory_instruction(compiler,0,true,{0x3B},RAX,RBP,upper_bound_displacement);
+		logo::emit_bytes(compiler,{0x0F,static_cast<std::uint8_t>(0x80 | static_cast<std::uint8_t>(Jit_Condition::Greater_Or_Equal))});
+		logo::emit_u32(compiler,0);
+		std::size_t skip_loop_jump = compiler->code.length - 4;
+
+		std::size_t iterator_slot = compiler->variable_types.length;
+		if(!logo::declare_variable(compiler,Interpreter_Value_Type::Int)) return false;
+		logo::emit_store(compiler,Interpreter_Value_Type::Int,RBX,logo::get_variable_displacement(compiler,iterator_slot));
+
+		//Induction variables start at 'counter * step'.
+		Static_Array<std::int32_t,MAX_INDUCTION_VARIABLE_COUNT> step_displacements{};
+		for(const auto& induction_variable : for_statement.induction_variables) {
+			auto [step_type,success2] = logo::compile_expression(compiler,induction_variable.step_expr);
+			if(!success2 || step_type != Interpreter_Value_Type::Int) return false;
+			auto step_displacement = logo::push_hidden_slot(compiler);
+			if(!step_displacements.push_back(step_displacement)) return false;
+			logo::emit_store(compiler,Interpreter_Value_Type::Int,RBP,step_displacement);
+			logo::emit_memory_instruction(compiler,0,true,{0x0F,0xAF},RAX,RBP,counter_displacement);
+			std::size_t slot = compiler->variable_types.length;
+			if(!logo::declare_variable(compiler,Interpreter_Value_Type::Int)) return false;
+			logo::emit_store(compiler,Interpreter_Value_Type::Int,RBX,logo::get_variable_displacement(compiler,slot));
+		}
+
+		if(!logo::begin_loop(compiler)) return false;
+		std::size_t body_offset = compiler->code.length;
+		if(!logo::compile_scope(compiler,{for_statement.body_statements.data,for_statement.body_statements.length})) return false;
+
+		std::size_t continue_offset = compiler->code.length;
+		logo::emit_watchdog_step(compiler,line_index);
+		logo::emit_load(compiler,Interpreter_Value_Type::Int,RAX,XMM0,RBP,counter_displacement);
+		logo::emit_bytes(compiler,{0x48,0x83,0xC0,0x01});
+		logo::emit_store(compiler,Interpreter_Value_Type::Int,RBP,counter_displacement);
+		logo::emit_memory_instruction(compiler,0,true,{0x3B},RAX,RBP,upper_bound_displacement);
+		logo::emit_bytes(compiler,{0x0F,static_cast<std::uint8_t>(0x80 | static_cast<std::uint8_t>(Jit_Condition::Greater_Or_Equal))});
+		logo::emit_u32(compiler,0);
+		std::size_t exit_loop_jump = compiler->code.length - 4;
+
+		auto iterator_displacement = logo::get_variable_displacement(compiler,iterator_slot);
+		logo::emit_memory_instruction(compiler,0,true,{0x83},0,RBX,iterator_displacement);
+		logo::emit_byte(compiler,0x01);
+		for(std::size_t i = 0;i < step_displacements.length;i += 1) {
+			logo::emit_load(compiler,Interpreter_Value_Type::Int,RAX,XMM0,RBP,step_displacements[i]);
+			logo::emit_memory_instruction(compiler,0,true,{0x01},RAX,RBX,logo::get_variable_displacement(compiler,iterator_slot + 1 + i));
+		}
+		logo::patch_jump(compiler,logo::emit_jump(compiler),body_offset);
+
+		std::size_t break_offset = compiler->code.length;
+		logo::end_loop(compiler,continue_offset,break_offset);
+		logo::patch_jump(compiler,skip_loop_jump,break_offset);
+		logo::patch_jump(compiler,exit_loop_jump,break_offset);
+		compiler->variable_types.length = variable_count;
+		compiler->hidden_slot_count = hidden_slot_count;
+		return true;
+	}
+
+	[[nodiscard]] static bool compile_statement(Jit_Compiler* compiler,const Ast_Statement& statement) {
+		logo::assert(compiler->pushed_value_count == 0);
+		switch(statement.type) {
+			case Ast_Statement_Type::Expression: {
+				if(statement.expression.type == Ast_Expression_Type::Function_Call) return logo::compile_turtle_call(compiler,*statement.expression.function_call);
+				auto [type,success] = logo::compile_expression(compiler,statement.expression);
+				return success;
+			}
+			case Ast_Statement_Type::Declaration: {
+				auto [type,success] = logo::compile_expression(compiler,statement.declaration.initial_value_expr);
+				if(!success) return false;
+				std::size_t slot = compiler->variable_types.length;
+				if(!logo::declare_variable(compiler,type)) return false;
+				logo::emit_store(compiler,type,RBX,logo::get_variable_displacement(compiler,slot));
+				return true;
+			}
+			case Ast_Statement_Type::Assignment: return logo::compile_assignment(compiler,statement.assignment);
+			case Ast_Statement_Type::If_Statement: {
+				const auto& if_statement = statement.if_statement;
+				auto [type,success] = logo::compile_expression(compiler,if_statement.condition_expr);
+				if(!success || type != Interpreter_Value_Type::Bool) return false;
+				std::size_t else_jump = logo::emit_jump_if_false(compiler);
+				if(!logo::compile_scope(compiler,{if_statement.if_true_statements.data,if_statement.if_true_statements.length})) return false;
+				if(if_statement.if_false_statements.length == 0) {
+					logo::patch_jump(compiler,else_jump,compiler->code.length);
+					return true;
+				}
+				std::size_t end_jump = logo::emit_jump(compiler);
+				logo::patch_jump(compiler,else_jump,compiler->code.length);
+				if(!logo::compile_scope(compiler,{if_statement.if_false_statements.data,if_statement.if_false_statements.length})) return false;
+				logo::patch_jump(compiler,end_jump,compiler->code.length);
+				return true;
+			}
+			case Ast_Statement_Type::While_Statement: {
+				const auto& while_statement = statement.while_statement;
+				std::size_t condition_offset = compiler->code.length;
+				auto [type,success] = logo::compile_expression(compiler,while_statement.condition_expr);
+				if(!success || type != Interpreter_Value_Type::Bool) return false;
+				std::size_t exit_jump = logo::emit_jump_if_false(compiler);
+				if(!logo::begin_loop(compiler)) return false;
+				if(!logo::compile_scope(compiler,{while_statement.body_statements.data,while_statement.body_statements.length})) return false;
+				std::size_t continue_offset = compiler->code.length;
+				logo::emit_watchdog_step(compiler,statement.line_index);
+				logo::patch_jump(compiler,logo::emit_jump(compiler),condition_offset);
+				logo::end_loop(compiler,continue_offset,compiler->code.length);
+				logo::patch_jump(compiler,exit_jump,compiler->code.length);
+				return true;
+			}
+			case Ast_Statement_Type::For_Statement: return logo::compile_for_statement(compiler,statement.for_statement,statement.line_index);
+			case Ast_Statement_Type::Break_Statement:
+			case Ast_Statement_Type::Continue_Statement: {
+				Jit_Loop_Jump jump{};
+				jump.patch_offset = logo::emit_jump(compiler);
+				jump.is_break = (statement.type == Ast_Statement_Type::Break_Statement);
+				if(!compiler->loop_jumps.push_back(jump)) {
+					compiler->is_out_of_memory = true;
+					return false;
+				}
+				return true;
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				auto type = Interpreter_Value_Type::Void;
+				if(statement.return_statement.return_value) {
+					auto [value_type,success] = logo::compile_expression(compiler,*statement.return_statement.return_value);
+					if(!success) return false;
+					type = value_type;
+					logo::emit_store(compiler,type,RBX,0);
+				}
+				logo::emit_memory_instruction(compiler,0,true,{0xC7},0,RBX,sizeof(std::uint64_t));
+				logo::emit_u32(compiler,static_cast<std::uint32_t>(type));
+				if(!compiler->return_jumps.push_back(logo::emit_jump(compiler))) {
+					compiler->is_out_of_memory = true;
+					return false;
+				}
+				return true;
+			}
+			//Functions defined inside of the function would have to be called through the interpreter.
+			case Ast_Statement_Type::Function_Definition: return false;
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool compile_statements(Jit_Compiler* compiler,Array_View<Ast_Statement> statements) {
+		for(const auto& statement : statements) {
+			if(!logo::compile_statement(compiler,statement)) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool add_parent_variable(Jit_State* jit,const Interpreter_Context* context,std::size_t first_parent_variable,const Ast_Value& value) {
+		for(std::size_t i = first_parent_variable;i < jit->parent_variables.length;i += 1) {
+			if(jit->parent_variables[i].name == value.identfier_name) return true;
+		}
+		auto var_index = logo::lookup_parent_scope_variable(context,value.identfier_name,value.slot);
+		if(var_index == context->variables.length) return false;
+		const auto& variable = context->variables[var_index];
+		if(!logo::is_compilable_type(variable.value.type)) return false;
+		Jit_Parent_Variable parent_variable{};
+		parent_variable.name = value.identfier_name;
+		parent_variable.slot = value.slot;
+		parent_variable.type = variable.value.type;
+		return jit->parent_variables.push_back(parent_variable);
+	}
+
+	[[nodiscard]] static bool collect_parent_variables(Jit_State* jit,const Interpreter_Context* context,std::size_t first_parent_variable,const Ast_Expression& expression) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto& unary_operator = *expression.unary_prefix_operator;
+				const auto& child = *unary_operator.child;
+				if(unary_operator.type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access && child.type == Ast_Expression_Type::Value &&
+				   child.value.type == Ast_Value_Type::Identifier && child.value.depth > 0) {
+					return logo::add_parent_variable(jit,context,first_parent_variable,child.value);
+				}
+				return logo::collect_parent_variables(jit,context,first_parent_variable,child);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				if(!logo::collect_parent_variables(jit,context,first_parent_variable,*expression.binary_operator->left)) return false;
+				return logo::collect_parent_variables(jit,context,first_parent_variable,*expression.binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::collect_parent_variables(jit,context,first_parent_variable,*expression.conditional->condition)) return false;
+				if(!logo::collect_parent_variables(jit,context,first_parent_variable,*expression.conditional->if_true)) return false;
+				return logo::collect_parent_variables(jit,context,first_parent_variable,*expression.conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				for(const auto* arg_expr : expression.function_call->arguments) {
+					if(!logo::collect_parent_variables(jit,context,first_parent_variable,*arg_expr)) return false;
+				}
+				return true;
+			}
+			default: return false;
+		}
+	}
+
+	[[nodiscard]] static bool collect_parent_variables(Jit_State* jit,const Interpreter_Context* context,std::size_t first_parent_variable,Array_View<Ast_Statement> statements) {
+		for(const auto& statement : statements) {
+			bool success = true;
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: success = logo::collect_parent_variables(jit,context,first_parent_variable,statement.expression); break;
+				case Ast_Statement_Type::Declaration: success = logo::collect_parent_variables(jit,context,first_parent_variable,statement.declaration.initial_value_expr); break;
+				case Ast_Statement_Type::Assignment: {
+					success = logo::collect_parent_variables(jit,context,first_parent_variable,statement.assignment.lvalue_expr) &&
+							  logo::collect_parent_variables(jit,context,first_parent_variable,statement.assignment.rvalue_expr);
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					const auto& if_statement = statement.if_statement;
+					success = logo::collect_parent_variables(jit,context,first_parent_variable,if_statement.condition_expr) &&
+							  logo::collect_parent_variables(jit,context,first_parent_variable,{if_statement.if_true_statements.data,if_statement.if_true_statements.length}) &&
+							  logo::collect_parent_variables(jit,context,first_parent_variable,{if_statement.if_false_statements.data,if_statement.if_false_statements.length});
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					const auto& while_statement = statement.while_statement;
+					success = logo::collect_parent_variables(jit,context,first_parent_variable,while_statement.condition_expr) &&
+							  logo::collect_parent_variables(jit,context,first_parent_variable,{while_statement.body_statements.data,while_statement.body_statements.length});
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					const auto& for_statement = statement.for_statement;
+					success = logo::collect_parent_variables(jit,context,first_parent_variable,for_statement.start_expr) &&
+							  logo::collect_parent_variables(jit,context,first_parent_variable,for_statement.end_expr) &&
+							  logo::collect_parent_variables(jit,context,first_parent_variable,{for_statement.body_statements.data,for_statement.body_statements.length});
+					for(const auto& induction_variable : for_statement.induction_variables) {
+						success = success && logo::collect_parent_variables(jit,context,first_parent_variable,induction_variable.step_expr);
+					}
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value) success = logo::collect_parent_variables(jit,context,first_parent_variable,*statement.return_statement.return_value);
+					break;
+				}
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				case Ast_Statement_Type::Function_Definition: success = false; break;
+				default: logo::unreachable();
+			}
+			if(!success) return false;
+		}
+		return true;
+	}
+
+	//Copies the code into new pages which are made executable after they're written.
+	[[nodiscard]] static void* make_executable_code(Jit_State* jit,const Heap_Array<std::uint8_t>& code) {
+		auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+		std::size_t size = (code.length + page_size - 1) / page_size * page_size;
+		void* address = mmap(nullptr,size,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+		if(address == MAP_FAILED) return nullptr;
+		std::memcpy(address,code.data,code.length);
+		Jit_Code_Region region{};
+		region.address = address;
+		region.size = size;
+		if(mprotect(address,size,PROT_READ | PROT_EXEC) != 0 || !jit->code_regions.push_back(region)) {
+			munmap(address,size);
+			return nullptr;
+		}
+		return address;
+	}
+
+	//Returns false if the function can't be compiled. The body is specialized for the types of 'args' and of the variables it accesses with operator '.
+	[[nodiscard]] static bool compile_function(Jit_State* jit,Interpreter_Context* context,Array_View<Ast_Statement> statements,Array_View<Interpreter_Value> args,Jit_Function* jit_function) {
+		for(const auto& arg : args) {
+			if(!logo::is_compilable_type(arg.type) || !jit_function->argument_types.push_back(arg.type)) return false;
+		}
+		jit_function->first_parent_variable = jit->parent_variables.length;
+		bool successful_return = false;
+		defer[&]{if(!successful_return) jit->parent_variables.length = jit_function->first_parent_variable;};
+		if(!logo::collect_parent_variables(jit,context,jit_function->first_parent_variable,statements)) return false;
+		jit_function->parent_variable_count = jit->parent_variables.length - jit_function->first_parent_variable;
+
+		Jit_Compiler compiler{};
+		defer[&]{compiler.destroy();};
+		compiler.context = context;
+		compiler.parent_variables = Array_View<Jit_Parent_Variable>(jit->parent_variables.data + jit_function->first_parent_variable,jit_function->parent_variable_count);
+		String_View names[] = {"forward","backward","backwards","right","left"};
+		Symbol* symbols[] = {&compiler.forward_symbol,&compiler.backward_symbol,&compiler.backwards_symbol,&compiler.right_symbol,&compiler.left_symbol};
+		for(std::size_t i = 0;i < logo::array_length(names);i += 1) {
+			auto [symbol,success] = logo::intern_symbol(names[i]);
+			if(!success) return false;
+			*symbols[i] = symbol;
+		}
+		for(const auto& arg : args) {
+			if(!logo::declare_variable(&compiler,arg.type)) return false;
+		}
+
+		//push rbp; mov rbp,rsp; push rbx; push r12; sub rsp,frame_size; mov rbx,rdi; mov r12,rsi
+		logo::emit_bytes(&compiler,{0x55,0x48,0x89,0xE5,0x53,0x41,0x54});
+		logo::emit_instruction(&compiler,0,true,{0x81},5,RSP);
+		logo::emit_u32(&compiler,0);
+		std::size_t frame_size_offset = compiler.code.length - 4;
+		logo::emit_instruction(&compiler,0,true,{0x89},RDI,RBX);
+		logo::emit_instruction(&compiler,0,true,{0x89},RSI,R12);
+
+		if(!logo::compile_statements(&compiler,statements)) return false;
+		logo::emit_memory_instruction(&compiler,0,true,{0xC7},0,RBX,sizeof(std::uint64_t));
+		logo::emit_u32(&compiler,static_cast<std::uint32_t>(Interpreter_Value_Type::Void));
+		for(auto return_jump : compiler.return_jumps) logo::patch_jump(&compiler,return_jump,compiler.code.length);
+		//lea rsp,[rbp-16]; pop r12; pop rbx; pop rbp; ret
+		logo::emit_memory_instruction(&compiler,0,true,{0x8D},RSP,RBP,-16);
+		logo::emit_bytes(&compiler,{0x41,0x5C,0x5B,0x5D,0xC3});
+		if(compiler.is_out_of_memory) return false;
+
+		//The frame keeps the stack aligned to 16 bytes.
+		auto frame_size = static_cast<std::uint32_t>((compiler.max_hidden_slot_count * sizeof(std::uint64_t) + 15) / 16 * 16);
+		std::memcpy(compiler.code.data + frame_size_offset,&frame_size,sizeof(frame_size));
+		jit_function->slot_count = JIT_FIRST_PARENT_VARIABLE_SLOT + jit_function->parent_variable_count + compiler.max_variable_count;
+		jit_function->code = logo::make_executable_code(jit,compiler.code);
+		if(!jit_function->code) return false;
+		successful_return = true;
+		return true;
+	}
+
+	[[nodiscard]] static std::uint64_t get_value_bits(const Interpreter_Value& value) {
+		switch(value.type) {
+			case Interpreter_Value_Type::Int: return static_cast<std::uint64_t>(value.int_v);
+			case Interpreter_Value_Type::Float: return std::bit_cast<std::uint64_t>(value.float_v);
+			case Interpreter_Value_Type::Bool: return value.bool_v ? 1 : 0;
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static Interpreter_Value make_value_from_bits(Interpreter_Value_Type type,std::uint64_t bits) {
+		Interpreter_Value value{};
+		value.type = type;
+		switch(type) {
+			case Interpreter_Value_Type::Void: break;
+			case Interpreter_Value_Type::Int: value.int_v = static_cast<std::int64_t>(bits); break;
+			case Interpreter_Value_Type::Float: value.float_v = std::bit_cast<double>(bits); break;
+			case Interpreter_Value_Type::Bool: value.bool_v = (bits != 0); break;
+			default: logo::unreachable();
+		}
+		return value;
+	}
+
+	//Returns the index of the compiled function, the code is null if it couldn't be compiled.
+	[[nodiscard]] static Option<std::size_t> find_or_compile_function(Jit_State* jit,Interpreter_Context* context,const Interpreter_Function& function,Array_View<Interpreter_Value> args) {
+		for(std::size_t i = 0;i < jit->functions.length;i += 1) {
+			if(jit->functions[i].body_statements == function.body_statements.ptr) return i;
+		}
+		Jit_Function jit_function{};
+		jit_function.body_statements = function.body_statements.ptr;
+		if(!logo::compile_function(jit,context,function.body_statements,args,&jit_function)) {
+			jit_function.code = nullptr;
+			jit_function.parent_variable_count = 0;
+		}
+		if(!jit->functions.push_back(jit_function)) return {};
+		return jit->functions.length - 1;
+	}
+#endif
+
+	Jit_Call_Result call_jit_function(Jit_State* jit,Interpreter_Context* context,Interpreter_Function* function,Array_View<Interpreter_Value> args,Interpreter_Value* result) {
+#ifdef LOGO_JIT_SUPPORTED
+		if(!jit->is_enabled) return Jit_Call_Result::Interpreted;
+		if(function->jit_function_index == 0) {
+			function->call_count += 1;
+			if(function->call_count < JIT_CALL_COUNT_THRESHOLD) return Jit_Call_Result::Interpreted;
+			auto [index,success] = logo::find_or_compile_function(jit,context,*function,args);
+			if(!success) return Jit_Call_Result::Interpreted;
+			function->jit_function_index = index + 1;
+		}
+		const auto& jit_function = jit->functions[function->jit_function_index - 1];
+		if(!jit_function.code) return Jit_Call_Result::Interpreted;
+		for(std::size_t i = 0;i < args.length;i += 1) {
+			if(args[i].type != jit_function.argument_types[i]) return Jit_Call_Result::Interpreted;
+		}
+		if(jit->slots.length < jit_function.slot_count && !jit->slots.resize(jit_function.slot_count)) return Jit_Call_Result::Interpreted;
+
+		auto* slots = jit->slots.data;
+		for(std::size_t i = 0;i < jit_function.parent_variable_count;i += 1) {
+			const auto& parent_variable = jit->parent_variables[jit_function.first_parent_variable + i];
+			auto var_index = logo::lookup_parent_scope_variable(context,parent_variable.name,parent_variable.slot);
+			if(var_index == context->variables.length) return Jit_Call_Result::Interpreted;
+			const auto& value = context->variables[var_index].value;
+			if(value.type != parent_variable.type) return Jit_Call_Result::Interpreted;
+			slots[JIT_FIRST_PARENT_VARIABLE_SLOT + i] = logo::get_value_bits(value);
+		}
+		std::size_t first_variable_slot = JIT_FIRST_PARENT_VARIABLE_SLOT + jit_function.parent_variable_count;
+		for(std::size_t i = 0;i < args.length;i += 1) slots[first_variable_slot + i] = logo::get_value_bits(args[i]);
+
+		reinterpret_cast<Jit_Code>(jit_function.code)(slots,&context->canvas);
+		auto type = static_cast<Interpreter_Value_Type>(slots[1]);
+		if(type == JIT_STOPPED_TYPE) return Jit_Call_Result::Stopped;
+		*result = logo::make_value_from_bits(type,slots[0]);
+		return Jit_Call_Result::Returned;
+#else
+		(void)jit;
+		(void)context;
+		(void)function;
+		(void)args;
+		(void)result;
+		return Jit_Call_Result::Interpreted;
+#endif
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef LOGO_JIT_HPP
+#define LOGO_JIT_HPP
+
+#include <cstdint>
+#include "parser.hpp"
+#include "heap_array.hpp"
+#include "array_view.hpp"
+#include "interpreter.hpp"
+#include "static_array.hpp"
+
+namespace logo {
+	//User defined functions are compiled to machine code once they have been called this many times.
+	static constexpr std::size_t JIT_CALL_COUNT_THRESHOLD = 50;
+
+	//Variables outside of the function accessed with operator '. They are looked up when the compiled function is called.
+	struct Jit_Parent_Variable {
+		Symbol name;
+		std::size_t slot; //'Ast_Value::slot' of the accessed identifier.
+		Interpreter_Value_Type type;
+	};
+	struct Jit_Function {
+		const Ast_Statement* body_statements; //Functions defined by the same definition share the compiled code.
+		void* code; //Null if the function uses something that can't be compiled, the function is always interpreted then.
+		Static_Array<Interpreter_Value_Type,16> argument_types; //The code is only valid for the argument types of the call that compiled it.
+		std::size_t first_parent_variable;
+		std::size_t parent_variable_count;
+		std::size_t slot_count;
+	};
+	struct Jit_Code_Region {
+		void* address;
+		std::size_t size;
+	};
+	struct Jit_State {
+		bool is_enabled;
+		Heap_Array<Jit_Function> functions;
+		Heap_Array<Jit_Parent_Variable> parent_variables;
+		Heap_Array<Jit_Code_Region> code_regions;
+		Heap_Array<std::uint64_t> slots; //Return value, parent variables and local variables of the running compiled function.
+		void destroy();
+	};
+
+	enum struct Jit_Call_Result {
+		Interpreted, //The call has to be interpreted.
+		Returned,
+		Stopped //The watchdog stopped the compiled code in a loop, the error has been reported.
+	};
+
+	//The JIT is only available on x86-64 Linux, 'is_jit_supported' returns false everywhere else and no function is ever compiled.
+	[[nodiscard]] bool is_jit_supported();
+	//Counts the calls of the function and compiles it when it gets hot. If the function has been compiled and the types of the arguments and
+	//of the variables accessed with operator ' match the compiled code, runs the machine code and stores the returned value in 'result'.
+	//Compiled functions don't call other user defined functions, take references or define functions, so they can only be stopped by the watchdog.
+	[[nodiscard]] Jit_Call_Result call_jit_function(Jit_State* jit,Interpreter_Context* context,Interpreter_Function* function,Array_View<Interpreter_Value> args,Interpreter_Value* result);
+}
+
+#endif
@@ -160,6 +160,9 @@ namespace logo {
 		else if(std::strcmp(token.string.begin_ptr,"for") == 0) {
 			token.type = Token_Type::Keyword_For;
 		}
+		else if(std::strcmp(token.string.begin_ptr,"parallel") == 0) {
+			token.type = Token_Type::Keyword_Parallel;
+		}
 		else if(std::strcmp(token.string.begin_ptr,"while") == 0) {
 			token.type = Token_Type::Keyword_While;
 		}
@@ -200,6 +203,9 @@ namespace logo {
 		}
 		else if(lexer.token_status == Lexing_Token_Status::Identifier) {
 			token.type = Token_Type::Identifier;
+			auto [symbol,success] = logo::intern_symbol(token.string);
+			if(!success) return false;
+			token.symbol = symbol;
 		}
 		else if(lexer.token_status == Lexing_Token_Status::String_Literal) {
 			token.type = Token_Type::String_Literal;
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include "string.hpp"
+#include "symbol_table.hpp"
 
 namespace logo {
 	enum struct Token_Type {
@@ -54,6 +55,7 @@ namespace logo {
 		Keyword_Else,
 		Keyword_While,
 		Keyword_For,
+		Keyword_Parallel,
 		Keyword_Let,
 		Keyword_Break,
 		Keyword_Continue,
@@ -69,6 +71,7 @@ namespace logo {
 	struct Token {
 		Token_Type type;
 		String_View string;
+		Symbol symbol; //Only set for identifiers.
 		std::size_t line_index;
 		std::int64_t int_value;
 		double float_value;
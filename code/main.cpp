@@ -1,10 +1,21 @@
 #include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include "utils.hpp"
 #include "debug.hpp"
 #include "parser.hpp"
 #include "heap_array.hpp"
 #include "interpreter.hpp"
 #include "memory_arena.hpp"
+#include "vm.hpp"
+#include "profile.hpp"
+#include "bytecode.hpp"
+#include "resolver.hpp"
+#include "optimizer.hpp"
+#include "transpiler.hpp"
+#include "type_inference.hpp"
+#include "symbol_table.hpp"
 #if defined(_WIN32) || defined(_WIN64) || defined(WIN32)
 	#define PLATFORM_WINDOWS
 	#define WIN32_LEAN_AND_MEAN
@@ -94,10 +105,10 @@ namespace logo {
 			case Ast_Expression_Type::Value: {
 				logo::print("Value: ");
 				if(expression.value.type == Ast_Value_Type::Identifier) {
-					logo::print("(Identifier) %\n",expression.value.identfier_name);
+					logo::print("(Identifier) %\n",logo::get_symbol_name(expression.value.identfier_name));
 				}
 				else if(expression.value.type == Ast_Value_Type::String_Literal) {
-					logo::print("(String) \"%\"\n",expression.value.string_value);
+					logo::print("(String) \"%\"\n",logo::get_symbol_name(expression.value.string_value));
 				}
 				else if(expression.value.type == Ast_Value_Type::Int_Literal) {
 					logo::print("(Int) %\n",expression.value.int_value);
@@ -183,7 +194,7 @@ namespace logo {
 			}
 			case Ast_Expression_Type::Function_Call: {
 				auto arg_count = expression.function_call->arguments.length;
-				logo::print("Function call % (% %):\n",expression.function_call->name,arg_count,(arg_count == 1) ? "arg" : "args");
+				logo::print("Function call % (% %):\n",logo::get_symbol_name(expression.function_call->name),arg_count,(arg_count == 1) ? "arg" : "args");
 				for(const auto* arg_expr : expression.function_call->arguments) {
 					logo::print_ast_expression(*arg_expr,depth + 1);
 				}
@@ -199,6 +210,19 @@ namespace logo {
 				logo::print_ast_expression(*expression.array_access->right,depth + 1);
 				break;
 			}
+			case Ast_Expression_Type::Conditional: {
+				logo::print("Conditional:\n");
+				logo::print_n_spaces(depth);
+				logo::print("If\n");
+				logo::print_ast_expression(*expression.conditional->condition,depth + 1);
+				logo::print_n_spaces(depth);
+				logo::print("Then\n");
+				logo::print_ast_expression(*expression.conditional->if_true,depth + 1);
+				logo::print_n_spaces(depth);
+				logo::print("Else\n");
+				logo::print_ast_expression(*expression.conditional->if_false,depth + 1);
+				break;
+			}
 			default: logo::unreachable();
 		}
 	}
@@ -216,7 +240,7 @@ namespace logo {
 				break;
 			}
 			case Ast_Statement_Type::Declaration: {
-				logo::print("Declaration % =\n",statement.declaration.name);
+				logo::print("Declaration % =\n",logo::get_symbol_name(statement.declaration.name));
 				logo::print_ast_expression(statement.declaration.initial_value_expr,depth + 1);
 				break;
 			}
@@ -272,7 +296,7 @@ namespace logo {
 				break;
 			}
 			case Ast_Statement_Type::For_Statement: {
-				logo::print("For %\n",statement.for_statement.iterator_identifier);
+				logo::print("For %\n",logo::get_symbol_name(statement.for_statement.iterator_identifier));
 				logo::print_n_spaces(depth);
 				logo::print("Lower bound\n");
 				logo::print_ast_expression(statement.for_statement.start_expr,depth + 1);
@@ -290,9 +314,9 @@ namespace logo {
 				break;
 			}
 			case Ast_Statement_Type::Function_Definition: {
-				logo::print("Function %(",statement.function_definition.name);
+				logo::print("Function %(",logo::get_symbol_name(statement.function_definition.name));
 				for(std::size_t i = 0;i < statement.function_definition.function_arguments.length;i += 1) {
-					logo::print("%",statement.function_definition.function_arguments[i]);
+					logo::print("%",logo::get_symbol_name(statement.function_definition.function_arguments[i]));
 					if((i + 1) < statement.function_definition.function_arguments.length) logo::print(",");
 				}
 				logo::print(")\n");
@@ -311,6 +335,87 @@ namespace logo {
 			default: logo::unreachable();
 		}
 	}
+
+	struct Script_Options {
+		bool use_bytecode_vm;
+		bool optimize;
+		bool type_report;
+		bool use_jit;
+		bool emit_cpp;
+		bool use_profile;
+		std::size_t max_stack_size;
+		std::size_t max_evaluation_step_count;
+		Interpreter_Limits limits;
+	};
+
+	//Errors are left in the reported error message. 'context' is shared by all scripts and is only used if the script is run.
+	[[nodiscard]] static bool run_script(Interpreter_Context* context,const char* input_file_name,const Script_Options& options) {
+		auto [file_bytes,file_opened] = logo::read_file(String_View(input_file_name));
+		if(!file_opened) return false;
+		defer[&]{file_bytes.destroy();};
+
+		auto [parsing_result,parsing_successful] = logo::parse_input({file_bytes.data,file_bytes.length});
+		if(!parsing_successful) return false;
+		defer[&]{parsing_result.destroy();};
+
+		if(!logo::resolve_ast(&parsing_result.statements)) return false;
+
+		if(options.optimize) {
+			auto [statistics,optimization_successful] = logo::optimize_ast(&parsing_result.statements,&parsing_result.memory,options.max_evaluation_step_count);
+			if(!optimization_successful) return false;
+			if(!options.emit_cpp) {
+				logo::print("Optimizer removed % AST nodes, inlined % calls, computed % calls of pure functions, memoized % recursive functions, hoisted % loop invariant expressions and replaced % multiplications with induction variables.\n",
+							statistics.removed_node_count,statistics.inlined_call_count,statistics.evaluated_call_count,statistics.memoized_function_count,statistics.hoisted_expression_count,statistics.reduced_multiplication_count);
+			}
+		}
+		//The transpiler writes operations with proven operand types as plain C++.
+		if(options.emit_cpp) {
+			auto [statistics,inference_successful] = logo::infer_types(&parsing_result.statements,false);
+			if(!inference_successful) return false;
+			return logo::emit_cpp(parsing_result.statements,String_View(input_file_name),options.max_stack_size);
+		}
+		if(options.optimize || options.type_report) {
+			auto [statistics,inference_successful] = logo::infer_types(&parsing_result.statements,options.type_report);
+			if(!inference_successful) return false;
+			logo::print("Type inference proved % of % operations and % of % builtin calls.\n",
+						statistics.proven_operation_count,statistics.proven_operation_count + statistics.dynamic_operation_count,
+						statistics.proven_call_count,statistics.proven_call_count + statistics.dynamic_call_count);
+		}
+
+		//The profile is keyed by the options that change the AST or the bytecode, so that a run with other options doesn't pick up feedback that doesn't fit.
+		Type_Profile profile{};
+		defer[&]{profile.destroy();};
+		if(options.use_profile) {
+			auto key = logo::make_type_profile_key({file_bytes.data,file_bytes.length},options.use_bytecode_vm,options.optimize,options.optimize || options.type_report);
+			auto [loaded_profile,profile_loaded] = logo::load_type_profile(String_View(input_file_name),key);
+			if(!profile_loaded) return false;
+			profile = loaded_profile;
+		}
+
+		/*for(const auto& statement : parsing_result.statements) {
+			logo::print_ast_statement(statement);
+		}
+		logo::print("\n");
+		return true;*/
+
+		if(options.use_bytecode_vm) {
+			auto [program,compilation_successful] = logo::compile_ast({parsing_result.statements.data,parsing_result.statements.length});
+			if(!compilation_successful) return false;
+			defer[&]{program.destroy();};
+
+			auto [vm_statistics,vm_successful] = logo::run_bytecode(context,&program,options.max_stack_size,options.use_jit,options.limits,options.use_profile ? &profile : nullptr);
+			if(!vm_successful || (options.use_profile && !logo::save_type_profile(String_View(input_file_name),profile))) return false;
+			if(options.use_profile) logo::print_interpreter_statistics(vm_statistics);
+			return true;
+		}
+
+		if(options.use_profile && !logo::apply_operation_profile(&parsing_result.statements,profile)) return false;
+		auto [interpreter_statistics,interpreter_successful] = logo::interpret_ast(context,&parsing_result.statements,options.max_stack_size,options.use_jit,options.limits,options.use_profile ? &profile : nullptr);
+		if(!interpreter_successful) return false;
+		if(options.use_profile && (!logo::record_operation_profile(&parsing_result.statements,&profile) || !logo::save_type_profile(String_View(input_file_name),profile))) return false;
+		if(options.use_profile) logo::print_interpreter_statistics(interpreter_statistics);
+		return true;
+	}
 }
 
 int main(int arg_count,char** args) {
@@ -320,36 +425,109 @@ int main(int arg_count,char** args) {
 	}
 	defer[]{logo::debug_term();};
 
-	logo::print("The MIT License (MIT)\nCopyright © 2023 Dawid Michalak (TheHyper45)\n\n");
-
-	if(arg_count < 2) {
-		logo::print("Usage: logo [input_file_name]\n");
+	logo::Script_Options options{};
+	options.use_jit = true;
+	options.max_stack_size = logo::DEFAULT_MAX_STACK_SIZE;
+	options.max_evaluation_step_count = logo::DEFAULT_MAX_EVALUATION_STEP_COUNT;
+	logo::Heap_Array<const char*> input_file_names{};
+	defer[&]{input_file_names.destroy();};
+	for(int i = 1;i < arg_count;i += 1) {
+		if(std::strcmp(args[i],"--vm") == 0) options.use_bytecode_vm = true;
+		else if(std::strcmp(args[i],"--optimize") == 0) options.optimize = true;
+		else if(std::strcmp(args[i],"--type-report") == 0) options.type_report = true;
+		else if(std::strcmp(args[i],"--no-jit") == 0) options.use_jit = false;
+		else if(std::strcmp(args[i],"--emit-cpp") == 0) options.emit_cpp = true;
+		else if(std::strcmp(args[i],"--profile") == 0) options.use_profile = true;
+		else if(std::strcmp(args[i],"--max-stack-size") == 0) {
+			char* end = nullptr;
+			unsigned long long megabytes = ((i + 1) < arg_count) ? std::strtoull(args[i + 1],&end,10) : 0;
+			if(megabytes == 0 || *end != '\0' || megabytes > (SIZE_MAX / (1024 * 1024))) {
+				logo::eprint("Option '--max-stack-size' expects a positive number of megabytes.\n");
+				return 1;
+			}
+			options.max_stack_size = static_cast<std::size_t>(megabytes) * 1024 * 1024;
+			i += 1;
+		}
+		else if(std::strcmp(args[i],"--eval-steps") == 0) {
+			char* end = nullptr;
+			const char* count = ((i + 1) < arg_count) ? args[i + 1] : "";
+			unsigned long long step_count = std::strtoull(count,&end,10);
+			if(*count == '\0' || *end != '\0' || step_count > SIZE_MAX) {
+				logo::eprint("Option '--eval-steps' expects a number of steps.\n");
+				return 1;
+			}
+			options.max_evaluation_step_count = static_cast<std::size_t>(step_count);
+			i += 1;
+		}
+		else if(std::strcmp(args[i],"--max-steps") == 0) {
+			char* end = nullptr;
+			unsigned long long step_count = ((i + 1) < arg_count) ? std::strtoull(args[i + 1],&end,10) : 0;
+			if(step_count == 0 || *end != '\0' || step_count > SIZE_MAX) {
+				logo::eprint("Option '--max-steps' expects a positive number of steps.\n");
+				return 1;
+			}
+			options.limits.max_step_count = static_cast<std::size_t>(step_count);
+			i += 1;
+		}
+		else if(std::strcmp(args[i],"--timeout") == 0) {
+			//The limit keeps the deadline within the range of the clock.
+			char* end = nullptr;
+			unsigned long long seconds = ((i + 1) < arg_count) ? std::strtoull(args[i + 1],&end,10) : 0;
+			if(seconds == 0 || *end != '\0' || seconds > 1000000000) {
+				logo::eprint("Option '--timeout' expects a positive number of seconds.\n");
+				return 1;
+			}
+			options.limits.timeout_seconds = static_cast<std::size_t>(seconds);
+			i += 1;
+		}
+		else if(std::strcmp(args[i],"--save-on-limit") == 0) {
+			if((i + 1) >= arg_count) {
+				logo::eprint("Option '--save-on-limit' expects a file name.\n");
+				return 1;
+			}
+			options.limits.canvas_path = args[i + 1];
+			i += 1;
+		}
+		else if(std::strncmp(args[i],"--",2) == 0) {
+			logo::eprint("Unknown option '%'.\n",args[i]);
+			return 1;
+		}
+		else if(!input_file_names.push_back(args[i])) {
+			logo::eprint("Couldn't allocate % bytes of memory.\n",sizeof(args[i]));
+			return 1;
+		}
+	}
+	//The generated C++ code is written to the standard output, so nothing else can be printed there.
+	if(!options.emit_cpp) logo::print("The MIT License (MIT)\nCopyright © 2023 Dawid Michalak (TheHyper45)\n\n");
+	if(input_file_names.length == 0) {
+		logo::print("Usage: logo [--vm] [--optimize] [--type-report] [--no-jit] [--emit-cpp] [--profile] [--max-stack-size megabytes] [--eval-steps steps] [--max-steps steps] [--timeout seconds] [--save-on-limit file_name] [input_file_name...]\n");
 		return 0;
 	}
 
-	auto [file_bytes,file_opened] = logo::read_file(logo::String_View(args[1]));
-	if(!file_opened) {
-		logo::eprint("%\n",logo::get_reported_error());
+	//The generated C++ code of several scripts couldn't be told apart.
+	if(options.emit_cpp && input_file_names.length > 1) {
+		logo::eprint("Option '--emit-cpp' expects a single input file.\n");
 		return 1;
 	}
-	defer[&]{file_bytes.destroy();};
+	defer[]{logo::term_symbol_table();};
 
-	auto [parsing_result,parsing_successful] = logo::parse_input({file_bytes.data,file_bytes.length});
-	if(!parsing_successful) {
+	//One context runs all the scripts, so that the symbols it interns, its thread pool and the memory of the variables, the functions and the canvas are reused.
+	//The builtin functions don't need it, they are a table built at compile time.
+	logo::Interpreter_Context context{};
+	if(!options.emit_cpp && !logo::init_interpreter_context(&context)) {
 		logo::eprint("%\n",logo::get_reported_error());
 		return 1;
 	}
-	defer[&]{parsing_result.destroy();};
+	defer[&]{logo::destroy_interpreter_context(&context);};
 
-	/*for(const auto& statement : parsing_result.statements) {
-		logo::print_ast_statement(statement);
-	}
-	logo::print("\n");
-	return 0;*/
-
-	if(!logo::interpret_ast({parsing_result.statements.data,parsing_result.statements.length})) {
-		logo::eprint("%\n",logo::get_reported_error());
-		return 1;
+	int exit_code = 0;
+	for(const char* input_file_name : input_file_names) {
+		if(input_file_names.length > 1) logo::print("Running \"%\".\n",input_file_name);
+		if(!logo::run_script(&context,input_file_name,options)) {
+			logo::eprint("%\n",logo::get_reported_error());
+			logo::truncate_reported_error(0);
+			exit_code = 1;
+		}
 	}
-	return 0;
+	return exit_code;
 }
@@ -0,0 +1,1620 @@
+#include <limits>
+#include "debug.hpp"
+#include "optimizer.hpp"
+#include "resolver.hpp"
+#include "interpreter.hpp"
+#include "static_array.hpp"
+
+namespace logo {
+	struct Optimizer_Binding {
+		bool* is_modified; //Points into the AST node that declares the variable, this is nullptr for function arguments.
+		bool is_constant;
+		Ast_Value constant_value;
+		Interpreter_Value_Type type; //Type of a variable that is never modified or 'Void' if it's not known.
+	};
+	struct Optimizer_Loop {
+		std::size_t first_binding_index; //Variables with lower binding indices are declared outside of the loop.
+		Ast_For_Statement* for_statement; //This is nullptr for while loops.
+		std::size_t line_index;
+		Heap_Array<Ast_Statement> hoisted_declarations; //These are placed right before the loop.
+	};
+	//Mirrors the variable stack of the interpreter the same way the resolver does, so that a slot of an identifier can be mapped to its declaration.
+	struct Optimizer_State {
+		Interpreter_Context context; //Only used to call pure builtin functions.
+		Heap_Array<Optimizer_Binding> bindings;
+		std::size_t current_function_scope_first_binding_index;
+		Heap_Array<Symbol> dynamically_accessed_names; //Names used with the 'parent scope access' operator that are looked up at runtime.
+		Heap_Array<Symbol> dynamically_modified_names; //Subset of the above that is also assigned to or referenced.
+		Heap_Array<Optimizer_Loop> loops;
+		std::size_t current_function_scope_first_loop_index;
+		std::size_t hidden_variable_count;
+		Arena_Allocator* memory; //Nodes of inlined function bodies are allocated here.
+		Heap_Array<Ast_Function_Definition*> function_definitions; //Every user defined function at its function index.
+		Heap_Array<const Ast_Expression*> inlined_bodies; //Returned expression of every function that can be inlined at its function index or nullptr.
+		Heap_Array<bool> are_functions_pure;
+		Heap_Array<Ast_Expression*> constant_calls; //Calls of pure user defined functions with constant arguments.
+		Optimizer_Statistics statistics;
+	};
+
+	[[nodiscard]] static bool contains_symbol(const Heap_Array<Symbol>& symbols,Symbol symbol) {
+		for(auto s : symbols) {
+			if(s == symbol) return true;
+		}
+		return false;
+	}
+
+	[[nodiscard]] static bool add_symbol(Heap_Array<Symbol>* symbols,Symbol symbol) {
+		if(logo::contains_symbol(*symbols,symbol)) return true;
+		if(!symbols->push_back(symbol)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(symbol));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool push_binding(Optimizer_State* state,bool* is_modified) {
+		Optimizer_Binding binding{};
+		binding.is_modified = is_modified;
+		if(!state->bindings.push_back(binding)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(binding));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static std::size_t get_binding_index(const Optimizer_State* state,const Ast_Value& value) {
+		logo::assert(value.type == Ast_Value_Type::Identifier && value.depth == 0);
+		std::size_t index = state->current_function_scope_first_binding_index + value.slot;
+		logo::assert(index < state->bindings.length);
+		return index;
+	}
+
+	[[nodiscard]] static Optimizer_Binding* get_binding(Optimizer_State* state,const Ast_Value& value) {
+		return &state->bindings[logo::get_binding_index(state,value)];
+	}
+
+	//Hidden variables hold values computed by the optimizer. Their names can't clash with any identifier because the lexer doesn't accept '$'.
+	[[nodiscard]] static Option<Symbol> make_hidden_variable_name(Optimizer_State* state) {
+		Array_String<32> name{};
+		logo::format(&name,"$%",state->hidden_variable_count);
+		state->hidden_variable_count += 1;
+		return logo::intern_symbol(String_View(name.buffer,name.byte_length));
+	}
+
+	[[nodiscard]] static std::size_t count_expression_nodes(const Ast_Expression& expression) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return 1;
+			case Ast_Expression_Type::Unary_Prefix_Operator: return 1 + logo::count_expression_nodes(*expression.unary_prefix_operator->child);
+			case Ast_Expression_Type::Binary_Operator: {
+				return 1 + logo::count_expression_nodes(*expression.binary_operator->left) + logo::count_expression_nodes(*expression.binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				return 1 + logo::count_expression_nodes(*conditional->condition) + logo::count_expression_nodes(*conditional->if_true) + logo::count_expression_nodes(*conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				std::size_t count = 1;
+				for(const auto* arg_expr : expression.function_call->arguments) count += logo::count_expression_nodes(*arg_expr);
+				return count;
+			}
+			case Ast_Expression_Type::Array_Access: {
+				return 1 + logo::count_expression_nodes(*expression.array_access->left) + logo::count_expression_nodes(*expression.array_access->right);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static std::size_t count_statement_nodes(const Ast_Statement& statement);
+
+	[[nodiscard]] static std::size_t count_statements_nodes(const Heap_Array<Ast_Statement>& statements) {
+		std::size_t count = 0;
+		for(const auto& statement : statements) count += logo::count_statement_nodes(statement);
+		return count;
+	}
+
+	static std::size_t count_statement_nodes(const Ast_Statement& statement) {
+		switch(statement.type) {
+			case Ast_Statement_Type::Expression: return 1 + logo::count_expression_nodes(statement.expression);
+			case Ast_Statement_Type::Declaration: return 1 + logo::count_expression_nodes(statement.declaration.initial_value_expr);
+			case Ast_Statement_Type::Assignment: {
+				return 1 + logo::count_expression_nodes(statement.assignment.lvalue_expr) + logo::count_expression_nodes(statement.assignment.rvalue_expr);
+			}
+			case Ast_Statement_Type::If_Statement: {
+				const auto& if_statement = statement.if_statement;
+				return 1 + logo::count_expression_nodes(if_statement.condition_expr) +
+					logo::count_statements_nodes(if_statement.if_true_statements) + logo::count_statements_nodes(if_statement.if_false_statements);
+			}
+			case Ast_Statement_Type::While_Statement: {
+				return 1 + logo::count_expression_nodes(statement.while_statement.condition_expr) + logo::count_statements_nodes(statement.while_statement.body_statements);
+			}
+			case Ast_Statement_Type::For_Statement: {
+				const auto& for_statement = statement.for_statement;
+				return 1 + logo::count_expression_nodes(for_statement.start_expr) + logo::count_expression_nodes(for_statement.end_expr) +
+					logo::count_statements_nodes(for_statement.body_statements);
+			}
+			case Ast_Statement_Type::Function_Definition: return 1 + logo::count_statements_nodes(statement.function_definition.body_statements);
+			case Ast_Statement_Type::Return_Statement: {
+				if(!statement.return_statement.return_value) return 1;
+				return 1 + logo::count_expression_nodes(*statement.return_statement.return_value);
+			}
+			case Ast_Statement_Type::Break_Statement:
+			case Ast_Statement_Type::Continue_Statement: return 1;
+			default: logo::unreachable();
+		}
+	}
+
+	static void remove_statement(Optimizer_State* state,Ast_Statement* statement) {
+		state->statistics.removed_node_count += logo::count_statement_nodes(*statement);
+		logo::destroy_statement(statement);
+	}
+
+	static void remove_statements(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) logo::remove_statement(state,&statement);
+		statements->destroy();
+	}
+
+	[[nodiscard]] static const Interpreter_Builtin_Function* find_builtin_function(const Ast_Function_Call& function_call) {
+		auto [function_index,function_found] = logo::find_builtin_function(function_call.name,function_call.arguments.length);
+		return function_found ? &logo::get_builtin_function(function_index) : nullptr;
+	}
+
+	[[nodiscard]] static bool is_builtin_function_call(const Optimizer_State* state,const Ast_Function_Call& function_call) {
+		return function_call.name == state->context.print_symbol || logo::find_builtin_function(function_call);
+	}
+
+	[[nodiscard]] static bool is_user_function_call(const Optimizer_State* state,const Ast_Function_Call& function_call) {
+		//Builtin functions take precedence over the user defined function the call is bound to.
+		if(logo::is_builtin_function_call(state,function_call)) return false;
+		return function_call.function_index != 0;
+	}
+
+	//The first pass replaces calls of small functions with the expression they return. Only functions whose body is a single 'return' statement
+	//that reads nothing but the arguments and calls nothing but builtin functions are inlined, so the copied expression doesn't declare anything
+	//and means the same at the place of the call. Parent scope accesses of other variables find the same variable from the caller, because the function
+	//doesn't declare any variables of its own. Functions become inlinable once the calls in their bodies are inlined, which can't happen for recursive ones.
+
+	//Functions returning an expression with more nodes than this aren't inlined.
+	static constexpr std::size_t MAX_INLINED_NODE_COUNT = 16;
+
+	//Returns the index of the argument if the expression reads one.
+	[[nodiscard]] static Option<std::size_t> find_read_argument(const Ast_Function_Definition& definition,const Ast_Expression& expression) {
+		const Ast_Value* value = nullptr;
+		if(expression.type == Ast_Expression_Type::Value) value = &expression.value;
+		else if(expression.type == Ast_Expression_Type::Unary_Prefix_Operator && expression.unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+			value = &expression.unary_prefix_operator->child->value;
+		}
+		if(!value || value->type != Ast_Value_Type::Identifier || value->depth != 0) return {};
+		if(value->slot >= definition.function_arguments.length || definition.function_arguments[value->slot] != value->identfier_name) return {};
+		return static_cast<std::size_t>(value->slot);
+	}
+
+	[[nodiscard]] static bool contains_function_call(const Ast_Expression& expression) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return false;
+			case Ast_Expression_Type::Unary_Prefix_Operator: return logo::contains_function_call(*expression.unary_prefix_operator->child);
+			case Ast_Expression_Type::Binary_Operator: {
+				return logo::contains_function_call(*expression.binary_operator->left) || logo::contains_function_call(*expression.binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				return logo::contains_function_call(*conditional->condition) || logo::contains_function_call(*conditional->if_true) || logo::contains_function_call(*conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: return true;
+			case Ast_Expression_Type::Array_Access: {
+				return logo::contains_function_call(*expression.array_access->left) || logo::contains_function_call(*expression.array_access->right);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool is_inlinable_expression(const Optimizer_State* state,const Ast_Function_Definition& definition,const Ast_Expression& expression) {
+		if(logo::find_read_argument(definition,expression).has_value) return true;
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return expression.value.type != Ast_Value_Type::Identifier;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) return unary_operator->child->value.depth != 0;
+				if(!logo::is_one_of(unary_operator->type,Ast_Unary_Prefix_Operator_Type::Plus,Ast_Unary_Prefix_Operator_Type::Minus,Ast_Unary_Prefix_Operator_Type::Logical_Not)) return false;
+				return logo::is_inlinable_expression(state,definition,*unary_operator->child);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				return logo::is_inlinable_expression(state,definition,*expression.binary_operator->left) && logo::is_inlinable_expression(state,definition,*expression.binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				return logo::is_inlinable_expression(state,definition,*conditional->condition) && logo::is_inlinable_expression(state,definition,*conditional->if_true) &&
+					   logo::is_inlinable_expression(state,definition,*conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				if(!logo::is_builtin_function_call(state,*expression.function_call)) return false;
+				for(const auto* arg_expr : expression.function_call->arguments) {
+					if(!logo::is_inlinable_expression(state,definition,*arg_expr)) return false;
+				}
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: return false;
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool find_inlined_bodies(Optimizer_State* state) {
+		if(state->inlined_bodies.length == 0 && !state->inlined_bodies.resize(state->function_definitions.length,nullptr)) {
+			Report_Error("Couldn't allocate % bytes of memory.",state->function_definitions.length * sizeof(const Ast_Expression*));
+			return false;
+		}
+		for(std::size_t i = 0;i < state->function_definitions.length;i += 1) {
+			const auto* definition = state->function_definitions[i];
+			state->inlined_bodies[i] = nullptr;
+			if(!definition || definition->function_arguments.length > 16 || definition->body_statements.length != 1) continue;
+			const auto& statement = definition->body_statements[0];
+			if(statement.type != Ast_Statement_Type::Return_Statement || !statement.return_statement.return_value) continue;
+			const auto& return_value = *statement.return_statement.return_value;
+			if(logo::count_expression_nodes(return_value) > MAX_INLINED_NODE_COUNT || !logo::is_inlinable_expression(state,*definition,return_value)) continue;
+			state->inlined_bodies[i] = &return_value;
+		}
+		return true;
+	}
+
+	//Counts the reads of the argument. 'is_conditional' is set if a read is in a branch of a conditional expression or in the right operand of 'and' or 'or'.
+	static std::size_t count_argument_reads(const Ast_Function_Definition& definition,const Ast_Expression& expression,std::size_t arg_index,bool is_in_branch,bool* is_conditional) {
+		auto read_arg_index = logo::find_read_argument(definition,expression);
+		if(read_arg_index.has_value) {
+			if(read_arg_index.value != arg_index) return 0;
+			if(is_in_branch) *is_conditional = true;
+			return 1;
+		}
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return 0;
+			case Ast_Expression_Type::Unary_Prefix_Operator: return logo::count_argument_reads(definition,*expression.unary_prefix_operator->child,arg_index,is_in_branch,is_conditional);
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto* binary_operator = expression.binary_operator;
+				bool is_right_in_branch = is_in_branch || logo::is_one_of(binary_operator->type,Ast_Binary_Operator_Type::Logical_And,Ast_Binary_Operator_Type::Logical_Or);
+				return logo::count_argument_reads(definition,*binary_operator->left,arg_index,is_in_branch,is_conditional) +
+					   logo::count_argument_reads(definition,*binary_operator->right,arg_index,is_right_in_branch,is_conditional);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				return logo::count_argument_reads(definition,*conditional->condition,arg_index,is_in_branch,is_conditional) +
+					   logo::count_argument_reads(definition,*conditional->if_true,arg_index,true,is_conditional) +
+					   logo::count_argument_reads(definition,*conditional->if_false,arg_index,true,is_conditional);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				std::size_t count = 0;
+				for(const auto* arg_expr : expression.function_call->arguments) count += logo::count_argument_reads(definition,*arg_expr,arg_index,is_in_branch,is_conditional);
+				return count;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	//Arguments are computed before the body of the function. Copying a literal or a variable to every place that reads the argument doesn't change that,
+	//because the expressions of inlined functions can't assign anything. Any other argument is allowed only if it's read exactly once and nothing
+	//in the call can have side effects, so computing it later makes no difference.
+	[[nodiscard]] static bool can_inline_call(const Optimizer_State* state,const Ast_Function_Call& function_call,const Ast_Expression& body) {
+		const auto& definition = *state->function_definitions[function_call.function_index - 1];
+		if(function_call.arguments.length != definition.function_arguments.length) return false;
+		for(std::size_t i = 0;i < function_call.arguments.length;i += 1) {
+			const auto& arg_expr = *function_call.arguments[i];
+			if(arg_expr.type == Ast_Expression_Type::Value) continue;
+			if(logo::contains_function_call(body) || logo::contains_function_call(arg_expr)) return false;
+			bool is_conditional = false;
+			if(logo::count_argument_reads(definition,body,i,false,&is_conditional) != 1 || is_conditional) return false;
+		}
+		return true;
+	}
+
+	template<typename T>
+	[[nodiscard]] static T* construct_node(Optimizer_State* state) {
+		T* node = state->memory->construct<T>();
+		if(!node) Report_Error("Couldn't allocate % bytes of memory.",sizeof(T));
+		return node;
+	}
+
+	//Copies the expression into 'copy'. If 'definition' isn't nullptr, the reads of its arguments are replaced with copies of 'args'.
+	[[nodiscard]] static bool copy_expression(Optimizer_State* state,const Ast_Expression& expression,Ast_Expression* copy,const Ast_Function_Definition* definition,Array_View<Ast_Expression*> args) {
+		if(definition) {
+			auto [arg_index,is_argument_read] = logo::find_read_argument(*definition,expression);
+			if(is_argument_read) return logo::copy_expression(state,*args[arg_index],copy,nullptr,{});
+		}
+		*copy = expression;
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				copy->unary_prefix_operator = logo::construct_node<Ast_Unary_Prefix_Operator>(state);
+				if(!copy->unary_prefix_operator) return false;
+				*copy->unary_prefix_operator = *expression.unary_prefix_operator;
+				copy->unary_prefix_operator->child = logo::construct_node<Ast_Expression>(state);
+				if(!copy->unary_prefix_operator->child) return false;
+				return logo::copy_expression(state,*expression.unary_prefix_operator->child,copy->unary_prefix_operator->child,definition,args);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				copy->binary_operator = logo::construct_node<Ast_Binary_Operator>(state);
+				if(!copy->binary_operator) return false;
+				*copy->binary_operator = *expression.binary_operator;
+				copy->binary_operator->left = logo::construct_node<Ast_Expression>(state);
+				copy->binary_operator->right = logo::construct_node<Ast_Expression>(state);
+				if(!copy->binary_operator->left || !copy->binary_operator->right) return false;
+				if(!logo::copy_expression(state,*expression.binary_operator->left,copy->binary_operator->left,definition,args)) return false;
+				return logo::copy_expression(state,*expression.binary_operator->right,copy->binary_operator->right,definition,args);
+			}
+			case Ast_Expression_Type::Conditional: {
+				copy->conditional = logo::construct_node<Ast_Conditional>(state);
+				if(!copy->conditional) return false;
+				*copy->conditional = *expression.conditional;
+				copy->conditional->condition = logo::construct_node<Ast_Expression>(state);
+				copy->conditional->if_true = logo::construct_node<Ast_Expression>(state);
+				copy->conditional->if_false = logo::construct_node<Ast_Expression>(state);
+				if(!copy->conditional->condition || !copy->conditional->if_true || !copy->conditional->if_false) return false;
+				if(!logo::copy_expression(state,*expression.conditional->condition,copy->conditional->condition,definition,args)) return false;
+				if(!logo::copy_expression(state,*expression.conditional->if_true,copy->conditional->if_true,definition,args)) return false;
+				return logo::copy_expression(state,*expression.conditional->if_false,copy->conditional->if_false,definition,args);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				const auto& function_call = *expression.function_call;
+				copy->function_call = logo::construct_node<Ast_Function_Call>(state);
+				if(!copy->function_call) return false;
+				copy->function_call->name = function_call.name;
+				copy->function_call->line_index = function_call.line_index;
+				copy->function_call->function_index = function_call.function_index;
+				copy->function_call->cache = function_call.cache;
+				for(const auto* arg_expr : function_call.arguments) {
+					auto* arg_copy = logo::construct_node<Ast_Expression>(state);
+					if(!arg_copy) return false;
+					if(!copy->function_call->arguments.push_back(arg_copy)) {
+						Report_Error("Couldn't allocate % bytes of memory.",sizeof(arg_copy));
+						return false;
+					}
+					if(!logo::copy_expression(state,*arg_expr,arg_copy,definition,args)) return false;
+				}
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: {
+				copy->array_access = logo::construct_node<Ast_Array_Access>(state);
+				if(!copy->array_access) return false;
+				*copy->array_access = *expression.array_access;
+				copy->array_access->left = logo::construct_node<Ast_Expression>(state);
+				copy->array_access->right = logo::construct_node<Ast_Expression>(state);
+				if(!copy->array_access->left || !copy->array_access->right) return false;
+				if(!logo::copy_expression(state,*expression.array_access->left,copy->array_access->left,definition,args)) return false;
+				return logo::copy_expression(state,*expression.array_access->right,copy->array_access->right,definition,args);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	//Calls are inlined only where their value is read, because the returned expression can be an lvalue while the result of a call never is.
+	[[nodiscard]] static bool inline_calls(Optimizer_State* state,Ast_Expression* expression,bool is_rvalue) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				bool is_child_rvalue = expression->unary_prefix_operator->type != Ast_Unary_Prefix_Operator_Type::Reference;
+				return logo::inline_calls(state,expression->unary_prefix_operator->child,is_child_rvalue);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				if(!logo::inline_calls(state,expression->binary_operator->left,true)) return false;
+				return logo::inline_calls(state,expression->binary_operator->right,true);
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::inline_calls(state,expression->conditional->condition,true)) return false;
+				if(!logo::inline_calls(state,expression->conditional->if_true,is_rvalue)) return false;
+				return logo::inline_calls(state,expression->conditional->if_false,is_rvalue);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				auto* function_call = expression->function_call;
+				for(auto* arg_expr : function_call->arguments) {
+					if(!logo::inline_calls(state,arg_expr,true)) return false;
+				}
+				if(!is_rvalue || !logo::is_user_function_call(state,*function_call)) return true;
+				const auto* body = state->inlined_bodies[function_call->function_index - 1];
+				if(!body || !logo::can_inline_call(state,*function_call,*body)) return true;
+
+				Ast_Expression inlined_expression{};
+				Array_View<Ast_Expression*> args(function_call->arguments.data,function_call->arguments.length);
+				if(!logo::copy_expression(state,*body,&inlined_expression,state->function_definitions[function_call->function_index - 1],args)) return false;
+				inlined_expression.is_parenthesised = true;
+				logo::destroy_expression(expression);
+				*expression = inlined_expression;
+				state->statistics.inlined_call_count += 1;
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: {
+				if(!logo::inline_calls(state,expression->array_access->left,true)) return false;
+				return logo::inline_calls(state,expression->array_access->right,true);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool inline_calls(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					if(!logo::inline_calls(state,&statement.expression,true)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					if(!logo::inline_calls(state,&statement.declaration.initial_value_expr,true)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					if(!logo::inline_calls(state,&statement.assignment.lvalue_expr,false)) return false;
+					if(!logo::inline_calls(state,&statement.assignment.rvalue_expr,true)) return false;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					if(!logo::inline_calls(state,&statement.if_statement.condition_expr,true)) return false;
+					if(!logo::inline_calls(state,&statement.if_statement.if_true_statements)) return false;
+					if(!logo::inline_calls(state,&statement.if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::inline_calls(state,&statement.while_statement.condition_expr,true)) return false;
+					if(!logo::inline_calls(state,&statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					if(!logo::inline_calls(state,&statement.for_statement.start_expr,true)) return false;
+					if(!logo::inline_calls(state,&statement.for_statement.end_expr,true)) return false;
+					if(!logo::inline_calls(state,&statement.for_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Function_Definition: {
+					if(!logo::inline_calls(state,&statement.function_definition.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value && !logo::inline_calls(state,statement.return_statement.return_value,true)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				default: logo::unreachable();
+			}
+		}
+		return true;
+	}
+
+	//Every inlined call removes a call of a user defined function from the program, so this stops once no more calls can be inlined.
+	[[nodiscard]] static bool inline_function_calls(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		while(true) {
+			if(!logo::find_inlined_bodies(state)) return false;
+			std::size_t inlined_call_count = state->statistics.inlined_call_count;
+			if(!logo::inline_calls(state,statements)) return false;
+			if(state->statistics.inlined_call_count == inlined_call_count) return true;
+		}
+	}
+
+	//The second pass computes calls of pure user defined functions with constant arguments. A function is pure if it doesn't use references
+	//or variables of other functions and calls only pure functions, so its result depends only on the arguments and it can run before the program does.
+
+	[[nodiscard]] static bool is_pure_call(const Optimizer_State* state,const Ast_Function_Call& function_call) {
+		if(logo::is_user_function_call(state,function_call)) return state->are_functions_pure[function_call.function_index - 1];
+		const auto* function = logo::find_builtin_function(function_call);
+		return function_call.name != state->context.print_symbol && function && function->is_pure;
+	}
+
+	//Constant expressions are pure expressions that don't read any variables.
+	[[nodiscard]] static bool is_pure_expression(const Optimizer_State* state,const Ast_Expression& expression,bool can_read_variables = true) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: return can_read_variables || expression.value.type != Ast_Value_Type::Identifier;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				if(!logo::is_one_of(unary_operator->type,Ast_Unary_Prefix_Operator_Type::Plus,Ast_Unary_Prefix_Operator_Type::Minus,Ast_Unary_Prefix_Operator_Type::Logical_Not)) return false;
+				return logo::is_pure_expression(state,*unary_operator->child,can_read_variables);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto* binary_operator = expression.binary_operator;
+				return logo::is_pure_expression(state,*binary_operator->left,can_read_variables) && logo::is_pure_expression(state,*binary_operator->right,can_read_variables);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				return logo::is_pure_expression(state,*conditional->condition,can_read_variables) && logo::is_pure_expression(state,*conditional->if_true,can_read_variables) && logo::is_pure_expression(state,*conditional->if_false,can_read_variables);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				for(const auto* arg_expr : expression.function_call->arguments) {
+					if(!logo::is_pure_expression(state,*arg_expr,can_read_variables)) return false;
+				}
+				return logo::is_pure_call(state,*expression.function_call);
+			}
+			case Ast_Expression_Type::Array_Access: return false;
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool are_pure_statements(const Optimizer_State* state,const Heap_Array<Ast_Statement>& statements) {
+		for(const auto& statement : statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					if(!logo::is_pure_expression(state,statement.expression)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					if(!logo::is_pure_expression(state,statement.declaration.initial_value_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					const auto& assignment = statement.assignment;
+					if(!logo::is_pure_expression(state,assignment.lvalue_expr) || !logo::is_pure_expression(state,assignment.rvalue_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					const auto& if_statement = statement.if_statement;
+					if(!logo::is_pure_expression(state,if_statement.condition_expr)) return false;
+					if(!logo::are_pure_statements(state,if_statement.if_true_statements) || !logo::are_pure_statements(state,if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::is_pure_expression(state,statement.while_statement.condition_expr)) return false;
+					if(!logo::are_pure_statements(state,statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					const auto& for_statement = statement.for_statement;
+					if(!logo::is_pure_expression(state,for_statement.start_expr) || !logo::is_pure_expression(state,for_statement.end_expr)) return false;
+					if(!logo::are_pure_statements(state,for_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value && !logo::is_pure_expression(state,*statement.return_statement.return_value)) return false;
+					break;
+				}
+				//Nested functions only matter if they are called.
+				case Ast_Statement_Type::Function_Definition:
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				default: logo::unreachable();
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool collect_function_definitions(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::If_Statement: {
+					if(!logo::collect_function_definitions(state,&statement.if_statement.if_true_statements)) return false;
+					if(!logo::collect_function_definitions(state,&statement.if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::collect_function_definitions(state,&statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					if(!logo::collect_function_definitions(state,&statement.for_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Function_Definition: {
+					auto& function_definition = statement.function_definition;
+					while(state->function_definitions.length <= function_definition.function_index) {
+						if(!state->function_definitions.push_back(nullptr)) {
+							Report_Error("Couldn't allocate % bytes of memory.",sizeof(Ast_Function_Definition*));
+							return false;
+						}
+					}
+					state->function_definitions[function_definition.function_index] = &function_definition;
+					if(!logo::collect_function_definitions(state,&function_definition.body_statements)) return false;
+					break;
+				}
+				default: break;
+			}
+		}
+		return true;
+	}
+
+	//Every function starts out as pure, so that recursive functions can be pure too. Functions that do something impure
+	//or call an impure function are marked until nothing changes.
+	[[nodiscard]] static bool find_pure_functions(Optimizer_State* state) {
+		if(!state->are_functions_pure.resize(state->function_definitions.length,true)) {
+			Report_Error("Couldn't allocate % bytes of memory.",state->function_definitions.length * sizeof(bool));
+			return false;
+		}
+		bool changed = true;
+		while(changed) {
+			changed = false;
+			for(std::size_t i = 0;i < state->function_definitions.length;i += 1) {
+				if(!state->are_functions_pure[i] || logo::are_pure_statements(state,state->function_definitions[i]->body_statements)) continue;
+				state->are_functions_pure[i] = false;
+				changed = true;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool calls_function(const Optimizer_State* state,const Ast_Expression& expression,std::size_t function_index) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value:
+			case Ast_Expression_Type::Array_Access: return false;
+			case Ast_Expression_Type::Unary_Prefix_Operator: return logo::calls_function(state,*expression.unary_prefix_operator->child,function_index);
+			case Ast_Expression_Type::Binary_Operator: {
+				return logo::calls_function(state,*expression.binary_operator->left,function_index) || logo::calls_function(state,*expression.binary_operator->right,function_index);
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				return logo::calls_function(state,*conditional->condition,function_index) || logo::calls_function(state,*conditional->if_true,function_index) ||
+					   logo::calls_function(state,*conditional->if_false,function_index);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				const auto& function_call = *expression.function_call;
+				if(logo::is_user_function_call(state,function_call) && function_call.function_index - 1 == function_index) return true;
+				for(const auto* arg_expr : function_call.arguments) {
+					if(logo::calls_function(state,*arg_expr,function_index)) return true;
+				}
+				return false;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	//Calls made by nested functions aren't counted.
+	[[nodiscard]] static bool calls_function(const Optimizer_State* state,const Heap_Array<Ast_Statement>& statements,std::size_t function_index) {
+		for(const auto& statement : statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					if(logo::calls_function(state,statement.expression,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					if(logo::calls_function(state,statement.declaration.initial_value_expr,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					if(logo::calls_function(state,statement.assignment.lvalue_expr,function_index) || logo::calls_function(state,statement.assignment.rvalue_expr,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					const auto& if_statement = statement.if_statement;
+					if(logo::calls_function(state,if_statement.condition_expr,function_index)) return true;
+					if(logo::calls_function(state,if_statement.if_true_statements,function_index) || logo::calls_function(state,if_statement.if_false_statements,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(logo::calls_function(state,statement.while_statement.condition_expr,function_index)) return true;
+					if(logo::calls_function(state,statement.while_statement.body_statements,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					const auto& for_statement = statement.for_statement;
+					if(logo::calls_function(state,for_statement.start_expr,function_index) || logo::calls_function(state,for_statement.end_expr,function_index)) return true;
+					if(logo::calls_function(state,for_statement.body_statements,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value && logo::calls_function(state,*statement.return_statement.return_value,function_index)) return true;
+					break;
+				}
+				case Ast_Statement_Type::Function_Definition:
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				default: logo::unreachable();
+			}
+		}
+		return false;
+	}
+
+	//Pure functions that call themselves get their results cached at runtime, which turns exponential recursions like the Fibonacci sequence into linear ones.
+	//The cache is keyed by the argument values, so it doesn't matter that the function can be called from many places.
+	static void mark_memoized_functions(Optimizer_State* state) {
+		for(std::size_t i = 0;i < state->function_definitions.length;i += 1) {
+			auto* function_definition = state->function_definitions[i];
+			if(!state->are_functions_pure[i] || !logo::calls_function(state,function_definition->body_statements,i)) continue;
+			function_definition->is_memoized = true;
+			state->statistics.memoized_function_count += 1;
+		}
+	}
+
+	[[nodiscard]] static bool collect_constant_calls(Optimizer_State* state,Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value:
+			case Ast_Expression_Type::Array_Access: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: return logo::collect_constant_calls(state,expression->unary_prefix_operator->child);
+			case Ast_Expression_Type::Binary_Operator: {
+				if(!logo::collect_constant_calls(state,expression->binary_operator->left)) return false;
+				return logo::collect_constant_calls(state,expression->binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::collect_constant_calls(state,expression->conditional->condition)) return false;
+				if(!logo::collect_constant_calls(state,expression->conditional->if_true)) return false;
+				return logo::collect_constant_calls(state,expression->conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				const auto& function_call = *expression->function_call;
+				bool are_arguments_constant = true;
+				for(const auto* arg_expr : function_call.arguments) {
+					if(!logo::is_pure_expression(state,*arg_expr,false)) are_arguments_constant = false;
+				}
+				if(are_arguments_constant && logo::is_user_function_call(state,function_call) && state->are_functions_pure[function_call.function_index - 1]) {
+					if(!state->constant_calls.push_back(expression)) {
+						Report_Error("Couldn't allocate % bytes of memory.",sizeof(expression));
+						return false;
+					}
+					return true;
+				}
+				for(auto* arg_expr : function_call.arguments) {
+					if(!logo::collect_constant_calls(state,arg_expr)) return false;
+				}
+				return true;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool collect_constant_calls(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					if(!logo::collect_constant_calls(state,&statement.expression)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					if(!logo::collect_constant_calls(state,&statement.declaration.initial_value_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					if(!logo::collect_constant_calls(state,&statement.assignment.rvalue_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					if(!logo::collect_constant_calls(state,&statement.if_statement.condition_expr)) return false;
+					if(!logo::collect_constant_calls(state,&statement.if_statement.if_true_statements)) return false;
+					if(!logo::collect_constant_calls(state,&statement.if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::collect_constant_calls(state,&statement.while_statement.condition_expr)) return false;
+					if(!logo::collect_constant_calls(state,&statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					if(!logo::collect_constant_calls(state,&statement.for_statement.start_expr)) return false;
+					if(!logo::collect_constant_calls(state,&statement.for_statement.end_expr)) return false;
+					if(!logo::collect_constant_calls(state,&statement.for_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Function_Definition: {
+					if(!logo::collect_constant_calls(state,&statement.function_definition.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value && !logo::collect_constant_calls(state,statement.return_statement.return_value)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				default: logo::unreachable();
+			}
+		}
+		return true;
+	}
+
+	static void replace_with_literal(Optimizer_State* state,Ast_Expression* expression,const Ast_Value& literal);
+	[[nodiscard]] static Ast_Value make_literal_from_interpreter_value(const Interpreter_Value& value,std::size_t line_index);
+
+	//Calls that fail, don't return a value or don't finish within the step limit are left for runtime.
+	[[nodiscard]] static bool evaluate_constant_calls(Optimizer_State* state,Heap_Array<Ast_Statement>* statements,std::size_t max_evaluation_step_count) {
+		if(!logo::find_pure_functions(state)) return false;
+		logo::mark_memoized_functions(state);
+		if(max_evaluation_step_count == 0) return true;
+		if(!logo::collect_constant_calls(state,statements)) return false;
+		if(state->constant_calls.length == 0) return true;
+
+		Heap_Array<Interpreter_Value> results{};
+		defer[&]{results.destroy();};
+		if(!results.resize(state->constant_calls.length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",state->constant_calls.length * sizeof(Interpreter_Value));
+			return false;
+		}
+		Array_View<Ast_Expression*> expressions(state->constant_calls.data,state->constant_calls.length);
+		if(!logo::evaluate_expressions(statements,expressions,max_evaluation_step_count,results.data)) return false;
+		for(std::size_t i = 0;i < results.length;i += 1) {
+			if(!logo::is_one_of(results[i].type,Interpreter_Value_Type::Int,Interpreter_Value_Type::Float,Interpreter_Value_Type::Bool,Interpreter_Value_Type::String)) continue;
+			auto* expression = state->constant_calls[i];
+			logo::replace_with_literal(state,expression,logo::make_literal_from_interpreter_value(results[i],expression->function_call->line_index));
+			state->statistics.evaluated_call_count += 1;
+		}
+		return true;
+	}
+
+	//The third pass finds variables that can change after they are declared.
+
+	[[nodiscard]] static bool mark_variables_in_expression(Optimizer_State* state,Ast_Expression* expression);
+
+	[[nodiscard]] static bool mark_modified_variable(Optimizer_State* state,Ast_Expression* expression) {
+		if(expression->type == Ast_Expression_Type::Value && expression->value.type == Ast_Value_Type::Identifier) {
+			auto* binding = logo::get_binding(state,expression->value);
+			if(binding->is_modified) *binding->is_modified = true;
+			return true;
+		}
+		if(expression->type == Ast_Expression_Type::Unary_Prefix_Operator && expression->unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+			const auto& child_value = expression->unary_prefix_operator->child->value;
+			if(child_value.depth == 0) {
+				auto* binding = logo::get_binding(state,child_value);
+				if(binding->is_modified) *binding->is_modified = true;
+				return true;
+			}
+			if(!logo::add_symbol(&state->dynamically_accessed_names,child_value.identfier_name)) return false;
+			return logo::add_symbol(&state->dynamically_modified_names,child_value.identfier_name);
+		}
+		//Either branch of a conditional expression can be the lvalue.
+		if(expression->type == Ast_Expression_Type::Conditional) {
+			if(!logo::mark_variables_in_expression(state,expression->conditional->condition)) return false;
+			if(!logo::mark_modified_variable(state,expression->conditional->if_true)) return false;
+			return logo::mark_modified_variable(state,expression->conditional->if_false);
+		}
+		return logo::mark_variables_in_expression(state,expression);
+	}
+
+	static bool mark_variables_in_expression(Optimizer_State* state,Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				auto* unary_operator = expression->unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Reference) return logo::mark_modified_variable(state,unary_operator->child);
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					if(unary_operator->child->value.depth == 0) return true;
+					return logo::add_symbol(&state->dynamically_accessed_names,unary_operator->child->value.identfier_name);
+				}
+				return logo::mark_variables_in_expression(state,unary_operator->child);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				if(!logo::mark_variables_in_expression(state,expression->binary_operator->left)) return false;
+				return logo::mark_variables_in_expression(state,expression->binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::mark_variables_in_expression(state,expression->conditional->condition)) return false;
+				if(!logo::mark_variables_in_expression(state,expression->conditional->if_true)) return false;
+				return logo::mark_variables_in_expression(state,expression->conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				for(auto* arg_expr : expression->function_call->arguments) {
+					if(!logo::mark_variables_in_expression(state,arg_expr)) return false;
+				}
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: return true;
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool mark_variables_in_statements(Optimizer_State* state,Heap_Array<Ast_Statement>* statements);
+
+	[[nodiscard]] static bool mark_variables_in_scope(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		std::size_t binding_count = state->bindings.length;
+		if(!logo::mark_variables_in_statements(state,statements)) return false;
+		state->bindings.length = binding_count;
+		return true;
+	}
+
+	[[nodiscard]] static bool mark_variables_in_statement(Optimizer_State* state,Ast_Statement* statement) {
+		switch(statement->type) {
+			case Ast_Statement_Type::Expression: return logo::mark_variables_in_expression(state,&statement->expression);
+			case Ast_Statement_Type::Declaration: {
+				statement->declaration.is_modified = false;
+				if(!logo::mark_variables_in_expression(state,&statement->declaration.initial_value_expr)) return false;
+				return logo::push_binding(state,&statement->declaration.is_modified);
+			}
+			case Ast_Statement_Type::Assignment: {
+				if(!logo::mark_modified_variable(state,&statement->assignment.lvalue_expr)) return false;
+				return logo::mark_variables_in_expression(state,&statement->assignment.rvalue_expr);
+			}
+			case Ast_Statement_Type::If_Statement: {
+				if(!logo::mark_variables_in_expression(state,&statement->if_statement.condition_expr)) return false;
+				if(!logo::mark_variables_in_scope(state,&statement->if_statement.if_true_statements)) return false;
+				return logo::mark_variables_in_scope(state,&statement->if_statement.if_false_statements);
+			}
+			case Ast_Statement_Type::While_Statement: {
+				if(!logo::mark_variables_in_expression(state,&statement->while_statement.condition_expr)) return false;
+				return logo::mark_variables_in_scope(state,&statement->while_statement.body_statements);
+			}
+			case Ast_Statement_Type::For_Statement: {
+				if(!logo::mark_variables_in_expression(state,&statement->for_statement.start_expr)) return false;
+				if(!logo::mark_variables_in_expression(state,&statement->for_statement.end_expr)) return false;
+				statement->for_statement.is_iterator_modified = false;
+				if(!logo::push_binding(state,&statement->for_statement.is_iterator_modified)) return false;
+				if(!logo::mark_variables_in_scope(state,&statement->for_statement.body_statements)) return false;
+				state->bindings.pop_back();
+				return true;
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				std::size_t binding_count = state->bindings.length;
+				std::size_t copy_binding_index = state->current_function_scope_first_binding_index;
+				state->current_function_scope_first_binding_index = state->bindings.length;
+				for(std::size_t i = 0;i < statement->function_definition.function_arguments.length;i += 1) {
+					if(!logo::push_binding(state,nullptr)) return false;
+				}
+				if(!logo::mark_variables_in_statements(state,&statement->function_definition.body_statements)) return false;
+				state->current_function_scope_first_binding_index = copy_binding_index;
+				state->bindings.length = binding_count;
+				return true;
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				if(!statement->return_statement.return_value) return true;
+				return logo::mark_variables_in_expression(state,statement->return_statement.return_value);
+			}
+			case Ast_Statement_Type::Break_Statement:
+			case Ast_Statement_Type::Continue_Statement: return true;
+			default: logo::unreachable();
+		}
+	}
+
+	static bool mark_variables_in_statements(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			if(!logo::mark_variables_in_statement(state,&statement)) return false;
+		}
+		return true;
+	}
+
+	//The fourth pass folds constants and removes dead code.
+
+	[[nodiscard]] static bool is_literal(const Ast_Expression& expression) {
+		return expression.type == Ast_Expression_Type::Value && expression.value.type != Ast_Value_Type::Identifier;
+	}
+
+	[[nodiscard]] static bool is_number_type(Interpreter_Value_Type type) {
+		return type == Interpreter_Value_Type::Int || type == Interpreter_Value_Type::Float;
+	}
+
+	[[nodiscard]] static Interpreter_Value make_interpreter_value_from_literal(const Ast_Value& value) {
+		Interpreter_Value result{};
+		switch(value.type) {
+			case Ast_Value_Type::Int_Literal: result.type = Interpreter_Value_Type::Int; result.int_v = value.int_value; break;
+			case Ast_Value_Type::Float_Literal: result.type = Interpreter_Value_Type::Float; result.float_v = value.float_value; break;
+			case Ast_Value_Type::Bool_Literal: result.type = Interpreter_Value_Type::Bool; result.bool_v = value.bool_value; break;
+			case Ast_Value_Type::String_Literal: result.type = Interpreter_Value_Type::String; result.string_v = value.string_value; break;
+			default: logo::unreachable();
+		}
+		return result;
+	}
+
+	static Ast_Value make_literal_from_interpreter_value(const Interpreter_Value& value,std::size_t line_index) {
+		Ast_Value result{};
+		result.line_index = line_index;
+		switch(value.type) {
+			case Interpreter_Value_Type::Int: result.type = Ast_Value_Type::Int_Literal; result.int_value = value.int_v; break;
+			case Interpreter_Value_Type::Float: result.type = Ast_Value_Type::Float_Literal; result.float_value = value.float_v; break;
+			case Interpreter_Value_Type::Bool: result.type = Ast_Value_Type::Bool_Literal; result.bool_value = value.bool_v; break;
+			case Interpreter_Value_Type::String: result.type = Ast_Value_Type::String_Literal; result.string_value = value.string_v; break;
+			default: logo::unreachable();
+		}
+		return result;
+	}
+
+	static void replace_with_literal(Optimizer_State* state,Ast_Expression* expression,const Ast_Value& literal) {
+		state->statistics.removed_node_count += logo::count_expression_nodes(*expression) - 1;
+		logo::destroy_expression(expression);
+		bool is_parenthesised = expression->is_parenthesised;
+		*expression = {};
+		expression->type = Ast_Expression_Type::Value;
+		expression->is_parenthesised = is_parenthesised;
+		expression->value = literal;
+	}
+
+	//'subexpression' must be a part of 'expression'.
+	static void replace_with_subexpression(Optimizer_State* state,Ast_Expression* expression,Ast_Expression* subexpression) {
+		state->statistics.removed_node_count += logo::count_expression_nodes(*expression) - logo::count_expression_nodes(*subexpression);
+		auto kept_expression = *subexpression;
+		//The subexpression is detached first so that destroying the rest of the expression doesn't destroy it.
+		*subexpression = {};
+		subexpression->type = Ast_Expression_Type::Value;
+		logo::destroy_expression(expression);
+		*expression = kept_expression;
+	}
+
+	static void replace_with_constant(Optimizer_State* state,Ast_Expression* expression,const Optimizer_Binding& binding,std::size_t line_index) {
+		Ast_Value literal = binding.constant_value;
+		literal.line_index = line_index;
+		logo::replace_with_literal(state,expression,literal);
+	}
+
+	//Returns true if the operation can't report an error at runtime for operands of the given types.
+	[[nodiscard]] static bool is_valid_unary_operation(Ast_Unary_Prefix_Operator_Type type,Interpreter_Value_Type child_type) {
+		switch(type) {
+			case Ast_Unary_Prefix_Operator_Type::Plus:
+			case Ast_Unary_Prefix_Operator_Type::Minus: return logo::is_number_type(child_type);
+			case Ast_Unary_Prefix_Operator_Type::Logical_Not: return child_type == Interpreter_Value_Type::Bool;
+			default: return false;
+		}
+	}
+
+	//Same as above, except that integer division and remainder also depend on the value of the divisor.
+	[[nodiscard]] static bool is_valid_binary_operation(Ast_Binary_Operator_Type type,Interpreter_Value_Type left_type,Interpreter_Value_Type right_type) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus:
+			case Ast_Binary_Operator_Type::Minus:
+			case Ast_Binary_Operator_Type::Multiply:
+			case Ast_Binary_Operator_Type::Divide:
+			case Ast_Binary_Operator_Type::Remainder:
+			case Ast_Binary_Operator_Type::Exponentiate:
+			case Ast_Binary_Operator_Type::Compare_Less_Than:
+			case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal:
+			case Ast_Binary_Operator_Type::Compare_Greater_Than:
+			case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: return logo::is_number_type(left_type) && logo::is_number_type(right_type);
+			case Ast_Binary_Operator_Type::Logical_And:
+			case Ast_Binary_Operator_Type::Logical_Or: return left_type == Interpreter_Value_Type::Bool && right_type == Interpreter_Value_Type::Bool;
+			case Ast_Binary_Operator_Type::Compare_Equal:
+			case Ast_Binary_Operator_Type::Compare_Unequal: {
+				if(logo::is_number_type(left_type) && logo::is_number_type(right_type)) return true;
+				return left_type == right_type && (left_type == Interpreter_Value_Type::Bool || left_type == Interpreter_Value_Type::String);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool is_integer_division(Ast_Binary_Operator_Type type,Interpreter_Value_Type left_type,Interpreter_Value_Type right_type) {
+		if(type != Ast_Binary_Operator_Type::Divide && type != Ast_Binary_Operator_Type::Remainder) return false;
+		return left_type == Interpreter_Value_Type::Int && right_type == Interpreter_Value_Type::Int;
+	}
+
+	//Operations that would report an error at runtime are not folded, the error is still reported if the code is ever executed.
+	[[nodiscard]] static bool can_fold_binary_operation(Ast_Binary_Operator_Type type,const Interpreter_Value& left,const Interpreter_Value& right) {
+		if(!logo::is_valid_binary_operation(type,left.type,right.type)) return false;
+		if(logo::is_integer_division(type,left.type,right.type)) {
+			if(right.int_v == 0) return false;
+			if(right.int_v == -1 && left.int_v == std::numeric_limits<std::int64_t>::min()) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static const Interpreter_Builtin_Function* find_pure_builtin_function(const Ast_Function_Call& function_call) {
+		const auto* function = logo::find_builtin_function(function_call);
+		return (function && function->is_pure) ? function : nullptr;
+	}
+
+	[[nodiscard]] static bool optimize_expression(Optimizer_State* state,Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value: {
+				if(expression->value.type != Ast_Value_Type::Identifier) return true;
+				const auto* binding = logo::get_binding(state,expression->value);
+				if(binding->is_constant) logo::replace_with_constant(state,expression,*binding,expression->value.line_index);
+				return true;
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				auto* unary_operator = expression->unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					const auto& child_value = unary_operator->child->value;
+					if(child_value.depth != 0) return true;
+					const auto* binding = logo::get_binding(state,child_value);
+					if(binding->is_constant) logo::replace_with_constant(state,expression,*binding,unary_operator->line_index);
+					return true;
+				}
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Reference) {
+					//The variables in the branches of a conditional lvalue are marked as modified, so only its condition can change.
+					if(unary_operator->child->type != Ast_Expression_Type::Conditional) return true;
+					return logo::optimize_expression(state,unary_operator->child);
+				}
+				if(!logo::optimize_expression(state,unary_operator->child)) return false;
+				if(!logo::is_literal(*unary_operator->child)) return true;
+
+				auto value = logo::make_interpreter_value_from_literal(unary_operator->child->value);
+				if(!logo::is_valid_unary_operation(unary_operator->type,value.type)) return true;
+				auto [result,success] = logo::compute_unary_operation(unary_operator->type,value,unary_operator->line_index);
+				logo::assert(success);
+				logo::replace_with_literal(state,expression,logo::make_literal_from_interpreter_value(result,unary_operator->line_index));
+				return true;
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				auto* binary_operator = expression->binary_operator;
+				if(!logo::optimize_expression(state,binary_operator->left)) return false;
+				if(logo::is_literal(*binary_operator->left)) {
+					auto left = logo::make_interpreter_value_from_literal(binary_operator->left->value);
+					if(logo::is_short_circuited(binary_operator->type,left)) {
+						logo::replace_with_subexpression(state,expression,binary_operator->left);
+						return true;
+					}
+				}
+				if(!logo::optimize_expression(state,binary_operator->right)) return false;
+				if(!logo::is_literal(*binary_operator->left) || !logo::is_literal(*binary_operator->right)) return true;
+
+				auto left = logo::make_interpreter_value_from_literal(binary_operator->left->value);
+				auto right = logo::make_interpreter_value_from_literal(binary_operator->right->value);
+				if(!logo::can_fold_binary_operation(binary_operator->type,left,right)) return true;
+				auto [result,success] = logo::compute_binary_operation(binary_operator->type,left,right,binary_operator->line_index);
+				logo::assert(success);
+				logo::replace_with_literal(state,expression,logo::make_literal_from_interpreter_value(result,binary_operator->line_index));
+				return true;
+			}
+			case Ast_Expression_Type::Conditional: {
+				auto* conditional = expression->conditional;
+				if(!logo::optimize_expression(state,conditional->condition)) return false;
+				const auto& condition = *conditional->condition;
+				if(condition.type == Ast_Expression_Type::Value && condition.value.type == Ast_Value_Type::Bool_Literal) {
+					auto* selected_expr = condition.value.bool_value ? conditional->if_true : conditional->if_false;
+					if(!logo::optimize_expression(state,selected_expr)) return false;
+					logo::replace_with_subexpression(state,expression,selected_expr);
+					return true;
+				}
+				if(!logo::optimize_expression(state,conditional->if_true)) return false;
+				return logo::optimize_expression(state,conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				auto* function_call = expression->function_call;
+				for(auto* arg_expr : function_call->arguments) {
+					if(!logo::optimize_expression(state,arg_expr)) return false;
+				}
+				const auto* function = logo::find_pure_builtin_function(*function_call);
+				if(!function) return true;
+
+				Static_Array<Interpreter_Value,16> args{};
+				for(const auto* arg_expr : function_call->arguments) {
+					if(!logo::is_literal(*arg_expr)) return true;
+					auto value = logo::make_interpreter_value_from_literal(arg_expr->value);
+					//All pure builtin functions take numbers only.
+					if(!logo::is_number_type(value.type)) return true;
+					if(!args.push_back(value)) return true;
+				}
+				auto [result,success] = function->func_ptr(&state->context,function_call->line_index,{args.data,args.length});
+				if(!success) return false;
+				logo::replace_with_literal(state,expression,logo::make_literal_from_interpreter_value(result,function_call->line_index));
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: return true;
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool append_statement(Heap_Array<Ast_Statement>* statements,const Ast_Statement& statement) {
+		if(!statements->push_back(statement)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(statement));
+			return false;
+		}
+		return true;
+	}
+
+	//Loop optimizations. They only touch expressions that can't fail and have no side effects, because such expressions are evaluated
+	//before the loop even if it never executes.
+
+	//Returns 'Void' if the type can't be determined. Operations that fail at runtime stop the program, so their operands are assumed to be valid.
+	[[nodiscard]] static Interpreter_Value_Type get_static_type(Optimizer_State* state,const Ast_Expression& expression) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: {
+				if(expression.value.type != Ast_Value_Type::Identifier) return logo::make_interpreter_value_from_literal(expression.value).type;
+				return logo::get_binding(state,expression.value)->type;
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				switch(unary_operator->type) {
+					case Ast_Unary_Prefix_Operator_Type::Plus:
+					case Ast_Unary_Prefix_Operator_Type::Minus: {
+						auto child_type = logo::get_static_type(state,*unary_operator->child);
+						return logo::is_number_type(child_type) ? child_type : Interpreter_Value_Type::Void;
+					}
+					case Ast_Unary_Prefix_Operator_Type::Logical_Not: return Interpreter_Value_Type::Bool;
+					case Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access: {
+						if(unary_operator->child->value.depth != 0) return Interpreter_Value_Type::Void;
+						return logo::get_binding(state,unary_operator->child->value)->type;
+					}
+					default: return Interpreter_Value_Type::Void;
+				}
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto* binary_operator = expression.binary_operator;
+				switch(binary_operator->type) {
+					case Ast_Binary_Operator_Type::Plus:
+					case Ast_Binary_Operator_Type::Minus:
+					case Ast_Binary_Operator_Type::Multiply:
+					case Ast_Binary_Operator_Type::Divide:
+					case Ast_Binary_Operator_Type::Remainder:
+					case Ast_Binary_Operator_Type::Exponentiate: {
+						auto left_type = logo::get_static_type(state,*binary_operator->left);
+						auto right_type = logo::get_static_type(state,*binary_operator->right);
+						if(!logo::is_number_type(left_type) || !logo::is_number_type(right_type)) return Interpreter_Value_Type::Void;
+						if(left_type == Interpreter_Value_Type::Int && right_type == Interpreter_Value_Type::Int) return Interpreter_Value_Type::Int;
+						return Interpreter_Value_Type::Float;
+					}
+					default: return Interpreter_Value_Type::Bool;
+				}
+			}
+			case Ast_Expression_Type::Conditional: {
+				auto if_true_type = logo::get_static_type(state,*expression.conditional->if_true);
+				auto if_false_type = logo::get_static_type(state,*expression.conditional->if_false);
+				return (if_true_type == if_false_type) ? if_true_type : Interpreter_Value_Type::Void;
+			}
+			case Ast_Expression_Type::Function_Call: {
+				return logo::find_pure_builtin_function(*expression.function_call) ? Interpreter_Value_Type::Float : Interpreter_Value_Type::Void;
+			}
+			default: return Interpreter_Value_Type::Void;
+		}
+	}
+
+	//Returns true if the expression can't fail, has no side effects and reads only variables that never change.
+	//'binding_limit' is raised to one past the highest binding index the expression reads.
+	[[nodiscard]] static bool is_safe_expression(Optimizer_State* state,const Ast_Expression& expression,std::size_t* binding_limit) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: {
+				if(expression.value.type != Ast_Value_Type::Identifier) return true;
+				std::size_t binding_index = logo::get_binding_index(state,expression.value);
+				if(state->bindings[binding_index].type == Interpreter_Value_Type::Void) return false;
+				if(binding_index + 1 > *binding_limit) *binding_limit = binding_index + 1;
+				return true;
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					if(unary_operator->child->value.depth != 0) return false;
+					return logo::is_safe_expression(state,*unary_operator->child,binding_limit);
+				}
+				if(!logo::is_safe_expression(state,*unary_operator->child,binding_limit)) return false;
+				return logo::is_valid_unary_operation(unary_operator->type,logo::get_static_type(state,*unary_operator->child));
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto* binary_operator = expression.binary_operator;
+				if(!logo::is_safe_expression(state,*binary_operator->left,binding_limit)) return false;
+				if(!logo::is_safe_expression(state,*binary_operator->right,binding_limit)) return false;
+				auto left_type = logo::get_static_type(state,*binary_operator->left);
+				auto right_type = logo::get_static_type(state,*binary_operator->right);
+				if(!logo::is_valid_binary_operation(binary_operator->type,left_type,right_type)) return false;
+				if(logo::is_integer_division(binary_operator->type,left_type,right_type)) {
+					const auto& right = *binary_operator->right;
+					if(!logo::is_literal(right) || right.value.int_value == 0 || right.value.int_value == -1) return false;
+				}
+				//Converting the result of a huge integer power back to an integer is undefined.
+				if(binary_operator->type == Ast_Binary_Operator_Type::Exponentiate && left_type == Interpreter_Value_Type::Int && right_type == Interpreter_Value_Type::Int) return false;
+				return true;
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				if(!logo::is_safe_expression(state,*conditional->condition,binding_limit)) return false;
+				if(logo::get_static_type(state,*conditional->condition) != Interpreter_Value_Type::Bool) return false;
+				if(!logo::is_safe_expression(state,*conditional->if_true,binding_limit)) return false;
+				return logo::is_safe_expression(state,*conditional->if_false,binding_limit);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				if(!logo::find_pure_builtin_function(*expression.function_call)) return false;
+				for(const auto* arg_expr : expression.function_call->arguments) {
+					if(!logo::is_safe_expression(state,*arg_expr,binding_limit)) return false;
+					if(!logo::is_number_type(logo::get_static_type(state,*arg_expr))) return false;
+				}
+				return true;
+			}
+			default: return false;
+		}
+	}
+
+	[[nodiscard]] static Ast_Expression make_hidden_variable_expression(Symbol name,std::size_t line_index) {
+		Ast_Expression expression{};
+		expression.type = Ast_Expression_Type::Value;
+		expression.value.type = Ast_Value_Type::Identifier;
+		expression.value.identfier_name = name;
+		expression.value.line_index = line_index;
+		return expression;
+	}
+
+	//The expression is moved into a declaration placed before the loop. Its slot is assigned when the AST is resolved again.
+	[[nodiscard]] static bool hoist_expression(Optimizer_State* state,Optimizer_Loop* loop,Ast_Expression* expression) {
+		auto [name,success] = logo::make_hidden_variable_name(state);
+		if(!success) return false;
+
+		Ast_Statement declaration{};
+		declaration.type = Ast_Statement_Type::Declaration;
+		declaration.line_index = loop->line_index;
+		declaration.declaration = {};
+		declaration.declaration.name = name;
+		declaration.declaration.initial_value_expr = *expression;
+		if(!logo::append_statement(&loop->hoisted_declarations,declaration)) return false;
+
+		*expression = logo::make_hidden_variable_expression(name,loop->line_index);
+		state->statistics.hoisted_expression_count += 1;
+		return true;
+	}
+
+	[[nodiscard]] static bool is_same_induction_step(Optimizer_State* state,const Ast_Expression& left,const Ast_Expression& right) {
+		if(left.type != Ast_Expression_Type::Value || right.type != Ast_Expression_Type::Value || left.value.type != right.value.type) return false;
+		if(left.value.type == Ast_Value_Type::Int_Literal) return left.value.int_value == right.value.int_value;
+		if(left.value.type == Ast_Value_Type::Identifier) return logo::get_binding_index(state,left.value) == logo::get_binding_index(state,right.value);
+		return false;
+	}
+
+	//Replaces 'iterator * step' with an induction variable of the loop if 'step' is a loop invariant integer.
+	[[nodiscard]] static Option<bool> reduce_multiplication(Optimizer_State* state,Ast_Expression* expression) {
+		auto* binary_operator = expression->binary_operator;
+		if(binary_operator->type != Ast_Binary_Operator_Type::Multiply) return false;
+
+		for(std::size_t i = 0;i < 2;i += 1) {
+			auto* iterator_expr = (i == 0) ? binary_operator->left : binary_operator->right;
+			auto* step_expr = (i == 0) ? binary_operator->right : binary_operator->left;
+			if(iterator_expr->type != Ast_Expression_Type::Value || iterator_expr->value.type != Ast_Value_Type::Identifier) continue;
+			std::size_t binding_index = logo::get_binding_index(state,iterator_expr->value);
+			if(state->bindings[binding_index].type != Interpreter_Value_Type::Int) continue;
+
+			Optimizer_Loop* loop = nullptr;
+			for(std::size_t j = state->current_function_scope_first_loop_index;j < state->loops.length;j += 1) {
+				if(state->loops[j].for_statement && state->loops[j].first_binding_index == binding_index) loop = &state->loops[j];
+			}
+			if(!loop) continue;
+
+			std::size_t binding_limit = 0;
+			if(!logo::is_safe_expression(state,*step_expr,&binding_limit) || binding_limit > loop->first_binding_index) continue;
+			if(logo::get_static_type(state,*step_expr) != Interpreter_Value_Type::Int) continue;
+
+			auto& induction_variables = loop->for_statement->induction_variables;
+			const Ast_Induction_Variable* induction_variable = nullptr;
+			for(const auto& existing_induction_variable : induction_variables) {
+				if(logo::is_same_induction_step(state,existing_induction_variable.step_expr,*step_expr)) induction_variable = &existing_induction_variable;
+			}
+			if(!induction_variable) {
+				if(induction_variables.length >= MAX_INDUCTION_VARIABLE_COUNT) return false;
+				auto [name,success] = logo::make_hidden_variable_name(state);
+				if(!success) return {};
+
+				Ast_Induction_Variable new_induction_variable{};
+				new_induction_variable.name = name;
+				new_induction_variable.step_expr = *step_expr;
+				if(!induction_variables.push_back(new_induction_variable)) {
+					Report_Error("Couldn't allocate % bytes of memory.",sizeof(new_induction_variable));
+					return {};
+				}
+				induction_variable = &induction_variables[induction_variables.length - 1];
+			}
+			else logo::destroy_expression(step_expr);
+
+			*expression = logo::make_hidden_variable_expression(induction_variable->name,iterator_expr->value.line_index);
+			state->statistics.reduced_multiplication_count += 1;
+			return true;
+		}
+		return false;
+	}
+
+	[[nodiscard]] static bool optimize_loop_expression(Optimizer_State* state,Ast_Expression* expression) {
+		if(state->loops.length == state->current_function_scope_first_loop_index) return true;
+		if(expression->type == Ast_Expression_Type::Value || expression->type == Ast_Expression_Type::Array_Access) return true;
+
+		//The expression is moved out of the outermost loop in which all variables it reads are already declared.
+		std::size_t binding_limit = 0;
+		if(logo::is_safe_expression(state,*expression,&binding_limit)) {
+			for(std::size_t i = state->current_function_scope_first_loop_index;i < state->loops.length;i += 1) {
+				if(state->loops[i].first_binding_index >= binding_limit) return logo::hoist_expression(state,&state->loops[i],expression);
+			}
+		}
+
+		switch(expression->type) {
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				auto* unary_operator = expression->unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Reference || unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) return true;
+				return logo::optimize_loop_expression(state,unary_operator->child);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				auto [reduced,success] = logo::reduce_multiplication(state,expression);
+				if(!success) return false;
+				if(reduced) return true;
+				if(!logo::optimize_loop_expression(state,expression->binary_operator->left)) return false;
+				return logo::optimize_loop_expression(state,expression->binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::optimize_loop_expression(state,expression->conditional->condition)) return false;
+				if(!logo::optimize_loop_expression(state,expression->conditional->if_true)) return false;
+				return logo::optimize_loop_expression(state,expression->conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				for(auto* arg_expr : expression->function_call->arguments) {
+					if(!logo::optimize_loop_expression(state,arg_expr)) return false;
+				}
+				return true;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool optimize_expressions(Optimizer_State* state,Ast_Expression* expression) {
+		if(!logo::optimize_expression(state,expression)) return false;
+		return logo::optimize_loop_expression(state,expression);
+	}
+
+	[[nodiscard]] static bool begin_loop(Optimizer_State* state,Ast_For_Statement* for_statement,std::size_t line_index) {
+		Optimizer_Loop loop{};
+		loop.first_binding_index = state->bindings.length;
+		loop.for_statement = for_statement;
+		loop.line_index = line_index;
+		if(!state->loops.push_back(loop)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(loop));
+			return false;
+		}
+		return true;
+	}
+
+	//Declarations hoisted out of the loop are placed before it and can be optimized further by the enclosing loops.
+	[[nodiscard]] static bool end_loop(Optimizer_State* state,Heap_Array<Ast_Statement>* output) {
+		auto loop = state->loops[state->loops.length - 1];
+		state->loops.pop_back();
+		defer[&]{loop.hoisted_declarations.destroy();};
+
+		for(std::size_t i = 0;i < loop.hoisted_declarations.length;i += 1) {
+			auto& declaration = loop.hoisted_declarations[i];
+			if(!logo::optimize_loop_expression(state,&declaration.declaration.initial_value_expr) || !logo::append_statement(output,declaration)) {
+				for(std::size_t j = i;j < loop.hoisted_declarations.length;j += 1) logo::destroy_statement(&loop.hoisted_declarations[j]);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool optimize_statements(Optimizer_State* state,Heap_Array<Ast_Statement>* statements);
+
+	[[nodiscard]] static bool optimize_scope(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		std::size_t binding_count = state->bindings.length;
+		if(!logo::optimize_statements(state,statements)) return false;
+		state->bindings.length = binding_count;
+		return true;
+	}
+
+	//Statements of a scope can be moved to the enclosing scope only if they don't define anything that would outlive the scope.
+	[[nodiscard]] static bool can_merge_scope(const Heap_Array<Ast_Statement>& statements) {
+		for(const auto& statement : statements) {
+			if(statement.type == Ast_Statement_Type::Declaration || statement.type == Ast_Statement_Type::Function_Definition) return false;
+		}
+		return true;
+	}
+
+	//Optimized statements are appended to 'output'.
+	[[nodiscard]] static bool optimize_statement(Optimizer_State* state,Ast_Statement* statement,Heap_Array<Ast_Statement>* output) {
+		switch(statement->type) {
+			case Ast_Statement_Type::Expression: {
+				if(!logo::optimize_expressions(state,&statement->expression)) return false;
+				break;
+			}
+			case Ast_Statement_Type::Declaration: {
+				auto& declaration = statement->declaration;
+				if(!logo::optimize_expression(state,&declaration.initial_value_expr)) return false;
+				if(!logo::push_binding(state,&declaration.is_modified)) return false;
+
+				if(!declaration.is_modified && !logo::contains_symbol(state->dynamically_modified_names,declaration.name)) {
+					auto& binding = state->bindings[state->bindings.length - 1];
+					binding.type = logo::get_static_type(state,declaration.initial_value_expr);
+					if(logo::is_literal(declaration.initial_value_expr)) {
+						binding.is_constant = true;
+						binding.constant_value = declaration.initial_value_expr.value;
+						//The variable has to stay on the stack if it can be found by name at runtime.
+						if(!logo::contains_symbol(state->dynamically_accessed_names,declaration.name)) {
+							logo::remove_statement(state,statement);
+							return true;
+						}
+					}
+				}
+				if(!logo::optimize_loop_expression(state,&declaration.initial_value_expr)) return false;
+				break;
+			}
+			case Ast_Statement_Type::Assignment: {
+				if(!logo::optimize_expression(state,&statement->assignment.lvalue_expr)) return false;
+				if(!logo::optimize_expressions(state,&statement->assignment.rvalue_expr)) return false;
+				break;
+			}
+			case Ast_Statement_Type::If_Statement: {
+				auto& if_statement = statement->if_statement;
+				if(!logo::optimize_expression(state,&if_statement.condition_expr)) return false;
+				const auto& condition = if_statement.condition_expr;
+				if(condition.type != Ast_Expression_Type::Value || condition.value.type != Ast_Value_Type::Bool_Literal) {
+					if(!logo::optimize_loop_expression(state,&if_statement.condition_expr)) return false;
+					if(!logo::optimize_scope(state,&if_statement.if_true_statements)) return false;
+					if(!logo::optimize_scope(state,&if_statement.if_false_statements)) return false;
+					break;
+				}
+
+				if(!condition.value.bool_value) {
+					auto if_true_statements = if_statement.if_true_statements;
+					if_statement.if_true_statements = if_statement.if_false_statements;
+					if_statement.if_false_statements = if_true_statements;
+					if_statement.condition_expr.value.bool_value = true;
+				}
+				logo::remove_statements(state,&if_statement.if_false_statements);
+				if(!logo::optimize_scope(state,&if_statement.if_true_statements)) return false;
+				if(!logo::can_merge_scope(if_statement.if_true_statements)) break;
+
+				if(!output->push_back(Array_View<Ast_Statement>(if_statement.if_true_statements.data,if_statement.if_true_statements.length))) {
+					Report_Error("Couldn't allocate % bytes of memory.",if_statement.if_true_statements.length * sizeof(Ast_Statement));
+					return false;
+				}
+				if_statement.if_true_statements.destroy();
+				logo::remove_statement(state,statement);
+				return true;
+			}
+			case Ast_Statement_Type::While_Statement: {
+				auto& while_statement = statement->while_statement;
+				if(!logo::optimize_expression(state,&while_statement.condition_expr)) return false;
+				const auto& condition = while_statement.condition_expr;
+				if(condition.type == Ast_Expression_Type::Value && condition.value.type == Ast_Value_Type::Bool_Literal && !condition.value.bool_value) {
+					logo::remove_statement(state,statement);
+					return true;
+				}
+				//The condition is evaluated in every iteration, so it belongs to the loop.
+				if(!logo::begin_loop(state,nullptr,statement->line_index)) return false;
+				if(!logo::optimize_loop_expression(state,&while_statement.condition_expr)) return false;
+				if(!logo::optimize_scope(state,&while_statement.body_statements)) return false;
+				while_statement.skip_scope = logo::can_merge_scope(while_statement.body_statements);
+				if(!logo::end_loop(state,output)) return false;
+				break;
+			}
+			case Ast_Statement_Type::For_Statement: {
+				auto& for_statement = statement->for_statement;
+				if(!logo::optimize_expressions(state,&for_statement.start_expr)) return false;
+				if(!logo::optimize_expressions(state,&for_statement.end_expr)) return false;
+				if(!logo::begin_loop(state,&for_statement,statement->line_index)) return false;
+				if(!logo::push_binding(state,&for_statement.is_iterator_modified)) return false;
+				if(!for_statement.is_iterator_modified && !logo::contains_symbol(state->dynamically_modified_names,for_statement.iterator_identifier)) {
+					state->bindings[state->bindings.length - 1].type = Interpreter_Value_Type::Int;
+				}
+				if(!logo::optimize_scope(state,&for_statement.body_statements)) return false;
+				for_statement.skip_scope = logo::can_merge_scope(for_statement.body_statements);
+				state->bindings.pop_back();
+				if(!logo::end_loop(state,output)) return false;
+				break;
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				std::size_t binding_count = state->bindings.length;
+				std::size_t copy_binding_index = state->current_function_scope_first_binding_index;
+				std::size_t copy_loop_index = state->current_function_scope_first_loop_index;
+				state->current_function_scope_first_binding_index = state->bindings.length;
+				state->current_function_scope_first_loop_index = state->loops.length;
+				for(std::size_t i = 0;i < statement->function_definition.function_arguments.length;i += 1) {
+					if(!logo::push_binding(state,nullptr)) return false;
+				}
+				if(!logo::optimize_statements(state,&statement->function_definition.body_statements)) return false;
+				state->current_function_scope_first_loop_index = copy_loop_index;
+				state->current_function_scope_first_binding_index = copy_binding_index;
+				state->bindings.length = binding_count;
+				break;
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				if(!statement->return_statement.return_value) break;
+				if(!logo::optimize_expressions(state,statement->return_statement.return_value)) return false;
+				break;
+			}
+			case Ast_Statement_Type::Break_Statement:
+			case Ast_Statement_Type::Continue_Statement: break;
+			default: logo::unreachable();
+		}
+		return logo::append_statement(output,*statement);
+	}
+
+	static bool optimize_statements(Optimizer_State* state,Heap_Array<Ast_Statement>* statements) {
+		Heap_Array<Ast_Statement> output{};
+		if(!output.reserve(statements->length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",statements->length * sizeof(Ast_Statement));
+			return false;
+		}
+		for(std::size_t i = 0;i < statements->length;i += 1) {
+			if(!logo::optimize_statement(state,&(*statements)[i],&output)) {
+				//Statements that were already moved are owned by 'output', the remaining ones are still owned by the original array.
+				for(auto& statement : output) logo::destroy_statement(&statement);
+				output.destroy();
+				for(std::size_t j = i;j < statements->length;j += 1) logo::destroy_statement(&(*statements)[j]);
+				statements->destroy();
+				return false;
+			}
+		}
+		statements->destroy();
+		*statements = output;
+		return true;
+	}
+
+	Option<Optimizer_Statistics> optimize_ast(Heap_Array<Ast_Statement>* statements,Arena_Allocator* memory,std::size_t max_evaluation_step_count) {
+		Optimizer_State state{};
+		if(!logo::init_interpreter_context(&state.context)) return {};
+		state.memory = memory;
+		defer[&]{
+			logo::destroy_interpreter_context(&state.context);
+			for(auto& loop : state.loops) {
+				for(auto& statement : loop.hoisted_declarations) logo::destroy_statement(&statement);
+				loop.hoisted_declarations.destroy();
+			}
+			state.loops.destroy();
+			state.bindings.destroy();
+			state.dynamically_accessed_names.destroy();
+			state.dynamically_modified_names.destroy();
+			state.constant_calls.destroy();
+			state.are_functions_pure.destroy();
+			state.inlined_bodies.destroy();
+			state.function_definitions.destroy();
+		};
+
+		if(!logo::collect_function_definitions(&state,statements)) return {};
+		if(!logo::inline_function_calls(&state,statements)) return {};
+		if(!logo::evaluate_constant_calls(&state,statements,max_evaluation_step_count)) return {};
+
+		if(!logo::mark_variables_in_statements(&state,statements)) return {};
+		state.bindings.length = 0;
+		if(!logo::optimize_statements(&state,statements)) return {};
+
+		//Removed declarations change the slots of the variables declared after them.
+		if(!logo::resolve_ast(statements)) return {};
+		return state.statistics;
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef LOGO_OPTIMIZER_HPP
+#define LOGO_OPTIMIZER_HPP
+
+#include "utils.hpp"
+#include "parser.hpp"
+#include "heap_array.hpp"
+
+namespace logo {
+	struct Optimizer_Statistics {
+		std::size_t removed_node_count;
+		std::size_t inlined_call_count;
+		std::size_t evaluated_call_count;
+		std::size_t memoized_function_count;
+		std::size_t hoisted_expression_count;
+		std::size_t reduced_multiplication_count;
+	};
+	//Number of steps a call of a pure user defined function can take when it's computed at compile time before it's left for runtime.
+	static constexpr std::size_t DEFAULT_MAX_EVALUATION_STEP_COUNT = 100000;
+	//Inlines calls of small functions that only return an expression of their arguments (its nodes are allocated in 'memory').
+	//Folds constant expressions (including calls to pure builtin functions), replaces uses of variables that are never modified with their values
+	//and removes if/else branches and loops that can never be executed. Calls of pure user defined functions with constant arguments are computed
+	//by the interpreter if they finish within 'max_evaluation_step_count' steps, 0 turns that off. Pure functions that call themselves are memoized. Loop invariant expressions are moved out of loops,
+	//multiplications of a 'for' loop iterator are replaced with induction variables and loop bodies that don't declare anything don't get their own scope.
+	//Expects a resolved AST and leaves it resolved.
+	[[nodiscard]] Option<Optimizer_Statistics> optimize_ast(Heap_Array<Ast_Statement>* statements,Arena_Allocator* memory,std::size_t max_evaluation_step_count);
+}
+
+#endif
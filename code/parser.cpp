@@ -66,7 +66,7 @@ namespace logo {
 		}
 	}
 
-	static void destroy_expression(Ast_Expression* expression) {
+	void destroy_expression(Ast_Expression* expression) {
 		switch(expression->type) {
 			case Ast_Expression_Type::Unary_Prefix_Operator: {
 				if(expression->unary_prefix_operator->child) logo::destroy_expression(expression->unary_prefix_operator->child);
@@ -89,10 +89,16 @@ namespace logo {
 				if(expression->array_access->right) logo::destroy_expression(expression->array_access->right);
 				break;
 			}
+			case Ast_Expression_Type::Conditional: {
+				logo::destroy_expression(expression->conditional->condition);
+				logo::destroy_expression(expression->conditional->if_true);
+				logo::destroy_expression(expression->conditional->if_false);
+				break;
+			}
 		}
 	}
 
-	static void destroy_statement(Ast_Statement* statement) {
+	void destroy_statement(Ast_Statement* statement) {
 		switch(statement->type) {
 			case Ast_Statement_Type::Assignment: {
 				logo::destroy_expression(&statement->assignment.lvalue_expr);
@@ -120,6 +126,8 @@ namespace logo {
 			case Ast_Statement_Type::For_Statement: {
 				for(auto& statement : statement->for_statement.body_statements) logo::destroy_statement(&statement);
 				statement->for_statement.body_statements.destroy();
+				for(auto& induction_variable : statement->for_statement.induction_variables) logo::destroy_expression(&induction_variable.step_expr);
+				statement->for_statement.induction_variables.destroy();
 				logo::destroy_expression(&statement->for_statement.end_expr);
 				logo::destroy_expression(&statement->for_statement.start_expr);
 				break;
@@ -183,7 +191,7 @@ namespace logo {
 		Token_Type last_token_type = Token_Type::None;
 	};
 
-	[[nodiscard]] static Option<Ast_Value> create_ast_value(Parsing_Result* state,const Token& token) {
+	[[nodiscard]] static Option<Ast_Value> create_ast_value(const Token& token) {
 		Ast_Value value{};
 		value.line_index = token.line_index;
 		if(token.type == Token_Type::Int_Literal) {
@@ -198,24 +206,17 @@ namespace logo {
 			value.type = Ast_Value_Type::Bool_Literal;
 			value.bool_value = token.bool_value;
 		}
-		else {
-			char* string_ptr = state->memory.construct_string(token.string.byte_length());
-			if(!string_ptr) {
-				Report_Error("Couldn't allocate % bytes of memory.",token.string.byte_length() + 1);
-				return {};
-			}
-			std::memcpy(string_ptr,token.string.begin_ptr,token.string.byte_length());
-
-			if(token.type == Token_Type::String_Literal) {
-				value.type = Ast_Value_Type::String_Literal;
-				value.string_value = String_View(string_ptr,token.string.byte_length());
-			}
-			else if(token.type == Token_Type::Identifier) {
-				value.type = Ast_Value_Type::Identifier;
-				value.identfier_name = String_View(string_ptr,token.string.byte_length());
-			}
-			else logo::unreachable();
+		else if(token.type == Token_Type::Identifier) {
+			value.type = Ast_Value_Type::Identifier;
+			value.identfier_name = token.symbol;
 		}
+		else if(token.type == Token_Type::String_Literal) {
+			auto [symbol,success] = logo::intern_symbol(token.string);
+			if(!success) return {};
+			value.type = Ast_Value_Type::String_Literal;
+			value.string_value = symbol;
+		}
+		else logo::unreachable();
 		return value;
 	}
 
@@ -376,8 +377,8 @@ namespace logo {
 				case Ast_Value_Type::Int_Literal: logo::report_parser_error("Invalid token after '%'.",root->value.int_value); return false;
 				case Ast_Value_Type::Float_Literal: logo::report_parser_error("Invalid token after '%''.",root->value.float_value); return false;
 				case Ast_Value_Type::Bool_Literal: logo::report_parser_error("Invalid token after '%'.",root->value.bool_value); return false;
-				case Ast_Value_Type::String_Literal: logo::report_parser_error("Invalid token after '%'.",root->value.string_value); return false;
-				case Ast_Value_Type::Identifier: logo::report_parser_error("Invalid token after '%'.",root->value.identfier_name); return false;
+				case Ast_Value_Type::String_Literal: logo::report_parser_error("Invalid token after '%'.",logo::get_symbol_name(root->value.string_value)); return false;
+				case Ast_Value_Type::Identifier: logo::report_parser_error("Invalid token after '%'.",logo::get_symbol_name(root->value.identfier_name)); return false;
 				default: {
 					logo::report_parser_error("Invalid token after ')'.");
 					return false;
@@ -386,12 +387,12 @@ namespace logo {
 		}
 	}
 
-	[[nodiscard]] static Option<Ast_Expression> parse_expression(Parsing_Result* state,bool inside_parenthesis,bool is_assignment_lvalue,bool is_for_lower_bound,bool inside_array_subscript);
+	[[nodiscard]] static Option<Ast_Expression> parse_expression(Parsing_Result* state,bool inside_parenthesis,bool is_assignment_lvalue,bool is_for_lower_bound,bool inside_array_subscript,bool inside_condition);
 
 	[[nodiscard]] static Option<Ast_Expression> parse_array_subscript(Parsing_Result* state,const Ast_Expression& left_expr,std::size_t line_index) {
 		if(logo::require_next_token(Token_Type::Left_Bracket,"Expected a '['.").status == Lexing_Status::Error) return {};
 
-		auto [subscript_expr,success] = logo::parse_expression(state,false,false,false,true);
+		auto [subscript_expr,success] = logo::parse_expression(state,false,false,false,true,false);
 		if(!success) return {};
 
 		if(logo::require_next_token(Token_Type::Right_Bracket,"Expected a ']'.").status == Lexing_Status::Error) return {};
@@ -421,7 +422,7 @@ namespace logo {
 		return array_subscript_ast;
 	}
 
-	[[nodiscard]] static Option<Ast_Expression> parse_expression(Parsing_Result* state,bool inside_parenthesis,bool is_assignment_lvalue,bool is_for_lower_bound,bool inside_array_subscript) {
+	[[nodiscard]] static Option<Ast_Expression> parse_expression(Parsing_Result* state,bool inside_parenthesis,bool is_assignment_lvalue,bool is_for_lower_bound,bool inside_array_subscript,bool inside_condition) {
 		Ast_Expression root_expr{};
 		Expression_State expr_state{};
 		while(true) {
@@ -433,7 +434,7 @@ namespace logo {
 			}
 			if(first_token.token->type == Token_Type::Semicolon || first_token.token->type == Token_Type::Comma || first_token.token->type == Token_Type::Right_Paren ||
 			   first_token.token->type == Token_Type::Left_Brace || logo::is_token_type_assignment(first_token.token->type) || first_token.token->type == Token_Type::Arrow ||
-			   first_token.token->type == Token_Type::Right_Bracket) {
+			   first_token.token->type == Token_Type::Right_Bracket || first_token.token->type == Token_Type::Keyword_Else) {
 				if(expr_state.complete) {
 					if(!inside_parenthesis && first_token.token->type == Token_Type::Right_Paren) {
 						logo::report_parser_error("Closed parenthesis that was never opened.");
@@ -451,6 +452,10 @@ namespace logo {
 						logo::report_parser_error("Unexpected token ']'.");
 						return {};
 					}
+					if(!inside_condition && first_token.token->type == Token_Type::Keyword_Else) {
+						logo::report_parser_error("Unexpected token 'else'.");
+						return {};
+					}
 					return root_expr;
 				}
 				String_View character = "";
@@ -461,6 +466,7 @@ namespace logo {
 					case Token_Type::Right_Bracket: character = "]"; break;
 					case Token_Type::Left_Brace: character = "{"; break;
 					case Token_Type::Arrow: character = "->"; break;
+					case Token_Type::Keyword_Else: character = "else"; break;
 					default: {
 						if(logo::is_token_type_assignment(first_token.token->type)) character = "=";
 						else logo::unreachable();
@@ -487,16 +493,7 @@ namespace logo {
 						Report_Error("Couldn't allocate % bytes of memory.",sizeof(Ast_Function_Call));
 						return {};
 					}
-					{
-						auto function_name_length = first_token.token->string.byte_length();
-						char* function_name_ptr = state->memory.construct_string(function_name_length);
-						if(!function_name_ptr) {
-							Report_Error("Couldn't allocate % bytes of memory.",function_name_length + 1);
-							return {};
-						}
-						std::memcpy(function_name_ptr,first_token.token->string.begin_ptr,function_name_length);
-						new_expr.function_call->name = String_View(function_name_ptr,function_name_length);
-					}
+					new_expr.function_call->name = first_token.token->symbol;
 
 					if(second_token.token->type == Token_Type::Left_Paren) {
 						second_token = logo::get_next_token();
@@ -532,7 +529,7 @@ namespace logo {
 						}
 
 						while(true) {
-							auto [arg_ast,success] = logo::parse_expression(state,true,false,false,false);
+							auto [arg_ast,success] = logo::parse_expression(state,true,false,false,false,false);
 							if(!success) return {};
 
 							Ast_Expression* arg_expr = state->memory.construct<Ast_Expression>();
@@ -591,7 +588,7 @@ namespace logo {
 						return {};
 					}
 					if(next_token.token->type == Token_Type::Left_Bracket) {
-						auto [subscripted_value,success0] = logo::create_ast_value(state,*first_token.token);
+						auto [subscripted_value,success0] = logo::create_ast_value(*first_token.token);
 						if(!success0) return {};
 						Ast_Expression left_expr{};
 						left_expr.type = Ast_Expression_Type::Value;
@@ -606,7 +603,7 @@ namespace logo {
 						continue;
 					}
 					else {
-						auto [value,has_value] = logo::create_ast_value(state,*first_token.token);
+						auto [value,has_value] = logo::create_ast_value(*first_token.token);
 						if(!has_value) return {};
 						if(!logo::insert_value_into_ast(state,&root_expr,value)) return {};
 						expr_state.complete = true;
@@ -635,7 +632,7 @@ namespace logo {
 					break;
 				}
 				case Token_Type::Left_Paren: {
-					auto [expr_ast,success] = logo::parse_expression(state,true,false,false,false);
+					auto [expr_ast,success] = logo::parse_expression(state,true,false,false,false,false);
 					if(!success) return {};
 					if(logo::require_next_token(Token_Type::Right_Paren,"Unmatched parenthesis.").status == Lexing_Status::Error) return {};
 					expr_ast.is_parenthesised = true;
@@ -658,6 +655,43 @@ namespace logo {
 					expr_state.complete = true;
 					continue;
 				}
+				case Token_Type::Keyword_If: {
+					//Everything to the left is the value if the condition is true and everything to the right of 'else' is the value if it's false.
+					if(!expr_state.complete) {
+						logo::report_parser_error("Unexpected token 'if'.");
+						return {};
+					}
+					Ast_Expression conditional_ast{};
+					conditional_ast.type = Ast_Expression_Type::Conditional;
+					conditional_ast.conditional = state->memory.construct<Ast_Conditional>();
+					if(!conditional_ast.conditional) {
+						Report_Error("Couldn't allocate % bytes of memory.",sizeof(Ast_Conditional));
+						return {};
+					}
+					conditional_ast.conditional->line_index = first_token.token->line_index;
+
+					auto [condition_expr,success0] = logo::parse_expression(state,inside_parenthesis,false,false,inside_array_subscript,true);
+					if(!success0) return {};
+					if(logo::require_next_token(Token_Type::Keyword_Else,"Expected 'else' after the condition of a conditional expression.").status == Lexing_Status::Error) return {};
+					auto [if_false_expr,success1] = logo::parse_expression(state,inside_parenthesis,is_assignment_lvalue,is_for_lower_bound,inside_array_subscript,inside_condition);
+					if(!success1) return {};
+
+					Ast_Expression* expressions[3] = {};
+					for(auto& expression : expressions) {
+						expression = state->memory.construct<Ast_Expression>();
+						if(!expression) {
+							Report_Error("Couldn't allocate % bytes of memory.",sizeof(Ast_Expression));
+							return {};
+						}
+					}
+					*expressions[0] = condition_expr;
+					*expressions[1] = root_expr;
+					*expressions[2] = if_false_expr;
+					conditional_ast.conditional->condition = expressions[0];
+					conditional_ast.conditional->if_true = expressions[1];
+					conditional_ast.conditional->if_false = expressions[2];
+					return conditional_ast;
+				}
 				default: {
 					logo::report_parser_error("Invalid token '%'.\n",first_token.token->string);
 					return {};
@@ -671,7 +705,7 @@ namespace logo {
 	[[nodiscard]] static Option<Ast_Assignment> parse_assignment(Parsing_Result* state) {
 		Ast_Assignment assignment_ast{};
 
-		auto [lvalue_expr,success0] = logo::parse_expression(state,false,true,false,false);
+		auto [lvalue_expr,success0] = logo::parse_expression(state,false,true,false,false,false);
 		if(!success0) return {};
 
 		auto assignment_token = logo::get_next_token();
@@ -688,7 +722,7 @@ namespace logo {
 		assignment_ast.line_index = assignment_token.token->line_index;
 		assignment_ast.lvalue_expr = lvalue_expr;
 
-		auto [value_expr,success1] = logo::parse_expression(state,false,false,false,false);
+		auto [value_expr,success1] = logo::parse_expression(state,false,false,false,false,false);
 		if(!success1) return {};
 		assignment_ast.rvalue_expr = value_expr;
 		return assignment_ast;
@@ -716,22 +750,13 @@ namespace logo {
 
 				auto identifier_token = logo::require_next_token(Token_Type::Identifier,"After 'let' keyword an identifier is expected.");
 				if(identifier_token.status == Lexing_Status::Error) return Parsing_Status::Error;
-				{
-					auto function_name_length = identifier_token.token->string.byte_length();
-					char* function_name_ptr = state->memory.construct_string(function_name_length);
-					if(!function_name_ptr) {
-						Report_Error("Couldn't allocate % bytes of memory.",function_name_length + 1);
-						return Parsing_Status::Error;
-					}
-					std::memcpy(function_name_ptr,identifier_token.token->string.begin_ptr,function_name_length);
-					statement_ast.declaration.name = String_View(function_name_ptr,function_name_length);
-				}
+				statement_ast.declaration.name = identifier_token.token->symbol;
 
 				if(logo::require_next_token(Token_Type::Equals_Sign,"Declaration of '%' without initial value is not allowed.",identifier_token.token->string).status == Lexing_Status::Error) {
 					return Parsing_Status::Error;
 				}
 
-				auto [init_ast,success] = logo::parse_expression(state,false,false,false,false);
+				auto [init_ast,success] = logo::parse_expression(state,false,false,false,false,false);
 				if(!success) return Parsing_Status::Error;
 				statement_ast.declaration.initial_value_expr = init_ast;
 				break;
@@ -743,7 +768,7 @@ namespace logo {
 				statement_ast.type = Ast_Statement_Type::If_Statement;
 				statement_ast.if_statement = {};
 
-				auto [init_ast,success] = logo::parse_expression(state,false,false,false,false);
+				auto [init_ast,success] = logo::parse_expression(state,false,false,false,false,false);
 				if(!success) return Parsing_Status::Error;
 				statement_ast.if_statement.condition_expr = init_ast;
 
@@ -807,7 +832,7 @@ namespace logo {
 				statement_ast.type = Ast_Statement_Type::While_Statement;
 				statement_ast.while_statement = {};
 
-				auto [init_ast,success] = logo::parse_expression(state,false,false,false,false);
+				auto [init_ast,success] = logo::parse_expression(state,false,false,false,false,false);
 				if(!success) return Parsing_Status::Error;
 				statement_ast.while_statement.condition_expr = init_ast;
 
@@ -827,31 +852,27 @@ namespace logo {
 				}
 				return statement_ast;
 			}
+			case Token_Type::Keyword_Parallel:
 			case Token_Type::Keyword_For: {
 				first_token = logo::get_next_token();
 
 				statement_ast.line_index = first_token.token->line_index;
 				statement_ast.type = Ast_Statement_Type::For_Statement;
 				statement_ast.for_statement = {};
+				if(first_token.token->type == Token_Type::Keyword_Parallel) {
+					if(logo::require_next_token(Token_Type::Keyword_For,"Expected 'for' after 'parallel'.").status == Lexing_Status::Error) return Parsing_Status::Error;
+					statement_ast.for_statement.is_parallel = true;
+				}
 
 				auto iternator_name_token = logo::require_next_token(Token_Type::Identifier,"Expected an identifier after 'for'.");
 				if(iternator_name_token.status == Lexing_Status::Out_Of_Tokens) return Parsing_Status::Error;
-				{
-					auto function_name_length = iternator_name_token.token->string.byte_length();
-					char* function_name_ptr = state->memory.construct_string(function_name_length);
-					if(!function_name_ptr) {
-						Report_Error("Couldn't allocate % bytes of memory.",function_name_length + 1);
-						return Parsing_Status::Error;
-					}
-					std::memcpy(function_name_ptr,iternator_name_token.token->string.begin_ptr,function_name_length);
-					statement_ast.for_statement.iterator_identifier = String_View(function_name_ptr,function_name_length);
-				}
+				statement_ast.for_statement.iterator_identifier = iternator_name_token.token->symbol;
 
 				if(logo::require_next_token(Token_Type::Colon,"Expected a colon after '%'.",iternator_name_token.token->string).status == Lexing_Status::Out_Of_Tokens) {
 					return Parsing_Status::Error;
 				}
 
-				auto [lower_bound_expr,success0] = logo::parse_expression(state,false,false,true,false);
+				auto [lower_bound_expr,success0] = logo::parse_expression(state,false,false,true,false,false);
 				if(!success0) return Parsing_Status::Error;
 				statement_ast.for_statement.start_expr = lower_bound_expr;
 
@@ -859,7 +880,7 @@ namespace logo {
 					return Parsing_Status::Error;
 				}
 
-				auto [upper_bound_expr,success1] = logo::parse_expression(state,false,false,false,false);
+				auto [upper_bound_expr,success1] = logo::parse_expression(state,false,false,false,false,false);
 				if(!success1) return Parsing_Status::Error;
 				statement_ast.for_statement.end_expr = upper_bound_expr;
 
@@ -888,16 +909,7 @@ namespace logo {
 
 				auto identifier_token = logo::require_next_token(Token_Type::Identifier,"Expected an identifier after 'func'.");
 				if(identifier_token.status == Lexing_Status::Error) return Parsing_Status::Error;
-				{
-					auto function_name_length = identifier_token.token->string.byte_length();
-					char* function_name_ptr = state->memory.construct_string(function_name_length);
-					if(!function_name_ptr) {
-						Report_Error("Couldn't allocate % bytes of memory.",function_name_length + 1);
-						return Parsing_Status::Error;
-					}
-					std::memcpy(function_name_ptr,identifier_token.token->string.begin_ptr,function_name_length);
-					statement_ast.function_definition.name = String_View(function_name_ptr,function_name_length);
-				}
+				statement_ast.function_definition.name = identifier_token.token->symbol;
 
 				if(logo::require_next_token(Token_Type::Left_Paren,"Expected a token '('.").status == Lexing_Status::Error) return Parsing_Status::Error;
 
@@ -924,17 +936,7 @@ namespace logo {
 							return Parsing_Status::Error;
 						}
 
-						String_View argument{};
-						{
-							auto function_name_length = next_token.token->string.byte_length();
-							char* function_name_ptr = state->memory.construct_string(function_name_length);
-							if(!function_name_ptr) {
-								Report_Error("Couldn't allocate % bytes of memory.",function_name_length + 1);
-								return Parsing_Status::Error;
-							}
-							std::memcpy(function_name_ptr,next_token.token->string.begin_ptr,function_name_length);
-							argument = String_View(function_name_ptr,function_name_length);
-						}
+						Symbol argument = next_token.token->symbol;
 						if(!statement_ast.function_definition.function_arguments.push_back(argument)) {
 							Report_Error("Couldn't allocate % bytes of memory.",sizeof(argument));
 							return Parsing_Status::Error;
@@ -1027,7 +1029,7 @@ namespace logo {
 				}
 
 				if(next_token.token->type != Token_Type::Semicolon) {
-					auto [return_expr,success] = logo::parse_expression(state,false,false,false,false);
+					auto [return_expr,success] = logo::parse_expression(state,false,false,false,false,false);
 					if(!success) return Parsing_Status::Error;
 
 					statement_ast.return_statement.return_value = state->memory.construct<Ast_Expression>();
@@ -1059,7 +1061,7 @@ namespace logo {
 					}
 					if(next_token.token->type == Token_Type::Semicolon) {
 						statement_ast.type = Ast_Statement_Type::Expression;
-						auto [expr_ast,success] = logo::parse_expression(state,false,false,false,false);
+						auto [expr_ast,success] = logo::parse_expression(state,false,false,false,false,false);
 						if(!success) return Parsing_Status::Error;
 						statement_ast.expression = expr_ast;
 						break;
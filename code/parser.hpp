@@ -6,11 +6,13 @@
 #include "heap_array.hpp"
 #include "array_view.hpp"
 #include "memory_arena.hpp"
+#include "symbol_table.hpp"
 
 namespace logo {
 	struct Ast_Binary_Operator;
 	struct Ast_Unary_Prefix_Operator;
 	struct Ast_Function_Call;
+	struct Ast_Conditional;
 	struct Ast_Statement;
 	struct Ast_Expression;
 
@@ -26,13 +28,19 @@ namespace logo {
 		Ast_Value_Type type;
 		std::size_t line_index;
 		union {
-			String_View identfier_name;
-			String_View string_value;
+			Symbol identfier_name;
+			Symbol string_value; //String literals are interned in the symbol table.
 			std::int64_t int_value;
 			double float_value;
 			bool bool_value;
 		};
-		Ast_Value() : type(),line_index(),identfier_name() {}
+		//These are filled in by the resolver for identifiers. 'depth' is the number of function scopes between the place of use and the variable,
+		//'slot' is the index of the variable counted from the first variable of the current function scope if 'depth' is 0.
+		//Parent scope accesses to variables outside of the current function have a 'depth' of 1. Their 'slot' is the index of the only top level variable
+		//they can refer to plus 1, which is checked at runtime in case the variable doesn't exist yet, or 0 if they are looked up by name.
+		std::uint32_t depth;
+		std::uint32_t slot;
+		Ast_Value() : type(),line_index(),identfier_name(),depth(),slot() {}
 	};
 
 	struct Ast_Array_Access {
@@ -47,19 +55,22 @@ namespace logo {
 		Binary_Operator,
 		Unary_Prefix_Operator,
 		Function_Call,
-		Array_Access
+		Array_Access,
+		Conditional
 	};
 	struct Ast_Expression {
 		Ast_Expression_Type type;
 		bool is_parenthesised;
+		bool contains_function_call; //This is filled in by the interpreter. Expressions without calls are computed without touching its call stack.
 		union {
 			Ast_Value value;
 			Ast_Binary_Operator* binary_operator;
 			Ast_Unary_Prefix_Operator* unary_prefix_operator;
 			Ast_Function_Call* function_call;
 			Ast_Array_Access* array_access;
+			Ast_Conditional* conditional;
 		};
-		Ast_Expression() : type(),is_parenthesised(),value() {}
+		Ast_Expression() : type(),is_parenthesised(),contains_function_call(),value() {}
 	};
 
 	enum struct Ast_Binary_Operator_Type {
@@ -78,11 +89,48 @@ namespace logo {
 		Compare_Greater_Than,
 		Compare_Greater_Than_Or_Equal
 	};
+	//This is only used by the interpreter. After an arithmetic or comparison operation has been executed with two ints or two floats,
+	//it's specialized for that pair of types and the next executions only check if the operands still have those types.
+	//If they don't, the operation goes back to the generic version (it's deoptimized).
+	enum struct Ast_Operation_Specialization : std::uint8_t {
+		None,
+		Int_Plus,
+		Int_Minus,
+		Int_Multiply,
+		Int_Divide,
+		Int_Remainder,
+		Int_Compare_Equal,
+		Int_Compare_Unequal,
+		Int_Compare_Less_Than,
+		Int_Compare_Less_Than_Or_Equal,
+		Int_Compare_Greater_Than,
+		Int_Compare_Greater_Than_Or_Equal,
+		Float_Plus,
+		Float_Minus,
+		Float_Multiply,
+		Float_Divide,
+		Float_Remainder,
+		Float_Compare_Equal,
+		Float_Compare_Unequal,
+		Float_Compare_Less_Than,
+		Float_Compare_Less_Than_Or_Equal,
+		Float_Compare_Greater_Than,
+		Float_Compare_Greater_Than_Or_Equal,
+		Bool_Logical_And,
+		Bool_Logical_Or
+	};
+	static constexpr std::uint8_t MAX_DEOPTIMIZATION_COUNT = 4; //Operations that were deoptimized this many times stay generic.
+	struct Ast_Operation_Cache {
+		Ast_Operation_Specialization specialization;
+		std::uint8_t deoptimization_count;
+		bool is_proven; //Set by the type inference pass if the operands always have the types of the specialization, so they are never checked.
+	};
 	struct Ast_Binary_Operator {
 		Ast_Binary_Operator_Type type;
 		Ast_Expression* left;
 		Ast_Expression* right;
 		std::size_t line_index;
+		Ast_Operation_Cache cache;
 	};
 
 	enum struct Ast_Unary_Prefix_Operator_Type {
@@ -97,12 +145,36 @@ namespace logo {
 		Ast_Unary_Prefix_Operator_Type type;
 		Ast_Expression* child;
 		std::size_t line_index;
+		bool is_reference_proven; //Set by the resolver for dereferences of a reference that can't be dangling, which aren't checked at runtime.
+	};
+
+	//'if_true if condition else if_false'. Only the branch selected by the condition is computed.
+	struct Ast_Conditional {
+		Ast_Expression* condition;
+		Ast_Expression* if_true;
+		Ast_Expression* if_false;
+		std::size_t line_index;
 	};
 
+	enum struct Ast_Function_Call_Target {
+		None,
+		Builtin_Function,
+		Function
+	};
+	//This is only used by the interpreter to skip the function lookup and the argument type checks when the same call is executed again.
+	struct Ast_Function_Call_Cache {
+		Ast_Function_Call_Target target;
+		std::size_t target_index;
+		std::uint64_t argument_signature; //Types of the arguments that were last accepted by a builtin function.
+		bool are_argument_types_proven; //Set by the type inference pass if the call always goes to a builtin function that accepts the types of the arguments.
+		bool is_name_in_scope; //Set by the resolver if a user defined function with the called name is visible from the call, whatever its number of arguments.
+	};
 	struct Ast_Function_Call {
-		String_View name;
+		Symbol name;
 		Heap_Array<Ast_Expression*> arguments;
 		std::size_t line_index;
+		std::size_t function_index; //Filled in by the resolver. Index of the user defined function the call is bound to plus 1 or 0 if there is none in scope.
+		Ast_Function_Call_Cache cache;
 	};
 
 	enum struct Ast_Assignment_Type {
@@ -119,11 +191,13 @@ namespace logo {
 		Ast_Expression lvalue_expr;
 		Ast_Expression rvalue_expr;
 		std::size_t line_index;
+		mutable Ast_Operation_Cache cache; //Only used by compound assignments. It's mutable because the interpreter walks the statements through const views.
 	};
 
 	struct Ast_Declaration {
-		String_View name;
+		Symbol name;
 		Ast_Expression initial_value_expr;
+		bool is_modified; //This is filled in by the optimizer, true if the variable can be assigned to or referenced after its declaration.
 	};
 
 	struct Ast_If_Statement {
@@ -135,23 +209,47 @@ namespace logo {
 	struct Ast_While_Statement {
 		Ast_Expression condition_expr;
 		Heap_Array<Ast_Statement> body_statements;
+		bool skip_scope; //This is set by the optimizer if the body doesn't declare anything, so the variables don't have to be restored after every iteration.
+	};
+
+	//Induction variables are created by the optimizer to replace multiplications of the loop iterator by a loop invariant integer.
+	//They are declared right after the iterator, start at 'iterator * step' and are increased by 'step' together with the iterator.
+	static constexpr std::size_t MAX_INDUCTION_VARIABLE_COUNT = 8;
+	struct Ast_Induction_Variable {
+		Symbol name;
+		Ast_Expression step_expr; //This is evaluated once before the first iteration.
 	};
 
 	struct Ast_For_Statement {
-		String_View iterator_identifier;
+		Symbol iterator_identifier;
 		Ast_Expression start_expr;
 		Ast_Expression end_expr;
 		Heap_Array<Ast_Statement> body_statements;
+		Heap_Array<Ast_Induction_Variable> induction_variables;
+		bool is_iterator_modified; //This is filled in by the optimizer, true if the iterator can be assigned to or referenced in the body.
+		bool skip_scope; //Same as in 'Ast_While_Statement'.
+		bool is_parallel; //'parallel for', the iterations can run at the same time on many threads.
 	};
 
 	struct Ast_Function_Definition {
-		String_View name;
-		Heap_Array<String_View> function_arguments;
+		Symbol name;
+		Heap_Array<Symbol> function_arguments;
 		Heap_Array<Ast_Statement> body_statements;
+		std::size_t function_index; //Filled in by the resolver. Every definition in the program gets its own index.
+		//These are filled in by the resolver. 'parent_function_index' is the index of the function whose body contains the definition plus 1 or 0 at the top level.
+		//'defines_dynamic_functions' is true if a function defined in the body can be called from outside of its scope, see 'find_call_target'.
+		std::size_t parent_function_index;
+		bool defines_dynamic_functions;
+		bool is_memoized; //Set by the optimizer for pure recursive functions, their results are cached at runtime.
 	};
 
 	struct Ast_Return_Statement {
 		Ast_Expression* return_value;
+		//These are filled in by the resolver. 'is_tail_call' is true if the statement returns the result of a function call from inside of a function,
+		//in which case the call is made after the current function exits. 'can_reuse_frame' is true if the variables of the current function
+		//can be removed before the call because nothing can refer to them.
+		bool is_tail_call;
+		bool can_reuse_frame;
 	};
 
 	enum struct Ast_Statement_Type {
@@ -188,6 +286,8 @@ namespace logo {
 		void destroy();
 	};
 	[[nodiscard]] Option<Parsing_Result> parse_input(Array_View<char> input);
+	void destroy_expression(Ast_Expression* expression);
+	void destroy_statement(Ast_Statement* statement);
 }
 
 #endif
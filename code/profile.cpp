@@ -0,0 +1,289 @@
+#include <cstdio>
+#include <cstring>
+#include "debug.hpp"
+#include "profile.hpp"
+#include "interpreter.hpp"
+
+namespace logo {
+	static constexpr std::uint8_t PROFILE_MAGIC_BYTES[] = {'L','G','P','F'};
+	static constexpr std::uint32_t PROFILE_VERSION = 1;
+
+	//Operation of the AST and the specializations it can get for two ints, two floats and two bools.
+	struct Profile_Site {
+		Ast_Operation_Cache* cache;
+		Ast_Operation_Specialization specializations[3];
+	};
+
+	[[nodiscard]] static bool add_profile_site(Heap_Array<Profile_Site>* sites,Ast_Operation_Cache* cache,auto specialize) {
+		Profile_Site site{};
+		site.cache = cache;
+		site.specializations[0] = specialize(Interpreter_Value_Type::Int);
+		site.specializations[1] = specialize(Interpreter_Value_Type::Float);
+		site.specializations[2] = specialize(Interpreter_Value_Type::Bool);
+		if(!sites->push_back(site)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(site));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool collect_profile_sites(Heap_Array<Profile_Site>* sites,Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: return logo::collect_profile_sites(sites,expression->unary_prefix_operator->child);
+			case Ast_Expression_Type::Binary_Operator: {
+				auto* binary_operator = expression->binary_operator;
+				auto specialize = [&](Interpreter_Value_Type type) { return logo::specialize_binary_operation(binary_operator->type,type,type); };
+				if(!logo::add_profile_site(sites,&binary_operator->cache,specialize)) return false;
+				return logo::collect_profile_sites(sites,binary_operator->left) && logo::collect_profile_sites(sites,binary_operator->right);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				for(auto* arg_expr : expression->function_call->arguments) {
+					if(!logo::collect_profile_sites(sites,arg_expr)) return false;
+				}
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: {
+				return logo::collect_profile_sites(sites,expression->array_access->left) && logo::collect_profile_sites(sites,expression->array_access->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				auto* conditional = expression->conditional;
+				return logo::collect_profile_sites(sites,conditional->condition) && logo::collect_profile_sites(sites,conditional->if_true) &&
+					   logo::collect_profile_sites(sites,conditional->if_false);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool collect_profile_sites(Heap_Array<Profile_Site>* sites,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					if(!logo::collect_profile_sites(sites,&statement.expression)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					if(!logo::collect_profile_sites(sites,&statement.declaration.initial_value_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					auto& assignment = statement.assignment;
+					if(assignment.type != Ast_Assignment_Type::Assignment) {
+						auto specialize = [&](Interpreter_Value_Type type) { return logo::specialize_compound_assignment(assignment.type,type,type); };
+						if(!logo::add_profile_site(sites,&assignment.cache,specialize)) return false;
+					}
+					if(!logo::collect_profile_sites(sites,&assignment.lvalue_expr)) return false;
+					if(!logo::collect_profile_sites(sites,&assignment.rvalue_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					if(!logo::collect_profile_sites(sites,&statement.if_statement.condition_expr)) return false;
+					if(!logo::collect_profile_sites(sites,&statement.if_statement.if_true_statements)) return false;
+					if(!logo::collect_profile_sites(sites,&statement.if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::collect_profile_sites(sites,&statement.while_statement.condition_expr)) return false;
+					if(!logo::collect_profile_sites(sites,&statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					auto& for_statement = statement.for_statement;
+					if(!logo::collect_profile_sites(sites,&for_statement.start_expr)) return false;
+					if(!logo::collect_profile_sites(sites,&for_statement.end_expr)) return false;
+					for(auto& induction_variable : for_statement.induction_variables) {
+						if(!logo::collect_profile_sites(sites,&induction_variable.step_expr)) return false;
+					}
+					if(!logo::collect_profile_sites(sites,&for_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Break_Statement: break;
+				case Ast_Statement_Type::Continue_Statement: break;
+				case Ast_Statement_Type::Function_Definition: {
+					if(!logo::collect_profile_sites(sites,&statement.function_definition.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(statement.return_statement.return_value && !logo::collect_profile_sites(sites,statement.return_statement.return_value)) return false;
+					break;
+				}
+				default: logo::unreachable();
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool is_valid_specialization(const Profile_Site& site,Ast_Operation_Specialization specialization) {
+		if(specialization == Ast_Operation_Specialization::None) return true;
+		for(auto site_specialization : site.specializations) {
+			if(site_specialization == specialization) return true;
+		}
+		return false;
+	}
+
+	//The profile is stored next to the script as 'script_path.profile'.
+	[[nodiscard]] static Option<Heap_Array<char>> make_profile_path(String_View script_path) {
+		static constexpr char Extension[] = ".profile";
+		Heap_Array<char> path{};
+		if(!path.push_back(Array_View<char>(script_path.begin_ptr,script_path.byte_length())) || !path.push_back(Array_View<char>(Extension,sizeof(Extension)))) {
+			path.destroy();
+			Report_Error("Couldn't allocate % bytes of memory.",script_path.byte_length() + sizeof(Extension));
+			return {};
+		}
+		return path;
+	}
+
+	std::uint64_t make_type_profile_key(Array_View<char> script_bytes,bool use_bytecode_vm,bool optimize,bool infer_types) {
+		//FNV-1a
+		std::uint64_t key = 14695981039346656037ull;
+		for(auto byte : script_bytes) {
+			key ^= static_cast<std::uint8_t>(byte);
+			key *= 1099511628211ull;
+		}
+		key ^= static_cast<std::uint64_t>(use_bytecode_vm) | (static_cast<std::uint64_t>(optimize) << 1) | (static_cast<std::uint64_t>(infer_types) << 2);
+		key *= 1099511628211ull;
+		return key;
+	}
+
+	Option<Type_Profile> load_type_profile(String_View script_path,std::uint64_t key) {
+		Type_Profile profile{};
+		profile.key = key;
+
+		auto [path,path_made] = logo::make_profile_path(script_path);
+		if(!path_made) return {};
+		defer[&]{path.destroy();};
+
+		//A missing profile isn't an error, the script just hasn't been profiled yet.
+		std::FILE* file = std::fopen(path.data,"rb");
+		if(!file) return profile;
+		defer[&]{std::fclose(file);};
+
+		if(std::fseek(file,0,SEEK_END) != 0) return profile;
+		long file_size = std::ftell(file);
+		if(file_size < 0 || std::fseek(file,0,SEEK_SET) != 0) return profile;
+
+		auto file_read = [&]<typename T>(T* value) {
+			return std::fread(value,sizeof(char),sizeof(T),file) == sizeof(T);
+		};
+		std::uint8_t magic_bytes[sizeof(PROFILE_MAGIC_BYTES)]{};
+		std::uint32_t version = 0;
+		std::uint64_t file_key = 0;
+		std::uint64_t operation_count = 0;
+		std::uint64_t instruction_count = 0;
+		std::uint64_t function_count = 0;
+		if(!file_read(&magic_bytes) || std::memcmp(magic_bytes,PROFILE_MAGIC_BYTES,sizeof(magic_bytes)) != 0) return profile;
+		if(!file_read(&version) || version != PROFILE_VERSION) return profile;
+		if(!file_read(&file_key) || file_key != key) return profile;
+		if(!file_read(&operation_count) || !file_read(&instruction_count) || !file_read(&function_count)) return profile;
+		//Every entry takes up at least 2 bytes, so the counts of a damaged file are rejected before anything is allocated.
+		auto max_count = static_cast<std::uint64_t>(file_size) / 2;
+		if(operation_count > max_count || instruction_count > max_count || function_count > max_count) return profile;
+
+		bool successful_return = false;
+		defer[&]{ if(!successful_return) profile.destroy(); };
+		if(!profile.operations.resize(static_cast<std::size_t>(operation_count)) || !profile.instructions.resize(static_cast<std::size_t>(instruction_count)) ||
+		   !profile.call_counts.resize(static_cast<std::size_t>(function_count))) {
+			Report_Error("Couldn't allocate % bytes of memory.",static_cast<std::size_t>(operation_count * sizeof(Profile_Operation) + instruction_count * sizeof(Profile_Instruction) + function_count * sizeof(std::size_t)));
+			return {};
+		}
+
+		auto is_damaged = [&] {
+			for(auto& operation : profile.operations) {
+				std::uint8_t specialization = 0;
+				if(!file_read(&specialization) || !file_read(&operation.deoptimization_count)) return true;
+				if(specialization > static_cast<std::uint8_t>(Ast_Operation_Specialization::Bool_Logical_Or)) return true;
+				operation.specialization = static_cast<Ast_Operation_Specialization>(specialization);
+			}
+			for(auto& instruction : profile.instructions) {
+				if(!file_read(&instruction.compiled_opcode) || !file_read(&instruction.opcode) || !file_read(&instruction.deoptimization_count)) return true;
+			}
+			for(auto& call_count : profile.call_counts) {
+				std::uint64_t count = 0;
+				if(!file_read(&count)) return true;
+				call_count = static_cast<std::size_t>(count);
+			}
+			return false;
+		};
+		if(is_damaged()) {
+			profile.operations.destroy();
+			profile.instructions.destroy();
+			profile.call_counts.destroy();
+		}
+		else logo::print("Loaded type profile \"%\".\n",String_View(path.data));
+		successful_return = true;
+		return profile;
+	}
+
+	bool save_type_profile(String_View script_path,const Type_Profile& profile) {
+		auto [path,path_made] = logo::make_profile_path(script_path);
+		if(!path_made) return false;
+		defer[&]{path.destroy();};
+		logo::print("Saving type profile as \"%\".\n",String_View(path.data));
+
+		std::FILE* file = std::fopen(path.data,"wb");
+		if(!file) {
+			Report_Error("Couldn't open file \"%\".",String_View(path.data));
+			return false;
+		}
+		defer[&]{std::fclose(file);};
+
+		auto file_write = [&]<typename T>(const T& value) {
+			if(std::fwrite(&value,sizeof(char),sizeof(T),file) < sizeof(T)) {
+				Report_Error("Couldn't write % bytes to file \"%\".",sizeof(T),String_View(path.data));
+				return false;
+			}
+			return true;
+		};
+		if(!file_write(PROFILE_MAGIC_BYTES)) return false;
+		if(!file_write(PROFILE_VERSION)) return false;
+		if(!file_write(profile.key)) return false;
+		if(!file_write(static_cast<std::uint64_t>(profile.operations.length))) return false;
+		if(!file_write(static_cast<std::uint64_t>(profile.instructions.length))) return false;
+		if(!file_write(static_cast<std::uint64_t>(profile.call_counts.length))) return false;
+		for(const auto& operation : profile.operations) {
+			if(!file_write(static_cast<std::uint8_t>(operation.specialization))) return false;
+			if(!file_write(operation.deoptimization_count)) return false;
+		}
+		for(const auto& instruction : profile.instructions) {
+			if(!file_write(instruction.compiled_opcode)) return false;
+			if(!file_write(instruction.opcode)) return false;
+			if(!file_write(instruction.deoptimization_count)) return false;
+		}
+		for(auto call_count : profile.call_counts) {
+			if(!file_write(static_cast<std::uint64_t>(call_count))) return false;
+		}
+		return true;
+	}
+
+	bool apply_operation_profile(Heap_Array<Ast_Statement>* statements,const Type_Profile& profile) {
+		if(profile.operations.length == 0) return true;
+		Heap_Array<Profile_Site> sites{};
+		defer[&]{sites.destroy();};
+		if(!logo::collect_profile_sites(&sites,statements)) return false;
+		if(sites.length != profile.operations.length) return true;
+		for(std::size_t i = 0;i < sites.length;i += 1) {
+			auto* cache = sites[i].cache;
+			const auto& operation = profile.operations[i];
+			if(cache->is_proven || !logo::is_valid_specialization(sites[i],operation.specialization)) continue;
+			cache->specialization = operation.specialization;
+			cache->deoptimization_count = operation.deoptimization_count;
+		}
+		return true;
+	}
+
+	bool record_operation_profile(Heap_Array<Ast_Statement>* statements,Type_Profile* profile) {
+		Heap_Array<Profile_Site> sites{};
+		defer[&]{sites.destroy();};
+		if(!logo::collect_profile_sites(&sites,statements)) return false;
+		profile->operations.destroy();
+		if(!profile->operations.resize(sites.length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sites.length * sizeof(Profile_Operation));
+			return false;
+		}
+		for(std::size_t i = 0;i < sites.length;i += 1) {
+			profile->operations[i].specialization = sites[i].cache->specialization;
+			profile->operations[i].deoptimization_count = sites[i].cache->deoptimization_count;
+		}
+		return true;
+	}
+}
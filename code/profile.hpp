@@ -0,0 +1,46 @@
+#ifndef LOGO_PROFILE_HPP
+#define LOGO_PROFILE_HPP
+
+#include <cstdint>
+#include "utils.hpp"
+#include "string.hpp"
+#include "parser.hpp"
+#include "bytecode.hpp"
+#include "heap_array.hpp"
+#include "array_view.hpp"
+
+namespace logo {
+	struct Profile_Operation {
+		Ast_Operation_Specialization specialization;
+		std::uint8_t deoptimization_count;
+	};
+	struct Profile_Instruction {
+		Bytecode_Opcode compiled_opcode; //Opcode emitted by the bytecode compiler, the other fields are used only if it's still the same.
+		Bytecode_Opcode opcode; //Opcode the instruction was quickened to.
+		std::uint8_t deoptimization_count;
+	};
+	//Type feedback gathered while running a script. It's saved next to the script, so that the next run starts with the operations specialized,
+	//the instructions quickened and the hot functions compiled by the JIT instead of learning all of that again.
+	struct Type_Profile {
+		std::uint64_t key; //Hash of the script and the options that change the AST or the bytecode, a profile with another key is ignored.
+		Heap_Array<Profile_Operation> operations; //Every binary operator and compound assignment in the order they appear in the AST. Only used by the tree-walking interpreter.
+		Heap_Array<Profile_Instruction> instructions; //Every instruction of the bytecode program. Only used by the bytecode VM.
+		Heap_Array<std::size_t> call_counts; //'Interpreter_Function::call_count' of every user defined function at its function index.
+		void destroy() {
+			call_counts.destroy();
+			instructions.destroy();
+			operations.destroy();
+		}
+	};
+
+	[[nodiscard]] std::uint64_t make_type_profile_key(Array_View<char> script_bytes,bool use_bytecode_vm,bool optimize,bool infer_types);
+	//Reads the profile saved for the script at 'script_path'. Returns an empty profile with the given key if there is none or if it was saved for another version of the script.
+	[[nodiscard]] Option<Type_Profile> load_type_profile(String_View script_path,std::uint64_t key);
+	[[nodiscard]] bool save_type_profile(String_View script_path,const Type_Profile& profile);
+	//Specializes the operations of the AST that the type inference pass didn't prove the way they were specialized in the profiled run.
+	//The specialized operations still check the operand types, so a profile that doesn't match the script only makes it slower.
+	[[nodiscard]] bool apply_operation_profile(Heap_Array<Ast_Statement>* statements,const Type_Profile& profile);
+	[[nodiscard]] bool record_operation_profile(Heap_Array<Ast_Statement>* statements,Type_Profile* profile);
+}
+
+#endif
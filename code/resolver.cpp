@@ -0,0 +1,486 @@
+#include <limits>
+#include "debug.hpp"
+#include "resolver.hpp"
+#include "interpreter.hpp"
+
+namespace logo {
+	//There is one for every function definition, at the index assigned to the definition.
+	struct Resolver_Function {
+		Ast_Function_Definition* definition;
+		Heap_Array<Symbol> variable_names; //Names of all arguments and variables declared in the function.
+		//True for the arguments that always hold a live reference, see 'find_proven_arguments'.
+		Heap_Array<bool> proven_arguments;
+		bool references_variables; //True if the function makes a reference to one of its own variables.
+	};
+	struct Resolver_Call {
+		Ast_Function_Call* function_call; //Only calls bound to a user defined function are kept.
+		std::size_t caller_function_index; //Same as 'Resolver_State::current_function_index' at the call.
+	};
+	struct Resolver_Dereference {
+		Ast_Unary_Prefix_Operator* unary_operator;
+		std::size_t function_index;
+		std::size_t argument_index;
+	};
+	struct Resolver_Top_Level_Variable {
+		Symbol name;
+		std::size_t slot;
+	};
+	struct Resolver_Tail_Call {
+		Ast_Return_Statement* return_statement;
+		std::size_t function_index;
+	};
+	//Mirrors the variable stack of the interpreter. Names are pushed in the same order the interpreter pushes variables at runtime.
+	struct Resolver_State {
+		Heap_Array<Symbol> variables;
+		std::size_t current_function_scope_first_var_index;
+		Heap_Array<Resolver_Function> functions;
+		std::size_t current_function_index; //Index into 'functions' plus 1 or 0 outside of functions.
+		Heap_Array<Resolver_Tail_Call> tail_calls;
+		Heap_Array<Symbol> dynamically_accessed_names; //Names used with the 'parent scope access' operator that are looked up at runtime.
+		Heap_Array<Ast_Value*> parent_scope_accesses; //Identifiers of the parent scope accesses to variables outside of the current function.
+		Heap_Array<Resolver_Top_Level_Variable> top_level_variables; //Every variable declared outside of functions.
+		Heap_Array<Resolver_Call> calls;
+		Heap_Array<const Ast_Function_Call*> unbound_calls; //Calls with no user defined function of their signature in scope.
+		Heap_Array<Resolver_Dereference> argument_dereferences; //Dereferences of arguments of the current function.
+		Heap_Array<Ast_Function_Definition*> visible_functions; //Functions defined in the enclosing scopes, outermost first.
+		//The iterations of a parallel loop can't leave it, so 'return' can't be used anywhere in its body and 'break' can't be used for it.
+		bool is_inside_parallel_loop;
+		bool is_innermost_loop_parallel;
+	};
+
+	[[nodiscard]] static bool push_symbol(Heap_Array<Symbol>* symbols,Symbol symbol) {
+		for(auto other_symbol : *symbols) {
+			if(other_symbol == symbol) return true;
+		}
+		if(!symbols->push_back(symbol)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(symbol));
+			return false;
+		}
+		return true;
+	}
+
+	template<typename... Args>
+	static void report_resolver_error(std::size_t line_index,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
+		logo::format_into(logo::write_char32_t_to_error_message,"[Semantic error] Line %: ",line_index);
+		logo::format_into(logo::write_char32_t_to_error_message,format,std::forward<Args>(args)...);
+		logo::write_char32_t_to_error_message('\n');
+	}
+
+	[[nodiscard]] static bool push_variable_name(Resolver_State* state,Symbol name,std::size_t line_index) {
+		if((state->variables.length - state->current_function_scope_first_var_index) >= std::numeric_limits<std::uint32_t>::max()) {
+			logo::report_resolver_error(line_index,"Too many variables in one function.");
+			return false;
+		}
+		if(state->current_function_index == 0) {
+			Resolver_Top_Level_Variable variable{};
+			variable.name = name;
+			variable.slot = state->variables.length;
+			if(!state->top_level_variables.push_back(variable)) {
+				Report_Error("Couldn't allocate % bytes of memory.",sizeof(variable));
+				return false;
+			}
+		}
+		if(!state->variables.push_back(name)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(name));
+			return false;
+		}
+		if(state->current_function_index == 0) return true;
+		return logo::push_symbol(&state->functions[state->current_function_index - 1].variable_names,name);
+	}
+
+	//Called for expressions that are assigned to or referenced. The arguments of the current function they can name can't be proven to hold a live reference.
+	static void mark_assigned_arguments(Resolver_State* state,const Ast_Expression& expression) {
+		if(state->current_function_index == 0) return;
+		if(expression.type == Ast_Expression_Type::Conditional) {
+			logo::mark_assigned_arguments(state,*expression.conditional->if_true);
+			logo::mark_assigned_arguments(state,*expression.conditional->if_false);
+			return;
+		}
+		const auto* identifier = &expression;
+		if(identifier->type == Ast_Expression_Type::Unary_Prefix_Operator && identifier->unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+			identifier = identifier->unary_prefix_operator->child;
+		}
+		if(identifier->type != Ast_Expression_Type::Value || identifier->value.type != Ast_Value_Type::Identifier || identifier->value.depth != 0) return;
+		auto& proven_arguments = state->functions[state->current_function_index - 1].proven_arguments;
+		if(identifier->value.slot < proven_arguments.length) proven_arguments[identifier->value.slot] = false;
+	}
+
+	[[nodiscard]] static bool push_argument_dereference(Resolver_State* state,Ast_Unary_Prefix_Operator* unary_operator) {
+		unary_operator->is_reference_proven = false;
+		const auto* child = unary_operator->child;
+		if(state->current_function_index == 0 || child->type != Ast_Expression_Type::Value || child->value.type != Ast_Value_Type::Identifier || child->value.depth != 0) return true;
+		if(child->value.slot >= state->functions[state->current_function_index - 1].proven_arguments.length) return true;
+		Resolver_Dereference dereference{};
+		dereference.unary_operator = unary_operator;
+		dereference.function_index = state->current_function_index - 1;
+		dereference.argument_index = child->value.slot;
+		if(!state->argument_dereferences.push_back(dereference)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(dereference));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool resolve_expression(Resolver_State* state,Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value: {
+				auto& value = expression->value;
+				if(value.type != Ast_Value_Type::Identifier) return true;
+				for(std::size_t i = state->current_function_scope_first_var_index;i < state->variables.length;i += 1) {
+					if(state->variables[i] == value.identfier_name) {
+						value.depth = 0;
+						value.slot = static_cast<std::uint32_t>(i - state->current_function_scope_first_var_index);
+						return true;
+					}
+				}
+				logo::report_resolver_error(value.line_index,"Identifier '%' does not exist.",logo::get_symbol_name(value.identfier_name));
+				return false;
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				auto* unary_operator = expression->unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Reference && state->current_function_index != 0) {
+					state->functions[state->current_function_index - 1].references_variables = true;
+				}
+				if(unary_operator->type != Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					if(!logo::resolve_expression(state,unary_operator->child)) return false;
+					if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Reference) logo::mark_assigned_arguments(state,*unary_operator->child);
+					if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Dereference) return logo::push_argument_dereference(state,unary_operator);
+					return true;
+				}
+
+				auto* child = unary_operator->child;
+				if(child->type != Ast_Expression_Type::Value || child->value.type != Ast_Value_Type::Identifier) {
+					logo::report_resolver_error(unary_operator->line_index,"'parent scope access' operator can only be applied on an identifier.");
+					return false;
+				}
+				//The most recently defined variable with the given name is used, which can be a variable of a function higher up the call stack.
+				child->value.depth = 1;
+				child->value.slot = 0;
+				for(std::size_t i = state->variables.length;i > state->current_function_scope_first_var_index;i -= 1) {
+					if(state->variables[i - 1] == child->value.identfier_name) {
+						child->value.depth = 0;
+						child->value.slot = static_cast<std::uint32_t>(i - 1 - state->current_function_scope_first_var_index);
+						break;
+					}
+				}
+				if(child->value.depth == 0) return true;
+				if(!state->parent_scope_accesses.push_back(&child->value)) {
+					Report_Error("Couldn't allocate % bytes of memory.",sizeof(&child->value));
+					return false;
+				}
+				return logo::push_symbol(&state->dynamically_accessed_names,child->value.identfier_name);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				if(!logo::resolve_expression(state,expression->binary_operator->left)) return false;
+				return logo::resolve_expression(state,expression->binary_operator->right);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				auto* function_call = expression->function_call;
+				for(auto* arg_expr : function_call->arguments) {
+					if(!logo::resolve_expression(state,arg_expr)) return false;
+				}
+				//The first defined function with the given signature takes precedence. Builtin functions are checked at runtime.
+				function_call->function_index = 0;
+				function_call->cache.is_name_in_scope = false;
+				for(const auto* function_definition : state->visible_functions) {
+					if(function_definition->name != function_call->name) continue;
+					function_call->cache.is_name_in_scope = true;
+					if(function_definition->function_arguments.length == function_call->arguments.length) {
+						function_call->function_index = function_definition->function_index + 1;
+						break;
+					}
+				}
+				if(function_call->function_index == 0) {
+					if(!state->unbound_calls.push_back(function_call)) {
+						Report_Error("Couldn't allocate % bytes of memory.",sizeof(Ast_Function_Call*));
+						return false;
+					}
+					return true;
+				}
+				Resolver_Call call{};
+				call.function_call = function_call;
+				call.caller_function_index = state->current_function_index;
+				if(!state->calls.push_back(call)) {
+					Report_Error("Couldn't allocate % bytes of memory.",sizeof(call));
+					return false;
+				}
+				return true;
+			}
+			case Ast_Expression_Type::Array_Access: {
+				//Arrays are rejected when the expression is evaluated so there is nothing to resolve here.
+				return true;
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::resolve_expression(state,expression->conditional->condition)) return false;
+				if(!logo::resolve_expression(state,expression->conditional->if_true)) return false;
+				return logo::resolve_expression(state,expression->conditional->if_false);
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool resolve_statements(Resolver_State* state,Heap_Array<Ast_Statement>* statements);
+
+	[[nodiscard]] static bool resolve_scope(Resolver_State* state,Heap_Array<Ast_Statement>* statements) {
+		std::size_t var_count = state->variables.length;
+		if(!logo::resolve_statements(state,statements)) return false;
+		state->variables.length = var_count;
+		return true;
+	}
+
+	[[nodiscard]] static bool resolve_statement(Resolver_State* state,Ast_Statement* statement) {
+		switch(statement->type) {
+			case Ast_Statement_Type::Expression: {
+				return logo::resolve_expression(state,&statement->expression);
+			}
+			case Ast_Statement_Type::Declaration: {
+				const auto& name = statement->declaration.name;
+				for(std::size_t i = state->current_function_scope_first_var_index;i < state->variables.length;i += 1) {
+					if(state->variables[i] == name) {
+						logo::report_resolver_error(statement->line_index,"Variable '%' has already been defined.",logo::get_symbol_name(name));
+						return false;
+					}
+				}
+				if(!logo::resolve_expression(state,&statement->declaration.initial_value_expr)) return false;
+				return logo::push_variable_name(state,name,statement->line_index);
+			}
+			case Ast_Statement_Type::Assignment: {
+				if(!logo::resolve_expression(state,&statement->assignment.lvalue_expr)) return false;
+				logo::mark_assigned_arguments(state,statement->assignment.lvalue_expr);
+				return logo::resolve_expression(state,&statement->assignment.rvalue_expr);
+			}
+			case Ast_Statement_Type::If_Statement: {
+				if(!logo::resolve_expression(state,&statement->if_statement.condition_expr)) return false;
+				if(!logo::resolve_scope(state,&statement->if_statement.if_true_statements)) return false;
+				return logo::resolve_scope(state,&statement->if_statement.if_false_statements);
+			}
+			case Ast_Statement_Type::While_Statement: {
+				if(!logo::resolve_expression(state,&statement->while_statement.condition_expr)) return false;
+				bool copy_is_innermost_loop_parallel = state->is_innermost_loop_parallel;
+				state->is_innermost_loop_parallel = false;
+				if(!logo::resolve_scope(state,&statement->while_statement.body_statements)) return false;
+				state->is_innermost_loop_parallel = copy_is_innermost_loop_parallel;
+				return true;
+			}
+			case Ast_Statement_Type::For_Statement: {
+				bool copy_is_inside_parallel_loop = state->is_inside_parallel_loop;
+				bool copy_is_innermost_loop_parallel = state->is_innermost_loop_parallel;
+				state->is_inside_parallel_loop = state->is_inside_parallel_loop || statement->for_statement.is_parallel;
+				state->is_innermost_loop_parallel = statement->for_statement.is_parallel;
+				if(!logo::resolve_expression(state,&statement->for_statement.start_expr)) return false;
+				if(!logo::resolve_expression(state,&statement->for_statement.end_expr)) return false;
+				//The iterator is not checked for redefinition, a variable with the same name defined earlier shadows it.
+				if(!logo::push_variable_name(state,statement->for_statement.iterator_identifier,statement->line_index)) return false;
+				for(auto& induction_variable : statement->for_statement.induction_variables) {
+					if(!logo::resolve_expression(state,&induction_variable.step_expr)) return false;
+					if(!logo::push_variable_name(state,induction_variable.name,statement->line_index)) return false;
+				}
+				if(!logo::resolve_scope(state,&statement->for_statement.body_statements)) return false;
+				state->variables.pop_back(1 + statement->for_statement.induction_variables.length);
+				state->is_inside_parallel_loop = copy_is_inside_parallel_loop;
+				state->is_innermost_loop_parallel = copy_is_innermost_loop_parallel;
+				return true;
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				const auto& function_definition = statement->function_definition;
+				std::size_t arg_count = function_definition.function_arguments.length;
+				if(!state->functions[function_definition.function_index].proven_arguments.resize(arg_count,true)) {
+					Report_Error("Couldn't allocate % bytes of memory.",arg_count * sizeof(bool));
+					return false;
+				}
+				std::size_t var_count = state->variables.length;
+				std::size_t copy_var_index = state->current_function_scope_first_var_index;
+				std::size_t copy_function_index = state->current_function_index;
+				bool copy_is_inside_parallel_loop = state->is_inside_parallel_loop;
+				bool copy_is_innermost_loop_parallel = state->is_innermost_loop_parallel;
+				state->current_function_scope_first_var_index = state->variables.length;
+				state->current_function_index = function_definition.function_index + 1;
+				state->is_inside_parallel_loop = false;
+				state->is_innermost_loop_parallel = false;
+				for(const auto& argument : function_definition.function_arguments) {
+					if(!logo::push_variable_name(state,argument,statement->line_index)) return false;
+				}
+				if(!logo::resolve_statements(state,&statement->function_definition.body_statements)) return false;
+				state->current_function_scope_first_var_index = copy_var_index;
+				state->current_function_index = copy_function_index;
+				state->is_inside_parallel_loop = copy_is_inside_parallel_loop;
+				state->is_innermost_loop_parallel = copy_is_innermost_loop_parallel;
+				state->variables.length = var_count;
+				return true;
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				if(state->is_inside_parallel_loop) {
+					logo::report_resolver_error(statement->line_index,"Keyword 'return' can't be used inside a parallel loop.");
+					return false;
+				}
+				auto& return_statement = statement->return_statement;
+				return_statement.is_tail_call = false;
+				return_statement.can_reuse_frame = false;
+				if(!return_statement.return_value) return true;
+				if(return_statement.return_value->type == Ast_Expression_Type::Function_Call && state->current_function_index != 0) {
+					return_statement.is_tail_call = true;
+					Resolver_Tail_Call tail_call{};
+					tail_call.return_statement = &return_statement;
+					tail_call.function_index = state->current_function_index - 1;
+					if(!state->tail_calls.push_back(tail_call)) {
+						Report_Error("Couldn't allocate % bytes of memory.",sizeof(tail_call));
+						return false;
+					}
+				}
+				return logo::resolve_expression(state,return_statement.return_value);
+			}
+			case Ast_Statement_Type::Break_Statement: {
+				if(state->is_innermost_loop_parallel) {
+					logo::report_resolver_error(statement->line_index,"Keyword 'break' can't be used inside a parallel loop.");
+					return false;
+				}
+				return true;
+			}
+			case Ast_Statement_Type::Continue_Statement: {
+				return true;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	//A function can be called anywhere in the scope it's defined in, so all of its definitions are bound before the statements are resolved.
+	[[nodiscard]] static bool resolve_statements(Resolver_State* state,Heap_Array<Ast_Statement>* statements) {
+		std::size_t visible_function_count = state->visible_functions.length;
+		for(auto& statement : *statements) {
+			if(statement.type != Ast_Statement_Type::Function_Definition) continue;
+			if(state->functions.length >= std::numeric_limits<std::uint32_t>::max()) {
+				logo::report_resolver_error(statement.line_index,"Too many functions.");
+				return false;
+			}
+			statement.function_definition.function_index = state->functions.length;
+			statement.function_definition.parent_function_index = state->current_function_index;
+			statement.function_definition.defines_dynamic_functions = false;
+			Resolver_Function function{};
+			function.definition = &statement.function_definition;
+			if(!state->functions.push_back(function)) {
+				Report_Error("Couldn't allocate % bytes of memory.",sizeof(function));
+				return false;
+			}
+			if(!state->visible_functions.push_back(&statement.function_definition)) {
+				Report_Error("Couldn't allocate % bytes of memory.",sizeof(Ast_Function_Definition*));
+				return false;
+			}
+		}
+		for(auto& statement : *statements) {
+			if(!logo::resolve_statement(state,&statement)) return false;
+		}
+		state->visible_functions.length = visible_function_count;
+		return true;
+	}
+
+	//A frame can be reused if its variables can't be reached by name from the called function and there are no references to them.
+	//The functions it defines have to stay visible to the called function too. Both are only known once the whole program is resolved.
+	[[nodiscard]] static bool can_reuse_frame(const Resolver_State* state,const Resolver_Function& function) {
+		if(function.references_variables || function.definition->defines_dynamic_functions) return false;
+		for(auto name : function.variable_names) {
+			for(auto dynamically_accessed_name : state->dynamically_accessed_names) {
+				if(name == dynamically_accessed_name) return false;
+			}
+		}
+		return true;
+	}
+
+	//A parent scope access can refer to a variable of any function up the call stack. If no function declares a variable with the given name
+	//and it's declared only once outside of functions, the access can only refer to that variable. Returns its slot plus 1 or 0 if there isn't one.
+	[[nodiscard]] static std::uint32_t find_top_level_slot(const Resolver_State* state,Symbol name) {
+		for(const auto& function : state->functions) {
+			for(auto variable_name : function.variable_names) {
+				if(variable_name == name) return 0;
+			}
+		}
+		std::uint32_t slot = 0;
+		for(const auto& variable : state->top_level_variables) {
+			if(variable.name != name) continue;
+			if(slot != 0) return 0;
+			slot = static_cast<std::uint32_t>(variable.slot + 1);
+		}
+		return slot;
+	}
+
+	//A call with no function of its signature in scope, which isn't a builtin function either, looks for the function at runtime among the ones defined
+	//by the running functions. Only the functions that define a function with the name of such a call keep track of when they run,
+	//functions with the same name and a different number of arguments decide the error message.
+	[[nodiscard]] static bool mark_dynamic_functions(Resolver_State* state) {
+		auto [print_symbol,print_symbol_interned] = logo::intern_symbol("print");
+		if(!print_symbol_interned) return false;
+		for(const auto* function_call : state->unbound_calls) {
+			if(function_call->name == print_symbol || logo::find_builtin_function(function_call->name,function_call->arguments.length).has_value) continue;
+			for(const auto& function : state->functions) {
+				const auto* definition = function.definition;
+				if(definition->name != function_call->name) continue;
+				if(definition->parent_function_index != 0) state->functions[definition->parent_function_index - 1].definition->defines_dynamic_functions = true;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool is_proven_reference(const Resolver_State* state,std::size_t caller_function_index,const Ast_Expression& argument) {
+		//A reference made right before the call refers to a variable that exists at that moment.
+		if(argument.type == Ast_Expression_Type::Unary_Prefix_Operator && argument.unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Reference) return true;
+		if(caller_function_index == 0 || argument.type != Ast_Expression_Type::Value || argument.value.type != Ast_Value_Type::Identifier || argument.value.depth != 0) return false;
+		const auto& proven_arguments = state->functions[caller_function_index - 1].proven_arguments;
+		return argument.value.slot < proven_arguments.length && proven_arguments[argument.value.slot];
+	}
+
+	//An argument always holds a live reference if every call passes it a new reference or a proven argument of the calling function, and it's never
+	//assigned to, referenced or accessed by name from other functions. The variable it refers to is below the frame of the function then,
+	//so it can't be removed before the function returns and dereferencing the argument doesn't have to check the reference.
+	static void find_proven_arguments(Resolver_State* state) {
+		for(auto& function : state->functions) {
+			for(std::size_t i = 0;i < function.proven_arguments.length;i += 1) {
+				for(auto name : state->dynamically_accessed_names) {
+					if(name == function.definition->function_arguments[i]) function.proven_arguments[i] = false;
+				}
+			}
+		}
+		bool changed = true;
+		while(changed) {
+			changed = false;
+			for(const auto& call : state->calls) {
+				auto& proven_arguments = state->functions[call.function_call->function_index - 1].proven_arguments;
+				if(call.function_call->arguments.length != proven_arguments.length) continue; //The call fails before the function runs.
+				for(std::size_t i = 0;i < proven_arguments.length;i += 1) {
+					if(!proven_arguments[i] || logo::is_proven_reference(state,call.caller_function_index,*call.function_call->arguments[i])) continue;
+					proven_arguments[i] = false;
+					changed = true;
+				}
+			}
+		}
+		for(const auto& dereference : state->argument_dereferences) {
+			dereference.unary_operator->is_reference_proven = state->functions[dereference.function_index].proven_arguments[dereference.argument_index];
+		}
+	}
+
+	bool resolve_ast(Heap_Array<Ast_Statement>* statements) {
+		Resolver_State state{};
+		defer[&]{
+			for(auto& function : state.functions) {
+				function.proven_arguments.destroy();
+				function.variable_names.destroy();
+			}
+			state.functions.destroy();
+			state.tail_calls.destroy();
+			state.dynamically_accessed_names.destroy();
+			state.visible_functions.destroy();
+			state.top_level_variables.destroy();
+			state.parent_scope_accesses.destroy();
+			state.argument_dereferences.destroy();
+			state.calls.destroy();
+			state.unbound_calls.destroy();
+			state.variables.destroy();
+		};
+		if(!logo::resolve_statements(&state,statements)) return false;
+		if(!logo::mark_dynamic_functions(&state)) return false;
+		for(auto& tail_call : state.tail_calls) {
+			tail_call.return_statement->can_reuse_frame = logo::can_reuse_frame(&state,state.functions[tail_call.function_index]);
+		}
+		for(auto* value : state.parent_scope_accesses) value->slot = logo::find_top_level_slot(&state,value->identfier_name);
+		logo::find_proven_arguments(&state);
+		return true;
+	}
+}
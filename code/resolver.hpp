@@ -0,0 +1,15 @@
+#ifndef LOGO_RESOLVER_HPP
+#define LOGO_RESOLVER_HPP
+
+#include "parser.hpp"
+#include "heap_array.hpp"
+
+namespace logo {
+	//Assigns a slot to every identifier in the program and reports uses of undefined variables and redefinitions.
+	//Every function definition gets an index and function calls are bound to the definitions visible in their scope.
+	//The other calls look for the function among the ones defined by the running functions at runtime.
+	//Both the interpreter and the bytecode compiler expect the AST to be resolved.
+	[[nodiscard]] bool resolve_ast(Heap_Array<Ast_Statement>* statements);
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include <limits>
+#include <cstring>
+#include "debug.hpp"
+#include "heap_array.hpp"
+#include "memory_arena.hpp"
+#include "symbol_table.hpp"
+
+namespace logo {
+	static struct {
+		Arena_Allocator memory;
+		Heap_Array<String_View> names;
+		Heap_Array<std::uint32_t> buckets; //Every bucket holds a symbol index plus 1 or 0 if it's empty. The length is always a power of 2.
+	} symbol_table;
+
+	[[nodiscard]] static std::uint32_t hash_symbol_name(String_View name) {
+		std::uint32_t hash = 2166136261u;
+		for(const char* ptr = name.begin_ptr;ptr != name.end_ptr;ptr += 1) {
+			hash ^= static_cast<std::uint8_t>(*ptr);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	[[nodiscard]] static bool rehash_symbol_table(std::size_t bucket_count) {
+		Heap_Array<std::uint32_t> buckets{};
+		if(!buckets.resize(bucket_count,0)) {
+			Report_Error("Couldn't allocate % bytes of memory.",bucket_count * sizeof(std::uint32_t));
+			return false;
+		}
+		for(std::size_t i = 0;i < symbol_table.names.length;i += 1) {
+			std::size_t bucket_index = logo::hash_symbol_name(symbol_table.names[i]) & (bucket_count - 1);
+			while(buckets[bucket_index] != 0) bucket_index = (bucket_index + 1) & (bucket_count - 1);
+			buckets[bucket_index] = static_cast<std::uint32_t>(i + 1);
+		}
+		symbol_table.buckets.destroy();
+		symbol_table.buckets = buckets;
+		return true;
+	}
+
+	//Returns the bucket that holds the name or the empty bucket it would go to.
+	[[nodiscard]] static std::size_t find_symbol_bucket(String_View name) {
+		std::size_t name_length = name.byte_length();
+		std::size_t bucket_mask = symbol_table.buckets.length - 1;
+		std::size_t bucket_index = logo::hash_symbol_name(name) & bucket_mask;
+		while(symbol_table.buckets[bucket_index] != 0) {
+			std::uint32_t symbol_index = symbol_table.buckets[bucket_index] - 1;
+			const auto& symbol_name = symbol_table.names[symbol_index];
+			if(symbol_name.byte_length() == name_length && std::memcmp(symbol_name.begin_ptr,name.begin_ptr,name_length) == 0) break;
+			bucket_index = (bucket_index + 1) & bucket_mask;
+		}
+		return bucket_index;
+	}
+
+	Option<Symbol> intern_symbol(String_View name) {
+		if(symbol_table.buckets.length == 0 && !logo::rehash_symbol_table(256)) return {};
+		//Names that are already interned are only looked up, so the threads of a parallel loop can intern them at the same time.
+		std::size_t bucket_index = logo::find_symbol_bucket(name);
+		if(symbol_table.buckets[bucket_index] != 0) return static_cast<Symbol>(symbol_table.buckets[bucket_index] - 1);
+		if((symbol_table.names.length + 1) * 2 > symbol_table.buckets.length) {
+			if(!logo::rehash_symbol_table(symbol_table.buckets.length * 2)) return {};
+			bucket_index = logo::find_symbol_bucket(name);
+		}
+
+		std::size_t name_length = name.byte_length();
+
+		if(symbol_table.names.length >= std::numeric_limits<std::uint32_t>::max()) {
+			Report_Error("Too many distinct identifiers.");
+			return {};
+		}
+		if(symbol_table.memory.arena_size == 0) symbol_table.memory.arena_size = logo::megabytes(1);
+		if(name_length >= symbol_table.memory.arena_size) {
+			Report_Error("Identifier '%' is too long.",name);
+			return {};
+		}
+		char* name_ptr = symbol_table.memory.construct_string(name_length);
+		if(!name_ptr) {
+			Report_Error("Couldn't allocate % bytes of memory.",name_length + 1);
+			return {};
+		}
+		std::memcpy(name_ptr,name.begin_ptr,name_length);
+		if(!symbol_table.names.push_back(String_View(name_ptr,name_length))) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(String_View));
+			return {};
+		}
+		symbol_table.buckets[bucket_index] = static_cast<std::uint32_t>(symbol_table.names.length);
+		return static_cast<Symbol>(symbol_table.names.length - 1);
+	}
+
+	String_View get_symbol_name(Symbol symbol) {
+		auto symbol_index = static_cast<std::size_t>(symbol);
+		logo::assert(symbol_index < symbol_table.names.length);
+		return symbol_table.names[symbol_index];
+	}
+
+	std::size_t get_symbol_count() {
+		return symbol_table.names.length;
+	}
+
+	void term_symbol_table() {
+		symbol_table.buckets.destroy();
+		symbol_table.names.destroy();
+		symbol_table.memory.destroy();
+	}
+}
@@ -0,0 +1,19 @@
+#ifndef LOGO_SYMBOL_TABLE_HPP
+#define LOGO_SYMBOL_TABLE_HPP
+
+#include <cstdint>
+#include "utils.hpp"
+#include "string.hpp"
+
+namespace logo {
+	//Every distinct identifier is stored once and referred to by its index. Two symbols are equal only if their names are equal.
+	enum struct Symbol : std::uint32_t {};
+
+	[[nodiscard]] Option<Symbol> intern_symbol(String_View name);
+	[[nodiscard]] String_View get_symbol_name(Symbol symbol);
+	//Symbols are numbered from 0 in the order they were interned.
+	[[nodiscard]] std::size_t get_symbol_count();
+	void term_symbol_table();
+}
+
+#endif
@@ -0,0 +1,175 @@
+#include <new>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+#include "debug.hpp"
+#include "thread_pool.hpp"
+
+namespace logo {
+	//Each range is on its own cache line, so that threads taking chunks from their own ranges don't slow each other down.
+	struct alignas(64) Thread_Pool_Range {
+		std::mutex mutex;
+		std::int64_t begin,end;
+	};
+
+	struct Thread_Pool {
+		std::size_t thread_count;
+		std::thread* threads; //'thread_count - 1' threads, the thread that runs the pool is thread 0.
+		Thread_Pool_Range* ranges;
+		std::mutex mutex;
+		std::condition_variable work_started;
+		std::condition_variable work_finished;
+		std::uint64_t generation; //Incremented every time the pool is given a new range.
+		std::size_t busy_thread_count;
+		bool is_stopping;
+		std::int64_t chunk_size;
+		void* data;
+		Thread_Pool_Task task;
+	};
+
+	[[nodiscard]] static bool steal_range(Thread_Pool* pool,std::size_t thread_index) {
+		while(true) {
+			std::size_t victim_index = pool->thread_count;
+			std::int64_t victim_size = 0;
+			for(std::size_t i = 0;i < pool->thread_count;i += 1) {
+				if(i == thread_index) continue;
+				std::lock_guard lock(pool->ranges[i].mutex);
+				if(pool->ranges[i].end - pool->ranges[i].begin > victim_size) {
+					victim_size = pool->ranges[i].end - pool->ranges[i].begin;
+					victim_index = i;
+				}
+			}
+			if(victim_index == pool->thread_count) return false;
+
+			std::int64_t begin = 0;
+			std::int64_t end = 0;
+			{
+				auto& victim = pool->ranges[victim_index];
+				std::lock_guard lock(victim.mutex);
+				//The victim might have run its range in the meantime.
+				if(victim.begin >= victim.end) continue;
+				std::int64_t size = victim.end - victim.begin;
+				end = victim.end;
+				begin = end - (size == 1 ? 1 : size / 2);
+				victim.end = begin;
+			}
+			//The range of the victim is unlocked first, two threads stealing from each other would deadlock otherwise.
+			auto& range = pool->ranges[thread_index];
+			std::lock_guard lock(range.mutex);
+			range.begin = begin;
+			range.end = end;
+			return true;
+		}
+	}
+
+	static void run_thread_work(Thread_Pool* pool,std::size_t thread_index) {
+		auto& range = pool->ranges[thread_index];
+		while(true) {
+			std::int64_t begin = 0;
+			std::int64_t end = 0;
+			{
+				std::lock_guard lock(range.mutex);
+				begin = range.begin;
+				end = std::min(range.begin + pool->chunk_size,range.end);
+				if(begin < end) range.begin = end;
+			}
+			if(begin < end) pool->task(pool->data,thread_index,begin,end);
+			else if(!logo::steal_range(pool,thread_index)) return;
+		}
+	}
+
+	static void run_worker_thread(Thread_Pool* pool,std::size_t thread_index) {
+		std::uint64_t generation = 0;
+		while(true) {
+			{
+				std::unique_lock lock(pool->mutex);
+				pool->work_started.wait(lock,[&]{ return pool->is_stopping || pool->generation != generation; });
+				if(pool->is_stopping) return;
+				generation = pool->generation;
+			}
+			logo::run_thread_work(pool,thread_index);
+			std::lock_guard lock(pool->mutex);
+			pool->busy_thread_count -= 1;
+			if(pool->busy_thread_count == 0) pool->work_finished.notify_one();
+		}
+	}
+
+	std::size_t get_hardware_thread_count() {
+		return std::max(std::thread::hardware_concurrency(),1u);
+	}
+
+	Thread_Pool* create_thread_pool(std::size_t thread_count) {
+		thread_count = std::max(thread_count,std::size_t(1));
+		auto* pool = new(std::nothrow) Thread_Pool();
+		if(!pool) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(Thread_Pool));
+			return nullptr;
+		}
+		pool->thread_count = thread_count;
+		pool->ranges = new(std::nothrow) Thread_Pool_Range[thread_count]();
+		if(!pool->ranges) {
+			Report_Error("Couldn't allocate % bytes of memory.",thread_count * sizeof(Thread_Pool_Range));
+			delete pool;
+			return nullptr;
+		}
+		pool->threads = new(std::nothrow) std::thread[thread_count - 1];
+		if(!pool->threads) {
+			Report_Error("Couldn't allocate % bytes of memory.",(thread_count - 1) * sizeof(std::thread));
+			delete[] pool->ranges;
+			delete pool;
+			return nullptr;
+		}
+		for(std::size_t i = 1;i < thread_count;i += 1) {
+			pool->threads[i - 1] = std::thread(logo::run_worker_thread,pool,i);
+		}
+		return pool;
+	}
+
+	void destroy_thread_pool(Thread_Pool* pool) {
+		if(!pool) return;
+		{
+			std::lock_guard lock(pool->mutex);
+			pool->is_stopping = true;
+		}
+		pool->work_started.notify_all();
+		for(std::size_t i = 1;i < pool->thread_count;i += 1) pool->threads[i - 1].join();
+		delete[] pool->threads;
+		delete[] pool->ranges;
+		delete pool;
+	}
+
+	std::size_t get_thread_count(const Thread_Pool* pool) {
+		return pool->thread_count;
+	}
+
+	//The first 'size % count' parts are one index longer than the others. Computing 'size * i / count' instead could overflow for big ranges.
+	[[nodiscard]] static std::int64_t get_part_begin(std::int64_t begin,std::int64_t size,std::int64_t count,std::int64_t i) {
+		return begin + size / count * i + std::min(i,size % count);
+	}
+
+	void run_thread_pool(Thread_Pool* pool,std::int64_t begin,std::int64_t end,void* data,Thread_Pool_Task task) {
+		if(begin >= end) return;
+		auto count = static_cast<std::int64_t>(pool->thread_count);
+		//Small chunks keep the threads busy until the end when the iterations take different amounts of time,
+		//but every chunk has to lock the range, so there are only a few of them per thread.
+		pool->chunk_size = std::max((end - begin) / (count * 8),std::int64_t(1));
+		pool->data = data;
+		pool->task = task;
+		for(std::int64_t i = 0;i < count;i += 1) {
+			auto& range = pool->ranges[i];
+			std::lock_guard lock(range.mutex);
+			range.begin = logo::get_part_begin(begin,end - begin,count,i);
+			range.end = logo::get_part_begin(begin,end - begin,count,i + 1);
+		}
+		{
+			std::lock_guard lock(pool->mutex);
+			pool->busy_thread_count = pool->thread_count - 1;
+			pool->generation += 1;
+		}
+		pool->work_started.notify_all();
+		logo::run_thread_work(pool,0);
+		std::unique_lock lock(pool->mutex);
+		pool->work_finished.wait(lock,[&]{ return pool->busy_thread_count == 0; });
+	}
+}
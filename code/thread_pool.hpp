@@ -0,0 +1,22 @@
+#ifndef LOGO_THREAD_POOL_HPP
+#define LOGO_THREAD_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace logo {
+	struct Thread_Pool;
+	//Runs the indices from 'begin' to 'end' (exclusive) on the thread with index 'thread_index'.
+	using Thread_Pool_Task = void(*)(void* data,std::size_t thread_index,std::int64_t begin,std::int64_t end);
+
+	[[nodiscard]] std::size_t get_hardware_thread_count();
+	//The calling thread is one of the 'thread_count' threads of the pool, so 'thread_count - 1' threads are started.
+	[[nodiscard]] Thread_Pool* create_thread_pool(std::size_t thread_count);
+	void destroy_thread_pool(Thread_Pool* pool);
+	[[nodiscard]] std::size_t get_thread_count(const Thread_Pool* pool);
+	//Splits the range between the threads of the pool and returns after all of it was run. The calling thread runs as thread 0.
+	//Every thread takes small chunks from the front of its part of the range and a thread that runs out of work steals half of the biggest part that's left.
+	void run_thread_pool(Thread_Pool* pool,std::int64_t begin,std::int64_t end,void* data,Thread_Pool_Task task);
+}
+
+#endif
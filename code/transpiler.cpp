@@ -0,0 +1,627 @@
+#include <bit>
+#include <limits>
+#include "debug.hpp"
+#include "transpiler.hpp"
+#include "symbol_table.hpp"
+
+namespace logo {
+	struct Transpiler_State {
+		Heap_Array<const Ast_Statement*> function_definitions; //Definitions at the indices assigned by the resolver, which are also the indices of their functions in the generated program.
+		std::size_t indentation;
+		std::size_t name_counter; //Numbers the temporaries, caches and labels of the function that's being generated.
+		std::size_t loop_id; //Number of the 'continue' label of the innermost loop.
+		bool is_inside_function;
+		Heap_Array<char> output; //The code is written to the standard output at once after it has been generated.
+		bool is_out_of_memory;
+	};
+
+	template<typename... Args>
+	static void emit(Transpiler_State* state,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
+		auto append = [&](char32_t c) {
+			Array_String<sizeof(c)> code_point{};
+			code_point.append(c);
+			for(std::size_t i = 0;i < code_point.byte_length;i += 1) {
+				if(!state->output.push_back(code_point.buffer[i])) state->is_out_of_memory = true;
+			}
+			return !state->is_out_of_memory;
+		};
+		logo::format_into(append,format,std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	static void emit_line(Transpiler_State* state,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
+		for(std::size_t i = 0;i < state->indentation;i += 1) logo::emit(state,"\t");
+		logo::emit(state,format,std::forward<Args>(args)...);
+		logo::emit(state,"\n");
+	}
+
+	//Writes the bytes of the string as a C++ string literal. Octal escapes never take more than 3 digits, so they can't swallow the next character.
+	static void emit_string_literal(Transpiler_State* state,String_View string) {
+		logo::emit(state,"\"");
+		for(const char* ptr = string.begin_ptr;ptr != string.end_ptr;ptr += 1) {
+			auto byte = static_cast<std::uint8_t>(*ptr);
+			if(byte >= 0x20 && byte < 0x7F && byte != '"' && byte != '\\' && byte != '?') logo::emit(state,"%",String_View(ptr,1));
+			else {
+				char escape[] = {'\\',static_cast<char>('0' + (byte >> 6)),static_cast<char>('0' + ((byte >> 3) & 7)),static_cast<char>('0' + (byte & 7))};
+				logo::emit(state,"%",String_View(escape,sizeof(escape)));
+			}
+		}
+		logo::emit(state,"\"");
+	}
+
+	[[nodiscard]] static std::uint32_t get_symbol_index(Symbol symbol) {
+		return static_cast<std::uint32_t>(symbol);
+	}
+
+	[[nodiscard]] static String_View get_unary_operator_name(Ast_Unary_Prefix_Operator_Type type) {
+		switch(type) {
+			case Ast_Unary_Prefix_Operator_Type::Plus: return "Plus";
+			case Ast_Unary_Prefix_Operator_Type::Minus: return "Minus";
+			case Ast_Unary_Prefix_Operator_Type::Logical_Not: return "Logical_Not";
+			case Ast_Unary_Prefix_Operator_Type::Reference: return "Reference";
+			case Ast_Unary_Prefix_Operator_Type::Dereference: return "Dereference";
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static String_View get_binary_operator_name(Ast_Binary_Operator_Type type) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus: return "Plus";
+			case Ast_Binary_Operator_Type::Minus: return "Minus";
+			case Ast_Binary_Operator_Type::Multiply: return "Multiply";
+			case Ast_Binary_Operator_Type::Divide: return "Divide";
+			case Ast_Binary_Operator_Type::Remainder: return "Remainder";
+			case Ast_Binary_Operator_Type::Exponentiate: return "Exponentiate";
+			case Ast_Binary_Operator_Type::Logical_And: return "Logical_And";
+			case Ast_Binary_Operator_Type::Logical_Or: return "Logical_Or";
+			case Ast_Binary_Operator_Type::Compare_Equal: return "Compare_Equal";
+			case Ast_Binary_Operator_Type::Compare_Unequal: return "Compare_Unequal";
+			case Ast_Binary_Operator_Type::Compare_Less_Than: return "Compare_Less_Than";
+			case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: return "Compare_Less_Than_Or_Equal";
+			case Ast_Binary_Operator_Type::Compare_Greater_Than: return "Compare_Greater_Than";
+			case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: return "Compare_Greater_Than_Or_Equal";
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static String_View get_assignment_name(Ast_Assignment_Type type) {
+		switch(type) {
+			case Ast_Assignment_Type::Assignment: return "Assignment";
+			case Ast_Assignment_Type::Compound_Plus: return "Compound_Plus";
+			case Ast_Assignment_Type::Compound_Minus: return "Compound_Minus";
+			case Ast_Assignment_Type::Compound_Multiply: return "Compound_Multiply";
+			case Ast_Assignment_Type::Compound_Divide: return "Compound_Divide";
+			case Ast_Assignment_Type::Compound_Remainder: return "Compound_Remainder";
+			case Ast_Assignment_Type::Compound_Exponentiate: return "Compound_Exponentiate";
+			default: logo::unreachable();
+		}
+	}
+
+	//Describes the C++ code of an operation whose operand types are proven. It's the same code as in 'compute_unchecked_operation'.
+	struct Transpiler_Specialized_Operation {
+		String_View result_type;
+		String_View result_field;
+		String_View operand_field;
+		String_View operator_string; //Empty for 'std::fmod'.
+	};
+	[[nodiscard]] static Transpiler_Specialized_Operation get_specialized_operation(Ast_Operation_Specialization specialization) {
+		switch(specialization) {
+			case Ast_Operation_Specialization::Int_Plus: return {"Int","int_v","int_v","+"};
+			case Ast_Operation_Specialization::Int_Minus: return {"Int","int_v","int_v","-"};
+			case Ast_Operation_Specialization::Int_Multiply: return {"Int","int_v","int_v","*"};
+			case Ast_Operation_Specialization::Int_Divide: return {"Int","int_v","int_v","/"};
+			case Ast_Operation_Specialization::Int_Remainder: return {"Int","int_v","int_v","%"};
+			case Ast_Operation_Specialization::Int_Compare_Equal: return {"Bool","bool_v","int_v","=="};
+			case Ast_Operation_Specialization::Int_Compare_Unequal: return {"Bool","bool_v","int_v","!="};
+			case Ast_Operation_Specialization::Int_Compare_Less_Than: return {"Bool","bool_v","int_v","<"};
+			case Ast_Operation_Specialization::Int_Compare_Less_Than_Or_Equal: return {"Bool","bool_v","int_v","<="};
+			case Ast_Operation_Specialization::Int_Compare_Greater_Than: return {"Bool","bool_v","int_v",">"};
+			case Ast_Operation_Specialization::Int_Compare_Greater_Than_Or_Equal: return {"Bool","bool_v","int_v",">="};
+			case Ast_Operation_Specialization::Float_Plus: return {"Float","float_v","float_v","+"};
+			case Ast_Operation_Specialization::Float_Minus: return {"Float","float_v","float_v","-"};
+			case Ast_Operation_Specialization::Float_Multiply: return {"Float","float_v","float_v","*"};
+			case Ast_Operation_Specialization::Float_Divide: return {"Float","float_v","float_v","/"};
+			case Ast_Operation_Specialization::Float_Remainder: return {"Float","float_v","float_v",""};
+			case Ast_Operation_Specialization::Float_Compare_Equal: return {"Bool","bool_v","float_v","=="};
+			case Ast_Operation_Specialization::Float_Compare_Unequal: return {"Bool","bool_v","float_v","!="};
+			case Ast_Operation_Specialization::Float_Compare_Less_Than: return {"Bool","bool_v","float_v","<"};
+			case Ast_Operation_Specialization::Float_Compare_Less_Than_Or_Equal: return {"Bool","bool_v","float_v","<="};
+			case Ast_Operation_Specialization::Float_Compare_Greater_Than: return {"Bool","bool_v","float_v",">"};
+			case Ast_Operation_Specialization::Float_Compare_Greater_Than_Or_Equal: return {"Bool","bool_v","float_v",">="};
+			case Ast_Operation_Specialization::Bool_Logical_And: return {"Bool","bool_v","bool_v","&&"};
+			case Ast_Operation_Specialization::Bool_Logical_Or: return {"Bool","bool_v","bool_v","||"};
+			default: logo::unreachable();
+		}
+	}
+
+	//Stores the result of the operation on 'left' and 'right' in 'result'. All three are names of C++ variables of type 'Interpreter_Value'.
+	static void emit_specialized_operation(Transpiler_State* state,Ast_Operation_Specialization specialization,String_View result,String_View left,String_View right) {
+		auto operation = logo::get_specialized_operation(specialization);
+		logo::emit_line(state,"%.type = logo::Interpreter_Value_Type::%;",result,operation.result_type);
+		if(operation.operator_string.byte_length() == 0) {
+			logo::emit_line(state,"%.% = std::fmod(%.%,%.%);",result,operation.result_field,left,operation.operand_field,right,operation.operand_field);
+		}
+		else logo::emit_line(state,"%.% = %.% % %.%;",result,operation.result_field,left,operation.operand_field,operation.operator_string,right,operation.operand_field);
+	}
+
+	[[nodiscard]] static std::size_t make_name(Transpiler_State* state) {
+		state->name_counter += 1;
+		return state->name_counter;
+	}
+
+	[[nodiscard]] static std::size_t emit_value(Transpiler_State* state,const Ast_Value& value,bool is_rvalue) {
+		auto index = logo::make_name(state);
+		switch(value.type) {
+			case Ast_Value_Type::Int_Literal: {
+				if(value.int_value == std::numeric_limits<std::int64_t>::min()) logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_int(std::numeric_limits<std::int64_t>::min());",index);
+				else logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_int(%);",index,value.int_value);
+				break;
+			}
+			case Ast_Value_Type::Float_Literal: {
+				logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_float(%u);",index,static_cast<std::size_t>(std::bit_cast<std::uint64_t>(value.float_value)));
+				break;
+			}
+			case Ast_Value_Type::Bool_Literal: {
+				logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_bool(%);",index,value.bool_value);
+				break;
+			}
+			case Ast_Value_Type::String_Literal: {
+				logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_string(logo::Symbol{%});",index,logo::get_symbol_index(value.string_value));
+				break;
+			}
+			case Ast_Value_Type::Identifier: {
+				if(is_rvalue) logo::emit_line(state,"logo::Interpreter_Value t% = context->variables[first_var_index + %].value;",index,static_cast<std::size_t>(value.slot));
+				else logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_lvalue(first_var_index + %);",index,static_cast<std::size_t>(value.slot));
+				break;
+			}
+			default: logo::unreachable();
+		}
+		return index;
+	}
+
+	[[nodiscard]] static std::size_t emit_expression(Transpiler_State* state,const Ast_Expression& expression,bool is_rvalue);
+
+	//Computes the arguments of the call, leaving the result in 't<returned index>'. If 'is_tail_call' is true, the result is stored in '*result' instead.
+	[[nodiscard]] static std::size_t emit_function_call(Transpiler_State* state,const Ast_Function_Call& function_call,bool is_tail_call) {
+		auto index = logo::make_name(state);
+		auto symbol_index = logo::get_symbol_index(function_call.name);
+		logo::emit_line(state,"static logo::Ast_Function_Call_Cache cache%{logo::Ast_Function_Call_Target::None,0,0,%,%};",index,function_call.cache.are_argument_types_proven,function_call.cache.is_name_in_scope);
+		std::size_t arg_count = function_call.arguments.length;
+		if(arg_count > 0) logo::emit_line(state,"logo::Interpreter_Value args%[%];",index,arg_count);
+		for(std::size_t i = 0;i < arg_count;i += 1) {
+			auto arg = logo::emit_expression(state,*function_call.arguments[i],false);
+			logo::emit_line(state,"if(!logo::aot_function_call_argument(context,cache%,logo::Symbol{%},%,t%,%,&args%[%])) return false;",index,symbol_index,i,arg,function_call.line_index,index,i);
+		}
+		String_View function_name = is_tail_call ? "aot_tail_call_function" : "aot_call_function";
+		if(!is_tail_call) logo::emit_line(state,"logo::Interpreter_Value t%{};",index);
+		for(std::size_t i = 0;i < state->indentation;i += 1) logo::emit(state,"\t");
+		logo::emit(state,"if(!logo::%(state,&cache%,logo::Symbol{%},%,",function_name,index,symbol_index,function_call.function_index);
+		if(arg_count > 0) logo::emit(state,"{args%,%}",index,arg_count);
+		else logo::emit(state,"{}");
+		if(is_tail_call) logo::emit(state,",%,result)) return false;\n",function_call.line_index);
+		else logo::emit(state,",%,&t%)) return false;\n",function_call.line_index,index);
+		return index;
+	}
+
+	//Emits the code that computes the expression into a new 't<returned index>' variable. It's an lvalue only if 'is_rvalue' is false.
+	[[nodiscard]] static std::size_t emit_expression(Transpiler_State* state,const Ast_Expression& expression,bool is_rvalue) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value: {
+				return logo::emit_value(state,expression.value,is_rvalue);
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					const auto& child_value = unary_operator->child->value;
+					if(child_value.depth == 0) return logo::emit_value(state,child_value,is_rvalue);
+					auto index = logo::make_name(state);
+					logo::emit_line(state,"logo::Interpreter_Value t%{};",index);
+					logo::emit_line(state,"if(!logo::aot_parent_scope_variable(context,logo::Symbol{%},%,%,&t%)) return false;",logo::get_symbol_index(child_value.identfier_name),child_value.slot,unary_operator->line_index,index);
+					if(is_rvalue) logo::emit_line(state,"t% = logo::aot_rvalue(context,t%);",index,index);
+					return index;
+				}
+				auto child = logo::emit_expression(state,*unary_operator->child,unary_operator->type != Ast_Unary_Prefix_Operator_Type::Reference);
+				auto index = logo::make_name(state);
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Dereference && unary_operator->is_reference_proven) {
+					logo::emit_line(state,"logo::Interpreter_Value t% = logo::aot_lvalue(t%.var_index);",index,child);
+					if(is_rvalue) logo::emit_line(state,"t% = logo::aot_rvalue(context,t%);",index,index);
+					return index;
+				}
+				logo::emit_line(state,"logo::Interpreter_Value t%{};",index);
+				logo::emit_line(state,"if(!logo::aot_unary_operation(context,logo::Ast_Unary_Prefix_Operator_Type::%,t%,%,&t%)) return false;",
+								logo::get_unary_operator_name(unary_operator->type),child,unary_operator->line_index,index);
+				if(is_rvalue && unary_operator->type == Ast_Unary_Prefix_Operator_Type::Dereference) logo::emit_line(state,"t% = logo::aot_rvalue(context,t%);",index,index);
+				return index;
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				const auto* binary_operator = expression.binary_operator;
+				auto left = logo::emit_expression(state,*binary_operator->left,true);
+				auto index = logo::make_name(state);
+				//The right operand of 'and' and 'or' is computed only if the left one doesn't decide the result.
+				bool is_logical_operator = binary_operator->type == Ast_Binary_Operator_Type::Logical_And || binary_operator->type == Ast_Binary_Operator_Type::Logical_Or;
+				if(is_logical_operator) {
+					logo::emit_line(state,"logo::Interpreter_Value t% = t%;",index,left);
+					logo::emit_line(state,"if(!logo::is_short_circuited(logo::Ast_Binary_Operator_Type::%,t%)) {",logo::get_binary_operator_name(binary_operator->type),index);
+					state->indentation += 1;
+				}
+				else logo::emit_line(state,"logo::Interpreter_Value t%{};",index);
+				auto right = logo::emit_expression(state,*binary_operator->right,true);
+				if(binary_operator->cache.is_proven) {
+					Array_String<32> result_name{},left_name{},right_name{};
+					logo::format(&result_name,"t%",index);
+					logo::format(&left_name,"t%",left);
+					logo::format(&right_name,"t%",right);
+					logo::emit_specialized_operation(state,binary_operator->cache.specialization,{result_name.buffer,result_name.byte_length},
+													 {left_name.buffer,left_name.byte_length},{right_name.buffer,right_name.byte_length});
+				}
+				else {
+					logo::emit_line(state,"static logo::Ast_Operation_Cache cache%{};",index);
+					logo::emit_line(state,"if(!logo::aot_binary_operation(&cache%,logo::Ast_Binary_Operator_Type::%,t%,t%,%,&t%)) return false;",
+									index,logo::get_binary_operator_name(binary_operator->type),left,right,binary_operator->line_index,index);
+				}
+				if(is_logical_operator) {
+					state->indentation -= 1;
+					logo::emit_line(state,"}");
+				}
+				return index;
+			}
+			case Ast_Expression_Type::Conditional: {
+				const auto* conditional = expression.conditional;
+				auto condition = logo::emit_expression(state,*conditional->condition,true);
+				logo::emit_line(state,"if(!logo::check_conditional_expression_condition(t%,%)) return false;",condition,conditional->line_index);
+				auto index = logo::make_name(state);
+				logo::emit_line(state,"logo::Interpreter_Value t%{};",index);
+				logo::emit_line(state,"if(t%.bool_v) {",condition);
+				state->indentation += 1;
+				auto if_true = logo::emit_expression(state,*conditional->if_true,is_rvalue);
+				logo::emit_line(state,"t% = t%;",index,if_true);
+				state->indentation -= 1;
+				logo::emit_line(state,"}");
+				logo::emit_line(state,"else {");
+				state->indentation += 1;
+				auto if_false = logo::emit_expression(state,*conditional->if_false,is_rvalue);
+				logo::emit_line(state,"t% = t%;",index,if_false);
+				state->indentation -= 1;
+				logo::emit_line(state,"}");
+				return index;
+			}
+			case Ast_Expression_Type::Function_Call: {
+				return logo::emit_function_call(state,*expression.function_call,false);
+			}
+			case Ast_Expression_Type::Array_Access: {
+				auto index = logo::make_name(state);
+				logo::emit_line(state,"logo::Interpreter_Value t%{};",index);
+				logo::emit_line(state,"logo::report_interpreter_error(%,\"Arrays are not yet implemented.\");",expression.array_access->line_index);
+				logo::emit_line(state,"return false;");
+				return index;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	static void emit_statements(Transpiler_State* state,const Heap_Array<Ast_Statement>& statements);
+
+	//Runs the statements in a scope that removes the variables declared by them at the end, like the interpreter does.
+	static void emit_scope(Transpiler_State* state,const Heap_Array<Ast_Statement>& statements) {
+		auto index = logo::make_name(state);
+		logo::emit_line(state,"std::size_t var_count% = context->variables.length;",index);
+		logo::emit_statements(state,statements);
+		logo::emit_line(state,"logo::aot_leave_scope(context,var_count%);",index);
+	}
+
+	//Loop bodies are left at the end of every iteration and after the loop, which also leaves the scopes that 'break' and 'continue' jump out of.
+	static void emit_loop_body(Transpiler_State* state,const Heap_Array<Ast_Statement>& statements,std::size_t loop_id) {
+		std::size_t outer_loop_id = state->loop_id;
+		state->loop_id = loop_id;
+		logo::emit_line(state,"{");
+		state->indentation += 1;
+		logo::emit_statements(state,statements);
+		state->indentation -= 1;
+		logo::emit_line(state,"}");
+		logo::emit_line(state,"continue%:;",loop_id);
+		logo::emit_line(state,"logo::aot_leave_scope(context,var_count%);",loop_id);
+		state->loop_id = outer_loop_id;
+	}
+
+	static void emit_statement(Transpiler_State* state,const Ast_Statement& statement) {
+		logo::emit_line(state,"{");
+		state->indentation += 1;
+		switch(statement.type) {
+			case Ast_Statement_Type::Expression: {
+				auto value = logo::emit_expression(state,statement.expression,false);
+				logo::emit_line(state,"static_cast<void>(t%);",value);
+				break;
+			}
+			case Ast_Statement_Type::Declaration: {
+				auto value = logo::emit_expression(state,statement.declaration.initial_value_expr,true);
+				logo::emit_line(state,"if(!logo::aot_declare_variable(context,logo::Symbol{%},t%,%)) return false;",logo::get_symbol_index(statement.declaration.name),value,statement.line_index);
+				break;
+			}
+			case Ast_Statement_Type::Assignment: {
+				const auto& assignment = statement.assignment;
+				auto lvalue = logo::emit_expression(state,assignment.lvalue_expr,false);
+				logo::emit_line(state,"if(!logo::aot_check_lvalue(context,t%,%)) return false;",lvalue,assignment.line_index);
+				auto rvalue = logo::emit_expression(state,assignment.rvalue_expr,true);
+				if(assignment.cache.is_proven) {
+					Array_String<32> rvalue_name{};
+					logo::format(&rvalue_name,"t%",rvalue);
+					logo::emit_line(state,"auto& target = context->variables[t%.var_index].value;",lvalue);
+					logo::emit_specialized_operation(state,assignment.cache.specialization,"target","target",{rvalue_name.buffer,rvalue_name.byte_length});
+					break;
+				}
+				auto index = logo::make_name(state);
+				logo::emit_line(state,"static logo::Ast_Operation_Cache cache%{};",index);
+				logo::emit_line(state,"if(!logo::aot_assignment(context,&cache%,logo::Ast_Assignment_Type::%,t%,t%,%)) return false;",
+								index,logo::get_assignment_name(assignment.type),lvalue,rvalue,assignment.line_index);
+				break;
+			}
+			case Ast_Statement_Type::If_Statement: {
+				const auto& if_statement = statement.if_statement;
+				auto condition = logo::emit_expression(state,if_statement.condition_expr,true);
+				logo::emit_line(state,"if(!logo::aot_check_condition(t%,false,%)) return false;",condition,statement.line_index);
+				if(if_statement.if_true_statements.length > 0) {
+					logo::emit_line(state,"if(t%.bool_v) {",condition);
+					state->indentation += 1;
+					logo::emit_scope(state,if_statement.if_true_statements);
+					state->indentation -= 1;
+					if(if_statement.if_false_statements.length > 0) {
+						logo::emit_line(state,"}");
+						logo::emit_line(state,"else {");
+						state->indentation += 1;
+						logo::emit_scope(state,if_statement.if_false_statements);
+						state->indentation -= 1;
+					}
+					logo::emit_line(state,"}");
+				}
+				else if(if_statement.if_false_statements.length > 0) {
+					logo::emit_line(state,"if(!t%.bool_v) {",condition);
+					state->indentation += 1;
+					logo::emit_scope(state,if_statement.if_false_statements);
+					state->indentation -= 1;
+					logo::emit_line(state,"}");
+				}
+				break;
+			}
+			case Ast_Statement_Type::While_Statement: {
+				const auto& while_statement = statement.while_statement;
+				auto loop_id = logo::make_name(state);
+				logo::emit_line(state,"std::size_t var_count% = context->variables.length;",loop_id);
+				logo::emit_line(state,"while(true) {");
+				state->indentation += 1;
+				logo::emit_line(state,"{");
+				state->indentation += 1;
+				auto condition = logo::emit_expression(state,while_statement.condition_expr,true);
+				logo::emit_line(state,"if(!logo::aot_check_condition(t%,true,%)) return false;",condition,statement.line_index);
+				logo::emit_line(state,"if(!t%.bool_v) break;",condition);
+				state->indentation -= 1;
+				logo::emit_line(state,"}");
+				logo::emit_loop_body(state,while_statement.body_statements,loop_id);
+				state->indentation -= 1;
+				logo::emit_line(state,"}");
+				logo::emit_line(state,"logo::aot_leave_scope(context,var_count%);",loop_id);
+				break;
+			}
+			case Ast_Statement_Type::For_Statement: {
+				const auto& for_statement = statement.for_statement;
+				auto start = logo::emit_expression(state,for_statement.start_expr,true);
+				logo::emit_line(state,"if(!logo::aot_check_loop_bound(t%,true,%)) return false;",start,statement.line_index);
+				auto end = logo::emit_expression(state,for_statement.end_expr,true);
+				logo::emit_line(state,"if(!logo::aot_check_loop_bound(t%,false,%)) return false;",end,statement.line_index);
+				logo::emit_line(state,"if(t%.int_v < t%.int_v) {",start,end);
+				state->indentation += 1;
+
+				//The iterator and the induction variables are declared before the body. Every step is computed after the previous variable is declared.
+				auto loop_id = logo::make_name(state);
+				std::size_t induction_variable_count = for_statement.induction_variables.length;
+				logo::emit_line(state,"std::size_t iterator% = context->variables.length;",loop_id);
+				logo::emit_line(state,"if(!logo::push_variable(context,logo::Symbol{%},t%)) return false;",logo::get_symbol_index(for_statement.iterator_identifier),start);
+				if(induction_variable_count > 0) logo::emit_line(state,"std::int64_t steps%[%]{};",loop_id,induction_variable_count);
+				for(std::size_t i = 0;i < induction_variable_count;i += 1) {
+					const auto& induction_variable = for_statement.induction_variables[i];
+					logo::emit_line(state,"{");
+					state->indentation += 1;
+					auto step = logo::emit_expression(state,induction_variable.step_expr,true);
+					logo::emit_line(state,"steps%[%] = t%.int_v;",loop_id,i,step);
+					logo::emit_line(state,"if(!logo::push_variable(context,logo::Symbol{%},logo::aot_int(t%.int_v * t%.int_v))) return false;",
+									logo::get_symbol_index(induction_variable.name),start,step);
+					state->indentation -= 1;
+					logo::emit_line(state,"}");
+				}
+				//The generated program runs the iterations of parallel loops one after another, it only resets the turtle between them.
+				if(for_statement.is_parallel) logo::emit_line(state,"if(!logo::enter_parallel_loop(context)) return false;");
+				logo::emit_line(state,"std::int64_t counter% = t%.int_v;",loop_id,start);
+				logo::emit_line(state,"std::size_t var_count% = context->variables.length;",loop_id);
+				logo::emit_line(state,"while(true) {");
+				state->indentation += 1;
+				logo::emit_loop_body(state,for_statement.body_statements,loop_id);
+				if(for_statement.is_parallel) logo::emit_line(state,"logo::next_parallel_loop_iteration(context);");
+				logo::emit_line(state,"counter% += 1;",loop_id);
+				logo::emit_line(state,"if(counter% >= t%.int_v) break;",loop_id,end);
+				logo::emit_line(state,"context->variables[iterator%].value.int_v += 1;",loop_id);
+				for(std::size_t i = 0;i < induction_variable_count;i += 1) {
+					logo::emit_line(state,"context->variables[iterator% + %].value.int_v += steps%[%];",loop_id,i + 1,loop_id,i);
+				}
+				state->indentation -= 1;
+				logo::emit_line(state,"}");
+				logo::emit_line(state,"logo::aot_leave_scope(context,var_count%);",loop_id);
+				logo::emit_line(state,"context->variables.pop_back(%);",induction_variable_count + 1);
+				if(for_statement.is_parallel) logo::emit_line(state,"logo::leave_parallel_loop(context);");
+				state->indentation -= 1;
+				logo::emit_line(state,"}");
+				break;
+			}
+			case Ast_Statement_Type::Break_Statement: {
+				logo::emit_line(state,"break;");
+				break;
+			}
+			case Ast_Statement_Type::Continue_Statement: {
+				logo::emit_line(state,"goto continue%;",state->loop_id);
+				break;
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				//Functions are defined by 'emit_function_definitions' before the top level code runs.
+				break;
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				const auto& return_statement = statement.return_statement;
+				if(!return_statement.return_value) {
+					logo::emit_line(state,"result->type = logo::Interpreter_Value_Type::Void;");
+				}
+				else if(return_statement.is_tail_call && return_statement.can_reuse_frame) {
+					static_cast<void>(logo::emit_function_call(state,*return_statement.return_value->function_call,true));
+				}
+				else {
+					auto value = logo::emit_expression(state,*return_statement.return_value,true);
+					logo::emit_line(state,"*result = t%;",value);
+				}
+				logo::emit_line(state,"return true;");
+				break;
+			}
+			default: logo::unreachable();
+		}
+		state->indentation -= 1;
+		logo::emit_line(state,"}");
+	}
+
+	static void emit_statements(Transpiler_State* state,const Heap_Array<Ast_Statement>& statements) {
+		for(const auto& statement : statements) logo::emit_statement(state,statement);
+	}
+
+	[[nodiscard]] static bool collect_function_definitions(Transpiler_State* state,const Heap_Array<Ast_Statement>& statements) {
+		for(const auto& statement : statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Function_Definition: {
+					std::size_t function_index = statement.function_definition.function_index;
+					while(state->function_definitions.length <= function_index) {
+						if(!state->function_definitions.push_back(nullptr)) {
+							Report_Error("Couldn't allocate % bytes of memory.",sizeof(&statement));
+							return false;
+						}
+					}
+					state->function_definitions[function_index] = &statement;
+					if(!logo::collect_function_definitions(state,statement.function_definition.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					if(!logo::collect_function_definitions(state,statement.if_statement.if_true_statements)) return false;
+					if(!logo::collect_function_definitions(state,statement.if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::collect_function_definitions(state,statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					if(!logo::collect_function_definitions(state,statement.for_statement.body_statements)) return false;
+					break;
+				}
+				default: break;
+			}
+		}
+		return true;
+	}
+
+	//Defines every function of the program at the index the resolver gave it.
+	static void emit_function_definitions(Transpiler_State* state) {
+		for(std::size_t i = 0;i < state->function_definitions.length;i += 1) {
+			const auto& function_definition = state->function_definitions[i]->function_definition;
+			std::size_t arg_count = function_definition.function_arguments.length;
+			if(arg_count > 0) {
+				for(std::size_t j = 0;j < state->indentation;j += 1) logo::emit(state,"\t");
+				logo::emit(state,"static const logo::Symbol arguments%[] = {",i);
+				for(std::size_t j = 0;j < arg_count;j += 1) {
+					logo::emit(state,"logo::Symbol{%}%",logo::get_symbol_index(function_definition.function_arguments[j]),((j + 1) < arg_count) ? "," : "");
+				}
+				logo::emit(state,"};\n");
+				logo::emit_line(state,"if(!logo::aot_define_function(context,logo::Symbol{%},{arguments%,%},%,%,%,%)) return false;",logo::get_symbol_index(function_definition.name),i,arg_count,i,
+								function_definition.is_memoized,function_definition.parent_function_index,function_definition.defines_dynamic_functions);
+			}
+			else {
+				logo::emit_line(state,"if(!logo::aot_define_function(context,logo::Symbol{%},{},%,%,%,%)) return false;",logo::get_symbol_index(function_definition.name),i,
+								function_definition.is_memoized,function_definition.parent_function_index,function_definition.defines_dynamic_functions);
+			}
+		}
+	}
+
+	static void emit_function(Transpiler_State* state,const Heap_Array<Ast_Statement>& statements,String_View signature) {
+		logo::emit_line(state,"%",signature);
+		state->indentation += 1;
+		state->name_counter = 0;
+		logo::emit_line(state,"[[maybe_unused]] auto* context = &state->context;");
+		logo::emit_line(state,"[[maybe_unused]] std::size_t first_var_index = context->current_function_scope_first_var_index;");
+		if(!state->is_inside_function) logo::emit_function_definitions(state);
+		logo::emit_statements(state,statements);
+		if(state->is_inside_function) logo::emit_line(state,"result->type = logo::Interpreter_Value_Type::Void;");
+		logo::emit_line(state,"return true;");
+		state->indentation -= 1;
+		logo::emit_line(state,"}");
+		logo::emit_line(state,"");
+	}
+
+	bool emit_cpp(const Heap_Array<Ast_Statement>& statements,String_View input_file_name,std::size_t max_stack_size) {
+		Transpiler_State transpiler{};
+		auto* state = &transpiler;
+		defer[&]{
+			transpiler.output.destroy();
+			transpiler.function_definitions.destroy();
+		};
+		if(!logo::collect_function_definitions(state,statements)) return false;
+
+		logo::emit(state,"//Generated by 'logo --emit-cpp' from \"%\". Link it with the 'logo_runtime' library:\n",input_file_name);
+		logo::emit(state,"//c++ -std=c++20 -O2 -I<path to logo>/code <this file> <path to logo build>/liblogo_runtime.a -pthread\n");
+		logo::emit(state,"#include <cmath>\n#include <cstdint>\n#include <limits>\n#include \"aot_runtime.hpp\"\n\n");
+
+		for(std::size_t i = 0;i < state->function_definitions.length;i += 1) {
+			logo::emit(state,"static bool logo_function_%(logo::Aot_State* state,logo::Interpreter_Value* result);\n",i);
+		}
+		logo::emit(state,"\n");
+		state->is_inside_function = true;
+		for(std::size_t i = 0;i < state->function_definitions.length;i += 1) {
+			const auto& function_definition = state->function_definitions[i]->function_definition;
+			logo::emit(state,"//Line %: func %(",state->function_definitions[i]->line_index,logo::get_symbol_name(function_definition.name));
+			for(std::size_t j = 0;j < function_definition.function_arguments.length;j += 1) {
+				logo::emit(state,"%%",logo::get_symbol_name(function_definition.function_arguments[j]),((j + 1) < function_definition.function_arguments.length) ? "," : "");
+			}
+			logo::emit(state,")\n");
+			Array_String<128> signature{};
+			logo::format(&signature,"static bool logo_function_%(logo::Aot_State* state,logo::Interpreter_Value* result) {",i);
+			logo::emit_function(state,function_definition.body_statements,{signature.buffer,signature.byte_length});
+		}
+		state->is_inside_function = false;
+		logo::emit_function(state,statements,"static bool run_top_level_code(logo::Aot_State* state) {");
+
+		//Symbols are numbered in the order they were interned, the generated program interns them again in the same order.
+		std::size_t symbol_count = logo::get_symbol_count();
+		if(symbol_count > 0) {
+			logo::emit(state,"static const logo::String_View symbol_names[] = {\n");
+			for(std::size_t i = 0;i < symbol_count;i += 1) {
+				logo::emit(state,"\t");
+				logo::emit_string_literal(state,logo::get_symbol_name(static_cast<Symbol>(i)));
+				logo::emit(state,",\n");
+			}
+			logo::emit(state,"};\n");
+		}
+		if(state->function_definitions.length > 0) {
+			logo::emit(state,"static const logo::Aot_Function functions[] = {\n");
+			for(std::size_t i = 0;i < state->function_definitions.length;i += 1) logo::emit(state,"\tlogo_function_%,\n",i);
+			logo::emit(state,"};\n");
+		}
+		logo::emit(state,"\nint main() {\n");
+		logo::emit(state,"\tlogo::Aot_Program program{};\n");
+		if(symbol_count > 0) logo::emit(state,"\tprogram.symbol_names = {symbol_names,%};\n",symbol_count);
+		if(state->function_definitions.length > 0) logo::emit(state,"\tprogram.functions = {functions,%};\n",state->function_definitions.length);
+		logo::emit(state,"\tprogram.top_level_code = run_top_level_code;\n");
+		logo::emit(state,"\tprogram.max_stack_size = %;\n",max_stack_size);
+		logo::emit(state,"\treturn logo::run_aot_program(program);\n");
+		logo::emit(state,"}\n");
+		if(state->is_out_of_memory) {
+			Report_Error("Couldn't allocate % bytes of memory.",state->output.length + 1);
+			return false;
+		}
+		if(!logo::write_to_stdout({state->output.data,state->output.length})) {
+			Report_Error("Couldn't write the generated code to the standard output.");
+			return false;
+		}
+		return true;
+	}
+}
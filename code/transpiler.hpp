@@ -0,0 +1,16 @@
+#ifndef LOGO_TRANSPILER_HPP
+#define LOGO_TRANSPILER_HPP
+
+#include "string.hpp"
+#include "parser.hpp"
+#include "heap_array.hpp"
+
+namespace logo {
+	//Prints a C++ program that does the same as the script to the standard output. Every user defined function becomes a C++ function
+	//that runs on top of the runtime in 'aot_runtime.hpp', operations proven by the type inference pass become plain C++ expressions.
+	//The program has to be linked with the 'logo_runtime' library. Calls that go over 'max_stack_size' bytes of stack fail with an error.
+	//Expects a resolved AST.
+	[[nodiscard]] bool emit_cpp(const Heap_Array<Ast_Statement>& statements,String_View input_file_name,std::size_t max_stack_size);
+}
+
+#endif
@@ -0,0 +1,619 @@
+#include "debug.hpp"
+#include "interpreter.hpp"
+#include "type_inference.hpp"
+
+namespace logo {
+	struct Type_Inference_Variable {
+		Interpreter_Value_Type type; //'Any' if the type is not known.
+		bool is_referenced; //Variables that can be modified through references or the 'parent scope access' operator can change their type at any point.
+	};
+	//Types of the variables of the current function at one point of the program, indexed by slots. It's unreachable after 'return', 'break' and 'continue'.
+	struct Type_Inference_Environment {
+		Heap_Array<Type_Inference_Variable> variables;
+		bool is_reachable;
+		void destroy() {
+			variables.destroy();
+		}
+	};
+	struct Type_Inference_Loop {
+		std::size_t var_count; //Number of variables declared before the loop body.
+		Type_Inference_Environment break_environment;
+		Type_Inference_Environment continue_environment;
+	};
+	struct Type_Inference_State {
+		Interpreter_Context context; //Only used to look up builtin functions.
+		Type_Inference_Environment environment;
+		Heap_Array<Type_Inference_Loop> loops;
+		std::size_t current_function_first_loop_index;
+		Heap_Array<Symbol> dynamically_accessed_names; //Names used with the 'parent scope access' operator that are looked up at runtime.
+		bool is_annotating; //This is false while the types of the variables in a loop are still being computed.
+		bool report_dynamic_sites;
+		Type_Inference_Statistics statistics;
+	};
+
+	[[nodiscard]] static bool copy_environment(Type_Inference_Environment* destination,const Type_Inference_Environment& source) {
+		destination->variables.length = 0;
+		destination->is_reachable = source.is_reachable;
+		if(!destination->variables.push_back(Array_View<Type_Inference_Variable>(source.variables.data,source.variables.length))) {
+			Report_Error("Couldn't allocate % bytes of memory.",source.variables.length * sizeof(Type_Inference_Variable));
+			return false;
+		}
+		return true;
+	}
+
+	//Only the first 'var_count' variables are merged, the others are removed from 'destination'.
+	[[nodiscard]] static bool merge_environment(Type_Inference_Environment* destination,const Type_Inference_Environment& source,std::size_t var_count) {
+		if(!source.is_reachable) {
+			if(destination->variables.length > var_count) destination->variables.length = var_count;
+			return true;
+		}
+		if(!destination->is_reachable) {
+			if(!logo::copy_environment(destination,source)) return false;
+		}
+		else {
+			for(std::size_t i = 0;i < var_count;i += 1) {
+				auto& variable = destination->variables[i];
+				const auto& other_variable = source.variables[i];
+				if(variable.type != other_variable.type) variable.type = Interpreter_Value_Type::Any;
+				variable.is_referenced = variable.is_referenced || other_variable.is_referenced;
+			}
+		}
+		destination->variables.length = var_count;
+		return true;
+	}
+
+	[[nodiscard]] static bool are_environments_equal(const Type_Inference_Environment& environment0,const Type_Inference_Environment& environment1) {
+		if(environment0.is_reachable != environment1.is_reachable) return false;
+		if(environment0.variables.length != environment1.variables.length) return false;
+		for(std::size_t i = 0;i < environment0.variables.length;i += 1) {
+			if(environment0.variables[i].type != environment1.variables[i].type) return false;
+			if(environment0.variables[i].is_referenced != environment1.variables[i].is_referenced) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool push_variable(Type_Inference_State* state,Symbol name,Interpreter_Value_Type type) {
+		Type_Inference_Variable variable{};
+		variable.type = (type == Interpreter_Value_Type::Void) ? Interpreter_Value_Type::Any : type;
+		variable.is_referenced = false;
+		for(auto dynamically_accessed_name : state->dynamically_accessed_names) {
+			if(dynamically_accessed_name == name) variable.is_referenced = true;
+		}
+		if(!state->environment.variables.push_back(variable)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(variable));
+			return false;
+		}
+		return true;
+	}
+
+	//Returns the variable that the expression refers to if it's a variable of the current function.
+	[[nodiscard]] static Type_Inference_Variable* get_local_variable(Type_Inference_State* state,const Ast_Expression& expression) {
+		const Ast_Expression* value_expression = &expression;
+		if(expression.type == Ast_Expression_Type::Unary_Prefix_Operator && expression.unary_prefix_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+			value_expression = expression.unary_prefix_operator->child;
+		}
+		if(value_expression->type != Ast_Expression_Type::Value) return nullptr;
+		const auto& value = value_expression->value;
+		if(value.type != Ast_Value_Type::Identifier || value.depth != 0) return nullptr;
+		logo::assert(value.slot < state->environment.variables.length);
+		return &state->environment.variables[value.slot];
+	}
+
+	[[nodiscard]] static Interpreter_Value_Type get_variable_type(const Type_Inference_Variable& variable) {
+		return variable.is_referenced ? Interpreter_Value_Type::Any : variable.type;
+	}
+
+	[[nodiscard]] static String_View get_type_name(Interpreter_Value_Type type) {
+		switch(type) {
+			case Interpreter_Value_Type::Void: return "'Void'";
+			case Interpreter_Value_Type::Int: return "'Int'";
+			case Interpreter_Value_Type::Float: return "'Float'";
+			case Interpreter_Value_Type::Bool: return "'Bool'";
+			case Interpreter_Value_Type::String: return "'String'";
+			case Interpreter_Value_Type::Reference: return "'Reference'";
+			case Interpreter_Value_Type::Any: return "unknown type";
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static String_View get_binary_operator_name(Ast_Binary_Operator_Type type) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus: return "+";
+			case Ast_Binary_Operator_Type::Minus: return "-";
+			case Ast_Binary_Operator_Type::Multiply: return "*";
+			case Ast_Binary_Operator_Type::Divide: return "/";
+			case Ast_Binary_Operator_Type::Remainder: return "%";
+			case Ast_Binary_Operator_Type::Exponentiate: return "^";
+			case Ast_Binary_Operator_Type::Logical_And: return "and";
+			case Ast_Binary_Operator_Type::Logical_Or: return "or";
+			case Ast_Binary_Operator_Type::Compare_Equal: return "==";
+			case Ast_Binary_Operator_Type::Compare_Unequal: return "!=";
+			case Ast_Binary_Operator_Type::Compare_Less_Than: return "<";
+			case Ast_Binary_Operator_Type::Compare_Less_Than_Or_Equal: return "<=";
+			case Ast_Binary_Operator_Type::Compare_Greater_Than: return ">";
+			case Ast_Binary_Operator_Type::Compare_Greater_Than_Or_Equal: return ">=";
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static String_View get_assignment_operator_name(Ast_Assignment_Type type) {
+		switch(type) {
+			case Ast_Assignment_Type::Compound_Plus: return "+=";
+			case Ast_Assignment_Type::Compound_Minus: return "-=";
+			case Ast_Assignment_Type::Compound_Multiply: return "*=";
+			case Ast_Assignment_Type::Compound_Divide: return "/=";
+			case Ast_Assignment_Type::Compound_Remainder: return "%=";
+			case Ast_Assignment_Type::Compound_Exponentiate: return "^=";
+			default: logo::unreachable();
+		}
+	}
+
+	template<typename... Args>
+	static void report_dynamic_site(const Type_Inference_State* state,std::size_t line_index,Format_String<std::type_identity_t<Args>...> format,Args&&... args) {
+		if(!state->report_dynamic_sites) return;
+		logo::print("[Type inference] Line %: ",line_index);
+		logo::print(format,std::forward<Args>(args)...);
+		logo::print("\n");
+	}
+
+	//Unchecked integer division would trap for a zero divisor instead of reporting the error, and for -1 it can overflow.
+	//It is only proven for the other literal divisors, otherwise it stays a checked specialization.
+	[[nodiscard]] static bool can_prove_operation(Ast_Operation_Specialization specialization,const Ast_Expression& right) {
+		if(specialization != Ast_Operation_Specialization::Int_Divide && specialization != Ast_Operation_Specialization::Int_Remainder) return true;
+		if(right.type != Ast_Expression_Type::Value || right.value.type != Ast_Value_Type::Int_Literal) return false;
+		return right.value.int_value != 0 && right.value.int_value != -1;
+	}
+
+	//Type of the result of an arithmetic operation or a compound assignment, if it doesn't fail.
+	[[nodiscard]] static Interpreter_Value_Type get_arithmetic_result_type(Interpreter_Value_Type left_type,Interpreter_Value_Type right_type) {
+		bool is_left_number = (left_type == Interpreter_Value_Type::Int || left_type == Interpreter_Value_Type::Float);
+		bool is_right_number = (right_type == Interpreter_Value_Type::Int || right_type == Interpreter_Value_Type::Float);
+		if(!is_left_number || !is_right_number) return Interpreter_Value_Type::Any;
+		if(left_type == Interpreter_Value_Type::Int && right_type == Interpreter_Value_Type::Int) return Interpreter_Value_Type::Int;
+		return Interpreter_Value_Type::Float;
+	}
+
+	[[nodiscard]] static Interpreter_Value_Type get_binary_operation_result_type(Ast_Binary_Operator_Type type,Interpreter_Value_Type left_type,Interpreter_Value_Type right_type) {
+		switch(type) {
+			case Ast_Binary_Operator_Type::Plus:
+			case Ast_Binary_Operator_Type::Minus:
+			case Ast_Binary_Operator_Type::Multiply:
+			case Ast_Binary_Operator_Type::Divide:
+			case Ast_Binary_Operator_Type::Remainder:
+			case Ast_Binary_Operator_Type::Exponentiate: return logo::get_arithmetic_result_type(left_type,right_type);
+			//These either fail or return a bool.
+			default: return Interpreter_Value_Type::Bool;
+		}
+	}
+
+	//Builtin functions are looked up before user defined functions.
+	[[nodiscard]] static const Interpreter_Builtin_Function* find_builtin_function(const Ast_Function_Call& function_call) {
+		auto [function_index,function_found] = logo::find_builtin_function(function_call.name,function_call.arguments.length);
+		return function_found ? &logo::get_builtin_function(function_index) : nullptr;
+	}
+
+	[[nodiscard]] static bool is_accepted_argument_type(Interpreter_Value_Type required_type,Interpreter_Value_Type type) {
+		if(type == Interpreter_Value_Type::Any || type == Interpreter_Value_Type::Void) return false;
+		if(required_type == Interpreter_Value_Type::Any || required_type == type) return true;
+		return required_type == Interpreter_Value_Type::Int_Or_Float && (type == Interpreter_Value_Type::Int || type == Interpreter_Value_Type::Float);
+	}
+
+	[[nodiscard]] static Interpreter_Value_Type infer_expression_type(Type_Inference_State* state,Ast_Expression* expression);
+
+	//Either branch of a conditional expression can be the lvalue, so the variables in both of them can be modified through it.
+	static void infer_lvalue_expression(Type_Inference_State* state,Ast_Expression* expression) {
+		auto* variable = logo::get_local_variable(state,*expression);
+		if(variable) variable->is_referenced = true;
+		else if(expression->type == Ast_Expression_Type::Conditional) {
+			static_cast<void>(logo::infer_expression_type(state,expression->conditional->condition));
+			logo::infer_lvalue_expression(state,expression->conditional->if_true);
+			logo::infer_lvalue_expression(state,expression->conditional->if_false);
+		}
+		else static_cast<void>(logo::infer_expression_type(state,expression));
+	}
+
+	static Interpreter_Value_Type infer_expression_type(Type_Inference_State* state,Ast_Expression* expression) {
+		switch(expression->type) {
+			case Ast_Expression_Type::Value: {
+				switch(expression->value.type) {
+					case Ast_Value_Type::Identifier: return logo::get_variable_type(*logo::get_local_variable(state,*expression));
+					case Ast_Value_Type::Int_Literal: return Interpreter_Value_Type::Int;
+					case Ast_Value_Type::Float_Literal: return Interpreter_Value_Type::Float;
+					case Ast_Value_Type::Bool_Literal: return Interpreter_Value_Type::Bool;
+					case Ast_Value_Type::String_Literal: return Interpreter_Value_Type::String;
+					default: logo::unreachable();
+				}
+			}
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				auto* unary_operator = expression->unary_prefix_operator;
+				switch(unary_operator->type) {
+					case Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access: {
+						auto* variable = logo::get_local_variable(state,*expression);
+						return variable ? logo::get_variable_type(*variable) : Interpreter_Value_Type::Any;
+					}
+					case Ast_Unary_Prefix_Operator_Type::Reference: {
+						logo::infer_lvalue_expression(state,unary_operator->child);
+						return Interpreter_Value_Type::Reference;
+					}
+					case Ast_Unary_Prefix_Operator_Type::Dereference: {
+						static_cast<void>(logo::infer_expression_type(state,unary_operator->child));
+						return Interpreter_Value_Type::Any;
+					}
+					case Ast_Unary_Prefix_Operator_Type::Logical_Not: {
+						static_cast<void>(logo::infer_expression_type(state,unary_operator->child));
+						return Interpreter_Value_Type::Bool;
+					}
+					case Ast_Unary_Prefix_Operator_Type::Plus:
+					case Ast_Unary_Prefix_Operator_Type::Minus: {
+						auto type = logo::infer_expression_type(state,unary_operator->child);
+						if(type == Interpreter_Value_Type::Int || type == Interpreter_Value_Type::Float) return type;
+						return Interpreter_Value_Type::Any;
+					}
+					default: logo::unreachable();
+				}
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				auto* binary_operator = expression->binary_operator;
+				auto left_type = logo::infer_expression_type(state,binary_operator->left);
+				auto right_type = logo::infer_expression_type(state,binary_operator->right);
+				if(state->is_annotating) {
+					auto specialization = logo::specialize_binary_operation(binary_operator->type,left_type,right_type);
+					if(specialization != Ast_Operation_Specialization::None && !logo::can_prove_operation(specialization,*binary_operator->right)) {
+						binary_operator->cache.specialization = specialization;
+						state->statistics.dynamic_operation_count += 1;
+						logo::report_dynamic_site(state,binary_operator->line_index,"Operator '%' is checked at runtime, its divisor can be 0.",logo::get_binary_operator_name(binary_operator->type));
+					}
+					else if(specialization != Ast_Operation_Specialization::None) {
+						binary_operator->cache.specialization = specialization;
+						binary_operator->cache.is_proven = true;
+						state->statistics.proven_operation_count += 1;
+					}
+					else {
+						state->statistics.dynamic_operation_count += 1;
+						logo::report_dynamic_site(state,binary_operator->line_index,"Operator '%' is checked at runtime, its operands are of % and %.",
+												  logo::get_binary_operator_name(binary_operator->type),logo::get_type_name(left_type),logo::get_type_name(right_type));
+					}
+				}
+				return logo::get_binary_operation_result_type(binary_operator->type,left_type,right_type);
+			}
+			case Ast_Expression_Type::Conditional: {
+				auto* conditional = expression->conditional;
+				static_cast<void>(logo::infer_expression_type(state,conditional->condition));
+				auto if_true_type = logo::infer_expression_type(state,conditional->if_true);
+				auto if_false_type = logo::infer_expression_type(state,conditional->if_false);
+				return (if_true_type == if_false_type) ? if_true_type : Interpreter_Value_Type::Any;
+			}
+			case Ast_Expression_Type::Function_Call: {
+				auto* function_call = expression->function_call;
+				Static_Array<Interpreter_Value_Type,16> arg_types{};
+				for(auto* arg_expr : function_call->arguments) {
+					auto type = logo::infer_expression_type(state,arg_expr);
+					//Calls with too many arguments fail at runtime.
+					if(!arg_types.push_back(type)) return Interpreter_Value_Type::Any;
+				}
+				if(function_call->name == state->context.print_symbol) return Interpreter_Value_Type::Void;
+
+				const auto* builtin_function = logo::find_builtin_function(*function_call);
+				if(!builtin_function) return Interpreter_Value_Type::Any;
+				if(state->is_annotating) {
+					bool are_argument_types_proven = true;
+					for(std::size_t i = 0;i < arg_types.length;i += 1) {
+						if(!logo::is_accepted_argument_type(logo::get_builtin_argument_type(*builtin_function,i),arg_types[i])) are_argument_types_proven = false;
+					}
+					if(are_argument_types_proven) {
+						function_call->cache.are_argument_types_proven = true;
+						state->statistics.proven_call_count += 1;
+					}
+					else {
+						state->statistics.dynamic_call_count += 1;
+						logo::report_dynamic_site(state,function_call->line_index,"Arguments of '%' are checked at runtime.",logo::get_symbol_name(function_call->name));
+					}
+				}
+				return builtin_function->return_type;
+			}
+			case Ast_Expression_Type::Array_Access: {
+				return Interpreter_Value_Type::Any;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool infer_statements(Type_Inference_State* state,Heap_Array<Ast_Statement>* statements);
+
+	[[nodiscard]] static bool infer_scope(Type_Inference_State* state,Heap_Array<Ast_Statement>* statements) {
+		std::size_t var_count = state->environment.variables.length;
+		if(!logo::infer_statements(state,statements)) return false;
+		state->environment.variables.length = var_count;
+		return true;
+	}
+
+	//Runs one iteration of a loop starting from the types in 'head'. 'next_head' receives the types at the start of the next iteration
+	//and 'exit' receives the types after the loop.
+	[[nodiscard]] static bool infer_loop_iteration(Type_Inference_State* state,Ast_Expression* condition_expr,Heap_Array<Ast_Statement>* body_statements,
+												   const Type_Inference_Environment& head,Type_Inference_Environment* next_head,Type_Inference_Environment* exit) {
+		if(!logo::copy_environment(&state->environment,head)) return false;
+		if(condition_expr) static_cast<void>(logo::infer_expression_type(state,condition_expr));
+
+		Type_Inference_Loop loop{};
+		loop.var_count = head.variables.length;
+		if(!state->loops.push_back(loop)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(loop));
+			return false;
+		}
+		bool success = logo::infer_scope(state,body_statements);
+		loop = state->loops[state->loops.length - 1];
+		state->loops.pop_back();
+		defer[&]{
+			loop.break_environment.destroy();
+			loop.continue_environment.destroy();
+		};
+		if(!success) return false;
+
+		if(!logo::copy_environment(next_head,head)) return false;
+		if(!logo::merge_environment(next_head,state->environment,loop.var_count)) return false;
+		if(!logo::merge_environment(next_head,loop.continue_environment,loop.var_count)) return false;
+		if(!logo::copy_environment(exit,head)) return false;
+		return logo::merge_environment(exit,loop.break_environment,loop.var_count);
+	}
+
+	//The body is analyzed with the types the variables have before the loop until the types at the start of an iteration stop changing.
+	//Only then the operations inside of it are annotated.
+	[[nodiscard]] static bool infer_loop(Type_Inference_State* state,Ast_Expression* condition_expr,Heap_Array<Ast_Statement>* body_statements) {
+		Type_Inference_Environment head{};
+		Type_Inference_Environment next_head{};
+		Type_Inference_Environment exit{};
+		defer[&]{
+			head.destroy();
+			next_head.destroy();
+			exit.destroy();
+		};
+		if(!logo::copy_environment(&head,state->environment)) return false;
+
+		bool is_annotating = state->is_annotating;
+		state->is_annotating = false;
+		while(true) {
+			if(!logo::infer_loop_iteration(state,condition_expr,body_statements,head,&next_head,&exit)) return false;
+			if(logo::are_environments_equal(head,next_head)) break;
+			if(!logo::copy_environment(&head,next_head)) return false;
+		}
+		state->is_annotating = is_annotating;
+		if(is_annotating) {
+			if(!logo::infer_loop_iteration(state,condition_expr,body_statements,head,&next_head,&exit)) return false;
+		}
+		return logo::copy_environment(&state->environment,exit);
+	}
+
+	[[nodiscard]] static bool infer_statement(Type_Inference_State* state,Ast_Statement* statement) {
+		switch(statement->type) {
+			case Ast_Statement_Type::Expression: {
+				static_cast<void>(logo::infer_expression_type(state,&statement->expression));
+				return true;
+			}
+			case Ast_Statement_Type::Declaration: {
+				auto type = logo::infer_expression_type(state,&statement->declaration.initial_value_expr);
+				return logo::push_variable(state,statement->declaration.name,type);
+			}
+			case Ast_Statement_Type::Assignment: {
+				auto& assignment = statement->assignment;
+				auto* variable = logo::get_local_variable(state,assignment.lvalue_expr);
+				auto target_type = Interpreter_Value_Type::Any;
+				if(variable) target_type = logo::get_variable_type(*variable);
+				else logo::infer_lvalue_expression(state,&assignment.lvalue_expr);
+				auto value_type = logo::infer_expression_type(state,&assignment.rvalue_expr);
+
+				auto result_type = value_type;
+				if(assignment.type != Ast_Assignment_Type::Assignment) {
+					result_type = logo::get_arithmetic_result_type(target_type,value_type);
+					if(state->is_annotating) {
+						auto specialization = logo::specialize_compound_assignment(assignment.type,target_type,value_type);
+						if(specialization != Ast_Operation_Specialization::None && !logo::can_prove_operation(specialization,assignment.rvalue_expr)) {
+							assignment.cache.specialization = specialization;
+							state->statistics.dynamic_operation_count += 1;
+							logo::report_dynamic_site(state,assignment.line_index,"Compound assignment '%' is checked at runtime, its divisor can be 0.",logo::get_assignment_operator_name(assignment.type));
+						}
+						else if(specialization != Ast_Operation_Specialization::None) {
+							assignment.cache.specialization = specialization;
+							assignment.cache.is_proven = true;
+							state->statistics.proven_operation_count += 1;
+						}
+						else {
+							state->statistics.dynamic_operation_count += 1;
+							logo::report_dynamic_site(state,assignment.line_index,"Compound assignment '%' is checked at runtime, its operands are of % and %.",
+													  logo::get_assignment_operator_name(assignment.type),logo::get_type_name(target_type),logo::get_type_name(value_type));
+						}
+					}
+				}
+				if(variable) variable->type = (result_type == Interpreter_Value_Type::Void) ? Interpreter_Value_Type::Any : result_type;
+				return true;
+			}
+			case Ast_Statement_Type::If_Statement: {
+				auto& if_statement = statement->if_statement;
+				static_cast<void>(logo::infer_expression_type(state,&if_statement.condition_expr));
+
+				std::size_t var_count = state->environment.variables.length;
+				Type_Inference_Environment if_true_environment{};
+				defer[&]{if_true_environment.destroy();};
+				if(!logo::copy_environment(&if_true_environment,state->environment)) return false;
+				if(!logo::infer_scope(state,&if_statement.if_false_statements)) return false;
+
+				//'if_true_environment' and the current environment are swapped so that the result is stored in the current one.
+				auto if_false_variables = state->environment.variables;
+				bool is_if_false_reachable = state->environment.is_reachable;
+				state->environment.variables = if_true_environment.variables;
+				state->environment.is_reachable = if_true_environment.is_reachable;
+				if_true_environment.variables = if_false_variables;
+				if_true_environment.is_reachable = is_if_false_reachable;
+
+				if(!logo::infer_scope(state,&if_statement.if_true_statements)) return false;
+				return logo::merge_environment(&state->environment,if_true_environment,var_count);
+			}
+			case Ast_Statement_Type::While_Statement: {
+				return logo::infer_loop(state,&statement->while_statement.condition_expr,&statement->while_statement.body_statements);
+			}
+			case Ast_Statement_Type::For_Statement: {
+				auto& for_statement = statement->for_statement;
+				static_cast<void>(logo::infer_expression_type(state,&for_statement.start_expr));
+				static_cast<void>(logo::infer_expression_type(state,&for_statement.end_expr));
+
+				std::size_t var_count = state->environment.variables.length;
+				if(!logo::push_variable(state,for_statement.iterator_identifier,Interpreter_Value_Type::Int)) return false;
+				for(auto& induction_variable : for_statement.induction_variables) {
+					static_cast<void>(logo::infer_expression_type(state,&induction_variable.step_expr));
+					if(!logo::push_variable(state,induction_variable.name,Interpreter_Value_Type::Int)) return false;
+				}
+				if(!logo::infer_loop(state,nullptr,&for_statement.body_statements)) return false;
+				state->environment.variables.length = var_count;
+				return true;
+			}
+			case Ast_Statement_Type::Break_Statement:
+			case Ast_Statement_Type::Continue_Statement: {
+				if(state->loops.length > state->current_function_first_loop_index) {
+					auto& loop = state->loops[state->loops.length - 1];
+					auto* environment = (statement->type == Ast_Statement_Type::Break_Statement) ? &loop.break_environment : &loop.continue_environment;
+					if(!logo::merge_environment(environment,state->environment,loop.var_count)) return false;
+				}
+				state->environment.is_reachable = false;
+				return true;
+			}
+			case Ast_Statement_Type::Function_Definition: {
+				//Function bodies only see their own variables, the variables of the caller can only be accessed by name.
+				auto outer_environment = state->environment;
+				std::size_t copy_loop_index = state->current_function_first_loop_index;
+				state->environment = {};
+				state->environment.is_reachable = true;
+				state->current_function_first_loop_index = state->loops.length;
+				defer[&]{
+					state->environment.destroy();
+					state->environment = outer_environment;
+					state->current_function_first_loop_index = copy_loop_index;
+				};
+				for(auto argument : statement->function_definition.function_arguments) {
+					if(!logo::push_variable(state,argument,Interpreter_Value_Type::Any)) return false;
+				}
+				return logo::infer_statements(state,&statement->function_definition.body_statements);
+			}
+			case Ast_Statement_Type::Return_Statement: {
+				if(statement->return_statement.return_value) static_cast<void>(logo::infer_expression_type(state,statement->return_statement.return_value));
+				state->environment.is_reachable = false;
+				return true;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	//Statements after 'return', 'break' or 'continue' are never executed so they are skipped.
+	[[nodiscard]] static bool infer_statements(Type_Inference_State* state,Heap_Array<Ast_Statement>* statements) {
+		for(auto& statement : *statements) {
+			if(!state->environment.is_reachable) break;
+			if(!logo::infer_statement(state,&statement)) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static bool collect_dynamically_accessed_names(Type_Inference_State* state,const Ast_Expression& expression) {
+		switch(expression.type) {
+			case Ast_Expression_Type::Value:
+			case Ast_Expression_Type::Array_Access: return true;
+			case Ast_Expression_Type::Unary_Prefix_Operator: {
+				const auto* unary_operator = expression.unary_prefix_operator;
+				if(unary_operator->type == Ast_Unary_Prefix_Operator_Type::Parent_Scope_Access) {
+					const auto& value = unary_operator->child->value;
+					if(value.depth == 0) return true;
+					for(auto name : state->dynamically_accessed_names) {
+						if(name == value.identfier_name) return true;
+					}
+					if(!state->dynamically_accessed_names.push_back(value.identfier_name)) {
+						Report_Error("Couldn't allocate % bytes of memory.",sizeof(Symbol));
+						return false;
+					}
+					return true;
+				}
+				return logo::collect_dynamically_accessed_names(state,*unary_operator->child);
+			}
+			case Ast_Expression_Type::Binary_Operator: {
+				if(!logo::collect_dynamically_accessed_names(state,*expression.binary_operator->left)) return false;
+				return logo::collect_dynamically_accessed_names(state,*expression.binary_operator->right);
+			}
+			case Ast_Expression_Type::Conditional: {
+				if(!logo::collect_dynamically_accessed_names(state,*expression.conditional->condition)) return false;
+				if(!logo::collect_dynamically_accessed_names(state,*expression.conditional->if_true)) return false;
+				return logo::collect_dynamically_accessed_names(state,*expression.conditional->if_false);
+			}
+			case Ast_Expression_Type::Function_Call: {
+				for(const auto* arg_expr : expression.function_call->arguments) {
+					if(!logo::collect_dynamically_accessed_names(state,*arg_expr)) return false;
+				}
+				return true;
+			}
+			default: logo::unreachable();
+		}
+	}
+
+	[[nodiscard]] static bool collect_dynamically_accessed_names(Type_Inference_State* state,const Heap_Array<Ast_Statement>& statements) {
+		for(const auto& statement : statements) {
+			switch(statement.type) {
+				case Ast_Statement_Type::Expression: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.expression)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Declaration: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.declaration.initial_value_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Assignment: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.assignment.lvalue_expr)) return false;
+					if(!logo::collect_dynamically_accessed_names(state,statement.assignment.rvalue_expr)) return false;
+					break;
+				}
+				case Ast_Statement_Type::If_Statement: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.if_statement.condition_expr)) return false;
+					if(!logo::collect_dynamically_accessed_names(state,statement.if_statement.if_true_statements)) return false;
+					if(!logo::collect_dynamically_accessed_names(state,statement.if_statement.if_false_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::While_Statement: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.while_statement.condition_expr)) return false;
+					if(!logo::collect_dynamically_accessed_names(state,statement.while_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::For_Statement: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.for_statement.start_expr)) return false;
+					if(!logo::collect_dynamically_accessed_names(state,statement.for_statement.end_expr)) return false;
+					if(!logo::collect_dynamically_accessed_names(state,statement.for_statement.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Function_Definition: {
+					if(!logo::collect_dynamically_accessed_names(state,statement.function_definition.body_statements)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Return_Statement: {
+					if(!statement.return_statement.return_value) break;
+					if(!logo::collect_dynamically_accessed_names(state,*statement.return_statement.return_value)) return false;
+					break;
+				}
+				case Ast_Statement_Type::Break_Statement:
+				case Ast_Statement_Type::Continue_Statement: break;
+				default: logo::unreachable();
+			}
+		}
+		return true;
+	}
+
+	Option<Type_Inference_Statistics> infer_types(Heap_Array<Ast_Statement>* statements,bool report_dynamic_sites) {
+		Type_Inference_State state{};
+		if(!logo::init_interpreter_context(&state.context)) return {};
+		defer[&]{
+			logo::destroy_interpreter_context(&state.context);
+			state.environment.destroy();
+			state.loops.destroy();
+			state.dynamically_accessed_names.destroy();
+		};
+		state.environment.is_reachable = true;
+		state.is_annotating = true;
+		state.report_dynamic_sites = report_dynamic_sites;
+
+		if(!logo::collect_dynamically_accessed_names(&state,*statements)) return {};
+		if(!logo::infer_statements(&state,statements)) return {};
+		return state.statistics;
+	}
+}
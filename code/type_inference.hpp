@@ -0,0 +1,23 @@
+#ifndef LOGO_TYPE_INFERENCE_HPP
+#define LOGO_TYPE_INFERENCE_HPP
+
+#include "utils.hpp"
+#include "parser.hpp"
+#include "heap_array.hpp"
+
+namespace logo {
+	struct Type_Inference_Statistics {
+		std::size_t proven_operation_count;
+		std::size_t dynamic_operation_count;
+		std::size_t proven_call_count;
+		std::size_t dynamic_call_count;
+	};
+	//Follows the types of the variables of every function and of the top level code through the program. Binary operators and compound assignments
+	//whose operands are proven to be two ints, two floats or two bools are marked so that the interpreter and the VM don't check the operand types,
+	//calls to builtin functions whose argument types are proven are marked so that the arguments are not checked.
+	//If 'report_dynamic_sites' is true, every operation and builtin function call that still has to be checked at runtime is printed.
+	//Expects a resolved AST.
+	[[nodiscard]] Option<Type_Inference_Statistics> infer_types(Heap_Array<Ast_Statement>* statements,bool report_dynamic_sites);
+}
+
+#endif
@@ -82,7 +82,7 @@ namespace logo {
 	}
 
 	template<typename T,std::size_t Count>
-	[[nodiscard]] constexpr std::size_t array_length(const T(&array)[Count]) {
+	[[nodiscard]] constexpr std::size_t array_length(const T(&)[Count]) {
 		return Count;
 	}
 
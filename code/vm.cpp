@@ -0,0 +1,643 @@
+#include <cmath>
+#include "vm.hpp"
+#include "jit.hpp"
+#include "debug.hpp"
+#include "interpreter.hpp"
+
+//GCC and Clang support taking addresses of labels which lets every instruction jump directly to the next one.
+#if defined(__GNUC__) || defined(__clang__)
+#define LOGO_VM_COMPUTED_GOTO
+#endif
+
+namespace logo {
+	struct Vm_Scope {
+		std::size_t var_count;
+	};
+	struct Vm_Call_Frame {
+		std::size_t return_index;
+		std::size_t first_var_index;
+		std::size_t var_count;
+		std::size_t scope_count;
+		std::size_t stack_length; //The arguments of a memoized call stay on the stack until its result is stored.
+		Interpreter_Function* memoized_function;
+		bool is_in_dynamic_scope; //The called function was put on 'Interpreter_Context::dynamic_scope'.
+	};
+	struct Vm_State {
+		Interpreter_Context* context; //Owned by the caller of 'run_bytecode'.
+		Heap_Array<Interpreter_Value> stack;
+		Heap_Array<Vm_Scope> scopes;
+		Heap_Array<Vm_Call_Frame> call_frames;
+		Heap_Array<Ast_Function_Call_Cache> call_site_caches;
+		Heap_Array<std::uint8_t> deoptimization_counts; //One for every instruction.
+		std::size_t max_stack_size;
+		Jit_State jit;
+		void destroy() {
+			jit.destroy();
+			deoptimization_counts.destroy();
+			call_site_caches.destroy();
+			call_frames.destroy();
+			scopes.destroy();
+			stack.destroy();
+		}
+	};
+
+	[[nodiscard]] static bool push_value(Vm_State* state,const Interpreter_Value& value) {
+		if(!state->stack.push_back(value)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(value));
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] static Interpreter_Value pop_value(Vm_State* state) {
+		state->stack.length -= 1;
+		return state->stack.data[state->stack.length];
+	}
+
+	[[nodiscard]] static bool push_lvalue(Vm_State* state,std::size_t var_index) {
+		return logo::push_value(state,logo::make_lvalue(var_index));
+	}
+
+	[[nodiscard]] static bool check_call_arguments(Array_View<Interpreter_Value> args,std::size_t line_index) {
+		for(const auto& arg : args) {
+			if(arg.type == Interpreter_Value_Type::Void) {
+				logo::report_interpreter_error(line_index,"Cannot assign value of type 'Void' to a function parameter.");
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static void quicken_instruction(Vm_State* state,Bytecode_Program* program,std::size_t instruction_index,Bytecode_Opcode opcode) {
+		if(state->deoptimization_counts[instruction_index] < MAX_DEOPTIMIZATION_COUNT) program->instructions[instruction_index].opcode = opcode;
+	}
+
+	static void deoptimize_instruction(Vm_State* state,Bytecode_Program* program,std::size_t instruction_index,Bytecode_Opcode generic_opcode) {
+		program->instructions[instruction_index].opcode = generic_opcode;
+		state->deoptimization_counts[instruction_index] += 1;
+	}
+
+	//Quickened integer divisions by zero turn back into the generic instruction, which reports the error.
+	[[nodiscard]] static bool is_division_by_zero(Bytecode_Opcode opcode,const Interpreter_Value& right) {
+		if(!logo::is_one_of(opcode,Bytecode_Opcode::Divide_Int,Bytecode_Opcode::Remainder_Int,Bytecode_Opcode::Assign_Divide_Int,Bytecode_Opcode::Assign_Remainder_Int)) return false;
+		return right.int_v == 0;
+	}
+
+	//Calls the function of a call site with the arguments on top of the stack. Calls to user defined functions set 'ip' to the first instruction of the function.
+	//If 'reuse_frame' is true, the call is in tail position and nothing can refer to the variables of the current function, so its frame is replaced
+	//by the one of the called function.
+	[[nodiscard]] static bool call_function(Vm_State* state,Bytecode_Program* program,std::size_t call_site_index,std::size_t* ip,bool reuse_frame) {
+		auto* context = state->context;
+		auto line_index = program->line_indices[*ip - 1];
+		const auto& call_site = program->call_sites[call_site_index];
+		std::size_t first_arg_index = state->stack.length - call_site.arg_count;
+		Array_View<Interpreter_Value> args(state->stack.data + first_arg_index,call_site.arg_count);
+		if(!call_site.are_argument_types_proven && !logo::check_call_arguments(args,line_index)) return false;
+
+		auto [target,target_found] = logo::find_call_target(context,&state->call_site_caches[call_site_index],call_site.name,call_site.function_index,args,line_index);
+		if(!target_found) return false;
+		if(target.builtin_function) {
+			auto [result,success] = target.builtin_function->func_ptr(context,line_index,args);
+			if(!success) return false;
+			state->stack.length = first_arg_index;
+			return logo::push_value(state,result);
+		}
+		auto* function = &context->functions[static_cast<std::size_t>(target.function - context->functions.data)];
+		if(!logo::count_watchdog_step(context,line_index)) return false;
+		bool is_memoized_call = logo::can_memoize_call(function,args);
+		if(is_memoized_call) {
+			auto [result,found] = logo::find_memoized_result(context,function,args);
+			if(found) {
+				state->stack.length = first_arg_index;
+				return logo::push_value(state,result);
+			}
+		}
+		else {
+			Interpreter_Value jit_result{};
+			auto jit_call_result = logo::call_jit_function(&state->jit,context,function,args,&jit_result);
+			if(jit_call_result == Jit_Call_Result::Stopped) return false;
+			if(jit_call_result == Jit_Call_Result::Returned) {
+				state->stack.length = first_arg_index;
+				return logo::push_value(state,jit_result);
+			}
+		}
+		auto argument_names = function->arguments;
+		auto code_offset = function->code_offset;
+
+		//A memoized call in tail position doesn't get a frame of its own, its result is only stored for the call whose frame it takes over.
+		auto* current_frame = (state->call_frames.length > 0) ? &state->call_frames[state->call_frames.length - 1] : nullptr;
+		if(reuse_frame && current_frame) {
+			//Functions put on the dynamic scope never reuse their frame, see 'can_reuse_frame' in the resolver.
+			if(function->defines_dynamic_functions) {
+				if(!logo::enter_dynamic_scope(context,function)) return false;
+				current_frame->is_in_dynamic_scope = true;
+			}
+			//The arguments stay in the unused part of the stack until they are copied.
+			context->variables.length = context->current_function_scope_first_var_index;
+			state->scopes.length = current_frame->scope_count;
+			for(std::size_t i = 0;i < args.length;i += 1) {
+				if(!logo::push_variable(context,argument_names[i],args[i])) return false;
+			}
+			state->stack.length = current_frame->stack_length;
+			*ip = code_offset;
+			return true;
+		}
+
+		std::size_t stack_size = state->call_frames.length * sizeof(Vm_Call_Frame) + state->stack.length * sizeof(Interpreter_Value) +
+								 state->scopes.length * sizeof(Vm_Scope) + context->variables.length * sizeof(Interpreter_Variable);
+		if(stack_size > state->max_stack_size) {
+			logo::report_interpreter_error(line_index,"Call stack exceeded the limit of % bytes.",state->max_stack_size);
+			return false;
+		}
+
+		Vm_Call_Frame frame{};
+		frame.return_index = *ip;
+		frame.first_var_index = context->current_function_scope_first_var_index;
+		frame.var_count = context->variables.length;
+		frame.scope_count = state->scopes.length;
+		frame.stack_length = first_arg_index;
+		if(is_memoized_call) {
+			frame.stack_length += args.length;
+			frame.memoized_function = function;
+		}
+		frame.is_in_dynamic_scope = function->defines_dynamic_functions;
+		if(frame.is_in_dynamic_scope && !logo::enter_dynamic_scope(context,function)) return false;
+		if(!state->call_frames.push_back(frame)) {
+			Report_Error("Couldn't allocate % bytes of memory.",sizeof(frame));
+			return false;
+		}
+
+		context->current_function_scope_first_var_index = context->variables.length;
+		for(std::size_t i = 0;i < args.length;i += 1) {
+			if(!logo::push_variable(context,argument_names[i],args[i])) return false;
+		}
+		state->stack.length = frame.stack_length;
+		*ip = code_offset;
+		return true;
+	}
+
+	[[nodiscard]] static bool execute(Vm_State* state,Bytecode_Program* program) {
+		auto* context = state->context;
+		const Bytecode_Instruction* instruction = nullptr;
+		std::size_t ip = 0;
+
+#ifdef LOGO_VM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define LOGO_VM_OPCODE_LABEL_ADDRESS(NAME) &&label_##NAME,
+		static void* const dispatch_table[] = {LOGO_BYTECODE_OPCODES(LOGO_VM_OPCODE_LABEL_ADDRESS)};
+#undef LOGO_VM_OPCODE_LABEL_ADDRESS
+#define LOGO_VM_CASE(NAME) label_##NAME:
+#define LOGO_VM_DISPATCH() do { instruction = &program->instructions[ip]; ip += 1; goto *dispatch_table[static_cast<std::size_t>(instruction->opcode)]; } while(false)
+		LOGO_VM_DISPATCH();
+#else
+#define LOGO_VM_CASE(NAME) case Bytecode_Opcode::NAME:
+#define LOGO_VM_DISPATCH() continue
+		while(true) {
+			instruction = &program->instructions[ip];
+			ip += 1;
+			switch(instruction->opcode) {
+#endif
+#define LOGO_VM_LINE_INDEX (program->line_indices[ip - 1])
+#define LOGO_VM_UNARY_OPERATION(NAME,TYPE)\
+		LOGO_VM_CASE(NAME) {\
+			auto [result,success] = logo::compute_unary_operation(Ast_Unary_Prefix_Operator_Type::TYPE,state->stack[state->stack.length - 1],LOGO_VM_LINE_INDEX);\
+			if(!success) return false;\
+			state->stack[state->stack.length - 1] = result;\
+			LOGO_VM_DISPATCH();\
+		}
+#define LOGO_VM_BINARY_OPERATION(NAME,TYPE)\
+		LOGO_VM_CASE(NAME) {\
+			auto specialization = logo::specialize_binary_operation(Ast_Binary_Operator_Type::TYPE,state->stack[state->stack.length - 2].type,state->stack[state->stack.length - 1].type);\
+			if(specialization != Ast_Operation_Specialization::None) logo::quicken_instruction(state,program,ip - 1,logo::get_specialized_binary_opcode(specialization));\
+			auto [result,success] = logo::compute_binary_operation(Ast_Binary_Operator_Type::TYPE,state->stack[state->stack.length - 2],state->stack[state->stack.length - 1],LOGO_VM_LINE_INDEX);\
+			if(!success) return false;\
+			state->stack.length -= 1;\
+			state->stack[state->stack.length - 1] = result;\
+			LOGO_VM_DISPATCH();\
+		}
+		//Quickened instructions that see operands of other types turn back into the generic instruction and execute it again.
+		//The '_Unchecked' versions are emitted only if the type inference pass proved the operand types.
+#define LOGO_VM_QUICKENED_BINARY_OPERATION(NAME,GENERIC_NAME,OPERAND_TYPE,RESULT_TYPE,RESULT_FIELD,EXPRESSION)\
+		LOGO_VM_CASE(NAME) {\
+			auto& left = state->stack[state->stack.length - 2];\
+			const auto& right = state->stack[state->stack.length - 1];\
+			if(left.type != Interpreter_Value_Type::OPERAND_TYPE || right.type != Interpreter_Value_Type::OPERAND_TYPE || logo::is_division_by_zero(Bytecode_Opcode::NAME,right)) {\
+				logo::deoptimize_instruction(state,program,ip - 1,Bytecode_Opcode::GENERIC_NAME);\
+				ip -= 1;\
+				LOGO_VM_DISPATCH();\
+			}\
+			left.RESULT_FIELD = (EXPRESSION);\
+			left.type = Interpreter_Value_Type::RESULT_TYPE;\
+			state->stack.length -= 1;\
+			LOGO_VM_DISPATCH();\
+		}\
+		LOGO_VM_CASE(NAME##_Unchecked) {\
+			auto& left = state->stack[state->stack.length - 2];\
+			const auto& right = state->stack[state->stack.length - 1];\
+			left.RESULT_FIELD = (EXPRESSION);\
+			left.type = Interpreter_Value_Type::RESULT_TYPE;\
+			state->stack.length -= 1;\
+			LOGO_VM_DISPATCH();\
+		}
+#define LOGO_VM_QUICKENED_ASSIGNMENT(NAME,OPERAND_TYPE,FIELD,EXPRESSION)\
+		LOGO_VM_CASE(NAME) {\
+			const auto& target = state->stack[state->stack.length - 2];\
+			const auto& right = state->stack[state->stack.length - 1];\
+			if(target.type == Interpreter_Value_Type::Lvalue && !logo::check_parallel_loop_assignment(context,target.var_index,LOGO_VM_LINE_INDEX)) return false;\
+			if(target.type == Interpreter_Value_Type::Lvalue && right.type == Interpreter_Value_Type::OPERAND_TYPE) {\
+				auto& left = context->variables[target.var_index].value;\
+				if(left.type == Interpreter_Value_Type::OPERAND_TYPE && !logo::is_division_by_zero(Bytecode_Opcode::NAME,right)) {\
+					left.FIELD = (EXPRESSION);\
+					state->stack.length -= 2;\
+					LOGO_VM_DISPATCH();\
+				}\
+			}\
+			logo::deoptimize_instruction(state,program,ip - 1,Bytecode_Opcode::Assign);\
+			ip -= 1;\
+			LOGO_VM_DISPATCH();\
+		}\
+		LOGO_VM_CASE(NAME##_Unchecked) {\
+			const auto& target = state->stack[state->stack.length - 2];\
+			const auto& right = state->stack[state->stack.length - 1];\
+			if(!logo::check_parallel_loop_assignment(context,target.var_index,LOGO_VM_LINE_INDEX)) return false;\
+			auto& left = context->variables[target.var_index].value;\
+			left.FIELD = (EXPRESSION);\
+			state->stack.length -= 2;\
+			LOGO_VM_DISPATCH();\
+		}
+
+		LOGO_VM_CASE(Halt) {
+			return true;
+		}
+		LOGO_VM_CASE(Push_Constant) {
+			if(!logo::push_value(state,program->constants[instruction->operand])) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Pop) {
+			state->stack.length -= 1;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Load_Variable) {
+			std::size_t var_index = context->current_function_scope_first_var_index + instruction->operand;
+			if(!logo::push_value(state,context->variables[var_index].value)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Load_Variable_Lvalue) {
+			if(!logo::push_lvalue(state,context->current_function_scope_first_var_index + instruction->operand)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Load_Parent_Variable) {
+			const auto& parent_variable = program->parent_variables[instruction->operand];
+			auto [var_index,success] = logo::find_parent_scope_variable(context,parent_variable.name,parent_variable.slot,LOGO_VM_LINE_INDEX);
+			if(!success) return false;
+			if(!logo::push_value(state,context->variables[var_index].value)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Load_Parent_Variable_Lvalue) {
+			const auto& parent_variable = program->parent_variables[instruction->operand];
+			auto [var_index,success] = logo::find_parent_scope_variable(context,parent_variable.name,parent_variable.slot,LOGO_VM_LINE_INDEX);
+			if(!success) return false;
+			if(!logo::push_lvalue(state,var_index)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Make_Reference) {
+			auto [result,success] = logo::make_reference(context,state->stack[state->stack.length - 1],LOGO_VM_LINE_INDEX);
+			if(!success) return false;
+			state->stack[state->stack.length - 1] = result;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Dereference) {
+			auto [result,success] = logo::dereference(context,state->stack[state->stack.length - 1],LOGO_VM_LINE_INDEX);
+			if(!success) return false;
+			state->stack[state->stack.length - 1] = context->variables[result.var_index].value;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Dereference_Lvalue) {
+			auto [result,success] = logo::dereference(context,state->stack[state->stack.length - 1],LOGO_VM_LINE_INDEX);
+			if(!success) return false;
+			state->stack[state->stack.length - 1] = result;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Dereference_Unchecked) {
+			state->stack[state->stack.length - 1] = context->variables[state->stack[state->stack.length - 1].var_index].value;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Dereference_Lvalue_Unchecked) {
+			state->stack[state->stack.length - 1] = logo::make_lvalue(state->stack[state->stack.length - 1].var_index);
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_UNARY_OPERATION(Unary_Plus,Plus)
+		LOGO_VM_UNARY_OPERATION(Negate,Minus)
+		LOGO_VM_UNARY_OPERATION(Logical_Not,Logical_Not)
+		LOGO_VM_BINARY_OPERATION(Add,Plus)
+		LOGO_VM_BINARY_OPERATION(Subtract,Minus)
+		LOGO_VM_BINARY_OPERATION(Multiply,Multiply)
+		LOGO_VM_BINARY_OPERATION(Divide,Divide)
+		LOGO_VM_BINARY_OPERATION(Remainder,Remainder)
+		LOGO_VM_BINARY_OPERATION(Exponentiate,Exponentiate)
+		LOGO_VM_BINARY_OPERATION(Logical_And,Logical_And)
+		LOGO_VM_BINARY_OPERATION(Logical_Or,Logical_Or)
+		LOGO_VM_BINARY_OPERATION(Compare_Equal,Compare_Equal)
+		LOGO_VM_BINARY_OPERATION(Compare_Unequal,Compare_Unequal)
+		LOGO_VM_BINARY_OPERATION(Compare_Less_Than,Compare_Less_Than)
+		LOGO_VM_BINARY_OPERATION(Compare_Less_Than_Or_Equal,Compare_Less_Than_Or_Equal)
+		LOGO_VM_BINARY_OPERATION(Compare_Greater_Than,Compare_Greater_Than)
+		LOGO_VM_BINARY_OPERATION(Compare_Greater_Than_Or_Equal,Compare_Greater_Than_Or_Equal)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Add_Int,Add,Int,Int,int_v,left.int_v + right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Subtract_Int,Subtract,Int,Int,int_v,left.int_v - right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Multiply_Int,Multiply,Int,Int,int_v,left.int_v * right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Divide_Int,Divide,Int,Int,int_v,logo::divide_integers(left.int_v,right.int_v))
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Remainder_Int,Remainder,Int,Int,int_v,logo::compute_integer_remainder(left.int_v,right.int_v))
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Equal_Int,Compare_Equal,Int,Bool,bool_v,left.int_v == right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Unequal_Int,Compare_Unequal,Int,Bool,bool_v,left.int_v != right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Less_Than_Int,Compare_Less_Than,Int,Bool,bool_v,left.int_v < right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Less_Than_Or_Equal_Int,Compare_Less_Than_Or_Equal,Int,Bool,bool_v,left.int_v <= right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Greater_Than_Int,Compare_Greater_Than,Int,Bool,bool_v,left.int_v > right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Greater_Than_Or_Equal_Int,Compare_Greater_Than_Or_Equal,Int,Bool,bool_v,left.int_v >= right.int_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Add_Float,Add,Float,Float,float_v,left.float_v + right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Subtract_Float,Subtract,Float,Float,float_v,left.float_v - right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Multiply_Float,Multiply,Float,Float,float_v,left.float_v * right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Divide_Float,Divide,Float,Float,float_v,left.float_v / right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Remainder_Float,Remainder,Float,Float,float_v,std::fmod(left.float_v,right.float_v))
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Equal_Float,Compare_Equal,Float,Bool,bool_v,left.float_v == right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Unequal_Float,Compare_Unequal,Float,Bool,bool_v,left.float_v != right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Less_Than_Float,Compare_Less_Than,Float,Bool,bool_v,left.float_v < right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Less_Than_Or_Equal_Float,Compare_Less_Than_Or_Equal,Float,Bool,bool_v,left.float_v <= right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Greater_Than_Float,Compare_Greater_Than,Float,Bool,bool_v,left.float_v > right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Compare_Greater_Than_Or_Equal_Float,Compare_Greater_Than_Or_Equal,Float,Bool,bool_v,left.float_v >= right.float_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Logical_And_Bool,Logical_And,Bool,Bool,bool_v,left.bool_v && right.bool_v)
+		LOGO_VM_QUICKENED_BINARY_OPERATION(Logical_Or_Bool,Logical_Or,Bool,Bool,bool_v,left.bool_v || right.bool_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Add_Int,Int,int_v,left.int_v + right.int_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Subtract_Int,Int,int_v,left.int_v - right.int_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Multiply_Int,Int,int_v,left.int_v * right.int_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Divide_Int,Int,int_v,logo::divide_integers(left.int_v,right.int_v))
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Remainder_Int,Int,int_v,logo::compute_integer_remainder(left.int_v,right.int_v))
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Add_Float,Float,float_v,left.float_v + right.float_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Subtract_Float,Float,float_v,left.float_v - right.float_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Multiply_Float,Float,float_v,left.float_v * right.float_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Divide_Float,Float,float_v,left.float_v / right.float_v)
+		LOGO_VM_QUICKENED_ASSIGNMENT(Assign_Remainder_Float,Float,float_v,std::fmod(left.float_v,right.float_v))
+		LOGO_VM_CASE(Declare_Variable) {
+			auto name = static_cast<Symbol>(instruction->operand);
+			auto value = logo::pop_value(state);
+			if(value.type == Interpreter_Value_Type::Void) {
+				logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Cannot assign value of type 'Void' to '%'.",logo::get_symbol_name(name));
+				return false;
+			}
+			if(!logo::push_variable(context,name,value)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Assign) {
+			auto value = logo::pop_value(state);
+			auto target = logo::pop_value(state);
+			if(target.type != Interpreter_Value_Type::Lvalue) {
+				logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Cannot assign a value to a non-lvalue.");
+				return false;
+			}
+			if(value.type == Interpreter_Value_Type::Void) {
+				logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Cannot assign value of type 'Void'.");
+				return false;
+			}
+			if(!logo::check_parallel_loop_assignment(context,target.var_index,LOGO_VM_LINE_INDEX)) return false;
+			auto* target_value = &context->variables[target.var_index].value;
+			auto specialization = logo::specialize_compound_assignment(static_cast<Ast_Assignment_Type>(instruction->variant),target_value->type,value.type);
+			if(specialization != Ast_Operation_Specialization::None) logo::quicken_instruction(state,program,ip - 1,logo::get_specialized_assignment_opcode(specialization));
+			if(!logo::compute_assignment(static_cast<Ast_Assignment_Type>(instruction->variant),target_value,value,LOGO_VM_LINE_INDEX)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Tail_Call) {
+			if(!logo::call_function(state,program,instruction->operand,&ip,instruction->variant != 0)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Call) {
+			if(!logo::call_function(state,program,instruction->operand,&ip,false)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Print) {
+			const auto& call_site = program->call_sites[instruction->operand];
+			std::size_t first_arg_index = state->stack.length - call_site.arg_count;
+			Array_View<Interpreter_Value> args(state->stack.data + first_arg_index,call_site.arg_count);
+			if(!logo::check_call_arguments(args,LOGO_VM_LINE_INDEX)) return false;
+			if(!logo::check_parallel_loop_call(context,"print",LOGO_VM_LINE_INDEX)) return false;
+			if(!logo::call_print_function(args,LOGO_VM_LINE_INDEX)) return false;
+
+			state->stack.length = first_arg_index;
+			Interpreter_Value result{};
+			result.type = Interpreter_Value_Type::Void;
+			if(!logo::push_value(state,result)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Jump) {
+			//Jumping back is only done by 'while' loops.
+			if(instruction->operand < ip && !logo::count_watchdog_step(context,LOGO_VM_LINE_INDEX)) return false;
+			ip = instruction->operand;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Jump_If_False) {
+			auto condition = logo::pop_value(state);
+			if(condition.type != Interpreter_Value_Type::Bool) {
+				if(instruction->variant == static_cast<std::uint8_t>(Bytecode_Condition_Type::If_Statement)) {
+					logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Condition in a 'if' statement must be of type 'Bool'.");
+				}
+				else if(instruction->variant == static_cast<std::uint8_t>(Bytecode_Condition_Type::While_Statement)) {
+					logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Condition in a 'while' statement must be of type 'Bool'.");
+				}
+				else static_cast<void>(logo::check_conditional_expression_condition(condition,LOGO_VM_LINE_INDEX));
+				return false;
+			}
+			if(!condition.bool_v) ip = instruction->operand;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Short_Circuit) {
+			const auto& left = state->stack[state->stack.length - 1];
+			if(left.type == Interpreter_Value_Type::Bool && left.bool_v == (instruction->variant != 0)) ip = instruction->operand;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Begin_Scope) {
+			Vm_Scope scope{};
+			scope.var_count = context->variables.length;
+			if(!state->scopes.push_back(scope)) {
+				Report_Error("Couldn't allocate % bytes of memory.",sizeof(scope));
+				return false;
+			}
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(End_Scope) {
+			state->scopes.length -= instruction->operand;
+			const auto& scope = state->scopes.data[state->scopes.length];
+			context->variables.length = scope.var_count;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Return) {
+			Interpreter_Value result{};
+			if(instruction->variant != 0) result = logo::pop_value(state);
+			else result.type = Interpreter_Value_Type::Void;
+
+			const auto& frame = state->call_frames[state->call_frames.length - 1];
+			ip = frame.return_index;
+			context->current_function_scope_first_var_index = frame.first_var_index;
+			context->variables.length = frame.var_count;
+			state->scopes.length = frame.scope_count;
+			state->stack.length = frame.stack_length;
+			if(frame.is_in_dynamic_scope) logo::leave_dynamic_scope(context);
+			if(frame.memoized_function) {
+				std::size_t arg_count = frame.memoized_function->arguments.length;
+				state->stack.length -= arg_count;
+				if(!logo::memoize_result(frame.memoized_function,Array_View<Interpreter_Value>(state->stack.data + state->stack.length,arg_count),result)) return false;
+			}
+			state->call_frames.pop_back();
+			if(!logo::push_value(state,result)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(For_Prepare) {
+			//The bounds stay on the stack and are used as the loop counter and the upper bound until 'For_End'.
+			const auto& lower_bound_value = state->stack[state->stack.length - 2];
+			const auto& upper_bound_value = state->stack[state->stack.length - 1];
+			if(lower_bound_value.type != Interpreter_Value_Type::Int) {
+				logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Starting index in a 'for' loop must be an integer.");
+				return false;
+			}
+			if(upper_bound_value.type != Interpreter_Value_Type::Int) {
+				logo::report_interpreter_error(LOGO_VM_LINE_INDEX,"Ending index in a 'for' loop must be an integer.");
+				return false;
+			}
+			if(lower_bound_value.int_v < upper_bound_value.int_v) {
+				if(!logo::push_variable(context,static_cast<Symbol>(instruction->operand),lower_bound_value)) return false;
+				ip += 1;
+			}
+			else state->stack.length -= 2;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Declare_Induction_Variable) {
+			//The stack holds the bounds followed by the steps of the induction variables declared so far and the step of this one.
+			const auto& counter_value = state->stack[state->stack.length - 3 - instruction->variant];
+			const auto& step_value = state->stack[state->stack.length - 1];
+			//The optimizer only creates induction variables with integer steps.
+			logo::assert(step_value.type == Interpreter_Value_Type::Int);
+			Interpreter_Value value{};
+			value.type = Interpreter_Value_Type::Int;
+			value.int_v = counter_value.int_v * step_value.int_v;
+			if(!logo::push_variable(context,static_cast<Symbol>(instruction->operand),value)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(For_Step) {
+			if(!logo::count_watchdog_step(context,LOGO_VM_LINE_INDEX)) return false;
+			std::size_t induction_variable_count = instruction->variant;
+			auto& counter_value = state->stack[state->stack.length - 2 - induction_variable_count];
+			const auto& upper_bound_value = state->stack[state->stack.length - 1 - induction_variable_count];
+			std::size_t iterator_var_index = context->variables.length - 1 - induction_variable_count;
+			context->variables[iterator_var_index].value.int_v += 1;
+			for(std::size_t i = 0;i < induction_variable_count;i += 1) {
+				context->variables[iterator_var_index + 1 + i].value.int_v += state->stack[state->stack.length - induction_variable_count + i].int_v;
+			}
+			counter_value.int_v += 1;
+			if(counter_value.int_v < upper_bound_value.int_v) ip = instruction->operand;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(For_End) {
+			state->stack.length -= 2 + instruction->variant;
+			context->variables.pop_back(1 + instruction->variant);
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Enter_Parallel_Loop) {
+			if(!logo::enter_parallel_loop(context)) return false;
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Next_Parallel_Iteration) {
+			logo::next_parallel_loop_iteration(context);
+			LOGO_VM_DISPATCH();
+		}
+		LOGO_VM_CASE(Leave_Parallel_Loop) {
+			logo::leave_parallel_loop(context);
+			LOGO_VM_DISPATCH();
+		}
+
+#undef LOGO_VM_QUICKENED_ASSIGNMENT
+#undef LOGO_VM_QUICKENED_BINARY_OPERATION
+#undef LOGO_VM_BINARY_OPERATION
+#undef LOGO_VM_UNARY_OPERATION
+#undef LOGO_VM_LINE_INDEX
+#undef LOGO_VM_DISPATCH
+#undef LOGO_VM_CASE
+#ifdef LOGO_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#else
+				default: logo::unreachable();
+			}
+		}
+#endif
+	}
+
+	//Quickens the instructions that are still the same as in the profiled run and makes the profile remember the opcodes emitted by the compiler.
+	[[nodiscard]] static bool apply_instruction_profile(Vm_State* state,Bytecode_Program* program,Type_Profile* profile) {
+		bool is_profile_applicable = profile->instructions.length == program->instructions.length;
+		if(!is_profile_applicable) {
+			profile->instructions.destroy();
+			if(!profile->instructions.resize(program->instructions.length)) {
+				Report_Error("Couldn't allocate % bytes of memory.",program->instructions.length * sizeof(Profile_Instruction));
+				return false;
+			}
+		}
+		for(std::size_t i = 0;i < program->instructions.length;i += 1) {
+			auto& instruction = program->instructions[i];
+			auto& profile_instruction = profile->instructions[i];
+			if(is_profile_applicable && profile_instruction.compiled_opcode == instruction.opcode && logo::can_quicken_instruction(instruction,profile_instruction.opcode)) {
+				instruction.opcode = profile_instruction.opcode;
+				state->deoptimization_counts[i] = profile_instruction.deoptimization_count;
+			}
+			profile_instruction.compiled_opcode = instruction.opcode;
+		}
+		return true;
+	}
+
+	static void record_instruction_profile(const Vm_State* state,const Bytecode_Program* program,Type_Profile* profile) {
+		for(std::size_t i = 0;i < program->instructions.length;i += 1) {
+			profile->instructions[i].opcode = program->instructions[i].opcode;
+			profile->instructions[i].deoptimization_count = state->deoptimization_counts[i];
+		}
+	}
+
+	Option<Interpreter_Statistics> run_bytecode(Interpreter_Context* context,Bytecode_Program* program,std::size_t max_stack_size,bool use_jit,const Interpreter_Limits& limits,Type_Profile* profile) {
+		logo::reset_interpreter_context(context);
+		Vm_State state{};
+		state.context = context;
+		defer[&]{state.destroy();};
+		state.max_stack_size = max_stack_size;
+		state.jit.is_enabled = use_jit;
+		if(!state.call_site_caches.resize(program->call_sites.length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",program->call_sites.length * sizeof(Ast_Function_Call_Cache));
+			return {};
+		}
+		for(std::size_t i = 0;i < program->call_sites.length;i += 1) {
+			state.call_site_caches[i].are_argument_types_proven = program->call_sites[i].are_argument_types_proven;
+			state.call_site_caches[i].is_name_in_scope = program->call_sites[i].is_name_in_scope;
+		}
+		if(!state.deoptimization_counts.resize(program->instructions.length)) {
+			Report_Error("Couldn't allocate % bytes of memory.",program->instructions.length * sizeof(std::uint8_t));
+			return {};
+		}
+		for(const auto& bytecode_function : program->functions) {
+			Interpreter_Function function{};
+			function.name = bytecode_function.name;
+			function.arguments = bytecode_function.arguments;
+			function.body_statements = bytecode_function.body_statements;
+			function.code_offset = bytecode_function.code_offset;
+			function.is_memoized = bytecode_function.is_memoized;
+			function.parent_function_index = bytecode_function.parent_function_index;
+			function.defines_dynamic_functions = bytecode_function.defines_dynamic_functions;
+			if(!logo::define_function(state.context,bytecode_function.function_index,function)) return {};
+		}
+		if(profile) {
+			if(!logo::apply_instruction_profile(&state,program,profile)) return {};
+			logo::apply_call_count_profile(state.context,*profile);
+		}
+		logo::start_watchdog(state.context,limits);
+		if(!logo::execute(&state,program)) return {};
+		if(profile) {
+			logo::record_instruction_profile(&state,program,profile);
+			if(!logo::record_call_count_profile(state.context,profile)) return {};
+		}
+		return state.context->statistics;
+	}
+}
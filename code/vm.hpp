@@ -0,0 +1,15 @@
+#ifndef LOGO_VM_HPP
+#define LOGO_VM_HPP
+
+#include "profile.hpp"
+#include "bytecode.hpp"
+
+namespace logo {
+	//Quickens instructions of the program while running it. Calls fail with an error once the call stack and the variables take up more than 'max_stack_size' bytes.
+	//If 'use_jit' is true, hot functions are compiled to machine code. If 'profile' isn't nullptr, the program starts with the instructions quickened
+	//and the call counts of the functions set as they were at the end of the profiled run and the new ones are saved into it after the program finishes.
+	//The program is stopped with an error once it goes over 'limits'. 'context' is reset before the program starts, see 'interpret_ast'.
+	[[nodiscard]] Option<Interpreter_Statistics> run_bytecode(Interpreter_Context* context,Bytecode_Program* program,std::size_t max_stack_size,bool use_jit,const Interpreter_Limits& limits,Type_Profile* profile);
+}
+
+#endif